@@ -0,0 +1,611 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <vulkan/vulkan.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include "VkDeviceTest.h"
+#include "VkMemoryAllocator.h"
+#include "VkRenderer.h"
+#include "VkShaders.h"
+#include "VkStagingUploader.h"
+#include "VkTexture.h"
+#include "VkTimeline.h"
+#include "VkUtil.h"
+
+// 최적화 전후의 숫자를 비교하기 위한 벤치마크로 실패 여부보다 출력되는 백분위수가 중요하다.
+// 각 벤치마크는 워밍업 후에 반복마다 걸린 시간을 재고 p50, p95, p99를 출력하고 테스트 속성으로 기록한다.
+namespace {
+
+constexpr uint32_t kWarmupIterationCount = 3;
+
+struct VkBenchStatistics {
+    double p50;
+    double p95;
+    double p99;
+};
+
+// 가장 가까운 순위의 표본을 백분위수로 사용한다.
+VkBenchStatistics getStatistics(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    const auto percentile = [&](double p) {
+        const auto rank = static_cast<size_t>(p * samples.size() + 0.5);
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+    return {percentile(0.50), percentile(0.95), percentile(0.99)};
+}
+
+void report(const std::string &name, const std::vector<double> &samples) {
+    const auto statistics = getStatistics(samples);
+
+    std::ostringstream stream;
+    stream << std::fixed;
+    stream.precision(3);
+    stream << name << ": p50 " << statistics.p50 << "ms, p95 " << statistics.p95
+           << "ms, p99 " << statistics.p99 << "ms (" << samples.size() << " samples)";
+    aout << stream.str() << std::endl;
+
+    testing::Test::RecordProperty(name + ".p50Ms", std::to_string(statistics.p50));
+    testing::Test::RecordProperty(name + ".p95Ms", std::to_string(statistics.p95));
+    testing::Test::RecordProperty(name + ".p99Ms", std::to_string(statistics.p99));
+}
+
+std::vector<double> measure(uint32_t iterationCount, const std::function<void()> &function) {
+    for (auto i = 0; i != kWarmupIterationCount; ++i) {
+        function();
+    }
+
+    std::vector<double> samples(iterationCount);
+    for (auto &sample: samples) {
+        const auto startTime = std::chrono::steady_clock::now();
+        function();
+        sample = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - startTime).count();
+    }
+    return samples;
+}
+
+// 압축이 너무 잘 되지 않도록 그라데이션에 노이즈를 더한 PNG를 메모리에 만든다.
+std::vector<uint8_t> encodePng(uint32_t size) {
+    std::mt19937 generator(size);
+    std::uniform_int_distribution<int> distribution(0, 15);
+
+    std::vector<uint8_t> pixels(size * size * 4);
+    for (auto y = 0; y != size; ++y) {
+        for (auto x = 0; x != size; ++x) {
+            auto pPixel = &pixels[(y * size + x) * 4];
+            pPixel[0] = static_cast<uint8_t>(x * 255 / size + distribution(generator));
+            pPixel[1] = static_cast<uint8_t>(y * 255 / size + distribution(generator));
+            pPixel[2] = static_cast<uint8_t>(distribution(generator) * 16);
+            pPixel[3] = UINT8_MAX;
+        }
+    }
+
+    std::vector<uint8_t> png;
+    stbi_write_png_to_func([](void *pContext, void *pData, int size) {
+                               auto pPng = static_cast<std::vector<uint8_t> *>(pContext);
+                               auto pBytes = static_cast<const uint8_t *>(pData);
+                               pPng->insert(pPng->end(), pBytes, pBytes + size);
+                           },
+                           &png,
+                           static_cast<int>(size),
+                           static_cast<int>(size),
+                           4,
+                           pixels.data(),
+                           static_cast<int>(size * 4));
+    return png;
+}
+
+}
+
+class VkBench : public VkDeviceTest {
+protected:
+    VkBench() : VkDeviceTest(kBlockSize) {
+    }
+
+    void SetUp() override {
+        VkDeviceTest::SetUp();
+        if (HasFatalFailure()) {
+            return;
+        }
+
+        // 기능을 활성화하지 않아도 동작하도록 VkFence로 완료를 확인한다.
+        VkTimelineCreateInfo timelineCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_CREATE_INFO,
+            .timelineSemaphore = VK_FALSE
+        };
+
+        ASSERT_EQ(vkCreateTimeline(mDevice, &timelineCreateInfo, nullptr, &mTimeline), VK_SUCCESS);
+    }
+
+    void TearDown() override {
+        if (mTimeline) {
+            vkDestroyTimeline(mDevice, mTimeline, nullptr);
+        }
+        VkDeviceTest::TearDown();
+    }
+
+    VkShaderModule createShaderModule(const std::vector<uint32_t> &shaderBinary) {
+        VkShaderModuleCreateInfo shaderModuleCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .codeSize = shaderBinary.size() * sizeof(uint32_t),
+            .pCode = shaderBinary.data()
+        };
+
+        VkShaderModule shaderModule = VK_NULL_HANDLE;
+        EXPECT_EQ(vkCreateShaderModule(mDevice, &shaderModuleCreateInfo, nullptr, &shaderModule),
+                  VK_SUCCESS);
+        return shaderModule;
+    }
+
+    static constexpr VkDeviceSize kBlockSize = 16 * 1024 * 1024;
+
+    VkTimeline mTimeline = VK_NULL_HANDLE;
+};
+
+#ifndef VK_PRECOMPILED_SHADERS
+TEST(VkShaderBench, compileShader) {
+    std::vector<uint32_t> shaderBinary;
+    report("compileShader.vertex", measure(20, [&]() {
+        ASSERT_EQ(vkCompileShader(kTriangleVertexShaderCode, VK_SHADER_TYPE_VERTEX, &shaderBinary),
+                  VK_SUCCESS);
+    }));
+    report("compileShader.compute", measure(20, [&]() {
+        ASSERT_EQ(vkCompileShader(kAnimateComputeShaderCode, VK_SHADER_TYPE_COMPUTE, &shaderBinary),
+                  VK_SUCCESS);
+    }));
+}
+#endif
+
+class VkTextureBench : public testing::TestWithParam<uint32_t> {
+};
+
+TEST_P(VkTextureBench, decode) {
+    const auto png = encodePng(GetParam());
+
+    VkTextureDataInfo textureDataInfo{
+        .sType = VK_STRUCTURE_TYPE_TEXTURE_DATA_INFO,
+        .dataSize = png.size(),
+        .pData = png.data()
+    };
+
+    VkTextureCreateInfo textureCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO,
+        .pNext = &textureDataInfo
+    };
+
+    // 스테이징에 쓰는 변환까지 포함해서 측정한다.
+    std::vector<uint8_t> pixels(GetParam() * GetParam() * 4);
+    report("createTexture.png" + std::to_string(GetParam()), measure(10, [&]() {
+        VkTexture texture;
+        ASSERT_EQ(vkCreateTexture(VK_NULL_HANDLE, &textureCreateInfo, nullptr, &texture), VK_SUCCESS);
+        vkWriteTextureData(texture, pixels.data());
+        vkDestroyTexture(VK_NULL_HANDLE, texture, nullptr);
+    }));
+}
+
+INSTANTIATE_TEST_SUITE_P(VkTextureBench, VkTextureBench, testing::Values(256, 1024, 2048));
+
+class VkStagingUploadBench : public VkBench, public testing::WithParamInterface<VkDeviceSize> {
+};
+
+TEST_P(VkStagingUploadBench, uploadBuffer) {
+    constexpr VkDeviceSize kArenaSize = 4 * 1024 * 1024;
+    const auto size = GetParam();
+
+    VkStagingUploaderCreateInfo stagingUploaderCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_STAGING_UPLOADER_CREATE_INFO,
+        .memoryAllocator = mMemoryAllocator,
+        .queueFamilyIndex = mQueueFamilyIndex,
+        .queue = mQueue,
+        .timeline = mTimeline,
+        .arenaSize = kArenaSize
+    };
+
+    VkStagingUploader stagingUploader;
+    ASSERT_EQ(vkCreateStagingUploader(mDevice, &stagingUploaderCreateInfo, nullptr, &stagingUploader),
+              VK_SUCCESS);
+
+    VkBufferCreateInfo bufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT
+    };
+
+    VkBuffer buffer;
+    ASSERT_EQ(vkCreateBuffer(mDevice, &bufferCreateInfo, nullptr, &buffer), VK_SUCCESS);
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(mDevice, buffer, &memoryRequirements);
+
+    VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .flags = VK_MEMORY_ALLOCATION_CREATE_DEDICATED_BIT,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = memoryRequirements,
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    };
+
+    VkMemoryAllocation memoryAllocation;
+    ASSERT_EQ(vkCreateMemoryAllocation(mMemoryAllocator, &memoryAllocationCreateInfo, &memoryAllocation),
+              VK_SUCCESS);
+
+    VkMemoryAllocationProperties memoryAllocationProperties;
+    vkGetMemoryAllocationProperties(memoryAllocation, &memoryAllocationProperties);
+    ASSERT_EQ(vkBindBufferMemory(mDevice,
+                                 buffer,
+                                 memoryAllocationProperties.memory,
+                                 memoryAllocationProperties.offset),
+              VK_SUCCESS);
+
+    // 스테이징 영역에 쓰는 시간부터 GPU가 복사를 끝낼 때까지를 잰다.
+    const std::vector<uint8_t> data(size, 0x5A);
+    report("uploadBuffer." + std::to_string(size / 1024) + "KiB", measure(20, [&]() {
+        ASSERT_EQ(vkUploadBuffer(stagingUploader, buffer, 0, size, data.data()), VK_SUCCESS);
+        ASSERT_EQ(vkFlushStagingUploader(stagingUploader), VK_SUCCESS);
+
+        VkTimelineProperties timelineProperties;
+        vkGetTimelineProperties(mTimeline, &timelineProperties);
+        ASSERT_EQ(vkWaitTimeline(mTimeline, timelineProperties.submittedValue, UINT64_MAX), VK_SUCCESS);
+    }));
+
+    vkDestroyStagingUploader(mDevice, stagingUploader, nullptr);
+    vkDestroyBuffer(mDevice, buffer, nullptr);
+    vkDestroyMemoryAllocation(mMemoryAllocator, memoryAllocation);
+}
+
+INSTANTIATE_TEST_SUITE_P(VkStagingUploadBench,
+                         VkStagingUploadBench,
+                         testing::Values(64 * 1024, 1024 * 1024, 16 * 1024 * 1024));
+
+// 렌더러와 같은 셰이더와 정점 입력으로 그래픽스 VkPipeline을 만든다.
+TEST_F(VkBench, createGraphicsPipeline) {
+    std::vector<uint32_t> vertexShaderBinary;
+    ASSERT_EQ(vkCompileShader(kTriangleVertexShaderCode, VK_SHADER_TYPE_VERTEX, nullptr, &vertexShaderBinary),
+              VK_SUCCESS);
+
+    std::vector<uint32_t> fragmentShaderBinary;
+    ASSERT_EQ(vkCompileShader(kTriangleFragmentShaderCode,
+                              VK_SHADER_TYPE_FRAGMENT,
+                              nullptr,
+                              &fragmentShaderBinary),
+              VK_SUCCESS);
+
+    const auto vertexShaderModule = createShaderModule(vertexShaderBinary);
+    const auto fragmentShaderModule = createShaderModule(fragmentShaderBinary);
+
+    VkAttachmentDescription attachmentDescription{
+        .format = VK_FORMAT_R8G8B8A8_UNORM,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    };
+
+    VkAttachmentReference attachmentReference{
+        .attachment = 0,
+        .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    };
+
+    VkSubpassDescription subpassDescription{
+        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &attachmentReference
+    };
+
+    VkRenderPassCreateInfo renderPassCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .attachmentCount = 1,
+        .pAttachments = &attachmentDescription,
+        .subpassCount = 1,
+        .pSubpasses = &subpassDescription
+    };
+
+    VkRenderPass renderPass;
+    ASSERT_EQ(vkCreateRenderPass(mDevice, &renderPassCreateInfo, nullptr, &renderPass), VK_SUCCESS);
+
+    VkDescriptorSetLayoutBinding descriptorSetLayoutBinding{
+        .binding = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .descriptorCount = 1,
+        .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+    };
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = 1,
+        .pBindings = &descriptorSetLayoutBinding
+    };
+
+    VkDescriptorSetLayout descriptorSetLayout;
+    ASSERT_EQ(vkCreateDescriptorSetLayout(mDevice, &descriptorSetLayoutCreateInfo, nullptr, &descriptorSetLayout),
+              VK_SUCCESS);
+
+    // mat2 rotation, float ratio, uint textureIndex.
+    VkPushConstantRange pushConstantRange{
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        .offset = 0,
+        .size = 6 * sizeof(float)
+    };
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+
+    VkPipelineLayout pipelineLayout;
+    ASSERT_EQ(vkCreatePipelineLayout(mDevice, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout),
+              VK_SUCCESS);
+
+    const std::array<VkPipelineShaderStageCreateInfo, 2> pipelineShaderStageCreateInfos{
+        VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .module = vertexShaderModule,
+            .pName = "main"
+        },
+        VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module = fragmentShaderModule,
+            .pName = "main"
+        }
+    };
+
+    // Vertex(위치, 색상, 텍스처 좌표)와 Instance(위치, 속도, 크기, 레이어) 배치이다.
+    const std::array<VkVertexInputBindingDescription, 2> vertexInputBindingDescriptions{
+        VkVertexInputBindingDescription{
+            .binding = 0,
+            .stride = 8 * sizeof(float),
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        },
+        VkVertexInputBindingDescription{
+            .binding = 1,
+            .stride = 6 * sizeof(float),
+            .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
+        }
+    };
+
+    const std::array<VkVertexInputAttributeDescription, 6> vertexInputAttributeDescriptions{
+        VkVertexInputAttributeDescription{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0},
+        VkVertexInputAttributeDescription{1, 0, VK_FORMAT_R32G32B32_SFLOAT, 3 * sizeof(float)},
+        VkVertexInputAttributeDescription{2, 0, VK_FORMAT_R32G32_SFLOAT, 6 * sizeof(float)},
+        VkVertexInputAttributeDescription{3, 1, VK_FORMAT_R32G32_SFLOAT, 0},
+        VkVertexInputAttributeDescription{4, 1, VK_FORMAT_R32_SFLOAT, 4 * sizeof(float)},
+        VkVertexInputAttributeDescription{5, 1, VK_FORMAT_R32_UINT, 5 * sizeof(float)}
+    };
+
+    VkPipelineVertexInputStateCreateInfo pipelineVertexInputStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount = static_cast<uint32_t>(vertexInputBindingDescriptions.size()),
+        .pVertexBindingDescriptions = vertexInputBindingDescriptions.data(),
+        .vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributeDescriptions.size()),
+        .pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data()
+    };
+
+    VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+    };
+
+    VkPipelineViewportStateCreateInfo pipelineViewportStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
+        .scissorCount = 1
+    };
+
+    VkPipelineRasterizationStateCreateInfo pipelineRasterizationStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode = VK_CULL_MODE_NONE,
+        .lineWidth = 1.0f
+    };
+
+    VkPipelineMultisampleStateCreateInfo pipelineMultisampleStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
+    };
+
+    VkPipelineDepthStencilStateCreateInfo pipelineDepthStencilStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO
+    };
+
+    VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentState{
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                          VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+    };
+
+    VkPipelineColorBlendStateCreateInfo pipelineColorBlendStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .attachmentCount = 1,
+        .pAttachments = &pipelineColorBlendAttachmentState
+    };
+
+    const std::array<VkDynamicState, 2> dynamicStates{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
+
+    VkPipelineDynamicStateCreateInfo pipelineDynamicStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+        .pDynamicStates = dynamicStates.data()
+    };
+
+    VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = static_cast<uint32_t>(pipelineShaderStageCreateInfos.size()),
+        .pStages = pipelineShaderStageCreateInfos.data(),
+        .pVertexInputState = &pipelineVertexInputStateCreateInfo,
+        .pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo,
+        .pViewportState = &pipelineViewportStateCreateInfo,
+        .pRasterizationState = &pipelineRasterizationStateCreateInfo,
+        .pMultisampleState = &pipelineMultisampleStateCreateInfo,
+        .pDepthStencilState = &pipelineDepthStencilStateCreateInfo,
+        .pColorBlendState = &pipelineColorBlendStateCreateInfo,
+        .pDynamicState = &pipelineDynamicStateCreateInfo,
+        .layout = pipelineLayout,
+        .renderPass = renderPass
+    };
+
+    const auto createPipeline = [&](VkPipelineCache pipelineCache) {
+        VkPipeline pipeline;
+        ASSERT_EQ(vkCreateGraphicsPipelines(mDevice,
+                                            pipelineCache,
+                                            1,
+                                            &graphicsPipelineCreateInfo,
+                                            nullptr,
+                                            &pipeline),
+                  VK_SUCCESS);
+        vkDestroyPipeline(mDevice, pipeline, nullptr);
+    };
+
+    report("createGraphicsPipeline.noCache", measure(20, [&]() {
+        createPipeline(VK_NULL_HANDLE);
+    }));
+
+    // 워밍업에서 만든 VkPipeline으로 캐시가 채워진 후의 시간을 잰다.
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
+    };
+
+    VkPipelineCache pipelineCache;
+    ASSERT_EQ(vkCreatePipelineCache(mDevice, &pipelineCacheCreateInfo, nullptr, &pipelineCache),
+              VK_SUCCESS);
+
+    report("createGraphicsPipeline.warmCache", measure(20, [&]() {
+        createPipeline(pipelineCache);
+    }));
+
+    vkDestroyPipelineCache(mDevice, pipelineCache, nullptr);
+    vkDestroyPipelineLayout(mDevice, pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(mDevice, descriptorSetLayout, nullptr);
+    vkDestroyRenderPass(mDevice, renderPass, nullptr);
+    vkDestroyShaderModule(mDevice, fragmentShaderModule, nullptr);
+    vkDestroyShaderModule(mDevice, vertexShaderModule, nullptr);
+}
+
+class VkRendererBench : public testing::TestWithParam<bool> {
+};
+
+// 윈도우 없이 오프스크린 이미지에 그리므로 수직 동기화와 상관없이 렌더러의 처리량을 잰다.
+// 미리 기록된 VkCommandBuffer를 사용하는지에 따라 render()의 CPU 시간을 비교한다.
+TEST_P(VkRendererBench, renderOffscreen) {
+    constexpr uint32_t kDiscardedFrameCount = 60;
+    constexpr uint32_t kMeasuredFrameCount = 300;
+
+    const auto png = encodePng(1024);
+
+    VkRendererConfig config{
+        .prerecordCommandBuffers = GetParam(),
+        .instanceCount = 1024,
+        .offscreenExtent = {1920, 1080},
+        .offscreenFrameCount = kDiscardedFrameCount + kMeasuredFrameCount,
+        .textureDataSize = png.size(),
+        .pTextureData = png.data()
+    };
+
+    std::vector<uint64_t> frameTimes;
+    {
+        VkRenderer renderer(nullptr, nullptr, nullptr, config);
+        frameTimes = renderer.waitOffscreenFrames();
+    }
+    ASSERT_EQ(frameTimes.size(), config.offscreenFrameCount);
+
+    // 텍스처 업로드가 끝나기 전의 프레임은 아무것도 그리지 않으므로 버린다.
+    std::vector<double> samples;
+    for (auto i = kDiscardedFrameCount; i != frameTimes.size(); ++i) {
+        samples.push_back(static_cast<double>(frameTimes[i]) / 1000000.0);
+    }
+
+    report(std::string("renderOffscreen.") + (GetParam() ? "prerecorded" : "immediate"), samples);
+}
+
+// 캡처한 프레임 트레이스를 재생하면 텍스처와 Graphics VkPipeline이 준비되는 시점과 상관없이 같은 프레임들을 그리므로
+// 최적화 전후의 실행마다 같은 작업량을 잰다. 재생은 트레이스를 두번 반복하고 두번째 반복만 측정한다.
+TEST_P(VkRendererBench, replayOffscreen) {
+    constexpr uint32_t kDiscardedFrameCount = 60;
+    constexpr uint32_t kCapturedFrameCount = 300;
+
+    const auto png = encodePng(1024);
+
+    VkRendererConfig config{
+        .prerecordCommandBuffers = GetParam(),
+        .instanceCount = 1024,
+        .offscreenExtent = {1920, 1080},
+        .offscreenFrameCount = kDiscardedFrameCount + kCapturedFrameCount,
+        .textureDataSize = png.size(),
+        .pTextureData = png.data(),
+        .frameCaptureCount = kDiscardedFrameCount + kCapturedFrameCount
+    };
+
+    std::vector<uint64_t> frameTimes;
+    std::vector<uint8_t> frameTraceData;
+    {
+        VkRenderer renderer(nullptr, nullptr, nullptr, config);
+        frameTimes = renderer.waitOffscreenFrames();
+        frameTraceData = renderer.getFrameTraceData();
+    }
+    ASSERT_EQ(frameTimes.size(), config.offscreenFrameCount);
+    ASSERT_FALSE(frameTraceData.empty());
+
+    const auto name = std::string("replayOffscreen.") + (GetParam() ? "prerecorded" : "immediate");
+    std::vector<double> samples;
+    for (auto i = kDiscardedFrameCount; i != frameTimes.size(); ++i) {
+        samples.push_back(static_cast<double>(frameTimes[i]) / 1000000.0);
+    }
+    report(name + ".captured", samples);
+
+    config.offscreenFrameCount = 2 * config.frameCaptureCount;
+    config.frameTraceDataSize = frameTraceData.size();
+    config.pFrameTraceData = frameTraceData.data();
+    {
+        VkRenderer renderer(nullptr, nullptr, nullptr, config);
+        frameTimes = renderer.waitOffscreenFrames();
+    }
+    ASSERT_EQ(frameTimes.size(), config.offscreenFrameCount);
+
+    samples.clear();
+    for (auto i = config.frameCaptureCount + kDiscardedFrameCount; i != frameTimes.size(); ++i) {
+        samples.push_back(static_cast<double>(frameTimes[i]) / 1000000.0);
+    }
+    report(name + ".replayed", samples);
+}
+
+INSTANTIATE_TEST_SUITE_P(VkRendererBench, VkRendererBench, testing::Bool());
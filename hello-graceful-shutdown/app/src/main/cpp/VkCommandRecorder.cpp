@@ -0,0 +1,253 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "VkCommandRecorder.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+struct VkCommandRecorderImpl {
+    VkDevice device;
+    uint32_t threadCount;
+    // 프레임과 스레드의 조합마다 frameIndex * threadCount + threadIndex에 저장된다.
+    vector<VkCommandPool> commandPools;
+    vector<VkCommandBuffer> commandBuffers;
+    uint32_t frameIndex;
+    mutex lock;
+    condition_variable condition;
+    // 워커 스레드는 jobID가 바뀌면 현재 작업을 기록한다.
+    uint64_t jobID;
+    const VkCommandBufferInheritanceInfo *pInheritanceInfo;
+    PFN_vkRecordCommandsFunction pfnRecord;
+    void *pUserData;
+    uint32_t pendingThreadCount;
+    VkResult result;
+    bool quit;
+    vector<thread> threads;
+};
+
+void vkRunCommandRecorder(VkCommandRecorderImpl *pImpl, uint32_t threadIndex) {
+    uint64_t jobID = 0;
+    unique_lock<mutex> guard(pImpl->lock);
+    while (true) {
+        pImpl->condition.wait(guard, [pImpl, jobID] {
+            return pImpl->quit || pImpl->jobID != jobID;
+        });
+
+        if (pImpl->quit) {
+            return;
+        }
+
+        jobID = pImpl->jobID;
+        const auto commandBuffer = pImpl->commandBuffers[pImpl->frameIndex * pImpl->threadCount + threadIndex];
+        const auto pInheritanceInfo = pImpl->pInheritanceInfo;
+        const auto pfnRecord = pImpl->pfnRecord;
+        const auto pUserData = pImpl->pUserData;
+        guard.unlock();
+
+        // ================================================================================
+        // 1. 보조 VkCommandBuffer 기록 시작
+        // ================================================================================
+        // VkRenderPass나 Dynamic Rendering 안에서 실행될 때는 렌더링을 이어서 기록한다.
+        const auto renderPassContinue =
+                pInheritanceInfo->renderPass ||
+                vkFindStructure(pInheritanceInfo->pNext,
+                                VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO);
+        VkCommandBufferBeginInfo commandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT |
+                     (renderPassContinue ? VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT : 0),
+            .pInheritanceInfo = pInheritanceInfo
+        };
+
+        auto result = vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo);
+        if (result == VK_SUCCESS) {
+            // ================================================================================
+            // 2. 명령 기록
+            // ================================================================================
+            pfnRecord(pUserData, commandBuffer, threadIndex, pImpl->threadCount);
+
+            // ================================================================================
+            // 3. 보조 VkCommandBuffer 기록 종료
+            // ================================================================================
+            result = vkEndCommandBuffer(commandBuffer);
+        }
+
+        guard.lock();
+        if (result != VK_SUCCESS) {
+            pImpl->result = result;
+        }
+        if (!--pImpl->pendingThreadCount) {
+            pImpl->condition.notify_all();
+        }
+    }
+}
+
+}
+
+VkResult vkCreateCommandRecorder(
+    VkDevice                                    device,
+    const VkCommandRecorderCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkCommandRecorder*                          pCommandRecorder) {
+    auto pImpl = make_unique<VkCommandRecorderImpl>();
+    pImpl->device = device;
+    pImpl->threadCount = max(pCreateInfo->threadCount, 1u);
+    pImpl->frameIndex = 0;
+    pImpl->jobID = 0;
+    pImpl->pendingThreadCount = 0;
+    pImpl->result = VK_SUCCESS;
+    pImpl->quit = false;
+
+    const auto commandPoolCount = pImpl->threadCount * max(pCreateInfo->frameCount, 1u);
+    pImpl->commandPools.resize(commandPoolCount, VK_NULL_HANDLE);
+    pImpl->commandBuffers.resize(commandPoolCount, VK_NULL_HANDLE);
+    for (uint32_t i = 0; i != commandPoolCount; ++i) {
+        // ================================================================================
+        // 1. VkCommandPool 생성
+        // ================================================================================
+        // VkCommandPool은 외부 동기화가 필요하므로 스레드마다 따로 사용하고,
+        // 개별 VkCommandBuffer 대신 VkCommandPool 전체를 한번에 초기화한다.
+        VkCommandPoolCreateInfo commandPoolCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = pCreateInfo->queueFamilyIndex
+        };
+
+        auto result = vkCreateCommandPool(device, &commandPoolCreateInfo, nullptr, &pImpl->commandPools[i]);
+        if (result != VK_SUCCESS) {
+            vkDestroyCommandRecorder(device, reinterpret_cast<VkCommandRecorder>(pImpl.release()), pAllocator);
+            return result;
+        }
+
+        // ================================================================================
+        // 2. 보조 VkCommandBuffer 할당
+        // ================================================================================
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = pImpl->commandPools[i],
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1
+        };
+
+        result = vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &pImpl->commandBuffers[i]);
+        if (result != VK_SUCCESS) {
+            vkDestroyCommandRecorder(device, reinterpret_cast<VkCommandRecorder>(pImpl.release()), pAllocator);
+            return result;
+        }
+    }
+
+    for (uint32_t i = 0; i != pImpl->threadCount; ++i) {
+        pImpl->threads.emplace_back(vkRunCommandRecorder, pImpl.get(), i);
+    }
+
+    *pCommandRecorder = reinterpret_cast<VkCommandRecorder>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyCommandRecorder(
+    VkDevice                                    device,
+    VkCommandRecorder                           commandRecorder,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkCommandRecorderImpl*>(commandRecorder);
+    {
+        lock_guard<mutex> guard(pImpl->lock);
+        pImpl->quit = true;
+    }
+    pImpl->condition.notify_all();
+
+    for (auto &thread : pImpl->threads) {
+        thread.join();
+    }
+
+    // VkCommandPool을 파괴하면 할당된 VkCommandBuffer도 해제된다.
+    for (auto commandPool : pImpl->commandPools) {
+        vkDestroyCommandPool(device, commandPool, nullptr);
+    }
+    delete pImpl;
+}
+
+void vkGetCommandRecorderProperties(
+    VkCommandRecorder                           commandRecorder,
+    VkCommandRecorderProperties*                pCommandRecorderProperties) {
+    auto pImpl = reinterpret_cast<VkCommandRecorderImpl*>(commandRecorder);
+    *pCommandRecorderProperties = {
+        .threadCount = pImpl->threadCount
+    };
+}
+
+VkResult vkBeginCommandRecorderFrame(
+    VkCommandRecorder                           commandRecorder,
+    uint32_t                                    frameIndex) {
+    auto pImpl = reinterpret_cast<VkCommandRecorderImpl*>(commandRecorder);
+    assert(frameIndex * pImpl->threadCount < pImpl->commandPools.size());
+
+    pImpl->frameIndex = frameIndex;
+    for (uint32_t i = 0; i != pImpl->threadCount; ++i) {
+        auto result = vkResetCommandPool(pImpl->device,
+                                         pImpl->commandPools[frameIndex * pImpl->threadCount + i],
+                                         0);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+    }
+
+    return VK_SUCCESS;
+}
+
+VkResult vkRecordCommands(
+    VkCommandRecorder                           commandRecorder,
+    const VkCommandBufferInheritanceInfo*       pInheritanceInfo,
+    PFN_vkRecordCommandsFunction                pfnRecord,
+    void*                                       pUserData,
+    VkCommandBuffer*                            pCommandBuffers) {
+    auto pImpl = reinterpret_cast<VkCommandRecorderImpl*>(commandRecorder);
+
+    unique_lock<mutex> guard(pImpl->lock);
+    ++pImpl->jobID;
+    pImpl->pInheritanceInfo = pInheritanceInfo;
+    pImpl->pfnRecord = pfnRecord;
+    pImpl->pUserData = pUserData;
+    pImpl->pendingThreadCount = pImpl->threadCount;
+    pImpl->result = VK_SUCCESS;
+    pImpl->condition.notify_all();
+
+    pImpl->condition.wait(guard, [pImpl] {
+        return !pImpl->pendingThreadCount;
+    });
+
+    for (uint32_t i = 0; i != pImpl->threadCount; ++i) {
+        pCommandBuffers[i] = pImpl->commandBuffers[pImpl->frameIndex * pImpl->threadCount + i];
+    }
+
+    return pImpl->result;
+}
@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKCOMMANDRECORDER_H
+#define PRACTICE_VULKAN_VKCOMMANDRECORDER_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkCommandRecorder)
+
+// 워커 스레드에서 호출되며 threadIndex에 해당하는 몫의 명령을 commandBuffer에 기록한다.
+typedef void (VKAPI_PTR *PFN_vkRecordCommandsFunction)(
+    void*                                       pUserData,
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    threadIndex,
+    uint32_t                                    threadCount);
+
+typedef struct VkCommandRecorderCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    uint32_t                         queueFamilyIndex;
+    // 스레드마다 보조 VkCommandBuffer를 하나씩 기록한다.
+    uint32_t                         threadCount;
+    // VkCommandPool은 프레임과 스레드마다 만들어서 프레임 단위로 초기화한다.
+    uint32_t                         frameCount;
+} VkCommandRecorderCreateInfo;
+
+typedef struct VkCommandRecorderProperties {
+    uint32_t                         threadCount;
+} VkCommandRecorderProperties;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateCommandRecorder(
+    VkDevice                                    device,
+    const VkCommandRecorderCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkCommandRecorder*                          pCommandRecorder);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyCommandRecorder(
+    VkDevice                                    device,
+    VkCommandRecorder                           commandRecorder,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR void VKAPI_CALL vkGetCommandRecorderProperties(
+    VkCommandRecorder                           commandRecorder,
+    VkCommandRecorderProperties*                pCommandRecorderProperties);
+
+// frameIndex에 해당하는 VkCommandPool들을 초기화한다.
+// 호출하기 전에 이 VkCommandPool에서 기록된 이전 프레임의 GPU 작업이 끝나야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkBeginCommandRecorderFrame(
+    VkCommandRecorder                           commandRecorder,
+    uint32_t                                    frameIndex);
+
+// 모든 워커 스레드에서 pfnRecord를 호출해서 보조 VkCommandBuffer를 기록하고 끝날 때까지 기다린다.
+// pCommandBuffers는 threadCount개의 원소를 가져야 하며 vkCmdExecuteCommands로 실행한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkRecordCommands(
+    VkCommandRecorder                           commandRecorder,
+    const VkCommandBufferInheritanceInfo*       pInheritanceInfo,
+    PFN_vkRecordCommandsFunction                pfnRecord,
+    void*                                       pUserData,
+    VkCommandBuffer*                            pCommandBuffers);
+
+#endif //PRACTICE_VULKAN_VKCOMMANDRECORDER_H
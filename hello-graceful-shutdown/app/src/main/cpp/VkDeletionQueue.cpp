@@ -0,0 +1,186 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <memory>
+
+#include "VkDeletionQueue.h"
+
+using namespace std;
+
+namespace {
+
+struct VkDeferredDestroy {
+    uint64_t timelineValue;
+    VkObjectType objectType;
+    PFN_vkDestroyObjectFunction pfnDestroy;
+    void *pUserData;
+    uint64_t object;
+};
+
+struct VkDeletionQueueImpl {
+    VkDevice device;
+    VkTimeline timeline;
+    // 타임라인 값은 보통 증가하는 순서로 예약되므로 앞에서부터 완료된 값을 확인한다.
+    deque<VkDeferredDestroy> destroys;
+};
+
+template<typename T>
+T vkCastHandle(uint64_t object) {
+    return reinterpret_cast<T>(object);
+}
+
+void vkDestroy(VkDeletionQueueImpl *pImpl, const VkDeferredDestroy &destroy) {
+    if (destroy.pfnDestroy) {
+        destroy.pfnDestroy(destroy.pUserData, destroy.object);
+        return;
+    }
+
+    const auto device = pImpl->device;
+    switch (destroy.objectType) {
+        case VK_OBJECT_TYPE_BUFFER:
+            vkDestroyBuffer(device, vkCastHandle<VkBuffer>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_IMAGE:
+            vkDestroyImage(device, vkCastHandle<VkImage>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_IMAGE_VIEW:
+            vkDestroyImageView(device, vkCastHandle<VkImageView>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SAMPLER:
+            vkDestroySampler(device, vkCastHandle<VkSampler>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_FRAMEBUFFER:
+            vkDestroyFramebuffer(device, vkCastHandle<VkFramebuffer>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE:
+            vkDestroyPipeline(device, vkCastHandle<VkPipeline>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SHADER_MODULE:
+            vkDestroyShaderModule(device, vkCastHandle<VkShaderModule>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SEMAPHORE:
+            vkDestroySemaphore(device, vkCastHandle<VkSemaphore>(destroy.object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_SWAPCHAIN_KHR:
+            vkDestroySwapchainKHR(device, vkCastHandle<VkSwapchainKHR>(destroy.object), nullptr);
+            break;
+        default:
+            assert(false);
+            break;
+    }
+}
+
+}
+
+VkResult vkCreateDeletionQueue(
+    VkDevice                                    device,
+    const VkDeletionQueueCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkDeletionQueue*                            pDeletionQueue) {
+    auto pImpl = make_unique<VkDeletionQueueImpl>();
+    pImpl->device = device;
+    pImpl->timeline = pCreateInfo->timeline;
+
+    *pDeletionQueue = reinterpret_cast<VkDeletionQueue>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyDeletionQueue(
+    VkDevice                                    device,
+    VkDeletionQueue                             deletionQueue,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkDeletionQueueImpl*>(deletionQueue);
+
+    uint64_t timelineValue = 0;
+    for (const auto &destroy : pImpl->destroys) {
+        timelineValue = max(timelineValue, destroy.timelineValue);
+    }
+    vkWaitTimeline(pImpl->timeline, timelineValue, UINT64_MAX);
+
+    vkFlushDeletionQueue(deletionQueue);
+    delete pImpl;
+}
+
+void vkDeferDestroyObject(
+    VkDeletionQueue                             deletionQueue,
+    uint64_t                                    timelineValue,
+    VkObjectType                                objectType,
+    uint64_t                                    object) {
+    auto pImpl = reinterpret_cast<VkDeletionQueueImpl*>(deletionQueue);
+    pImpl->destroys.push_back({
+        .timelineValue = timelineValue,
+        .objectType = objectType,
+        .pfnDestroy = nullptr,
+        .pUserData = nullptr,
+        .object = object
+    });
+}
+
+void vkDeferDestroy(
+    VkDeletionQueue                             deletionQueue,
+    uint64_t                                    timelineValue,
+    PFN_vkDestroyObjectFunction                 pfnDestroy,
+    void*                                       pUserData,
+    uint64_t                                    object) {
+    auto pImpl = reinterpret_cast<VkDeletionQueueImpl*>(deletionQueue);
+    pImpl->destroys.push_back({
+        .timelineValue = timelineValue,
+        .objectType = VK_OBJECT_TYPE_UNKNOWN,
+        .pfnDestroy = pfnDestroy,
+        .pUserData = pUserData,
+        .object = object
+    });
+}
+
+VkResult vkCollectDeletionQueue(
+    VkDeletionQueue                             deletionQueue) {
+    auto pImpl = reinterpret_cast<VkDeletionQueueImpl*>(deletionQueue);
+    if (pImpl->destroys.empty()) {
+        return VK_SUCCESS;
+    }
+
+    uint64_t completedValue;
+    const auto result = vkGetTimelineCompletedValue(pImpl->timeline, &completedValue);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    // 더 작은 값이 뒤에 예약되었더라도 앞의 값이 완료될 때까지 기다렸다가 파괴한다.
+    auto &destroys = pImpl->destroys;
+    while (!destroys.empty() && destroys.front().timelineValue <= completedValue) {
+        vkDestroy(pImpl, destroys.front());
+        destroys.pop_front();
+    }
+    return VK_SUCCESS;
+}
+
+void vkFlushDeletionQueue(
+    VkDeletionQueue                             deletionQueue) {
+    auto pImpl = reinterpret_cast<VkDeletionQueueImpl*>(deletionQueue);
+    for (const auto &destroy : pImpl->destroys) {
+        vkDestroy(pImpl, destroy);
+    }
+    pImpl->destroys.clear();
+}
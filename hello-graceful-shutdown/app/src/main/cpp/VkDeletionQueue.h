@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKDELETIONQUEUE_H
+#define PRACTICE_VULKAN_VKDELETIONQUEUE_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTimeline.h"
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkDeletionQueue)
+
+// 예약한 타임라인 값이 완료된 후 호출되며 object를 파괴한다.
+typedef void (VKAPI_PTR *PFN_vkDestroyObjectFunction)(
+    void*                                       pUserData,
+    uint64_t                                    object);
+
+typedef struct VkDeletionQueueCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // 파괴할 오브젝트를 사용한 제출의 타임라인으로 큐보다 나중에 파괴되어야 한다.
+    VkTimeline                       timeline;
+} VkDeletionQueueCreateInfo;
+
+// 모든 함수는 외부에서 동기화해야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDeletionQueue(
+    VkDevice                                    device,
+    const VkDeletionQueueCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkDeletionQueue*                            pDeletionQueue);
+
+// 예약된 가장 큰 타임라인 값만 기다린 후 남은 오브젝트를 모두 파괴한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyDeletionQueue(
+    VkDevice                                    device,
+    VkDeletionQueue                             deletionQueue,
+    const VkAllocationCallbacks*                pAllocator);
+
+// timelineValue가 완료되면 Vulkan 오브젝트를 파괴한다. 지원하는 objectType은 BUFFER, IMAGE,
+// IMAGE_VIEW, SAMPLER, FRAMEBUFFER, PIPELINE, SHADER_MODULE, SEMAPHORE와 SWAPCHAIN_KHR이다.
+VKAPI_ATTR void VKAPI_CALL vkDeferDestroyObject(
+    VkDeletionQueue                             deletionQueue,
+    uint64_t                                    timelineValue,
+    VkObjectType                                objectType,
+    uint64_t                                    object);
+
+// timelineValue가 완료되면 pfnDestroy로 오브젝트를 파괴하며 VkMemoryAllocation이나
+// VkTextureLoad처럼 Vulkan 오브젝트가 아니거나 다른 오브젝트가 필요한 경우에 사용한다.
+VKAPI_ATTR void VKAPI_CALL vkDeferDestroy(
+    VkDeletionQueue                             deletionQueue,
+    uint64_t                                    timelineValue,
+    PFN_vkDestroyObjectFunction                 pfnDestroy,
+    void*                                       pUserData,
+    uint64_t                                    object);
+
+// 타임라인 값이 완료된 오브젝트를 예약한 순서대로 파괴하며 기다리지 않는다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCollectDeletionQueue(
+    VkDeletionQueue                             deletionQueue);
+
+// 타임라인 값을 확인하지 않고 예약된 오브젝트를 모두 파괴한다. 호출한 쪽이 이미 예약된 값을 기다렸거나
+// 디바이스를 잃어서 완료된 값을 알 수 없지만 GPU가 더 이상 오브젝트를 사용하지 않을 때 사용한다.
+VKAPI_ATTR void VKAPI_CALL vkFlushDeletionQueue(
+    VkDeletionQueue                             deletionQueue);
+
+#endif //PRACTICE_VULKAN_VKDELETIONQUEUE_H
@@ -0,0 +1,223 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <vector>
+
+#include "VkDeviceSelector.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+uint64_t vkGetPhysicalDeviceTypeRank(VkPhysicalDeviceType physicalDeviceType) {
+    switch (physicalDeviceType) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+            return 4;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+            return 3;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+            return 2;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// VkPhysicalDeviceFeatures는 VkBool32로만 이루어져 있으므로 배열처럼 비교한다.
+VkBool32 vkSupportsFeatures(const VkPhysicalDeviceFeatures &supported,
+                            const VkPhysicalDeviceFeatures &required) {
+    constexpr auto kFeatureCount = sizeof(VkPhysicalDeviceFeatures) / sizeof(VkBool32);
+    const auto pSupported = reinterpret_cast<const VkBool32 *>(&supported);
+    const auto pRequired = reinterpret_cast<const VkBool32 *>(&required);
+    for (auto i = 0; i != kFeatureCount; ++i) {
+        if (pRequired[i] && !pSupported[i]) {
+            return VK_FALSE;
+        }
+    }
+    return VK_TRUE;
+}
+
+}
+
+VkResult vkSelectPhysicalDevice(VkInstance instance,
+                                const VkPhysicalDeviceSelectInfo *pSelectInfo,
+                                VkPhysicalDeviceSelection *pSelection) {
+    uint32_t physicalDeviceCount;
+    auto result = vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
+    result = vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, physicalDevices.data());
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    VkPhysicalDeviceSelection bestSelection{.physicalDevice = VK_NULL_HANDLE};
+    for (auto physicalDevice: physicalDevices) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        if (properties.apiVersion < pSelectInfo->minApiVersion) {
+            continue;
+        }
+
+        uint32_t extensionCount;
+        result = vkEnumerateDeviceExtensionProperties(physicalDevice,
+                                                      nullptr,
+                                                      &extensionCount,
+                                                      nullptr);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+
+        vector<VkExtensionProperties> extensionProperties(extensionCount);
+        result = vkEnumerateDeviceExtensionProperties(physicalDevice,
+                                                      nullptr,
+                                                      &extensionCount,
+                                                      extensionProperties.data());
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+
+        if (!all_of(pSelectInfo->ppRequiredExtensionNames,
+                    pSelectInfo->ppRequiredExtensionNames + pSelectInfo->requiredExtensionCount,
+                    [&](auto extensionName) {
+                        return vkHasExtension(extensionProperties, extensionName);
+                    })) {
+            continue;
+        }
+
+        if (pSelectInfo->pRequiredFeatures) {
+            VkPhysicalDeviceFeatures features;
+            vkGetPhysicalDeviceFeatures(physicalDevice, &features);
+            if (!vkSupportsFeatures(features, *pSelectInfo->pRequiredFeatures)) {
+                continue;
+            }
+        }
+
+        uint32_t queueFamilyPropertyCount;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyPropertyCount, nullptr);
+
+        vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyPropertyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice,
+                                                 &queueFamilyPropertyCount,
+                                                 queueFamilyProperties.data());
+
+        VkPhysicalDeviceSelection selection{.physicalDevice = physicalDevice};
+        if (!vkSelectQueueFamilies(queueFamilyPropertyCount,
+                                   queueFamilyProperties.data(),
+                                   &selection)) {
+            continue;
+        }
+
+        const auto supportedOptionalExtensionCount = count_if(
+                pSelectInfo->ppOptionalExtensionNames,
+                pSelectInfo->ppOptionalExtensionNames + pSelectInfo->optionalExtensionCount,
+                [&](auto extensionName) {
+                    return vkHasExtension(extensionProperties, extensionName);
+                });
+
+        VkPhysicalDeviceMemoryProperties memoryProperties;
+        vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+        selection.score = vkScorePhysicalDevice(&properties,
+                                                &memoryProperties,
+                                                supportedOptionalExtensionCount);
+
+        // 점수가 같으면 먼저 열거된 VkPhysicalDevice를 선택한다.
+        if (!bestSelection.physicalDevice || selection.score > bestSelection.score) {
+            bestSelection = selection;
+        }
+    }
+
+    if (!bestSelection.physicalDevice) {
+        return VK_ERROR_INCOMPATIBLE_DRIVER;
+    }
+
+    *pSelection = bestSelection;
+
+    return VK_SUCCESS;
+}
+
+uint64_t vkScorePhysicalDevice(const VkPhysicalDeviceProperties *pProperties,
+                               const VkPhysicalDeviceMemoryProperties *pMemoryProperties,
+                               uint32_t supportedOptionalExtensionCount) {
+    VkDeviceSize deviceLocalHeapSize = 0;
+    for (auto i = 0; i != pMemoryProperties->memoryHeapCount; ++i) {
+        const auto &memoryHeap = pMemoryProperties->memoryHeaps[i];
+        if (memoryHeap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            deviceLocalHeapSize += memoryHeap.size;
+        }
+    }
+
+    // 상위 8비트는 타입, 다음 8비트는 선택 확장 개수, 하위 48비트는 MiB 단위의 힙 크기다.
+    constexpr uint64_t kMaxHeapSizeInMiB = (uint64_t{1} << 48) - 1;
+    return vkGetPhysicalDeviceTypeRank(pProperties->deviceType) << 56 |
+           uint64_t{min(supportedOptionalExtensionCount, 255u)} << 48 |
+           min(deviceLocalHeapSize >> 20, kMaxHeapSizeInMiB);
+}
+
+VkBool32 vkSelectQueueFamilies(uint32_t queueFamilyPropertyCount,
+                               const VkQueueFamilyProperties *pQueueFamilyProperties,
+                               VkPhysicalDeviceSelection *pSelection) {
+    constexpr auto kNotFound = VK_QUEUE_FAMILY_IGNORED;
+    auto graphicsQueueFamilyIndex = kNotFound;
+    auto computeQueueFamilyIndex = kNotFound;
+    auto transferQueueFamilyIndex = kNotFound;
+    for (auto i = 0; i != queueFamilyPropertyCount; ++i) {
+        const auto &properties = pQueueFamilyProperties[i];
+        if (!properties.queueCount) {
+            continue;
+        }
+
+        const auto queueFlags = properties.queueFlags;
+        if (queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+            if (graphicsQueueFamilyIndex == kNotFound) {
+                graphicsQueueFamilyIndex = i;
+            }
+        } else if (queueFlags & VK_QUEUE_COMPUTE_BIT) {
+            if (computeQueueFamilyIndex == kNotFound) {
+                computeQueueFamilyIndex = i;
+            }
+        } else if (queueFlags & VK_QUEUE_TRANSFER_BIT) {
+            if (transferQueueFamilyIndex == kNotFound) {
+                transferQueueFamilyIndex = i;
+            }
+        }
+    }
+
+    if (graphicsQueueFamilyIndex == kNotFound) {
+        return VK_FALSE;
+    }
+
+    pSelection->graphicsQueueFamilyIndex = graphicsQueueFamilyIndex;
+    pSelection->computeQueueFamilyIndex =
+            computeQueueFamilyIndex == kNotFound ? graphicsQueueFamilyIndex : computeQueueFamilyIndex;
+    pSelection->transferQueueFamilyIndex =
+            transferQueueFamilyIndex == kNotFound ? graphicsQueueFamilyIndex : transferQueueFamilyIndex;
+
+    return VK_TRUE;
+}
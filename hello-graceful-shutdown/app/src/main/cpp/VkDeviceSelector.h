@@ -0,0 +1,73 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKDEVICESELECTOR_H
+#define PRACTICE_VULKAN_VKDEVICESELECTOR_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+typedef struct VkPhysicalDeviceSelectInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // apiVersion이 이보다 낮은 VkPhysicalDevice는 선택하지 않는다.
+    uint32_t                         minApiVersion;
+    uint32_t                         requiredExtensionCount;
+    const char* const*               ppRequiredExtensionNames;
+    // 지원하지 않아도 선택할 수 있지만 많이 지원할수록 점수가 높다.
+    uint32_t                         optionalExtensionCount;
+    const char* const*               ppOptionalExtensionNames;
+    // nullptr이 아니면 VK_TRUE인 기능을 모두 지원해야 한다.
+    const VkPhysicalDeviceFeatures*  pRequiredFeatures;
+} VkPhysicalDeviceSelectInfo;
+
+typedef struct VkPhysicalDeviceSelection {
+    VkPhysicalDevice                 physicalDevice;
+    uint64_t                         score;
+    uint32_t                         graphicsQueueFamilyIndex;
+    // 그래픽스를 지원하지 않는 큐 패밀리가 있으면 그 큐 패밀리로 없으면 graphicsQueueFamilyIndex와 같다.
+    uint32_t                         computeQueueFamilyIndex;
+    // 그래픽스와 컴퓨트를 지원하지 않는 큐 패밀리가 있으면 그 큐 패밀리로 없으면 graphicsQueueFamilyIndex와 같다.
+    uint32_t                         transferQueueFamilyIndex;
+} VkPhysicalDeviceSelection;
+
+// 조건을 만족하는 VkPhysicalDevice 중 점수가 가장 높은 것을 선택하며 없으면 VK_ERROR_INCOMPATIBLE_DRIVER를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkSelectPhysicalDevice(
+    VkInstance                                  instance,
+    const VkPhysicalDeviceSelectInfo*           pSelectInfo,
+    VkPhysicalDeviceSelection*                  pSelection);
+
+// 타입(DISCRETE > INTEGRATED > VIRTUAL > CPU), 지원하는 선택 확장 개수, DEVICE_LOCAL 힙 크기 순으로 비교되는 점수를 계산한다.
+VKAPI_ATTR uint64_t VKAPI_CALL vkScorePhysicalDevice(
+    const VkPhysicalDeviceProperties*           pProperties,
+    const VkPhysicalDeviceMemoryProperties*     pMemoryProperties,
+    uint32_t                                    supportedOptionalExtensionCount);
+
+// 그래픽스 큐 패밀리가 없으면 VK_FALSE를 반환한다.
+VKAPI_ATTR VkBool32 VKAPI_CALL vkSelectQueueFamilies(
+    uint32_t                                    queueFamilyPropertyCount,
+    const VkQueueFamilyProperties*              pQueueFamilyProperties,
+    VkPhysicalDeviceSelection*                  pSelection);
+
+#endif //PRACTICE_VULKAN_VKDEVICESELECTOR_H
@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <vulkan/vulkan.h>
+
+#include "VkDeviceSelector.h"
+
+namespace {
+
+uint64_t getScore(VkPhysicalDeviceType deviceType,
+                  VkDeviceSize deviceLocalHeapSize,
+                  uint32_t supportedOptionalExtensionCount = 0) {
+    VkPhysicalDeviceProperties properties{.deviceType = deviceType};
+
+    VkPhysicalDeviceMemoryProperties memoryProperties{.memoryHeapCount = 2};
+    memoryProperties.memoryHeaps[0] = {
+        .size = deviceLocalHeapSize,
+        .flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT
+    };
+    memoryProperties.memoryHeaps[1] = {.size = VkDeviceSize{64} << 30};
+
+    return vkScorePhysicalDevice(&properties, &memoryProperties, supportedOptionalExtensionCount);
+}
+
+}
+
+TEST(VkDeviceSelectorTest, scoreDeviceType) {
+    constexpr VkDeviceSize kGiB = VkDeviceSize{1} << 30;
+
+    // 힙이 훨씬 커도 타입의 우선순위를 뒤집지 않는다.
+    EXPECT_GT(getScore(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 1 * kGiB),
+              getScore(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 32 * kGiB, 16));
+    EXPECT_GT(getScore(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 1 * kGiB),
+              getScore(VK_PHYSICAL_DEVICE_TYPE_CPU, 32 * kGiB, 16));
+
+    // 같은 타입이면 선택 확장, 힙 크기 순으로 비교한다.
+    EXPECT_GT(getScore(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 1 * kGiB, 2),
+              getScore(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 8 * kGiB, 1));
+    EXPECT_GT(getScore(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 8 * kGiB, 1),
+              getScore(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 4 * kGiB, 1));
+}
+
+TEST(VkDeviceSelectorTest, selectQueueFamilies) {
+    const std::vector<VkQueueFamilyProperties> queueFamilyProperties{
+        {.queueFlags = VK_QUEUE_TRANSFER_BIT, .queueCount = 0},
+        {.queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT,
+         .queueCount = 1},
+        {.queueFlags = VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT, .queueCount = 2},
+        {.queueFlags = VK_QUEUE_TRANSFER_BIT, .queueCount = 1}
+    };
+
+    VkPhysicalDeviceSelection selection{};
+    ASSERT_TRUE(vkSelectQueueFamilies(queueFamilyProperties.size(),
+                                      queueFamilyProperties.data(),
+                                      &selection));
+    EXPECT_EQ(selection.graphicsQueueFamilyIndex, 1);
+    EXPECT_EQ(selection.computeQueueFamilyIndex, 2);
+    // 큐가 없는 큐 패밀리는 무시한다.
+    EXPECT_EQ(selection.transferQueueFamilyIndex, 3);
+
+    // 전용 큐 패밀리가 없으면 그래픽스 큐 패밀리를 함께 사용한다.
+    ASSERT_TRUE(vkSelectQueueFamilies(2, queueFamilyProperties.data(), &selection));
+    EXPECT_EQ(selection.computeQueueFamilyIndex, 1);
+    EXPECT_EQ(selection.transferQueueFamilyIndex, 1);
+
+    EXPECT_FALSE(vkSelectQueueFamilies(1, queueFamilyProperties.data(), &selection));
+}
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKDEVICETEST_H
+#define PRACTICE_VULKAN_VKDEVICETEST_H
+
+#include <gtest/gtest.h>
+#include <vulkan/vulkan.h>
+
+#include "VkDeviceSelector.h"
+#include "VkMemoryAllocator.h"
+
+// 테스트와 벤치마크가 공유하는 Fixture로 VkInstance, 그래픽스 큐를 가진 VkDevice와
+// VkMemoryAllocator를 만든다. 매개변수가 있는 테스트는 testing::WithParamInterface를 함께 상속한다.
+class VkDeviceTest : public testing::Test {
+protected:
+    explicit VkDeviceTest(VkDeviceSize blockSize) : mBlockSize(blockSize) {
+    }
+
+    void SetUp() override {
+        VkApplicationInfo applicationInfo{
+            .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+            .apiVersion = VK_MAKE_API_VERSION(0, 1, 0, 0)
+        };
+
+        VkInstanceCreateInfo instanceCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+            .pApplicationInfo = &applicationInfo
+        };
+
+        ASSERT_EQ(vkCreateInstance(&instanceCreateInfo, nullptr, &mInstance), VK_SUCCESS);
+
+        VkPhysicalDeviceSelectInfo physicalDeviceSelectInfo{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SELECT_INFO,
+            .minApiVersion = VK_API_VERSION_1_0
+        };
+
+        VkPhysicalDeviceSelection physicalDeviceSelection;
+        ASSERT_EQ(vkSelectPhysicalDevice(mInstance, &physicalDeviceSelectInfo, &physicalDeviceSelection),
+                  VK_SUCCESS);
+
+        mPhysicalDevice = physicalDeviceSelection.physicalDevice;
+        mQueueFamilyIndex = physicalDeviceSelection.graphicsQueueFamilyIndex;
+
+        const float queuePriority = 1.0;
+        VkDeviceQueueCreateInfo deviceQueueCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = mQueueFamilyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = &queuePriority
+        };
+
+        VkDeviceCreateInfo deviceCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .queueCreateInfoCount = 1,
+            .pQueueCreateInfos = &deviceQueueCreateInfo
+        };
+
+        ASSERT_EQ(vkCreateDevice(mPhysicalDevice, &deviceCreateInfo, nullptr, &mDevice), VK_SUCCESS);
+        vkGetDeviceQueue(mDevice, mQueueFamilyIndex, 0, &mQueue);
+
+        VkMemoryAllocatorCreateInfo memoryAllocatorCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATOR_CREATE_INFO,
+            .physicalDevice = mPhysicalDevice,
+            .blockSize = mBlockSize,
+            .strategy = getMemoryAllocatorStrategy()
+        };
+
+        ASSERT_EQ(vkCreateMemoryAllocator(mDevice, &memoryAllocatorCreateInfo, nullptr, &mMemoryAllocator),
+                  VK_SUCCESS);
+    }
+
+    void TearDown() override {
+        if (mMemoryAllocator) {
+            vkDestroyMemoryAllocator(mDevice, mMemoryAllocator, nullptr);
+        }
+        if (mDevice) {
+            vkDestroyDevice(mDevice, nullptr);
+        }
+        if (mInstance) {
+            vkDestroyInstance(mInstance, nullptr);
+        }
+    }
+
+    virtual VkMemoryAllocatorStrategy getMemoryAllocatorStrategy() const {
+        return VK_MEMORY_ALLOCATOR_STRATEGY_FREE_LIST;
+    }
+
+    const VkDeviceSize mBlockSize;
+
+    VkInstance mInstance = VK_NULL_HANDLE;
+    VkPhysicalDevice mPhysicalDevice = VK_NULL_HANDLE;
+    uint32_t mQueueFamilyIndex = 0;
+    VkDevice mDevice = VK_NULL_HANDLE;
+    VkQueue mQueue = VK_NULL_HANDLE;
+    VkMemoryAllocator mMemoryAllocator = VK_NULL_HANDLE;
+};
+
+#endif //PRACTICE_VULKAN_VKDEVICETEST_H
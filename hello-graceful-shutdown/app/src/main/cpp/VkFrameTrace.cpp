@@ -0,0 +1,311 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "VkFrameTrace.h"
+
+using namespace std;
+
+namespace {
+
+// 'VKFT'로 시작하며 형식이 바뀌면 버전을 올려서 이전 빌드의 트레이스를 잘못 해석하지 않게 한다.
+constexpr uint32_t kFrameTraceMagic = 0x54464B56;
+constexpr uint32_t kFrameTraceVersion = 1;
+
+struct VkFrameTraceRecord {
+    uint32_t type;
+    uint32_t dataSize;
+    size_t dataOffset;
+};
+
+struct VkFrameTraceImpl {
+    // 연산의 데이터를 이어 붙인 것으로 반복된 연산은 이전 연산과 같은 위치를 가리킨다.
+    vector<uint8_t> data;
+    vector<VkFrameTraceRecord> records;
+    // i번째 프레임의 연산은 records의 [frameOffsets[i], frameOffsets[i + 1]) 범위다.
+    vector<uint32_t> frameOffsets{0};
+    // 종류마다 마지막으로 기록된 연산의 records 인덱스.
+    unordered_map<uint32_t, uint32_t> lastRecordIndices;
+};
+
+void vkAppendRecord(VkFrameTraceImpl *pImpl, uint32_t type, uint32_t dataSize, const void *pData) {
+    // 같은 종류의 마지막 연산과 데이터가 같으면 데이터를 다시 저장하지 않는다.
+    auto iter = pImpl->lastRecordIndices.find(type);
+    if (iter != pImpl->lastRecordIndices.end()) {
+        const auto record = pImpl->records[iter->second];
+        if (record.dataSize == dataSize && !memcmp(pImpl->data.data() + record.dataOffset, pData, dataSize)) {
+            iter->second = pImpl->records.size();
+            pImpl->records.push_back(record);
+            return;
+        }
+    }
+
+    const auto pBytes = static_cast<const uint8_t *>(pData);
+    pImpl->lastRecordIndices[type] = pImpl->records.size();
+    pImpl->records.push_back({
+        .type = type,
+        .dataSize = dataSize,
+        .dataOffset = pImpl->data.size()
+    });
+    pImpl->data.insert(pImpl->data.end(), pBytes, pBytes + dataSize);
+}
+
+void vkWriteVarint(uint64_t value, vector<uint8_t> *pData) {
+    while (value >= 0x80) {
+        pData->push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    pData->push_back(static_cast<uint8_t>(value));
+}
+
+void vkWriteUint32(uint32_t value, vector<uint8_t> *pData) {
+    const auto pBytes = reinterpret_cast<const uint8_t *>(&value);
+    pData->insert(pData->end(), pBytes, pBytes + sizeof(value));
+}
+
+struct VkFrameTraceReader {
+    const uint8_t *pData;
+    const uint8_t *pEnd;
+
+    bool readVarint(uint64_t *pValue) {
+        *pValue = 0;
+        for (auto shift = 0; shift < 64; shift += 7) {
+            if (pData == pEnd) {
+                return false;
+            }
+
+            const auto byte = *pData++;
+            *pValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool readUint32(uint32_t *pValue) {
+        if (pEnd - pData < sizeof(*pValue)) {
+            return false;
+        }
+
+        memcpy(pValue, pData, sizeof(*pValue));
+        pData += sizeof(*pValue);
+        return true;
+    }
+};
+
+// 헤더 다음에 프레임 개수가 오고, 프레임마다 연산 개수와 연산이 온다.
+// 연산은 (종류 << 1 | 반복)으로 시작하며 반복이 아닐 때만 데이터 크기와 데이터가 이어진다.
+vector<uint8_t> vkSerialize(const VkFrameTraceImpl *pImpl) {
+    vector<uint8_t> data;
+    vkWriteUint32(kFrameTraceMagic, &data);
+    vkWriteUint32(kFrameTraceVersion, &data);
+
+    const auto frameCount = pImpl->frameOffsets.size() - 1;
+    vkWriteVarint(frameCount, &data);
+
+    unordered_map<uint32_t, size_t> lastDataOffsets;
+    for (auto i = 0; i != frameCount; ++i) {
+        const auto firstRecord = pImpl->frameOffsets[i];
+        const auto lastRecord = pImpl->frameOffsets[i + 1];
+        vkWriteVarint(lastRecord - firstRecord, &data);
+
+        for (auto j = firstRecord; j != lastRecord; ++j) {
+            const auto &record = pImpl->records[j];
+            auto [iter, inserted] = lastDataOffsets.try_emplace(record.type, record.dataOffset);
+            if (!inserted && iter->second == record.dataOffset) {
+                vkWriteVarint(static_cast<uint64_t>(record.type) << 1 | 1, &data);
+                continue;
+            }
+            iter->second = record.dataOffset;
+
+            vkWriteVarint(static_cast<uint64_t>(record.type) << 1, &data);
+            vkWriteVarint(record.dataSize, &data);
+            data.insert(data.end(),
+                        pImpl->data.begin() + record.dataOffset,
+                        pImpl->data.begin() + record.dataOffset + record.dataSize);
+        }
+    }
+    return data;
+}
+
+bool vkDeserialize(const void *pData, size_t dataSize, VkFrameTraceImpl *pImpl) {
+    VkFrameTraceReader reader{
+        .pData = static_cast<const uint8_t *>(pData),
+        .pEnd = static_cast<const uint8_t *>(pData) + dataSize
+    };
+
+    uint32_t magic;
+    uint32_t version;
+    if (!reader.readUint32(&magic) || magic != kFrameTraceMagic ||
+        !reader.readUint32(&version) || version != kFrameTraceVersion) {
+        return false;
+    }
+
+    uint64_t frameCount;
+    if (!reader.readVarint(&frameCount)) {
+        return false;
+    }
+
+    for (auto i = 0; i != frameCount; ++i) {
+        uint64_t opCount;
+        if (!reader.readVarint(&opCount)) {
+            return false;
+        }
+
+        for (auto j = 0; j != opCount; ++j) {
+            uint64_t header;
+            if (!reader.readVarint(&header) || header >> 33) {
+                return false;
+            }
+
+            // 반복은 같은 종류의 마지막 연산을 다시 기록한다.
+            const auto type = static_cast<uint32_t>(header >> 1);
+            if (header & 1) {
+                auto iter = pImpl->lastRecordIndices.find(type);
+                if (iter == pImpl->lastRecordIndices.end()) {
+                    return false;
+                }
+
+                const auto record = pImpl->records[iter->second];
+                iter->second = pImpl->records.size();
+                pImpl->records.push_back(record);
+                continue;
+            }
+
+            uint64_t opDataSize;
+            if (!reader.readVarint(&opDataSize) || opDataSize > reader.pEnd - reader.pData) {
+                return false;
+            }
+
+            pImpl->lastRecordIndices[type] = pImpl->records.size();
+            pImpl->records.push_back({
+                .type = type,
+                .dataSize = static_cast<uint32_t>(opDataSize),
+                .dataOffset = pImpl->data.size()
+            });
+            pImpl->data.insert(pImpl->data.end(), reader.pData, reader.pData + opDataSize);
+            reader.pData += opDataSize;
+        }
+        pImpl->frameOffsets.push_back(pImpl->records.size());
+    }
+    return reader.pData == reader.pEnd;
+}
+
+}
+
+VkResult vkCreateFrameTrace(
+    const VkFrameTraceCreateInfo*               pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkFrameTrace*                               pFrameTrace) {
+    auto pImpl = make_unique<VkFrameTraceImpl>();
+    if (pCreateInfo->initialDataSize &&
+        !vkDeserialize(pCreateInfo->pInitialData, pCreateInfo->initialDataSize, pImpl.get())) {
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
+
+    *pFrameTrace = reinterpret_cast<VkFrameTrace>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyFrameTrace(
+    VkFrameTrace                                frameTrace,
+    const VkAllocationCallbacks*                pAllocator) {
+    delete reinterpret_cast<VkFrameTraceImpl *>(frameTrace);
+}
+
+void vkGetFrameTraceProperties(
+    VkFrameTrace                                frameTrace,
+    VkFrameTraceProperties*                     pProperties) {
+    auto pImpl = reinterpret_cast<VkFrameTraceImpl *>(frameTrace);
+    *pProperties = {
+        .frameCount = static_cast<uint32_t>(pImpl->frameOffsets.size() - 1),
+        .opCount = static_cast<uint32_t>(pImpl->records.size())
+    };
+}
+
+VkResult vkAppendFrameTrace(
+    VkFrameTrace                                frameTrace,
+    uint32_t                                    opCount,
+    const VkFrameTraceOp*                       pOps) {
+    auto pImpl = reinterpret_cast<VkFrameTraceImpl *>(frameTrace);
+    for (auto i = 0; i != opCount; ++i) {
+        vkAppendRecord(pImpl, pOps[i].type, pOps[i].dataSize, pOps[i].pData);
+    }
+    pImpl->frameOffsets.push_back(pImpl->records.size());
+    return VK_SUCCESS;
+}
+
+VkResult vkGetFrameTraceOps(
+    VkFrameTrace                                frameTrace,
+    uint32_t                                    frameIndex,
+    uint32_t*                                   pOpCount,
+    VkFrameTraceOp*                             pOps) {
+    auto pImpl = reinterpret_cast<VkFrameTraceImpl *>(frameTrace);
+    assert(frameIndex + 1 < pImpl->frameOffsets.size());
+
+    const auto firstRecord = pImpl->frameOffsets[frameIndex];
+    const auto recordCount = pImpl->frameOffsets[frameIndex + 1] - firstRecord;
+    if (!pOps) {
+        *pOpCount = recordCount;
+        return VK_SUCCESS;
+    }
+
+    const auto opCount = min(*pOpCount, recordCount);
+    for (auto i = 0; i != opCount; ++i) {
+        const auto &record = pImpl->records[firstRecord + i];
+        pOps[i] = {
+            .type = record.type,
+            .dataSize = record.dataSize,
+            .pData = pImpl->data.data() + record.dataOffset
+        };
+    }
+    *pOpCount = opCount;
+    return opCount < recordCount ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+VkResult vkGetFrameTraceData(
+    VkFrameTrace                                frameTrace,
+    size_t*                                     pDataSize,
+    void*                                       pData) {
+    auto pImpl = reinterpret_cast<VkFrameTraceImpl *>(frameTrace);
+    const auto data = vkSerialize(pImpl);
+    if (!pData) {
+        *pDataSize = data.size();
+        return VK_SUCCESS;
+    }
+
+    // 잘린 데이터는 불러올 수 없으므로 크기가 작으면 아무것도 쓰지 않는다.
+    if (*pDataSize < data.size()) {
+        *pDataSize = 0;
+        return VK_INCOMPLETE;
+    }
+
+    memcpy(pData, data.data(), data.size());
+    *pDataSize = data.size();
+    return VK_SUCCESS;
+}
@@ -0,0 +1,91 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKFRAMETRACE_H
+#define PRACTICE_VULKAN_VKFRAMETRACE_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkFrameTrace)
+
+// 연산의 종류와 데이터는 기록하는 쪽이 정하며 트레이스는 해석하지 않는다.
+typedef struct VkFrameTraceOp {
+    uint32_t                         type;
+    uint32_t                         dataSize;
+    const void*                      pData;
+} VkFrameTraceOp;
+
+typedef struct VkFrameTraceCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // 크기가 0이 아니면 vkGetFrameTraceData로 얻은 데이터의 프레임을 불러온다.
+    size_t                           initialDataSize;
+    const void*                      pInitialData;
+} VkFrameTraceCreateInfo;
+
+typedef struct VkFrameTraceProperties {
+    uint32_t                         frameCount;
+    // 불러온 프레임을 포함한 모든 연산의 개수로 같은 데이터가 반복되는 연산도 센다.
+    uint32_t                         opCount;
+} VkFrameTraceProperties;
+
+// 프레임마다의 연산을 순서대로 기록하고 압축된 바이너리 데이터로 저장하거나 불러온다.
+// 데이터가 같은 종류의 이전 연산과 같으면 데이터 없이 반복으로 기록하므로 장면이 바뀌지 않는 프레임은 몇 바이트만 차지한다.
+// 모든 함수는 외부에서 동기화해야 한다.
+// 데이터가 손상되었거나 다른 버전의 트레이스면 VK_ERROR_FORMAT_NOT_SUPPORTED를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateFrameTrace(
+    const VkFrameTraceCreateInfo*               pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkFrameTrace*                               pFrameTrace);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyFrameTrace(
+    VkFrameTrace                                frameTrace,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR void VKAPI_CALL vkGetFrameTraceProperties(
+    VkFrameTrace                                frameTrace,
+    VkFrameTraceProperties*                     pProperties);
+
+// 한 프레임의 연산을 기록 순서대로 마지막 프레임 뒤에 추가한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkAppendFrameTrace(
+    VkFrameTrace                                frameTrace,
+    uint32_t                                    opCount,
+    const VkFrameTraceOp*                       pOps);
+
+// pOps가 nullptr이면 frameIndex 프레임의 연산 개수를 반환하고, pOpCount가 작으면 VK_INCOMPLETE를 반환한다.
+// 연산의 pData는 트레이스가 소유하며 다음 vkAppendFrameTrace를 호출할 때까지 유효하다.
+VKAPI_ATTR VkResult VKAPI_CALL vkGetFrameTraceOps(
+    VkFrameTrace                                frameTrace,
+    uint32_t                                    frameIndex,
+    uint32_t*                                   pOpCount,
+    VkFrameTraceOp*                             pOps);
+
+// vkGetPipelineCacheData와 같이 pData가 nullptr이면 크기를 반환하고, 크기가 작으면 VK_INCOMPLETE를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkGetFrameTraceData(
+    VkFrameTrace                                frameTrace,
+    size_t*                                     pDataSize,
+    void*                                       pData);
+
+#endif //PRACTICE_VULKAN_VKFRAMETRACE_H
@@ -0,0 +1,320 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VkGpuProfiler.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+struct VkGpuProfilerHistory {
+    string name;
+    // 최근 historyLength개의 시간을 원형으로 저장한다.
+    vector<double> times;
+    uint32_t nextTimeIndex;
+    double lastTime;
+};
+
+struct VkGpuProfilerImpl {
+    VkDevice device;
+    VkQueryPool queryPool;
+    uint32_t frameCount;
+    uint32_t maxScopeCount;
+    uint32_t historyLength;
+    // 타임스탬프 한 틱의 나노초.
+    double timestampPeriod;
+    // timestampValidBits보다 위의 비트는 정의되지 않으므로 차이를 계산할 때 버린다.
+    uint64_t timestampMask;
+    // 프레임 영역마다 기록된 범위의 이름으로 i번째 범위는 2i와 2i + 1번째 쿼리를 사용한다.
+    vector<vector<string>> frameScopeNames;
+    uint32_t recordingFrameIndex;
+    // 열린 범위의 인덱스로 maxScopeCount를 넘은 범위는 UINT32_MAX다.
+    vector<uint32_t> openScopes;
+    vector<VkGpuProfilerHistory> histories;
+};
+
+uint32_t vkGetGpuProfilerFirstQuery(const VkGpuProfilerImpl *pImpl, uint32_t frameIndex) {
+    return frameIndex * pImpl->maxScopeCount * 2;
+}
+
+}
+
+VkResult vkCreateGpuProfiler(
+    VkDevice                                    device,
+    const VkGpuProfilerCreateInfo*              pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkGpuProfiler*                              pGpuProfiler) {
+    // ================================================================================
+    // 1. 타임스탬프 지원 확인
+    // ================================================================================
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(pCreateInfo->physicalDevice, &physicalDeviceProperties);
+
+    uint32_t queueFamilyPropertiesCount;
+    vkGetPhysicalDeviceQueueFamilyProperties(pCreateInfo->physicalDevice, &queueFamilyPropertiesCount, nullptr);
+
+    vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyPropertiesCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(pCreateInfo->physicalDevice,
+                                             &queueFamilyPropertiesCount,
+                                             queueFamilyProperties.data());
+
+    const auto timestampValidBits = queueFamilyProperties[pCreateInfo->queueFamilyIndex].timestampValidBits;
+    if (!timestampValidBits) {
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    auto pImpl = make_unique<VkGpuProfilerImpl>();
+    pImpl->device = device;
+    pImpl->frameCount = pCreateInfo->frameCount;
+    pImpl->maxScopeCount = pCreateInfo->maxScopeCount;
+    pImpl->historyLength = max(pCreateInfo->historyLength, 1u);
+    pImpl->timestampPeriod = physicalDeviceProperties.limits.timestampPeriod;
+    pImpl->timestampMask = timestampValidBits < 64 ? (uint64_t{1} << timestampValidBits) - 1 : UINT64_MAX;
+    pImpl->frameScopeNames.resize(pCreateInfo->frameCount);
+    pImpl->recordingFrameIndex = 0;
+
+    // ================================================================================
+    // 2. VkQueryPool 생성
+    // ================================================================================
+    const VkQueryPoolCreateInfo queryPoolCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = pCreateInfo->frameCount * pCreateInfo->maxScopeCount * 2
+    };
+
+    auto result = vkCreateQueryPool(device, &queryPoolCreateInfo, nullptr, &pImpl->queryPool);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    *pGpuProfiler = reinterpret_cast<VkGpuProfiler>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyGpuProfiler(
+    VkDevice                                    device,
+    VkGpuProfiler                               gpuProfiler,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkGpuProfilerImpl*>(gpuProfiler);
+
+    vkDestroyQueryPool(device, pImpl->queryPool, nullptr);
+    delete pImpl;
+}
+
+VkResult vkCollectGpuProfilerFrame(
+    VkGpuProfiler                               gpuProfiler,
+    uint32_t                                    frameIndex) {
+    auto pImpl = reinterpret_cast<VkGpuProfilerImpl*>(gpuProfiler);
+    const auto &scopeNames = pImpl->frameScopeNames[frameIndex];
+    if (scopeNames.empty()) {
+        return VK_SUCCESS;
+    }
+
+    // ================================================================================
+    // 1. 쿼리 결과 읽기
+    // ================================================================================
+    // 쿼리마다 타임스탬프와 가용성이 순서대로 저장된다.
+    const auto queryCount = static_cast<uint32_t>(scopeNames.size() * 2);
+    vector<uint64_t> results(queryCount * 2);
+    auto result = vkGetQueryPoolResults(pImpl->device,
+                                        pImpl->queryPool,
+                                        vkGetGpuProfilerFirstQuery(pImpl, frameIndex),
+                                        queryCount,
+                                        results.size() * sizeof(uint64_t),
+                                        results.data(),
+                                        2 * sizeof(uint64_t),
+                                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        return result;
+    }
+
+    // ================================================================================
+    // 2. 통계에 추가
+    // ================================================================================
+    for (auto i = 0; i != scopeNames.size(); ++i) {
+        const auto *pBegin = &results[i * 4];
+        const auto *pEnd = &results[i * 4 + 2];
+        if (!pBegin[1] || !pEnd[1]) {
+            continue;
+        }
+
+        const auto ticks = (pEnd[0] - pBegin[0]) & pImpl->timestampMask;
+        const auto time = static_cast<double>(ticks) * pImpl->timestampPeriod / 1000000.0;
+
+        auto iter = find_if(pImpl->histories.begin(), pImpl->histories.end(), [&](const auto &history) {
+            return history.name == scopeNames[i];
+        });
+        if (iter == pImpl->histories.end()) {
+            iter = pImpl->histories.insert(iter, {
+                .name = scopeNames[i],
+                .nextTimeIndex = 0
+            });
+        }
+
+        if (iter->times.size() < pImpl->historyLength) {
+            iter->times.push_back(time);
+        } else {
+            iter->times[iter->nextTimeIndex] = time;
+        }
+        iter->nextTimeIndex = (iter->nextTimeIndex + 1) % pImpl->historyLength;
+        iter->lastTime = time;
+    }
+
+    return VK_SUCCESS;
+}
+
+void vkCmdBeginGpuProfilerFrame(
+    VkGpuProfiler                               gpuProfiler,
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    frameIndex) {
+    auto pImpl = reinterpret_cast<VkGpuProfilerImpl*>(gpuProfiler);
+
+    vkCmdResetQueryPool(commandBuffer,
+                        pImpl->queryPool,
+                        vkGetGpuProfilerFirstQuery(pImpl, frameIndex),
+                        pImpl->maxScopeCount * 2);
+
+    pImpl->recordingFrameIndex = frameIndex;
+    pImpl->frameScopeNames[frameIndex].clear();
+    pImpl->openScopes.clear();
+}
+
+void vkCmdBeginGpuProfilerScope(
+    VkGpuProfiler                               gpuProfiler,
+    VkCommandBuffer                             commandBuffer,
+    const char*                                 pName) {
+    auto pImpl = reinterpret_cast<VkGpuProfilerImpl*>(gpuProfiler);
+    auto &scopeNames = pImpl->frameScopeNames[pImpl->recordingFrameIndex];
+
+    if (scopeNames.size() == pImpl->maxScopeCount) {
+        pImpl->openScopes.push_back(UINT32_MAX);
+        return;
+    }
+
+    const auto scopeIndex = static_cast<uint32_t>(scopeNames.size());
+    scopeNames.emplace_back(pName);
+    pImpl->openScopes.push_back(scopeIndex);
+
+    // 이전 명령이 모두 끝난 후가 아니라 이 범위의 명령이 시작될 때의 시간을 기록한다.
+    vkCmdWriteTimestamp(commandBuffer,
+                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        pImpl->queryPool,
+                        vkGetGpuProfilerFirstQuery(pImpl, pImpl->recordingFrameIndex) + scopeIndex * 2);
+}
+
+void vkCmdEndGpuProfilerScope(
+    VkGpuProfiler                               gpuProfiler,
+    VkCommandBuffer                             commandBuffer) {
+    auto pImpl = reinterpret_cast<VkGpuProfilerImpl*>(gpuProfiler);
+
+    const auto scopeIndex = pImpl->openScopes.back();
+    pImpl->openScopes.pop_back();
+    if (scopeIndex == UINT32_MAX) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(commandBuffer,
+                        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        pImpl->queryPool,
+                        vkGetGpuProfilerFirstQuery(pImpl, pImpl->recordingFrameIndex) + scopeIndex * 2 + 1);
+}
+
+VkResult vkGetGpuProfilerStatistics(
+    VkGpuProfiler                               gpuProfiler,
+    uint32_t*                                   pScopeCount,
+    VkGpuProfilerScopeStatistics*               pStatistics) {
+    auto pImpl = reinterpret_cast<VkGpuProfilerImpl*>(gpuProfiler);
+    const auto scopeCount = static_cast<uint32_t>(pImpl->histories.size());
+
+    if (!pStatistics) {
+        *pScopeCount = scopeCount;
+        return VK_SUCCESS;
+    }
+
+    const auto count = min(*pScopeCount, scopeCount);
+    for (auto i = 0; i != count; ++i) {
+        const auto &history = pImpl->histories[i];
+        auto &statistics = pStatistics[i];
+
+        strncpy(statistics.name, history.name.c_str(), VK_MAX_DESCRIPTION_SIZE - 1);
+        statistics.name[VK_MAX_DESCRIPTION_SIZE - 1] = '\0';
+        statistics.sampleCount = history.times.size();
+        statistics.lastTime = history.lastTime;
+        statistics.minTime = *min_element(history.times.begin(), history.times.end());
+        statistics.maxTime = *max_element(history.times.begin(), history.times.end());
+
+        auto totalTime = 0.0;
+        for (auto time: history.times) {
+            totalTime += time;
+        }
+        statistics.averageTime = totalTime / history.times.size();
+    }
+
+    *pScopeCount = count;
+    return count < scopeCount ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+VkResult vkGetGpuProfilerResultStatistics(
+    VkGpuProfiler                               gpuProfiler,
+    uint32_t*                                   pResultCount,
+    VkGpuProfilerResultStatistics*              pStatistics) {
+    // 다른 스레드가 새 호출 위치를 등록하거나 횟수를 늘릴 수 있으므로 두번의 호출 사이에 개수가 늘어날 수 있다.
+    uint32_t resultCount = 0;
+    uint32_t count = 0;
+    for (auto pCounter = vkGetFirstResultCounter(); pCounter; pCounter = pCounter->pNext) {
+        for (auto i = 0; i != VkResultCounter::kSlotCount; ++i) {
+            const auto result = pCounter->results[i].load(memory_order_relaxed);
+            if (result == VK_SUCCESS) {
+                break;
+            }
+
+            ++resultCount;
+            if (!pStatistics || count == *pResultCount) {
+                continue;
+            }
+
+            auto &statistics = pStatistics[count++];
+            const auto fileName = vkGetFileName(pCounter->file);
+            const auto fileNameSize = min(fileName.size(), size_t{VK_MAX_DESCRIPTION_SIZE - 1});
+            memcpy(statistics.fileName, fileName.data(), fileNameSize);
+            statistics.fileName[fileNameSize] = '\0';
+            statistics.line = pCounter->line;
+            statistics.result = result;
+            statistics.count = pCounter->counts[i].load(memory_order_relaxed);
+        }
+    }
+
+    if (!pStatistics) {
+        *pResultCount = resultCount;
+        return VK_SUCCESS;
+    }
+
+    *pResultCount = count;
+    return count < resultCount ? VK_INCOMPLETE : VK_SUCCESS;
+}
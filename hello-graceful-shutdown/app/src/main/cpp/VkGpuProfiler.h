@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKGPUPROFILER_H
+#define PRACTICE_VULKAN_VKGPUPROFILER_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkGpuProfiler)
+
+typedef struct VkGpuProfilerCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    VkPhysicalDevice                 physicalDevice;
+    // 타임스탬프를 기록할 VkCommandBuffer가 제출되는 큐 패밀리.
+    uint32_t                         queueFamilyIndex;
+    // 동시에 실행될 수 있는 프레임 개수로 프레임마다 별도의 쿼리 영역을 사용한다.
+    uint32_t                         frameCount;
+    // 프레임마다 측정할 수 있는 범위의 최대 개수로 넘는 범위는 무시된다.
+    uint32_t                         maxScopeCount;
+    // 범위마다 통계를 계산할 최근 프레임 개수.
+    uint32_t                         historyLength;
+} VkGpuProfilerCreateInfo;
+
+// 시간은 밀리초 단위다.
+typedef struct VkGpuProfilerScopeStatistics {
+    char                             name[VK_MAX_DESCRIPTION_SIZE];
+    uint32_t                         sampleCount;
+    double                           lastTime;
+    double                           averageTime;
+    double                           minTime;
+    double                           maxTime;
+} VkGpuProfilerScopeStatistics;
+
+// VK_COUNT_RESULT와 VK_CHECK_ERROR의 호출 위치와 결과마다 하나씩 존재하며 프로세스 전체에서 센 횟수다.
+typedef struct VkGpuProfilerResultStatistics {
+    char                             fileName[VK_MAX_DESCRIPTION_SIZE];
+    uint32_t                         line;
+    VkResult                         result;
+    uint32_t                         count;
+} VkGpuProfilerResultStatistics;
+
+// 모든 함수는 외부에서 동기화해야 한다.
+// 큐 패밀리가 타임스탬프를 지원하지 않으면 VK_ERROR_FEATURE_NOT_PRESENT를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateGpuProfiler(
+    VkDevice                                    device,
+    const VkGpuProfilerCreateInfo*              pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkGpuProfiler*                              pGpuProfiler);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyGpuProfiler(
+    VkDevice                                    device,
+    VkGpuProfiler                               gpuProfiler,
+    const VkAllocationCallbacks*                pAllocator);
+
+// frameIndex 영역에 마지막으로 기록된 범위의 시간을 읽어서 통계에 추가한다.
+// 호출하기 전에 이 영역을 사용한 GPU 작업이 끝나야 하며 끝나지 않은 범위는 건너뛴다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCollectGpuProfilerFrame(
+    VkGpuProfiler                               gpuProfiler,
+    uint32_t                                    frameIndex);
+
+// frameIndex 영역의 쿼리를 초기화하며 이후에 기록되는 범위는 이 영역을 사용한다.
+// VkRenderPass 밖에서 기록해야 한다.
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginGpuProfilerFrame(
+    VkGpuProfiler                               gpuProfiler,
+    VkCommandBuffer                             commandBuffer,
+    uint32_t                                    frameIndex);
+
+// 범위는 중첩될 수 있으며 같은 이름의 범위는 하나의 통계로 합쳐진다.
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginGpuProfilerScope(
+    VkGpuProfiler                               gpuProfiler,
+    VkCommandBuffer                             commandBuffer,
+    const char*                                 pName);
+
+VKAPI_ATTR void VKAPI_CALL vkCmdEndGpuProfilerScope(
+    VkGpuProfiler                               gpuProfiler,
+    VkCommandBuffer                             commandBuffer);
+
+// pStatistics가 nullptr이면 범위 개수를 pScopeCount에 쓰며 범위는 처음 측정된 순서로 정렬된다.
+VKAPI_ATTR VkResult VKAPI_CALL vkGetGpuProfilerStatistics(
+    VkGpuProfiler                               gpuProfiler,
+    uint32_t*                                   pScopeCount,
+    VkGpuProfilerScopeStatistics*               pStatistics);
+
+// 릴리스 빌드에서도 로그 없이 센 스왑체인 재생성이나 시간 초과 같은 성공이 아닌 결과를 GPU 시간과 함께 보고한다.
+// pStatistics가 nullptr이면 개수를 pResultCount에 쓰며 호출 위치는 최근에 처음 실패한 순서로 정렬된다.
+VKAPI_ATTR VkResult VKAPI_CALL vkGetGpuProfilerResultStatistics(
+    VkGpuProfiler                               gpuProfiler,
+    uint32_t*                                   pResultCount,
+    VkGpuProfilerResultStatistics*              pStatistics);
+
+#endif //PRACTICE_VULKAN_VKGPUPROFILER_H
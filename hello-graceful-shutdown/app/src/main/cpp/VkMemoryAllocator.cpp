@@ -0,0 +1,500 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "VkMemoryAllocator.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+struct VkMemoryBlock {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    uint32_t memoryTypeIndex;
+    uint8_t *pMappedData;
+    uint32_t allocationCount;
+    // VK_MEMORY_ALLOCATOR_STRATEGY_LINEAR: 다음 할당이 시작될 위치.
+    VkDeviceSize top;
+    // VK_MEMORY_ALLOCATOR_STRATEGY_FREE_LIST: 오프셋을 키로 하는 빈 영역.
+    map<VkDeviceSize, VkDeviceSize> freeRanges;
+};
+
+struct VkMemoryAllocationImpl {
+    // 전용 할당이면 nullptr.
+    VkMemoryBlock *pBlock;
+    // 정렬 패딩을 포함해 블록에서 예약한 영역.
+    VkDeviceSize rangeOffset;
+    VkDeviceSize rangeSize;
+    VkMemoryAllocationProperties properties;
+};
+
+struct VkMemoryAllocatorImpl {
+    VkDevice device;
+    VkPhysicalDevice physicalDevice;
+    VkMemoryAllocatorCreateFlags flags;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    VkDeviceSize bufferImageGranularity;
+    VkDeviceSize nonCoherentAtomSize;
+    VkDeviceSize blockSize;
+    VkMemoryAllocatorStrategy strategy;
+    mutex lock;
+    vector<unique_ptr<VkMemoryBlock>> blocks[VK_MAX_MEMORY_TYPES];
+    // 할당자를 파괴할 때 남은 할당을 한번에 해제하기 위해 모든 할당을 기록한다.
+    unordered_set<VkMemoryAllocationImpl *> allocations;
+    VkMemoryAllocatorStatistics statistics;
+};
+
+// 잠금을 잡은 상태에서 호출한다.
+void vkGetBudget(VkMemoryAllocatorImpl *pImpl, VkMemoryAllocatorBudget *pBudget) {
+    const auto &statistics = pImpl->statistics;
+    pBudget->heapCount = pImpl->memoryProperties.memoryHeapCount;
+
+    if (pImpl->flags & VK_MEMORY_ALLOCATOR_CREATE_MEMORY_BUDGET_BIT) {
+        VkPhysicalDeviceMemoryBudgetPropertiesEXT physicalDeviceMemoryBudgetProperties{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+        };
+
+        VkPhysicalDeviceMemoryProperties2 physicalDeviceMemoryProperties{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+            .pNext = &physicalDeviceMemoryBudgetProperties
+        };
+
+        vkGetPhysicalDeviceMemoryProperties2(pImpl->physicalDevice, &physicalDeviceMemoryProperties);
+
+        // 드라이버의 사용량은 늦게 갱신될 수 있으므로 이 할당자가 할당한 양보다 작게 보지 않는다.
+        for (uint32_t i = 0; i != pBudget->heapCount; ++i) {
+            pBudget->heapBudget[i] = physicalDeviceMemoryBudgetProperties.heapBudget[i];
+            pBudget->heapUsage[i] = max(physicalDeviceMemoryBudgetProperties.heapUsage[i],
+                                        statistics.heapDeviceMemoryBytes[i]);
+        }
+    } else {
+        for (uint32_t i = 0; i != pBudget->heapCount; ++i) {
+            pBudget->heapBudget[i] = pImpl->memoryProperties.memoryHeaps[i].size / 10 * 8;
+            pBudget->heapUsage[i] = statistics.heapDeviceMemoryBytes[i];
+        }
+    }
+}
+
+VkResult vkAllocateDeviceMemory(VkMemoryAllocatorImpl *pImpl,
+                                VkDeviceSize size,
+                                uint32_t memoryTypeIndex,
+                                VkMemoryAllocationCreateFlags flags,
+                                VkDeviceMemory *pMemory,
+                                void **ppMappedData) {
+    const auto &memoryType = pImpl->memoryProperties.memoryTypes[memoryTypeIndex];
+    if (flags & VK_MEMORY_ALLOCATION_CREATE_WITHIN_BUDGET_BIT) {
+        VkMemoryAllocatorBudget budget;
+        vkGetBudget(pImpl, &budget);
+        if (budget.heapUsage[memoryType.heapIndex] + size > budget.heapBudget[memoryType.heapIndex]) {
+            return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+        }
+    }
+
+    const VkMemoryAllocateInfo memoryAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = size,
+            .memoryTypeIndex = memoryTypeIndex
+    };
+
+    auto result = vkAllocateMemory(pImpl->device, &memoryAllocateInfo, nullptr, pMemory);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    // 하나의 VkDeviceMemory는 동시에 한번만 맵핑할 수 있으므로 블록 전체를 영구적으로 맵핑한다.
+    *ppMappedData = nullptr;
+    if (memoryType.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        result = vkMapMemory(pImpl->device, *pMemory, 0, VK_WHOLE_SIZE, 0, ppMappedData);
+        if (result != VK_SUCCESS) {
+            vkFreeMemory(pImpl->device, *pMemory, nullptr);
+            return result;
+        }
+    }
+
+    auto &statistics = pImpl->statistics;
+    statistics.deviceMemoryCount++;
+    statistics.deviceMemoryBytes += size;
+    statistics.heapDeviceMemoryBytes[memoryType.heapIndex] += size;
+
+    return VK_SUCCESS;
+}
+
+void vkFreeDeviceMemory(VkMemoryAllocatorImpl *pImpl,
+                        VkDeviceSize size,
+                        uint32_t memoryTypeIndex,
+                        VkDeviceMemory memory) {
+    // 맵핑된 메모리는 해제시 자동으로 언맵핑된다.
+    vkFreeMemory(pImpl->device, memory, nullptr);
+
+    const auto &memoryType = pImpl->memoryProperties.memoryTypes[memoryTypeIndex];
+    auto &statistics = pImpl->statistics;
+    statistics.deviceMemoryCount--;
+    statistics.deviceMemoryBytes -= size;
+    statistics.heapDeviceMemoryBytes[memoryType.heapIndex] -= size;
+}
+
+bool vkAllocateRange(VkMemoryAllocatorStrategy strategy,
+                     VkMemoryBlock *pBlock,
+                     VkDeviceSize size,
+                     VkDeviceSize alignment,
+                     VkMemoryAllocationImpl *pAllocation) {
+    if (strategy == VK_MEMORY_ALLOCATOR_STRATEGY_LINEAR) {
+        const auto offset = vkAlignUp(pBlock->top, alignment);
+        if (offset + size > pBlock->size) {
+            return false;
+        }
+
+        pAllocation->rangeOffset = pBlock->top;
+        pAllocation->rangeSize = offset + size - pBlock->top;
+        pAllocation->properties.offset = offset;
+        pBlock->top = offset + size;
+    } else {
+        // 할당 가능한 가장 작은 빈 영역을 찾는다.
+        auto bestIter = pBlock->freeRanges.end();
+        for (auto iter = pBlock->freeRanges.begin(); iter != pBlock->freeRanges.end(); ++iter) {
+            const auto [rangeOffset, rangeSize] = *iter;
+            if (vkAlignUp(rangeOffset, alignment) + size > rangeOffset + rangeSize) {
+                continue;
+            }
+
+            if (bestIter == pBlock->freeRanges.end() || rangeSize < bestIter->second) {
+                bestIter = iter;
+            }
+        }
+
+        if (bestIter == pBlock->freeRanges.end()) {
+            return false;
+        }
+
+        const auto [rangeOffset, rangeSize] = *bestIter;
+        const auto offset = vkAlignUp(rangeOffset, alignment);
+        pBlock->freeRanges.erase(bestIter);
+
+        // 앞쪽 정렬 패딩은 할당에 포함시키고 뒤쪽의 남은 영역만 빈 영역으로 되돌린다.
+        const auto end = offset + size;
+        if (end < rangeOffset + rangeSize) {
+            pBlock->freeRanges.emplace(end, rangeOffset + rangeSize - end);
+        }
+
+        pAllocation->rangeOffset = rangeOffset;
+        pAllocation->rangeSize = end - rangeOffset;
+        pAllocation->properties.offset = offset;
+    }
+
+    pAllocation->pBlock = pBlock;
+    pAllocation->properties.memory = pBlock->memory;
+    pAllocation->properties.pMappedData = pBlock->pMappedData ?
+                                          pBlock->pMappedData + pAllocation->properties.offset :
+                                          nullptr;
+    pBlock->allocationCount++;
+
+    return true;
+}
+
+void vkFreeRange(VkMemoryAllocatorStrategy strategy,
+                 VkMemoryBlock *pBlock,
+                 const VkMemoryAllocationImpl *pAllocation) {
+    pBlock->allocationCount--;
+
+    if (strategy == VK_MEMORY_ALLOCATOR_STRATEGY_LINEAR) {
+        if (!pBlock->allocationCount) {
+            pBlock->top = 0;
+        } else if (pAllocation->rangeOffset + pAllocation->rangeSize == pBlock->top) {
+            // 마지막 할당이라면 스택처럼 되돌린다.
+            pBlock->top = pAllocation->rangeOffset;
+        }
+    } else {
+        auto offset = pAllocation->rangeOffset;
+        auto size = pAllocation->rangeSize;
+
+        // 뒤쪽 빈 영역과 합친다.
+        auto nextIter = pBlock->freeRanges.find(offset + size);
+        if (nextIter != pBlock->freeRanges.end()) {
+            size += nextIter->second;
+            pBlock->freeRanges.erase(nextIter);
+        }
+
+        // 앞쪽 빈 영역과 합친다.
+        auto nextOrEndIter = pBlock->freeRanges.lower_bound(offset);
+        if (nextOrEndIter != pBlock->freeRanges.begin()) {
+            auto prevIter = prev(nextOrEndIter);
+            if (prevIter->first + prevIter->second == offset) {
+                prevIter->second += size;
+                return;
+            }
+        }
+
+        pBlock->freeRanges.emplace(offset, size);
+    }
+}
+
+}
+
+VkResult vkCreateMemoryAllocator(
+    VkDevice                                    device,
+    const VkMemoryAllocatorCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkMemoryAllocator*                          pMemoryAllocator) {
+    auto pImpl = make_unique<VkMemoryAllocatorImpl>();
+    pImpl->device = device;
+    pImpl->physicalDevice = pCreateInfo->physicalDevice;
+    pImpl->flags = pCreateInfo->flags;
+    vkGetPhysicalDeviceMemoryProperties(pCreateInfo->physicalDevice, &pImpl->memoryProperties);
+
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(pCreateInfo->physicalDevice, &physicalDeviceProperties);
+    pImpl->bufferImageGranularity = physicalDeviceProperties.limits.bufferImageGranularity;
+    pImpl->nonCoherentAtomSize = physicalDeviceProperties.limits.nonCoherentAtomSize;
+
+    pImpl->blockSize = pCreateInfo->blockSize;
+    pImpl->strategy = pCreateInfo->strategy;
+    pImpl->statistics = {};
+
+    *pMemoryAllocator = reinterpret_cast<VkMemoryAllocator>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyMemoryAllocator(
+    VkDevice                                    device,
+    VkMemoryAllocator                           memoryAllocator,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkMemoryAllocatorImpl*>(memoryAllocator);
+    // 블록의 할당은 블록과 함께 해제되므로 전용 할당의 메모리만 따로 해제한다.
+    for (auto pAllocation : pImpl->allocations) {
+        if (!pAllocation->pBlock) {
+            vkFreeDeviceMemory(pImpl,
+                               pAllocation->rangeSize,
+                               pAllocation->properties.memoryTypeIndex,
+                               pAllocation->properties.memory);
+        }
+        delete pAllocation;
+    }
+    for (auto &blocks : pImpl->blocks) {
+        for (auto &pBlock : blocks) {
+            vkFreeDeviceMemory(pImpl, pBlock->size, pBlock->memoryTypeIndex, pBlock->memory);
+        }
+    }
+    delete pImpl;
+}
+
+VkResult vkCreateMemoryAllocation(
+    VkMemoryAllocator                           memoryAllocator,
+    const VkMemoryAllocationCreateInfo*         pCreateInfo,
+    VkMemoryAllocation*                         pMemoryAllocation) {
+    auto pImpl = reinterpret_cast<VkMemoryAllocatorImpl*>(memoryAllocator);
+
+    uint32_t memoryTypeIndex;
+    auto result = vkGetMemoryTypeIndex(pImpl->memoryProperties,
+                                       pCreateInfo->memoryRequirements,
+                                       pCreateInfo->memoryPropertyFlags,
+                                       pCreateInfo->preferredMemoryPropertyFlags,
+                                       &memoryTypeIndex);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    auto size = pCreateInfo->memoryRequirements.size;
+    auto alignment = pCreateInfo->memoryRequirements.alignment;
+
+    // OPTIMAL 이미지가 차지하는 페이지를 버퍼나 LINEAR 이미지와 공유하지 않도록
+    // 시작과 끝을 bufferImageGranularity에 맞춘다.
+    if (pCreateInfo->type == VK_MEMORY_ALLOCATION_TYPE_IMAGE_OPTIMAL) {
+        alignment = max(alignment, pImpl->bufferImageGranularity);
+        size = vkAlignUp(size, pImpl->bufferImageGranularity);
+    }
+
+    // HOST_COHERENT가 아닌 메모리는 플러시 범위를 nonCoherentAtomSize에 맞춰 넓혀도
+    // 할당 밖으로 나가지 않도록 시작과 끝을 nonCoherentAtomSize에 맞춘다.
+    const auto memoryPropertyFlags = pImpl->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if ((memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+        !(memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        alignment = max(alignment, pImpl->nonCoherentAtomSize);
+        size = vkAlignUp(size, pImpl->nonCoherentAtomSize);
+    }
+
+    auto pAllocation = make_unique<VkMemoryAllocationImpl>();
+    pAllocation->properties.size = pCreateInfo->memoryRequirements.size;
+    pAllocation->properties.memoryTypeIndex = memoryTypeIndex;
+
+    lock_guard<mutex> guard(pImpl->lock);
+
+    // 블록의 절반보다 큰 할당은 블록을 낭비하지 않도록 전용 메모리를 사용한다.
+    if ((pCreateInfo->flags & VK_MEMORY_ALLOCATION_CREATE_DEDICATED_BIT) ||
+        size > pImpl->blockSize / 2) {
+        VkDeviceMemory memory;
+        void *pMappedData;
+        result = vkAllocateDeviceMemory(pImpl, size, memoryTypeIndex, pCreateInfo->flags, &memory, &pMappedData);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+
+        pAllocation->pBlock = nullptr;
+        pAllocation->rangeOffset = 0;
+        pAllocation->rangeSize = size;
+        pAllocation->properties.memory = memory;
+        pAllocation->properties.offset = 0;
+        pAllocation->properties.pMappedData = pMappedData;
+    } else {
+        auto &blocks = pImpl->blocks[memoryTypeIndex];
+        auto allocated = any_of(blocks.begin(), blocks.end(), [&](auto &pBlock) {
+            return vkAllocateRange(pImpl->strategy, pBlock.get(), size, alignment, pAllocation.get());
+        });
+
+        if (!allocated) {
+            auto pBlock = make_unique<VkMemoryBlock>();
+            void *pMappedData;
+            result = vkAllocateDeviceMemory(pImpl,
+                                            pImpl->blockSize,
+                                            memoryTypeIndex,
+                                            pCreateInfo->flags,
+                                            &pBlock->memory,
+                                            &pMappedData);
+            if (result != VK_SUCCESS) {
+                return result;
+            }
+
+            pBlock->size = pImpl->blockSize;
+            pBlock->memoryTypeIndex = memoryTypeIndex;
+            pBlock->pMappedData = static_cast<uint8_t *>(pMappedData);
+            pBlock->allocationCount = 0;
+            pBlock->top = 0;
+            pBlock->freeRanges.emplace(0, pImpl->blockSize);
+
+            vkAllocateRange(pImpl->strategy, pBlock.get(), size, alignment, pAllocation.get());
+            blocks.push_back(move(pBlock));
+        }
+    }
+
+    const auto heapIndex = pImpl->memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    auto &statistics = pImpl->statistics;
+    statistics.allocationCount++;
+    statistics.allocationBytes += pAllocation->properties.size;
+    statistics.heapAllocationBytes[heapIndex] += pAllocation->properties.size;
+
+    pImpl->allocations.insert(pAllocation.get());
+    *pMemoryAllocation = reinterpret_cast<VkMemoryAllocation>(pAllocation.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyMemoryAllocation(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocation                          memoryAllocation) {
+    auto pImpl = reinterpret_cast<VkMemoryAllocatorImpl*>(memoryAllocator);
+    auto pAllocation = reinterpret_cast<VkMemoryAllocationImpl*>(memoryAllocation);
+    if (!pAllocation) {
+        return;
+    }
+
+    const auto memoryTypeIndex = pAllocation->properties.memoryTypeIndex;
+
+    lock_guard<mutex> guard(pImpl->lock);
+
+    if (!pAllocation->pBlock) {
+        vkFreeDeviceMemory(pImpl,
+                           pAllocation->rangeSize,
+                           memoryTypeIndex,
+                           pAllocation->properties.memory);
+    } else {
+        auto pBlock = pAllocation->pBlock;
+        vkFreeRange(pImpl->strategy, pBlock, pAllocation);
+
+        // 할당과 해제가 반복될 때 블록을 계속 새로 만들지 않도록 마지막 블록은 유지한다.
+        auto &blocks = pImpl->blocks[memoryTypeIndex];
+        if (!pBlock->allocationCount && blocks.size() > 1) {
+            vkFreeDeviceMemory(pImpl, pBlock->size, memoryTypeIndex, pBlock->memory);
+            blocks.erase(find_if(blocks.begin(), blocks.end(), [pBlock](auto &pOther) {
+                return pOther.get() == pBlock;
+            }));
+        }
+    }
+
+    const auto heapIndex = pImpl->memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    auto &statistics = pImpl->statistics;
+    statistics.allocationCount--;
+    statistics.allocationBytes -= pAllocation->properties.size;
+    statistics.heapAllocationBytes[heapIndex] -= pAllocation->properties.size;
+
+    pImpl->allocations.erase(pAllocation);
+    delete pAllocation;
+}
+
+void vkGetMemoryAllocationProperties(
+    VkMemoryAllocation                          memoryAllocation,
+    VkMemoryAllocationProperties*               pMemoryAllocationProperties) {
+    *pMemoryAllocationProperties =
+            reinterpret_cast<VkMemoryAllocationImpl*>(memoryAllocation)->properties;
+}
+
+void vkGetMemoryAllocatorStatistics(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocatorStatistics*                pMemoryAllocatorStatistics) {
+    auto pImpl = reinterpret_cast<VkMemoryAllocatorImpl*>(memoryAllocator);
+    lock_guard<mutex> guard(pImpl->lock);
+    *pMemoryAllocatorStatistics = pImpl->statistics;
+}
+
+VkResult vkFlushMemoryAllocation(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocation                          memoryAllocation,
+    VkDeviceSize                                offset,
+    VkDeviceSize                                size) {
+    auto pImpl = reinterpret_cast<VkMemoryAllocatorImpl*>(memoryAllocator);
+    const auto &properties = reinterpret_cast<VkMemoryAllocationImpl*>(memoryAllocation)->properties;
+    const auto memoryPropertyFlags = pImpl->memoryProperties.memoryTypes[properties.memoryTypeIndex].propertyFlags;
+    if (memoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+        return VK_SUCCESS;
+    }
+
+    if (size == VK_WHOLE_SIZE) {
+        size = properties.size - offset;
+    }
+
+    // 할당의 시작과 끝이 nonCoherentAtomSize에 맞춰져 있으므로 넓힌 범위도 할당 안에 있다.
+    const auto atomSize = pImpl->nonCoherentAtomSize;
+    const auto begin = (properties.offset + offset) & ~(atomSize - 1);
+    const auto end = vkAlignUp(properties.offset + offset + size, atomSize);
+
+    const VkMappedMemoryRange mappedMemoryRange{
+        .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .memory = properties.memory,
+        .offset = begin,
+        .size = end - begin
+    };
+
+    return vkFlushMappedMemoryRanges(pImpl->device, 1, &mappedMemoryRange);
+}
+
+void vkGetMemoryAllocatorBudget(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocatorBudget*                    pMemoryAllocatorBudget) {
+    auto pImpl = reinterpret_cast<VkMemoryAllocatorImpl*>(memoryAllocator);
+    lock_guard<mutex> guard(pImpl->lock);
+    vkGetBudget(pImpl, pMemoryAllocatorBudget);
+}
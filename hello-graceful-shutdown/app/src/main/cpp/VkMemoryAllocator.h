@@ -0,0 +1,149 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKMEMORYALLOCATOR_H
+#define PRACTICE_VULKAN_VKMEMORYALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkMemoryAllocator)
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkMemoryAllocation)
+
+typedef enum VkMemoryAllocatorStrategy {
+    // 블록마다 빈 영역 목록을 유지하고 best-fit으로 할당한다.
+    VK_MEMORY_ALLOCATOR_STRATEGY_FREE_LIST = 0,
+    // 블록 끝으로만 할당하고 블록의 모든 할당이 해제되면 처음부터 다시 사용한다.
+    VK_MEMORY_ALLOCATOR_STRATEGY_LINEAR = 1
+} VkMemoryAllocatorStrategy;
+
+typedef enum VkMemoryAllocatorCreateFlagBits {
+    // VK_EXT_memory_budget이 활성화되어 있으면 드라이버가 보고하는 힙 예산과 사용량을 사용한다.
+    // 설정하지 않으면 힙 크기의 80%를 예산으로 보고 이 할당자가 할당한 VkDeviceMemory만 사용량으로 센다.
+    VK_MEMORY_ALLOCATOR_CREATE_MEMORY_BUDGET_BIT = 0x00000001
+} VkMemoryAllocatorCreateFlagBits;
+typedef VkFlags VkMemoryAllocatorCreateFlags;
+
+typedef enum VkMemoryAllocationType {
+    VK_MEMORY_ALLOCATION_TYPE_BUFFER = 0,
+    VK_MEMORY_ALLOCATION_TYPE_IMAGE_LINEAR = 1,
+    VK_MEMORY_ALLOCATION_TYPE_IMAGE_OPTIMAL = 2
+} VkMemoryAllocationType;
+
+typedef enum VkMemoryAllocationCreateFlagBits {
+    // 블록을 공유하지 않고 전용 VkDeviceMemory를 할당한다.
+    VK_MEMORY_ALLOCATION_CREATE_DEDICATED_BIT = 0x00000001,
+    // 새 VkDeviceMemory가 힙 예산을 넘으면 vkAllocateMemory를 호출하지 않고
+    // VK_ERROR_OUT_OF_DEVICE_MEMORY를 반환해서 저메모리 킬러의 대상이 되기 전에 실패하게 한다.
+    VK_MEMORY_ALLOCATION_CREATE_WITHIN_BUDGET_BIT = 0x00000002
+} VkMemoryAllocationCreateFlagBits;
+typedef VkFlags VkMemoryAllocationCreateFlags;
+
+typedef struct VkMemoryAllocatorCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkMemoryAllocatorCreateFlags     flags;
+    VkPhysicalDevice                 physicalDevice;
+    VkDeviceSize                     blockSize;
+    VkMemoryAllocatorStrategy        strategy;
+} VkMemoryAllocatorCreateInfo;
+
+typedef struct VkMemoryAllocationCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkMemoryAllocationCreateFlags    flags;
+    VkMemoryAllocationType           type;
+    VkMemoryRequirements             memoryRequirements;
+    VkMemoryPropertyFlags            memoryPropertyFlags;
+    // memoryPropertyFlags를 만족하는 메모리 타입 중 이 플래그까지 가진 타입이 있으면 우선 사용한다.
+    VkMemoryPropertyFlags            preferredMemoryPropertyFlags;
+} VkMemoryAllocationCreateInfo;
+
+typedef struct VkMemoryAllocationProperties {
+    VkDeviceMemory                   memory;
+    VkDeviceSize                     offset;
+    VkDeviceSize                     size;
+    uint32_t                         memoryTypeIndex;
+    // HOST_VISIBLE 메모리는 블록 생성시 한번만 맵핑되며 할당의 시작 주소를 가리킨다.
+    void*                            pMappedData;
+} VkMemoryAllocationProperties;
+
+typedef struct VkMemoryAllocatorStatistics {
+    uint32_t                         deviceMemoryCount;
+    uint32_t                         allocationCount;
+    VkDeviceSize                     deviceMemoryBytes;
+    VkDeviceSize                     allocationBytes;
+    VkDeviceSize                     heapDeviceMemoryBytes[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize                     heapAllocationBytes[VK_MAX_MEMORY_HEAPS];
+} VkMemoryAllocatorStatistics;
+
+typedef struct VkMemoryAllocatorBudget {
+    uint32_t                         heapCount;
+    VkDeviceSize                     heapBudget[VK_MAX_MEMORY_HEAPS];
+    // 다른 할당자와 프로세스를 포함한 힙의 사용량으로 VkDeviceMemory 안의 빈 영역도 포함한다.
+    VkDeviceSize                     heapUsage[VK_MAX_MEMORY_HEAPS];
+} VkMemoryAllocatorBudget;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateMemoryAllocator(
+    VkDevice                                    device,
+    const VkMemoryAllocatorCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkMemoryAllocator*                          pMemoryAllocator);
+
+// 파괴되지 않은 VkMemoryAllocation은 블록과 전용 메모리를 포함해 모두 해제되며 다시 사용할 수 없다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyMemoryAllocator(
+    VkDevice                                    device,
+    VkMemoryAllocator                           memoryAllocator,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateMemoryAllocation(
+    VkMemoryAllocator                           memoryAllocator,
+    const VkMemoryAllocationCreateInfo*         pCreateInfo,
+    VkMemoryAllocation*                         pMemoryAllocation);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyMemoryAllocation(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocation                          memoryAllocation);
+
+VKAPI_ATTR void VKAPI_CALL vkGetMemoryAllocationProperties(
+    VkMemoryAllocation                          memoryAllocation,
+    VkMemoryAllocationProperties*               pMemoryAllocationProperties);
+
+VKAPI_ATTR void VKAPI_CALL vkGetMemoryAllocatorStatistics(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocatorStatistics*                pMemoryAllocatorStatistics);
+
+// 맵핑된 메모리에 쓴 범위를 디바이스에 보이게 하며 HOST_COHERENT 메모리는 아무것도 하지 않는다.
+// 범위는 nonCoherentAtomSize에 맞춰 넓혀지고 size가 VK_WHOLE_SIZE이면 할당의 끝까지 플러시한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkFlushMemoryAllocation(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocation                          memoryAllocation,
+    VkDeviceSize                                offset,
+    VkDeviceSize                                size);
+
+// 드라이버에 질의하므로 프레임마다 한번 정도만 호출한다.
+VKAPI_ATTR void VKAPI_CALL vkGetMemoryAllocatorBudget(
+    VkMemoryAllocator                           memoryAllocator,
+    VkMemoryAllocatorBudget*                    pMemoryAllocatorBudget);
+
+#endif //PRACTICE_VULKAN_VKMEMORYALLOCATOR_H
@@ -0,0 +1,255 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstring>
+#include <vector>
+#include <gtest/gtest.h>
+#include <vulkan/vulkan.h>
+
+#include "VkDeviceTest.h"
+#include "VkMemoryAllocator.h"
+
+class VkMemoryAllocatorTest : public VkDeviceTest,
+                              public testing::WithParamInterface<VkMemoryAllocatorStrategy> {
+protected:
+    VkMemoryAllocatorTest() : VkDeviceTest(kBlockSize) {
+    }
+
+    VkMemoryAllocatorStrategy getMemoryAllocatorStrategy() const override {
+        return GetParam();
+    }
+
+    VkMemoryAllocation allocate(VkMemoryAllocationType type, VkDeviceSize size, VkDeviceSize alignment) {
+        VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+            .type = type,
+            .memoryRequirements = {
+                .size = size,
+                .alignment = alignment,
+                .memoryTypeBits = UINT32_MAX
+            },
+            .memoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        };
+
+        VkMemoryAllocation memoryAllocation = VK_NULL_HANDLE;
+        EXPECT_EQ(vkCreateMemoryAllocation(mMemoryAllocator, &memoryAllocationCreateInfo, &memoryAllocation),
+                  VK_SUCCESS);
+        return memoryAllocation;
+    }
+
+    static constexpr VkDeviceSize kBlockSize = 1024 * 1024;
+};
+
+TEST_P(VkMemoryAllocatorTest, suballocate) {
+    std::vector<VkMemoryAllocation> memoryAllocations;
+    for (auto alignment : {1, 16, 256, 4096}) {
+        memoryAllocations.push_back(allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, 100, alignment));
+
+        VkMemoryAllocationProperties properties;
+        vkGetMemoryAllocationProperties(memoryAllocations.back(), &properties);
+        EXPECT_EQ(properties.offset % alignment, 0);
+        EXPECT_NE(properties.pMappedData, nullptr);
+    }
+
+    VkMemoryAllocatorStatistics statistics;
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.deviceMemoryCount, 1);
+    EXPECT_EQ(statistics.allocationCount, 4);
+    EXPECT_EQ(statistics.allocationBytes, 400);
+
+    for (auto memoryAllocation : memoryAllocations) {
+        vkDestroyMemoryAllocation(mMemoryAllocator, memoryAllocation);
+    }
+
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.allocationCount, 0);
+    EXPECT_EQ(statistics.allocationBytes, 0);
+}
+
+TEST_P(VkMemoryAllocatorTest, reuse) {
+    auto first = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, kBlockSize / 4, 256);
+    auto second = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, kBlockSize / 4, 256);
+    vkDestroyMemoryAllocation(mMemoryAllocator, second);
+    vkDestroyMemoryAllocation(mMemoryAllocator, first);
+
+    // 해제된 영역이 다시 합쳐져 새 블록 없이 재사용되어야 한다.
+    auto third = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, kBlockSize / 2, 256);
+
+    VkMemoryAllocationProperties properties;
+    vkGetMemoryAllocationProperties(third, &properties);
+    EXPECT_EQ(properties.offset, 0);
+
+    VkMemoryAllocatorStatistics statistics;
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.deviceMemoryCount, 1);
+
+    vkDestroyMemoryAllocation(mMemoryAllocator, third);
+}
+
+TEST_P(VkMemoryAllocatorTest, bufferImageGranularity) {
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(mPhysicalDevice, &physicalDeviceProperties);
+    const auto granularity = physicalDeviceProperties.limits.bufferImageGranularity;
+
+    auto buffer = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, 100, 16);
+    auto image = allocate(VK_MEMORY_ALLOCATION_TYPE_IMAGE_OPTIMAL, 100, 16);
+    auto nextBuffer = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, 100, 16);
+
+    VkMemoryAllocationProperties bufferProperties;
+    vkGetMemoryAllocationProperties(buffer, &bufferProperties);
+    VkMemoryAllocationProperties imageProperties;
+    vkGetMemoryAllocationProperties(image, &imageProperties);
+    VkMemoryAllocationProperties nextBufferProperties;
+    vkGetMemoryAllocationProperties(nextBuffer, &nextBufferProperties);
+
+    // OPTIMAL 이미지는 버퍼와 같은 페이지를 사용하면 안된다.
+    const auto page = [granularity](VkDeviceSize offset) { return offset / granularity; };
+    EXPECT_NE(page(bufferProperties.offset + bufferProperties.size - 1), page(imageProperties.offset));
+    EXPECT_NE(page(imageProperties.offset + imageProperties.size - 1), page(nextBufferProperties.offset));
+
+    vkDestroyMemoryAllocation(mMemoryAllocator, nextBuffer);
+    vkDestroyMemoryAllocation(mMemoryAllocator, image);
+    vkDestroyMemoryAllocation(mMemoryAllocator, buffer);
+}
+
+TEST_P(VkMemoryAllocatorTest, dedicated) {
+    auto memoryAllocation = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, kBlockSize, 256);
+
+    VkMemoryAllocationProperties properties;
+    vkGetMemoryAllocationProperties(memoryAllocation, &properties);
+    EXPECT_EQ(properties.offset, 0);
+
+    VkMemoryAllocatorStatistics statistics;
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.deviceMemoryCount, 1);
+    EXPECT_EQ(statistics.deviceMemoryBytes, kBlockSize);
+
+    vkDestroyMemoryAllocation(mMemoryAllocator, memoryAllocation);
+
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.deviceMemoryCount, 0);
+}
+
+TEST_P(VkMemoryAllocatorTest, destroyWithAllocations) {
+    allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, 100, 16);
+    allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, kBlockSize, 256);
+
+    VkMemoryAllocatorStatistics statistics;
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.deviceMemoryCount, 2);
+
+    // 남은 블록과 전용 메모리는 VkDevice를 파괴하기 전에 할당자와 함께 해제되어야 한다.
+    vkDestroyMemoryAllocator(mDevice, mMemoryAllocator, nullptr);
+    mMemoryAllocator = VK_NULL_HANDLE;
+}
+
+TEST_P(VkMemoryAllocatorTest, withinBudget) {
+    auto memoryAllocation = allocate(VK_MEMORY_ALLOCATION_TYPE_BUFFER, 100, 16);
+
+    VkMemoryAllocationProperties properties;
+    vkGetMemoryAllocationProperties(memoryAllocation, &properties);
+
+    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &physicalDeviceMemoryProperties);
+    const auto heapIndex = physicalDeviceMemoryProperties.memoryTypes[properties.memoryTypeIndex].heapIndex;
+
+    VkMemoryAllocatorBudget budget;
+    vkGetMemoryAllocatorBudget(mMemoryAllocator, &budget);
+    EXPECT_EQ(budget.heapCount, physicalDeviceMemoryProperties.memoryHeapCount);
+    EXPECT_GE(budget.heapUsage[heapIndex], kBlockSize);
+    EXPECT_LE(budget.heapBudget[heapIndex], physicalDeviceMemoryProperties.memoryHeaps[heapIndex].size);
+
+    // 예산을 넘는 할당은 드라이버에 요청하지 않고 실패해야 한다.
+    VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .flags = VK_MEMORY_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = {
+            .size = budget.heapBudget[heapIndex],
+            .alignment = 256,
+            .memoryTypeBits = 1u << properties.memoryTypeIndex
+        },
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+    };
+
+    VkMemoryAllocation overBudgetAllocation = VK_NULL_HANDLE;
+    EXPECT_EQ(vkCreateMemoryAllocation(mMemoryAllocator, &memoryAllocationCreateInfo, &overBudgetAllocation),
+              VK_ERROR_OUT_OF_DEVICE_MEMORY);
+
+    VkMemoryAllocatorStatistics statistics;
+    vkGetMemoryAllocatorStatistics(mMemoryAllocator, &statistics);
+    EXPECT_EQ(statistics.deviceMemoryCount, 1);
+
+    vkDestroyMemoryAllocation(mMemoryAllocator, memoryAllocation);
+}
+
+TEST_P(VkMemoryAllocatorTest, preferredMemoryType) {
+    VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = {
+            .size = 100,
+            .alignment = 16,
+            .memoryTypeBits = UINT32_MAX
+        },
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .preferredMemoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT
+    };
+
+    VkMemoryAllocation memoryAllocation = VK_NULL_HANDLE;
+    ASSERT_EQ(vkCreateMemoryAllocation(mMemoryAllocator, &memoryAllocationCreateInfo, &memoryAllocation),
+              VK_SUCCESS);
+
+    VkMemoryAllocationProperties properties;
+    vkGetMemoryAllocationProperties(memoryAllocation, &properties);
+
+    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &physicalDeviceMemoryProperties);
+
+    // HOST_CACHED 타입이 있으면 그 타입을 선택해야 한다.
+    auto cachedMemoryType = false;
+    for (uint32_t i = 0; i != physicalDeviceMemoryProperties.memoryTypeCount; ++i) {
+        const auto flags = physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags;
+        cachedMemoryType |= (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+                            (flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    }
+
+    const auto flags = physicalDeviceMemoryProperties.memoryTypes[properties.memoryTypeIndex].propertyFlags;
+    EXPECT_EQ((flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT) != 0, cachedMemoryType);
+
+    // HOST_COHERENT가 아니면 플러시 범위를 넓힐 수 있도록 nonCoherentAtomSize에 맞춰져야 한다.
+    if (!(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(mPhysicalDevice, &physicalDeviceProperties);
+        EXPECT_EQ(properties.offset % physicalDeviceProperties.limits.nonCoherentAtomSize, 0);
+    }
+
+    memset(properties.pMappedData, 0xff, 100);
+    EXPECT_EQ(vkFlushMemoryAllocation(mMemoryAllocator, memoryAllocation, 10, 50), VK_SUCCESS);
+
+    vkDestroyMemoryAllocation(mMemoryAllocator, memoryAllocation);
+}
+
+INSTANTIATE_TEST_SUITE_P(VkMemoryAllocator,
+                         VkMemoryAllocatorTest,
+                         testing::Values(VK_MEMORY_ALLOCATOR_STRATEGY_FREE_LIST,
+                                         VK_MEMORY_ALLOCATOR_STRATEGY_LINEAR));
@@ -0,0 +1,456 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include "VkMesh.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+constexpr char kMeshIdentifier[4]{'P', 'V', 'M', 'S'};
+
+constexpr uint32_t kMeshVersion = 1;
+
+struct VkMeshFileHeader {
+    char identifier[4];
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+};
+static_assert(sizeof(VkMeshFileHeader) == 16);
+
+// 최적화에서 가정하는 Post-transform 정점 캐시의 크기로 실제 GPU의 캐시와 달라도 결과는 비슷하다.
+constexpr uint32_t kVertexCacheSize = 32;
+
+struct VkMeshImpl {
+    VkMeshProperties properties;
+    vector<Vertex> vertices;
+    vector<uint32_t> indices;
+    vector<uint16_t> shortIndices;
+};
+
+VkResult vkReadMesh(AAssetManager *pAssetManager,
+                    const char *pFileName,
+                    vector<Vertex> *pVertices,
+                    vector<uint32_t> *pIndices) {
+    auto pAsset = AAssetManager_open(pAssetManager, pFileName, AASSET_MODE_BUFFER);
+    if (!pAsset) {
+        return VK_ERROR_UNKNOWN;
+    }
+
+    auto result = VK_ERROR_FORMAT_NOT_SUPPORTED;
+    const auto pData = static_cast<const uint8_t *>(AAsset_getBuffer(pAsset));
+    const auto size = static_cast<size_t>(AAsset_getLength64(pAsset));
+
+    VkMeshFileHeader header;
+    if (pData && size >= sizeof(header)) {
+        memcpy(&header, pData, sizeof(header));
+
+        const auto vertexDataSize = static_cast<size_t>(header.vertexCount) * sizeof(Vertex);
+        const auto indexDataSize = static_cast<size_t>(header.indexCount) * sizeof(uint32_t);
+        if (!memcmp(header.identifier, kMeshIdentifier, sizeof(kMeshIdentifier)) &&
+            header.version == kMeshVersion &&
+            size >= sizeof(header) + vertexDataSize + indexDataSize) {
+            pVertices->resize(header.vertexCount);
+            memcpy(pVertices->data(), pData + sizeof(header), vertexDataSize);
+            pIndices->resize(header.indexCount);
+            memcpy(pIndices->data(), pData + sizeof(header) + vertexDataSize, indexDataSize);
+
+            const auto outOfRange = any_of(pIndices->begin(), pIndices->end(), [&](auto index) {
+                return index >= header.vertexCount;
+            });
+            result = outOfRange ? VK_ERROR_FORMAT_NOT_SUPPORTED : VK_SUCCESS;
+        }
+    }
+
+    AAsset_close(pAsset);
+    return result;
+}
+
+// 모든 바이트가 같은 정점을 하나로 합치고 인덱스를 다시 매긴다.
+void vkDeduplicateVertices(vector<Vertex> *pVertices, vector<uint32_t> *pIndices) {
+    struct VertexHash {
+        size_t operator()(const Vertex &vertex) const {
+            return vkHash(&vertex, sizeof(vertex));
+        }
+    };
+
+    struct VertexEqual {
+        bool operator()(const Vertex &lhs, const Vertex &rhs) const {
+            return !memcmp(&lhs, &rhs, sizeof(Vertex));
+        }
+    };
+
+    unordered_map<Vertex, uint32_t, VertexHash, VertexEqual> uniqueIndices;
+    vector<Vertex> uniqueVertices;
+    for (auto &index: *pIndices) {
+        const auto &vertex = (*pVertices)[index];
+        auto [iterator, inserted] = uniqueIndices.try_emplace(vertex, uniqueVertices.size());
+        if (inserted) {
+            uniqueVertices.push_back(vertex);
+        }
+        index = iterator->second;
+    }
+
+    *pVertices = move(uniqueVertices);
+}
+
+// Tom Forsyth의 "Linear-Speed Vertex Cache Optimisation"에서 사용하는 정점 점수이다.
+float vkScoreVertex(uint32_t cachePosition, uint32_t activeTriangleCount) {
+    if (!activeTriangleCount) {
+        return -1.0f;
+    }
+
+    auto score = 0.0f;
+    if (cachePosition < 3) {
+        // 직전 삼각형의 정점은 바로 이어서 사용하면 같은 삼각형을 다시 그리는 것과 비슷하므로 낮게 둔다.
+        score = 0.75f;
+    } else if (cachePosition < kVertexCacheSize) {
+        score = powf(1.0f - static_cast<float>(cachePosition - 3) / (kVertexCacheSize - 3), 1.5f);
+    }
+
+    // 남은 삼각형이 적은 정점을 먼저 끝내서 고립된 삼각형이 남지 않게 한다.
+    return score + 2.0f * powf(static_cast<float>(activeTriangleCount), -0.5f);
+}
+
+void vkOptimizeVertexCache(uint32_t vertexCount, vector<uint32_t> *pIndices) {
+    const auto &indices = *pIndices;
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+    // 정점마다 아직 그리지 않은 삼각형 목록을 만든다.
+    vector<uint32_t> activeTriangleCounts(vertexCount, 0);
+    for (auto index: indices) {
+        ++activeTriangleCounts[index];
+    }
+
+    vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+    partial_sum(activeTriangleCounts.begin(), activeTriangleCounts.end(), triangleOffsets.begin() + 1);
+
+    vector<uint32_t> vertexTriangles(indices.size());
+    vector<uint32_t> triangleCursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+    for (uint32_t i = 0; i != indices.size(); ++i) {
+        vertexTriangles[triangleCursors[indices[i]]++] = i / 3;
+    }
+
+    vector<uint32_t> cachePositions(vertexCount, UINT32_MAX);
+    vector<float> vertexScores(vertexCount);
+    for (uint32_t i = 0; i != vertexCount; ++i) {
+        vertexScores[i] = vkScoreVertex(UINT32_MAX, activeTriangleCounts[i]);
+    }
+
+    auto scoreTriangle = [&](uint32_t triangle) {
+        return vertexScores[indices[triangle * 3]] +
+               vertexScores[indices[triangle * 3 + 1]] +
+               vertexScores[indices[triangle * 3 + 2]];
+    };
+
+    uint32_t bestTriangle = UINT32_MAX;
+    auto bestScore = -1.0f;
+    for (uint32_t i = 0; i != triangleCount; ++i) {
+        if (const auto score = scoreTriangle(i); score > bestScore) {
+            bestTriangle = i;
+            bestScore = score;
+        }
+    }
+
+    vector<bool> emitted(triangleCount, false);
+    vector<uint32_t> cache;
+    vector<uint32_t> nextCache;
+    vector<uint32_t> optimizedIndices;
+    optimizedIndices.reserve(indices.size());
+    uint32_t searchCursor = 0;
+
+    while (bestTriangle != UINT32_MAX) {
+        // 고른 삼각형을 출력하고 정점마다의 삼각형 목록에서 제거한다.
+        emitted[bestTriangle] = true;
+        const auto *triangleIndices = &indices[bestTriangle * 3];
+
+        nextCache.clear();
+        for (uint32_t i = 0; i != 3; ++i) {
+            const auto index = triangleIndices[i];
+            optimizedIndices.push_back(index);
+            nextCache.push_back(index);
+
+            const auto first = vertexTriangles.begin() + triangleOffsets[index];
+            const auto last = first + activeTriangleCounts[index];
+            iter_swap(find(first, last, bestTriangle), last - 1);
+            --activeTriangleCounts[index];
+        }
+
+        // 사용한 정점을 캐시의 앞에 두는 LRU 캐시로 가정한다.
+        for (auto index: cache) {
+            if (index != triangleIndices[0] && index != triangleIndices[1] && index != triangleIndices[2]) {
+                nextCache.push_back(index);
+            }
+        }
+
+        for (uint32_t i = 0; i != nextCache.size(); ++i) {
+            const auto index = nextCache[i];
+            cachePositions[index] = i < kVertexCacheSize ? i : UINT32_MAX;
+            vertexScores[index] = vkScoreVertex(cachePositions[index], activeTriangleCounts[index]);
+        }
+
+        // 점수가 바뀐 정점을 사용하는 삼각형 중에서 다음 삼각형을 고른다.
+        bestTriangle = UINT32_MAX;
+        bestScore = -1.0f;
+        for (auto index: nextCache) {
+            const auto first = vertexTriangles.begin() + triangleOffsets[index];
+            const auto last = first + activeTriangleCounts[index];
+            for (auto iterator = first; iterator != last; ++iterator) {
+                if (const auto score = scoreTriangle(*iterator); score > bestScore) {
+                    bestTriangle = *iterator;
+                    bestScore = score;
+                }
+            }
+        }
+
+        if (nextCache.size() > kVertexCacheSize) {
+            nextCache.resize(kVertexCacheSize);
+        }
+        swap(cache, nextCache);
+
+        // 캐시의 정점으로 이어지는 삼각형이 없으면 남은 삼각형 중에서 순서대로 고른다.
+        if (bestTriangle == UINT32_MAX) {
+            while (searchCursor != triangleCount && emitted[searchCursor]) {
+                ++searchCursor;
+            }
+            bestTriangle = searchCursor != triangleCount ? searchCursor : UINT32_MAX;
+        }
+    }
+
+    *pIndices = move(optimizedIndices);
+}
+
+// 세 정점이 모두 캐시에 없는 삼각형에서 묶음을 나누고 묶음 안의 순서는 유지하므로
+// 캐시 적중률은 거의 바뀌지 않는다. 묶음은 메시의 중심에서 바깥쪽을 향하는 순서로 그려서
+// 볼록한 부분이 먼저 깊이를 채우게 한다.
+void vkOptimizeOverdraw(const vector<Vertex> &vertices, vector<uint32_t> *pIndices) {
+    const auto &indices = *pIndices;
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+    // 마지막으로 캐시에 들어온 시점을 기록해서 FIFO 캐시를 시뮬레이션한다.
+    vector<uint32_t> cacheTimestamps(vertices.size(), 0);
+    auto timestamp = kVertexCacheSize + 1;
+
+    vector<uint32_t> clusterOffsets;
+    for (uint32_t i = 0; i != triangleCount; ++i) {
+        uint32_t missCount = 0;
+        for (uint32_t j = 0; j != 3; ++j) {
+            const auto index = indices[i * 3 + j];
+            if (timestamp - cacheTimestamps[index] > kVertexCacheSize) {
+                cacheTimestamps[index] = timestamp++;
+                ++missCount;
+            }
+        }
+
+        if (missCount == 3) {
+            clusterOffsets.push_back(i);
+        }
+    }
+    clusterOffsets.push_back(triangleCount);
+
+    Vector3 meshCenter{};
+    for (const auto &vertex: vertices) {
+        meshCenter.x += vertex.position.x / vertices.size();
+        meshCenter.y += vertex.position.y / vertices.size();
+        meshCenter.z += vertex.position.z / vertices.size();
+    }
+
+    struct Cluster {
+        float sortKey;
+        uint32_t firstTriangle;
+        uint32_t lastTriangle;
+    };
+
+    vector<Cluster> clusters;
+    for (uint32_t i = 0; i + 1 < clusterOffsets.size(); ++i) {
+        // 넓이로 가중한 묶음의 중심과 법선을 구한다. 외적의 크기는 넓이의 두 배이다.
+        Vector3 center{};
+        Vector3 normal{};
+        auto area = 0.0f;
+        for (auto triangle = clusterOffsets[i]; triangle != clusterOffsets[i + 1]; ++triangle) {
+            const auto &p0 = vertices[indices[triangle * 3]].position;
+            const auto &p1 = vertices[indices[triangle * 3 + 1]].position;
+            const auto &p2 = vertices[indices[triangle * 3 + 2]].position;
+
+            const Vector3 e0{p1.x - p0.x, p1.y - p0.y, p1.z - p0.z};
+            const Vector3 e1{p2.x - p0.x, p2.y - p0.y, p2.z - p0.z};
+            const Vector3 n{e0.y * e1.z - e0.z * e1.y, e0.z * e1.x - e0.x * e1.z, e0.x * e1.y - e0.y * e1.x};
+            const auto triangleArea = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+
+            center.x += triangleArea * (p0.x + p1.x + p2.x) / 3.0f;
+            center.y += triangleArea * (p0.y + p1.y + p2.y) / 3.0f;
+            center.z += triangleArea * (p0.z + p1.z + p2.z) / 3.0f;
+            normal.x += n.x;
+            normal.y += n.y;
+            normal.z += n.z;
+            area += triangleArea;
+        }
+
+        const auto normalLength = sqrtf(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        auto sortKey = 0.0f;
+        if (area > 0.0f && normalLength > 0.0f) {
+            sortKey = ((center.x / area - meshCenter.x) * normal.x +
+                       (center.y / area - meshCenter.y) * normal.y +
+                       (center.z / area - meshCenter.z) * normal.z) / normalLength;
+        }
+
+        clusters.push_back({sortKey, clusterOffsets[i], clusterOffsets[i + 1]});
+    }
+
+    stable_sort(clusters.begin(), clusters.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.sortKey > rhs.sortKey;
+    });
+
+    vector<uint32_t> optimizedIndices;
+    optimizedIndices.reserve(indices.size());
+    for (const auto &cluster: clusters) {
+        optimizedIndices.insert(optimizedIndices.end(),
+                                indices.begin() + cluster.firstTriangle * 3,
+                                indices.begin() + cluster.lastTriangle * 3);
+    }
+
+    *pIndices = move(optimizedIndices);
+}
+
+// 정점을 처음 사용되는 순서로 다시 배치해서 정점을 읽을 때 메모리를 순서대로 접근하게 한다.
+void vkOptimizeVertexFetch(vector<Vertex> *pVertices, vector<uint32_t> *pIndices) {
+    vector<uint32_t> remap(pVertices->size(), UINT32_MAX);
+    vector<Vertex> vertices;
+    vertices.reserve(pVertices->size());
+    for (auto &index: *pIndices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = vertices.size();
+            vertices.push_back((*pVertices)[index]);
+        }
+        index = remap[index];
+    }
+
+    *pVertices = move(vertices);
+}
+
+}
+
+VkResult vkCreateMesh(
+    VkDevice                                    device,
+    const VkMeshCreateInfo*                     pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkMesh*                                     pMesh) {
+    auto pImpl = make_unique<VkMeshImpl>();
+    auto &vertices = pImpl->vertices;
+    auto &indices = pImpl->indices;
+
+    // ================================================================================
+    // 1. 정점과 인덱스 읽기
+    // ================================================================================
+    if (pCreateInfo->pFileName) {
+        if (auto result = vkReadMesh(pCreateInfo->pAssetManager, pCreateInfo->pFileName, &vertices, &indices);
+            result != VK_SUCCESS) {
+            return result;
+        }
+    } else {
+        vertices.assign(pCreateInfo->pVertices, pCreateInfo->pVertices + pCreateInfo->vertexCount);
+    }
+
+    if (indices.empty()) {
+        indices.resize(vertices.size());
+        iota(indices.begin(), indices.end(), 0);
+    }
+
+    if (indices.size() % 3) {
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
+
+    // ================================================================================
+    // 2. 중복된 정점 합치기
+    // ================================================================================
+    vkDeduplicateVertices(&vertices, &indices);
+
+    // ================================================================================
+    // 3. 삼각형 순서 최적화
+    // ================================================================================
+    // 오버드로 최적화는 정점 캐시 최적화로 만들어진 묶음을 사용하므로 나중에 한다.
+    if (pCreateInfo->flags & VK_MESH_CREATE_OPTIMIZE_VERTEX_CACHE_BIT) {
+        vkOptimizeVertexCache(vertices.size(), &indices);
+    }
+
+    if (pCreateInfo->flags & VK_MESH_CREATE_OPTIMIZE_OVERDRAW_BIT) {
+        vkOptimizeOverdraw(vertices, &indices);
+    }
+
+    // ================================================================================
+    // 4. 정점 순서 최적화
+    // ================================================================================
+    vkOptimizeVertexFetch(&vertices, &indices);
+
+    // ================================================================================
+    // 5. 인덱스 타입 결정
+    // ================================================================================
+    auto &properties = pImpl->properties;
+    properties = {
+        .vertexCount = static_cast<uint32_t>(vertices.size()),
+        .pVertices = vertices.data(),
+        .indexCount = static_cast<uint32_t>(indices.size())
+    };
+
+    if (vertices.size() <= UINT16_MAX + 1) {
+        pImpl->shortIndices.assign(indices.begin(), indices.end());
+        properties.indexType = VK_INDEX_TYPE_UINT16;
+        properties.indexDataSize = pImpl->shortIndices.size() * sizeof(uint16_t);
+        properties.pIndexData = pImpl->shortIndices.data();
+    } else {
+        properties.indexType = VK_INDEX_TYPE_UINT32;
+        properties.indexDataSize = indices.size() * sizeof(uint32_t);
+        properties.pIndexData = indices.data();
+    }
+
+    for (const auto &vertex: vertices) {
+        properties.extent.x = max(properties.extent.x, fabsf(vertex.position.x));
+        properties.extent.y = max(properties.extent.y, fabsf(vertex.position.y));
+        properties.extent.z = max(properties.extent.z, fabsf(vertex.position.z));
+    }
+
+    *pMesh = reinterpret_cast<VkMesh>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyMesh(
+    VkDevice                                    device,
+    VkMesh                                      mesh,
+    const VkAllocationCallbacks*                pAllocator) {
+    delete reinterpret_cast<VkMeshImpl*>(mesh);
+}
+
+void vkGetMeshProperties(
+    VkMesh                                      mesh,
+    VkMeshProperties*                           pMeshProperties) {
+    *pMeshProperties = reinterpret_cast<VkMeshImpl*>(mesh)->properties;
+}
@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKMESH_H
+#define PRACTICE_VULKAN_VKMESH_H
+
+#include <game-activity/GameActivity.h>
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+struct Vector2 {
+    union {
+        float x;
+        float r;
+        float u;
+    };
+
+    union {
+        float y;
+        float g;
+        float v;
+    };
+};
+
+struct Vector3 {
+    union {
+        float x;
+        float r;
+        float u;
+    };
+
+    union {
+        float y;
+        float g;
+        float v;
+    };
+
+    union {
+        float z;
+        float b;
+        float w;
+    };
+};
+
+struct Vertex {
+    Vector3 position;
+    Vector3 color;
+    Vector2 uv;
+};
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkMesh)
+
+typedef enum VkMeshCreateFlagBits {
+    // 삼각형 순서를 바꿔서 Post-transform 정점 캐시의 적중률을 높인다.
+    VK_MESH_CREATE_OPTIMIZE_VERTEX_CACHE_BIT = 0x00000001,
+    // 캐시 적중률을 유지하는 삼각형 묶음 단위로 바깥쪽을 향하는 묶음을 먼저 그려서 오버드로를 줄인다.
+    VK_MESH_CREATE_OPTIMIZE_OVERDRAW_BIT = 0x00000002
+} VkMeshCreateFlagBits;
+typedef VkFlags VkMeshCreateFlags;
+
+typedef struct VkMeshCreateInfo {
+    VkStructureTypeEXT    sType;
+    const void*           pNext;
+    VkMeshCreateFlags     flags;
+    AAssetManager*        pAssetManager;
+    // 에셋은 "PVMS" 식별자, 버전(1), 정점 개수, 인덱스 개수(모두 uint32_t) 뒤에
+    // Vertex 배열과 uint32_t 인덱스 배열이 이어진다. 인덱스 개수가 0이면 정점은 삼각형 목록이다.
+    // nullptr이면 에셋 대신 pVertices를 삼각형 목록으로 사용한다.
+    const char*           pFileName;
+    uint32_t              vertexCount;
+    const Vertex*         pVertices;
+} VkMeshCreateInfo;
+
+typedef struct VkMeshProperties {
+    // 중복된 정점은 합쳐지고 처음 사용되는 순서로 정렬된다.
+    uint32_t              vertexCount;
+    const Vertex*         pVertices;
+    // 정점이 65536개 이하면 VK_INDEX_TYPE_UINT16을 사용한다.
+    VkIndexType           indexType;
+    uint32_t              indexCount;
+    VkDeviceSize          indexDataSize;
+    const void*           pIndexData;
+    // 원점에서 정점 위치까지의 축마다의 최대 거리.
+    Vector3               extent;
+} VkMeshProperties;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateMesh(
+    VkDevice                                    device,
+    const VkMeshCreateInfo*                     pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkMesh*                                     pMesh);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyMesh(
+    VkDevice                                    device,
+    VkMesh                                      mesh,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR void VKAPI_CALL vkGetMeshProperties(
+    VkMesh                                      mesh,
+    VkMeshProperties*                           pMeshProperties);
+
+#endif //PRACTICE_VULKAN_VKMESH_H
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "VkMesh.h"
+
+namespace {
+
+std::vector<uint32_t> getIndices(const VkMeshProperties &properties) {
+    std::vector<uint32_t> indices(properties.indexCount);
+    for (uint32_t i = 0; i != properties.indexCount; ++i) {
+        indices[i] = properties.indexType == VK_INDEX_TYPE_UINT16 ?
+                     static_cast<const uint16_t *>(properties.pIndexData)[i] :
+                     static_cast<const uint32_t *>(properties.pIndexData)[i];
+    }
+    return indices;
+}
+
+// 16개의 정점을 가진 FIFO 캐시에서 삼각형마다 평균 캐시 미스 횟수를 구한다.
+float getAverageCacheMissRatio(const std::vector<uint32_t> &indices, uint32_t vertexCount) {
+    std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+    uint32_t timestamp = 17;
+    uint32_t missCount = 0;
+    for (auto index: indices) {
+        if (timestamp - cacheTimestamps[index] > 16) {
+            cacheTimestamps[index] = timestamp++;
+            ++missCount;
+        }
+    }
+    return static_cast<float>(missCount) / (indices.size() / 3);
+}
+
+// 삼각형을 감는 방향을 유지하면서 가장 작은 정점이 앞에 오도록 돌린 위치 목록을 만든다.
+std::vector<std::array<float, 9>> getTriangles(const VkMeshProperties &properties) {
+    const auto indices = getIndices(properties);
+    std::vector<std::array<float, 9>> triangles;
+    for (uint32_t i = 0; i != indices.size(); i += 3) {
+        std::array<std::array<float, 3>, 3> positions;
+        for (uint32_t j = 0; j != 3; ++j) {
+            const auto &position = properties.pVertices[indices[i + j]].position;
+            positions[j] = {position.x, position.y, position.z};
+        }
+        std::rotate(positions.begin(), std::min_element(positions.begin(), positions.end()), positions.end());
+
+        std::array<float, 9> triangle;
+        for (uint32_t j = 0; j != 3; ++j) {
+            std::copy(positions[j].begin(), positions[j].end(), triangle.begin() + j * 3);
+        }
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+}
+
+TEST(VkMeshTest, deduplicate) {
+    const std::array<Vertex, 6> vertices{
+        Vertex{.position{-0.5, -0.5, 0.0}, .uv{0.0, 0.0}},
+        Vertex{.position{0.5, -0.5, 0.0}, .uv{1.0, 0.0}},
+        Vertex{.position{0.5, 0.5, 0.0}, .uv{1.0, 1.0}},
+        Vertex{.position{-0.5, -0.5, 0.0}, .uv{0.0, 0.0}},
+        Vertex{.position{0.5, 0.5, 0.0}, .uv{1.0, 1.0}},
+        Vertex{.position{-0.5, 0.5, 0.0}, .uv{0.0, 1.0}}
+    };
+
+    VkMeshCreateInfo meshCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MESH_CREATE_INFO,
+        .vertexCount = vertices.size(),
+        .pVertices = vertices.data()
+    };
+
+    VkMesh mesh;
+    ASSERT_EQ(vkCreateMesh(VK_NULL_HANDLE, &meshCreateInfo, nullptr, &mesh), VK_SUCCESS);
+
+    VkMeshProperties properties;
+    vkGetMeshProperties(mesh, &properties);
+    EXPECT_EQ(properties.vertexCount, 4);
+    EXPECT_EQ(properties.indexType, VK_INDEX_TYPE_UINT16);
+    EXPECT_EQ(properties.indexCount, vertices.size());
+    EXPECT_EQ(properties.indexDataSize, vertices.size() * sizeof(uint16_t));
+    EXPECT_FLOAT_EQ(properties.extent.x, 0.5f);
+    EXPECT_FLOAT_EQ(properties.extent.y, 0.5f);
+
+    const auto indices = getIndices(properties);
+    for (uint32_t i = 0; i != indices.size(); ++i) {
+        EXPECT_EQ(memcmp(&properties.pVertices[indices[i]], &vertices[i], sizeof(Vertex)), 0);
+    }
+
+    vkDestroyMesh(VK_NULL_HANDLE, mesh, nullptr);
+}
+
+TEST(VkMeshTest, optimize) {
+    // 삼각형 순서를 섞은 격자로 캐시 최적화 전후의 결과를 비교한다.
+    constexpr uint32_t gridSize = 32;
+    std::vector<Vertex> vertices;
+    for (uint32_t y = 0; y != gridSize; ++y) {
+        for (uint32_t x = 0; x != gridSize; ++x) {
+            auto vertex = [&](uint32_t i, uint32_t j) {
+                return Vertex{.position{static_cast<float>(i) / gridSize, static_cast<float>(j) / gridSize, 0.0f}};
+            };
+            for (const auto &quadVertex: {vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1),
+                                          vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1)}) {
+                vertices.push_back(quadVertex);
+            }
+        }
+    }
+
+    std::vector<std::array<Vertex, 3>> triangles(vertices.size() / 3);
+    memcpy(triangles.data(), vertices.data(), vertices.size() * sizeof(Vertex));
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(0));
+    memcpy(vertices.data(), triangles.data(), vertices.size() * sizeof(Vertex));
+
+    VkMeshCreateInfo meshCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MESH_CREATE_INFO,
+        .vertexCount = static_cast<uint32_t>(vertices.size()),
+        .pVertices = vertices.data()
+    };
+
+    VkMesh mesh;
+    ASSERT_EQ(vkCreateMesh(VK_NULL_HANDLE, &meshCreateInfo, nullptr, &mesh), VK_SUCCESS);
+
+    meshCreateInfo.flags = VK_MESH_CREATE_OPTIMIZE_VERTEX_CACHE_BIT | VK_MESH_CREATE_OPTIMIZE_OVERDRAW_BIT;
+    VkMesh optimizedMesh;
+    ASSERT_EQ(vkCreateMesh(VK_NULL_HANDLE, &meshCreateInfo, nullptr, &optimizedMesh), VK_SUCCESS);
+
+    VkMeshProperties properties;
+    vkGetMeshProperties(mesh, &properties);
+    VkMeshProperties optimizedProperties;
+    vkGetMeshProperties(optimizedMesh, &optimizedProperties);
+
+    EXPECT_EQ(optimizedProperties.vertexCount, (gridSize + 1) * (gridSize + 1));
+    EXPECT_EQ(getTriangles(optimizedProperties), getTriangles(properties));
+    EXPECT_LT(getAverageCacheMissRatio(getIndices(optimizedProperties), optimizedProperties.vertexCount),
+              getAverageCacheMissRatio(getIndices(properties), properties.vertexCount) * 0.5f);
+
+    vkDestroyMesh(VK_NULL_HANDLE, optimizedMesh, nullptr);
+    vkDestroyMesh(VK_NULL_HANDLE, mesh, nullptr);
+}
@@ -0,0 +1,213 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <memory>
+#include <dlfcn.h>
+#include <android/performance_hint.h>
+#include <android/thermal.h>
+
+#include "VkPerformanceHint.h"
+
+using namespace std;
+
+namespace {
+
+typedef APerformanceHintManager *(*PFN_APerformanceHint_getManager)();
+typedef APerformanceHintSession *(*PFN_APerformanceHint_createSession)(APerformanceHintManager *,
+                                                                        const int32_t *,
+                                                                        size_t,
+                                                                        int64_t);
+typedef int (*PFN_APerformanceHint_updateTargetWorkDuration)(APerformanceHintSession *, int64_t);
+typedef int (*PFN_APerformanceHint_reportActualWorkDuration)(APerformanceHintSession *, int64_t);
+typedef void (*PFN_APerformanceHint_closeSession)(APerformanceHintSession *);
+typedef AThermalManager *(*PFN_AThermal_acquireManager)();
+typedef void (*PFN_AThermal_releaseManager)(AThermalManager *);
+typedef AThermalStatus (*PFN_AThermal_getCurrentThermalStatus)(AThermalManager *);
+typedef int (*PFN_AThermal_registerThermalStatusListener)(AThermalManager *, AThermal_StatusCallback, void *);
+typedef int (*PFN_AThermal_unregisterThermalStatusListener)(AThermalManager *, AThermal_StatusCallback, void *);
+
+struct VkPerformanceHintImpl {
+    void *pLibrary;
+    PFN_APerformanceHint_updateTargetWorkDuration pfnUpdateTargetWorkDuration;
+    PFN_APerformanceHint_reportActualWorkDuration pfnReportActualWorkDuration;
+    PFN_APerformanceHint_closeSession pfnCloseSession;
+    PFN_AThermal_releaseManager pfnReleaseManager;
+    PFN_AThermal_unregisterThermalStatusListener pfnUnregisterThermalStatusListener;
+    APerformanceHintSession *pSession;
+    uint64_t targetWorkDuration;
+    AThermalManager *pThermalManager;
+    // 리스너는 바인더 스레드에서 호출된다.
+    atomic<int32_t> thermalStatus;
+};
+
+template<typename T>
+T vkGetLibrarySymbol(void *pLibrary, const char *pName) {
+    return reinterpret_cast<T>(dlsym(pLibrary, pName));
+}
+
+void vkThermalStatusCallback(void *pData, AThermalStatus status) {
+    auto pImpl = static_cast<VkPerformanceHintImpl *>(pData);
+    pImpl->thermalStatus = status;
+}
+
+}
+
+VkResult vkCreatePerformanceHint(
+    const VkPerformanceHintCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPerformanceHint*                          pPerformanceHint) {
+    auto pImpl = make_unique<VkPerformanceHintImpl>();
+    pImpl->pLibrary = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    pImpl->pSession = nullptr;
+    pImpl->targetWorkDuration = pCreateInfo->targetWorkDuration;
+    pImpl->pThermalManager = nullptr;
+    pImpl->thermalStatus = ATHERMAL_STATUS_NONE;
+
+    if (pImpl->pLibrary) {
+        // ================================================================================
+        // 1. APerformanceHintSession 생성
+        // ================================================================================
+        // Android 13 미만이거나 기기가 지원하지 않으면 함수나 관리자가 없다.
+        auto pfnGetManager = vkGetLibrarySymbol<PFN_APerformanceHint_getManager>(
+                pImpl->pLibrary, "APerformanceHint_getManager");
+        auto pfnCreateSession = vkGetLibrarySymbol<PFN_APerformanceHint_createSession>(
+                pImpl->pLibrary, "APerformanceHint_createSession");
+        pImpl->pfnUpdateTargetWorkDuration = vkGetLibrarySymbol<PFN_APerformanceHint_updateTargetWorkDuration>(
+                pImpl->pLibrary, "APerformanceHint_updateTargetWorkDuration");
+        pImpl->pfnReportActualWorkDuration = vkGetLibrarySymbol<PFN_APerformanceHint_reportActualWorkDuration>(
+                pImpl->pLibrary, "APerformanceHint_reportActualWorkDuration");
+        pImpl->pfnCloseSession = vkGetLibrarySymbol<PFN_APerformanceHint_closeSession>(
+                pImpl->pLibrary, "APerformanceHint_closeSession");
+
+        if (pfnGetManager && pfnCreateSession && pImpl->pfnUpdateTargetWorkDuration &&
+            pImpl->pfnReportActualWorkDuration && pImpl->pfnCloseSession) {
+            if (auto pManager = pfnGetManager()) {
+                pImpl->pSession = pfnCreateSession(pManager,
+                                                   pCreateInfo->pThreadIds,
+                                                   pCreateInfo->threadIdCount,
+                                                   static_cast<int64_t>(pCreateInfo->targetWorkDuration));
+            }
+        }
+
+        // ================================================================================
+        // 2. 열 상태 리스너 등록
+        // ================================================================================
+        // 매 프레임 바인더를 호출하지 않도록 현재 상태를 한번 읽고 이후에는 리스너로 받는다.
+        auto pfnAcquireManager = vkGetLibrarySymbol<PFN_AThermal_acquireManager>(
+                pImpl->pLibrary, "AThermal_acquireManager");
+        auto pfnGetCurrentThermalStatus = vkGetLibrarySymbol<PFN_AThermal_getCurrentThermalStatus>(
+                pImpl->pLibrary, "AThermal_getCurrentThermalStatus");
+        auto pfnRegisterThermalStatusListener = vkGetLibrarySymbol<PFN_AThermal_registerThermalStatusListener>(
+                pImpl->pLibrary, "AThermal_registerThermalStatusListener");
+        pImpl->pfnReleaseManager = vkGetLibrarySymbol<PFN_AThermal_releaseManager>(
+                pImpl->pLibrary, "AThermal_releaseManager");
+        pImpl->pfnUnregisterThermalStatusListener = vkGetLibrarySymbol<PFN_AThermal_unregisterThermalStatusListener>(
+                pImpl->pLibrary, "AThermal_unregisterThermalStatusListener");
+
+        if (pfnAcquireManager && pfnGetCurrentThermalStatus && pfnRegisterThermalStatusListener &&
+            pImpl->pfnReleaseManager && pImpl->pfnUnregisterThermalStatusListener) {
+            pImpl->pThermalManager = pfnAcquireManager();
+        }
+
+        if (pImpl->pThermalManager) {
+            pImpl->thermalStatus = pfnGetCurrentThermalStatus(pImpl->pThermalManager);
+            if (pfnRegisterThermalStatusListener(pImpl->pThermalManager,
+                                                 vkThermalStatusCallback,
+                                                 pImpl.get())) {
+                pImpl->pfnReleaseManager(pImpl->pThermalManager);
+                pImpl->pThermalManager = nullptr;
+                pImpl->thermalStatus = ATHERMAL_STATUS_NONE;
+            }
+        }
+    }
+
+    *pPerformanceHint = reinterpret_cast<VkPerformanceHint>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyPerformanceHint(
+    VkPerformanceHint                           performanceHint,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkPerformanceHintImpl*>(performanceHint);
+
+    // 등록을 해제하면 리스너가 더 이상 호출되지 않는다.
+    if (pImpl->pThermalManager) {
+        pImpl->pfnUnregisterThermalStatusListener(pImpl->pThermalManager, vkThermalStatusCallback, pImpl);
+        pImpl->pfnReleaseManager(pImpl->pThermalManager);
+    }
+    if (pImpl->pSession) {
+        pImpl->pfnCloseSession(pImpl->pSession);
+    }
+    if (pImpl->pLibrary) {
+        dlclose(pImpl->pLibrary);
+    }
+    delete pImpl;
+}
+
+void vkGetPerformanceHintProperties(
+    VkPerformanceHint                           performanceHint,
+    VkPerformanceHintProperties*                pProperties) {
+    auto pImpl = reinterpret_cast<VkPerformanceHintImpl*>(performanceHint);
+
+    *pProperties = {
+        .performanceHint = pImpl->pSession != nullptr,
+        .thermalStatus = pImpl->pThermalManager != nullptr
+    };
+}
+
+VkResult vkUpdatePerformanceHintTargetDuration(
+    VkPerformanceHint                           performanceHint,
+    uint64_t                                    targetWorkDuration) {
+    auto pImpl = reinterpret_cast<VkPerformanceHintImpl*>(performanceHint);
+
+    if (!pImpl->pSession || pImpl->targetWorkDuration == targetWorkDuration) {
+        return VK_SUCCESS;
+    }
+
+    pImpl->targetWorkDuration = targetWorkDuration;
+    return pImpl->pfnUpdateTargetWorkDuration(pImpl->pSession, static_cast<int64_t>(targetWorkDuration)) ?
+           VK_ERROR_UNKNOWN : VK_SUCCESS;
+}
+
+VkResult vkReportPerformanceHintWorkDuration(
+    VkPerformanceHint                           performanceHint,
+    uint64_t                                    actualWorkDuration) {
+    auto pImpl = reinterpret_cast<VkPerformanceHintImpl*>(performanceHint);
+
+    // 0 이하의 시간은 세션이 거부한다.
+    if (!pImpl->pSession || !actualWorkDuration) {
+        return VK_SUCCESS;
+    }
+
+    return pImpl->pfnReportActualWorkDuration(pImpl->pSession, static_cast<int64_t>(actualWorkDuration)) ?
+           VK_ERROR_UNKNOWN : VK_SUCCESS;
+}
+
+VkThermalStatus vkGetPerformanceHintThermalStatus(
+    VkPerformanceHint                           performanceHint) {
+    auto pImpl = reinterpret_cast<VkPerformanceHintImpl*>(performanceHint);
+
+    const auto thermalStatus = pImpl->thermalStatus.load();
+    return thermalStatus > ATHERMAL_STATUS_NONE ? static_cast<VkThermalStatus>(thermalStatus)
+                                                : VK_THERMAL_STATUS_NONE;
+}
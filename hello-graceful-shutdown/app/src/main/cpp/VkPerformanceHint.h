@@ -0,0 +1,91 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKPERFORMANCEHINT_H
+#define PRACTICE_VULKAN_VKPERFORMANCEHINT_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkPerformanceHint)
+
+// AThermalStatus와 같은 값이며 상태를 알 수 없으면 NONE으로 취급한다.
+typedef enum VkThermalStatus {
+    VK_THERMAL_STATUS_NONE = 0,
+    VK_THERMAL_STATUS_LIGHT = 1,
+    VK_THERMAL_STATUS_MODERATE = 2,
+    VK_THERMAL_STATUS_SEVERE = 3,
+    VK_THERMAL_STATUS_CRITICAL = 4,
+    VK_THERMAL_STATUS_EMERGENCY = 5,
+    VK_THERMAL_STATUS_SHUTDOWN = 6,
+    VK_THERMAL_STATUS_MAX_ENUM = 0x7FFFFFFF
+} VkThermalStatus;
+
+typedef struct VkPerformanceHintCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // APerformanceHintSession에 포함할 스레드로 작업 시간을 보고하는 스레드를 포함해야 한다.
+    uint32_t                         threadIdCount;
+    const int32_t*                   pThreadIds;
+    // 나노초 단위의 목표 작업 시간으로 보통 한 프레임의 시간이다.
+    uint64_t                         targetWorkDuration;
+} VkPerformanceHintCreateInfo;
+
+typedef struct VkPerformanceHintProperties {
+    // Android 13 이상에서 APerformanceHintSession을 만들었으면 VK_TRUE다.
+    VkBool32                         performanceHint;
+    // Android 11 이상에서 열 상태를 받을 수 있으면 VK_TRUE다.
+    VkBool32                         thermalStatus;
+} VkPerformanceHintProperties;
+
+// 최소 API 레벨을 올리지 않도록 libandroid.so의 함수를 실행 중에 찾으며,
+// 지원하지 않는 기능은 아무것도 하지 않으므로 항상 만들 수 있다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreatePerformanceHint(
+    const VkPerformanceHintCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPerformanceHint*                          pPerformanceHint);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyPerformanceHint(
+    VkPerformanceHint                           performanceHint,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR void VKAPI_CALL vkGetPerformanceHintProperties(
+    VkPerformanceHint                           performanceHint,
+    VkPerformanceHintProperties*                pProperties);
+
+// 값이 바뀔 때만 세션에 전달하므로 프레임마다 호출해도 된다.
+VKAPI_ATTR VkResult VKAPI_CALL vkUpdatePerformanceHintTargetDuration(
+    VkPerformanceHint                           performanceHint,
+    uint64_t                                    targetWorkDuration);
+
+// 기다리는 시간을 제외한 실제 CPU 작업 시간을 나노초 단위로 보고한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkReportPerformanceHintWorkDuration(
+    VkPerformanceHint                           performanceHint,
+    uint64_t                                    actualWorkDuration);
+
+// 열 상태 변경은 리스너로 받아 두므로 어느 스레드에서든 매 프레임 호출해도 된다.
+VKAPI_ATTR VkThermalStatus VKAPI_CALL vkGetPerformanceHintThermalStatus(
+    VkPerformanceHint                           performanceHint);
+
+#endif //PRACTICE_VULKAN_VKPERFORMANCEHINT_H
@@ -0,0 +1,191 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "VkPipelineCompiler.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+enum VkPipelineCompileState {
+    VK_PIPELINE_COMPILE_STATE_QUEUED,
+    VK_PIPELINE_COMPILE_STATE_COMPILING,
+    VK_PIPELINE_COMPILE_STATE_COMPLETE
+};
+
+struct VkPipelineCompilerImpl;
+
+struct VkPipelineCompileImpl {
+    VkPipelineCompilerImpl *pCompiler;
+    PFN_vkCreatePipelineFunction pfnCreatePipeline;
+    void *pUserData;
+    VkPipelineCompileState state;
+    VkResult result;
+    // 가져가면 VK_NULL_HANDLE이 되며 남아 있으면 VkPipelineCompile과 함께 파괴한다.
+    VkPipeline pipeline;
+};
+
+struct VkPipelineCompilerImpl {
+    VkDevice device;
+    mutex lock;
+    // 워커 스레드는 새 컴파일을 기다리고 컴파일을 파괴하는 스레드는 컴파일이 끝나기를 기다린다.
+    // 하나를 공유하면 notify_one이 깨워야 할 워커 대신 다른 스레드를 깨울 수 있으므로 따로 둔다.
+    condition_variable queueCondition;
+    condition_variable completeCondition;
+    deque<VkPipelineCompileImpl *> queuedCompiles;
+    bool quit;
+    vector<thread> threads;
+};
+
+void vkRunPipelineCompiler(VkPipelineCompilerImpl *pCompiler) {
+    unique_lock<mutex> guard(pCompiler->lock);
+    while (true) {
+        pCompiler->queueCondition.wait(guard, [pCompiler] {
+            return pCompiler->quit || !pCompiler->queuedCompiles.empty();
+        });
+        if (pCompiler->quit) {
+            return;
+        }
+
+        auto pCompile = pCompiler->queuedCompiles.front();
+        pCompiler->queuedCompiles.pop_front();
+        pCompile->state = VK_PIPELINE_COMPILE_STATE_COMPILING;
+
+        // 컴파일은 잠금 없이 해서 다른 워커 스레드와 상태를 확인하는 스레드를 막지 않는다.
+        guard.unlock();
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        auto result = pCompile->pfnCreatePipeline(pCompile->pUserData, &pipeline);
+        guard.lock();
+
+        pCompile->result = result;
+        pCompile->pipeline = result == VK_SUCCESS ? pipeline : VK_NULL_HANDLE;
+        pCompile->state = VK_PIPELINE_COMPILE_STATE_COMPLETE;
+        pCompiler->completeCondition.notify_all();
+    }
+}
+
+}
+
+VkResult vkCreatePipelineCompiler(
+    VkDevice                                    device,
+    const VkPipelineCompilerCreateInfo*         pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPipelineCompiler*                         pPipelineCompiler) {
+    auto pImpl = make_unique<VkPipelineCompilerImpl>();
+    pImpl->device = device;
+    pImpl->quit = false;
+
+    for (uint32_t i = 0; i != max(pCreateInfo->threadCount, 1u); ++i) {
+        pImpl->threads.emplace_back(vkRunPipelineCompiler, pImpl.get());
+    }
+
+    *pPipelineCompiler = reinterpret_cast<VkPipelineCompiler>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyPipelineCompiler(
+    VkDevice                                    device,
+    VkPipelineCompiler                          pipelineCompiler,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkPipelineCompilerImpl*>(pipelineCompiler);
+    {
+        lock_guard<mutex> guard(pImpl->lock);
+        pImpl->quit = true;
+    }
+    pImpl->queueCondition.notify_all();
+
+    for (auto &thread : pImpl->threads) {
+        thread.join();
+    }
+    delete pImpl;
+}
+
+VkResult vkCreatePipelineCompile(
+    VkPipelineCompiler                          pipelineCompiler,
+    const VkPipelineCompileInfo*                pCompileInfo,
+    VkPipelineCompile*                          pPipelineCompile) {
+    auto pImpl = reinterpret_cast<VkPipelineCompilerImpl*>(pipelineCompiler);
+
+    auto pCompile = new VkPipelineCompileImpl{
+        .pCompiler = pImpl,
+        .pfnCreatePipeline = pCompileInfo->pfnCreatePipeline,
+        .pUserData = pCompileInfo->pUserData,
+        .state = VK_PIPELINE_COMPILE_STATE_QUEUED,
+        .result = VK_NOT_READY,
+        .pipeline = VK_NULL_HANDLE
+    };
+
+    {
+        lock_guard<mutex> guard(pImpl->lock);
+        pImpl->queuedCompiles.push_back(pCompile);
+    }
+    pImpl->queueCondition.notify_one();
+
+    *pPipelineCompile = reinterpret_cast<VkPipelineCompile>(pCompile);
+    return VK_SUCCESS;
+}
+
+void vkDestroyPipelineCompile(
+    VkPipelineCompiler                          pipelineCompiler,
+    VkPipelineCompile                           pipelineCompile) {
+    auto pImpl = reinterpret_cast<VkPipelineCompilerImpl*>(pipelineCompiler);
+    auto pCompile = reinterpret_cast<VkPipelineCompileImpl*>(pipelineCompile);
+
+    unique_lock<mutex> guard(pImpl->lock);
+
+    // 워커 스레드가 컴파일 중이라면 끝날 때까지 기다린다.
+    pImpl->completeCondition.wait(guard, [pCompile] {
+        return pCompile->state != VK_PIPELINE_COMPILE_STATE_COMPILING;
+    });
+
+    auto &queuedCompiles = pImpl->queuedCompiles;
+    queuedCompiles.erase(remove(queuedCompiles.begin(), queuedCompiles.end(), pCompile), queuedCompiles.end());
+
+    guard.unlock();
+
+    vkDestroyPipeline(pImpl->device, pCompile->pipeline, nullptr);
+    delete pCompile;
+}
+
+VkResult vkAcquirePipelineCompile(
+    VkPipelineCompile                           pipelineCompile,
+    VkPipeline*                                 pPipeline) {
+    auto pCompile = reinterpret_cast<VkPipelineCompileImpl*>(pipelineCompile);
+    lock_guard<mutex> guard(pCompile->pCompiler->lock);
+
+    if (pCompile->state != VK_PIPELINE_COMPILE_STATE_COMPLETE) {
+        return VK_NOT_READY;
+    }
+
+    *pPipeline = pCompile->pipeline;
+    pCompile->pipeline = VK_NULL_HANDLE;
+    return pCompile->result;
+}
@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKPIPELINECOMPILER_H
+#define PRACTICE_VULKAN_VKPIPELINECOMPILER_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkPipelineCompiler)
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkPipelineCompile)
+
+// 워커 스레드에서 호출되며 VkPipeline을 만들어서 pPipeline에 쓴다.
+// 여러 워커 스레드에서 동시에 호출될 수 있으며 VkPipelineCache는 내부적으로 동기화된다.
+typedef VkResult (VKAPI_PTR *PFN_vkCreatePipelineFunction)(
+    void*                                       pUserData,
+    VkPipeline*                                 pPipeline);
+
+typedef struct VkPipelineCompilerCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    uint32_t                         threadCount;
+} VkPipelineCompilerCreateInfo;
+
+typedef struct VkPipelineCompileInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    PFN_vkCreatePipelineFunction     pfnCreatePipeline;
+    // VkPipelineCompile이 파괴될 때까지 유효해야 한다.
+    void*                            pUserData;
+} VkPipelineCompileInfo;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreatePipelineCompiler(
+    VkDevice                                    device,
+    const VkPipelineCompilerCreateInfo*         pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkPipelineCompiler*                         pPipelineCompiler);
+
+// 생성된 모든 VkPipelineCompile을 먼저 파괴해야 한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyPipelineCompiler(
+    VkDevice                                    device,
+    VkPipelineCompiler                          pipelineCompiler,
+    const VkAllocationCallbacks*                pAllocator);
+
+// 요청한 순서대로 워커 스레드에서 pfnCreatePipeline을 호출한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreatePipelineCompile(
+    VkPipelineCompiler                          pipelineCompiler,
+    const VkPipelineCompileInfo*                pCompileInfo,
+    VkPipelineCompile*                          pPipelineCompile);
+
+// 시작하지 않았으면 취소하고 컴파일 중이면 끝날 때까지 기다린다.
+// 가져가지 않은 VkPipeline은 함께 파괴한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyPipelineCompile(
+    VkPipelineCompiler                          pipelineCompiler,
+    VkPipelineCompile                           pipelineCompile);
+
+// 컴파일 중이면 VK_NOT_READY, 실패하면 에러를 반환하며 기다리지 않는다.
+// 성공하면 pPipeline에 VkPipeline을 쓰고 소유권을 넘기므로 성공한 후에는 다시 호출하지 않는다.
+VKAPI_ATTR VkResult VKAPI_CALL vkAcquirePipelineCompile(
+    VkPipelineCompile                           pipelineCompile,
+    VkPipeline*                                 pPipeline);
+
+#endif //PRACTICE_VULKAN_VKPIPELINECOMPILER_H
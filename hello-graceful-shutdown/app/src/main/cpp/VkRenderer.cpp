@@ -21,67 +21,171 @@
 // SOFTWARE.
 
 #include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstring>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <iomanip>
+#include <unistd.h>
 
+#include "VkDeviceSelector.h"
+#include "VkMesh.h"
 #include "VkRenderer.h"
+#include "VkShaders.h"
 #include "VkUtil.h"
 #include "AndroidOut.h"
 
 using namespace std;
 
-struct Vector2 {
-    union {
-        float x;
-        float r;
-        float u;
-    };
+// Vertex의 절반 크기로 16비트 3채널 포맷은 지원하지 않는 GPU가 많아서 위치는 4채널을 사용한다.
+// 셰이더의 입력은 바뀌지 않고 Vertex 입력 단계에서 실수로 변환된다.
+struct CompactVertex {
+    int16_t position[4];
+    uint8_t color[4];
+    uint16_t uv[2];
+};
 
-    union {
-        float y;
-        float g;
-        float v;
+static_assert(sizeof(CompactVertex) * 2 == sizeof(Vertex));
+
+// 상수 식에서는 초기화된 공용체 멤버만 읽을 수 있으므로 색상과 텍스처 좌표도 x, y, z로 읽는다.
+constexpr CompactVertex toCompactVertex(const Vertex &vertex) {
+    return {
+        .position{
+            vkQuantizeSnorm16(vertex.position.x),
+            vkQuantizeSnorm16(vertex.position.y),
+            vkQuantizeSnorm16(vertex.position.z),
+            0
+        },
+        .color{
+            vkQuantizeUnorm8(vertex.color.x),
+            vkQuantizeUnorm8(vertex.color.y),
+            vkQuantizeUnorm8(vertex.color.z),
+            UINT8_MAX
+        },
+        .uv{
+            vkQuantizeUnorm16(vertex.uv.x),
+            vkQuantizeUnorm16(vertex.uv.y)
+        }
     };
+}
+
+// 인스턴스의 위치는 Compute 셰이더가 Storage VkBuffer에서 직접 갱신하므로 CPU는 갱신하지 않는다.
+// std430에서 구조체는 가장 큰 멤버의 정렬(8바이트)에 맞춰서 배치된다.
+struct Instance {
+    Vector2 position;
+    Vector2 velocity;
+    float scale;
+    // 샘플링할 텍스처 배열의 레이어로 정렬 때문에 남는 자리를 사용한다.
+    uint32_t layer;
 };
 
-struct Vector3 {
-    union {
-        float x;
-        float r;
-        float u;
-    };
+// 정점 속성의 배치를 타입마다 컴파일 시간에 기술하고 이것으로 VkVertexInputAttributeDescription을 만든다.
+struct VertexAttribute {
+    uint32_t location;
+    VkFormat format;
+    uint32_t offset;
+};
 
-    union {
-        float y;
-        float g;
-        float v;
+template<typename T>
+struct VertexLayout;
+
+template<>
+struct VertexLayout<Vertex> {
+    static constexpr array<VertexAttribute, 3> kAttributes{
+        VertexAttribute{0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position)},
+        VertexAttribute{1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)},
+        VertexAttribute{2, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv)}
     };
+};
 
-    union {
-        float z;
-        float b;
-        float w;
+template<>
+struct VertexLayout<CompactVertex> {
+    static constexpr array<VertexAttribute, 3> kAttributes{
+        VertexAttribute{0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(CompactVertex, position)},
+        VertexAttribute{1, VK_FORMAT_R8G8B8A8_UNORM, offsetof(CompactVertex, color)},
+        VertexAttribute{2, VK_FORMAT_R16G16_UNORM, offsetof(CompactVertex, uv)}
     };
 };
 
-struct Vertex {
-    Vector3 position;
-    Vector3 color;
-    Vector2 uv;
+template<>
+struct VertexLayout<Instance> {
+    static constexpr array<VertexAttribute, 3> kAttributes{
+        VertexAttribute{3, VK_FORMAT_R32G32_SFLOAT, offsetof(Instance, position)},
+        VertexAttribute{4, VK_FORMAT_R32_SFLOAT, offsetof(Instance, scale)},
+        VertexAttribute{5, VK_FORMAT_R32_UINT, offsetof(Instance, layer)}
+    };
 };
 
+template<typename T>
+void appendVertexInputAttributeDescriptions(uint32_t binding,
+                                            vector<VkVertexInputAttributeDescription> *descriptions) {
+    for (const auto &attribute: VertexLayout<T>::kAttributes) {
+        descriptions->push_back({
+            .location = attribute.location,
+            .binding = binding,
+            .format = attribute.format,
+            .offset = attribute.offset
+        });
+    }
+}
+
+// Compute 셰이더가 프레임마다 사용하는 데이터로 그리기마다의 데이터는 PushConstant로 전달한다.
 struct Uniform {
-    float position[8];
     float ratio;
+    float deltaTime;
+    // 컬링에 사용하는 메시의 x, y 축 크기.
+    Vector2 meshExtent;
 };
 
-VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
-    : mAssetManager{assetManager}, mFrameIndex{0} {
+// 트레이스의 연산이 있고 데이터의 크기가 맞을 때만 읽으므로 다른 빌드의 트레이스로 잘못 읽지 않는다.
+template<typename T>
+bool readTraceOp(const VkFrameTraceOp *pOp, T *pValue) {
+    if (!pOp || pOp->dataSize != sizeof(T)) {
+        return false;
+    }
+    memcpy(pValue, pOp->pData, sizeof(T));
+    return true;
+}
+
+// 검증 레이어의 메시지를 출력하며 VK_FALSE를 반환해서 메시지를 발생시킨 호출을 중단하지 않는다.
+VKAPI_ATTR VkBool32 VKAPI_CALL
+vkDebugUtilsMessengerCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
+                              VkDebugUtilsMessageTypeFlagsEXT messageTypes,
+                              const VkDebugUtilsMessengerCallbackDataEXT *pCallbackData,
+                              void *pUserData) {
+    aout << (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT ? "[ERROR] "
+                                                                               : "[WARNING] ")
+         << pCallbackData->pMessage << endl;
+    return VK_FALSE;
+}
+
+VkRenderer::VkRenderer(ANativeWindow *nativeWindow,
+                       AAssetManager *assetManager,
+                       const char *internalDataPath,
+                       const VkRendererConfig &config)
+    : mAssetManager{assetManager},
+      mInternalDataPath{internalDataPath},
+      mConfig{config},
+      mFrameIndex{0} {
+    VK_TRACE_STEPS(traceSteps);
+
+    // 오프스크린 모드에서는 윈도우를 사용하지 않으며 출력하지 않으므로 그린 이미지를 복사할 수 있게 둔다.
+    mOffscreen = mConfig.offscreenExtent.width && mConfig.offscreenExtent.height;
+    if (mOffscreen) {
+        mSwapchainImageFinalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    }
+
     // ================================================================================
     // 1. VkInstance 생성
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkInstance 생성");
     VkApplicationInfo applicationInfo{
         .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
         .pApplicationName = "Practice Vulkan",
@@ -96,9 +200,14 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
     VK_CHECK_ERROR(vkEnumerateInstanceLayerProperties(&instanceLayerCount,
                                                       instanceLayerProperties.data()));
 
+    // 설정된 레이어 중 설치된 레이어만 활성화한다.
     vector<const char *> instanceLayerNames;
-    for (const auto &properties: instanceLayerProperties) {
-        instanceLayerNames.push_back(properties.layerName);
+    for (auto layerName: mConfig.instanceLayerNames) {
+        if (vkHasLayer(instanceLayerProperties, layerName)) {
+            instanceLayerNames.push_back(layerName);
+        } else {
+            aout << "Instance layer is not installed: " << layerName << endl;
+        }
     }
 
     uint32_t instanceExtensionCount;
@@ -112,13 +221,43 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
                                                           instanceExtensionProperties.data()));
 
     vector<const char *> instanceExtensionNames;
-    for (const auto &properties: instanceExtensionProperties) {
-        if (properties.extensionName == string("VK_KHR_surface") ||
-            properties.extensionName == string("VK_KHR_android_surface")) {
-            instanceExtensionNames.push_back(properties.extensionName);
+    if (!mOffscreen) {
+        for (const auto &properties: instanceExtensionProperties) {
+            if (properties.extensionName == string("VK_KHR_surface") ||
+                properties.extensionName == string("VK_KHR_android_surface")) {
+                instanceExtensionNames.push_back(properties.extensionName);
+            }
+        }
+        assert(instanceExtensionNames.size() == 2);
+    }
+
+    // 레이어가 제공하는 확장도 찾을 수 있도록 활성화할 레이어의 확장을 함께 확인한다.
+    auto debugUtilsEnabled = false;
+    if (mConfig.debugMessenger) {
+        for (auto layerName: instanceLayerNames) {
+            uint32_t layerExtensionCount;
+            VK_CHECK_ERROR(vkEnumerateInstanceExtensionProperties(layerName,
+                                                                  &layerExtensionCount,
+                                                                  nullptr));
+
+            vector<VkExtensionProperties> layerExtensionProperties(layerExtensionCount);
+            VK_CHECK_ERROR(vkEnumerateInstanceExtensionProperties(layerName,
+                                                                  &layerExtensionCount,
+                                                                  layerExtensionProperties.data()));
+
+            instanceExtensionProperties.insert(instanceExtensionProperties.end(),
+                                               layerExtensionProperties.begin(),
+                                               layerExtensionProperties.end());
+        }
+
+        debugUtilsEnabled = vkHasExtension(instanceExtensionProperties,
+                                           VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        if (debugUtilsEnabled) {
+            instanceExtensionNames.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        } else {
+            aout << "VK_EXT_debug_utils is not supported." << endl;
         }
     }
-    assert(instanceExtensionNames.size() == 2);
 
     VkInstanceCreateInfo instanceCreateInfo{
         .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
@@ -132,17 +271,64 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
     VK_CHECK_ERROR(vkCreateInstance(&instanceCreateInfo, nullptr, &mInstance));
 
     // ================================================================================
-    // 2. VkPhysicalDevice 선택
+    // 2. VkDebugUtilsMessengerEXT 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDebugUtilsMessengerEXT 생성");
+    if (debugUtilsEnabled) {
+        auto vkCreateDebugUtilsMessenger = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>(
+                vkGetInstanceProcAddr(mInstance, "vkCreateDebugUtilsMessengerEXT"));
+        assert(vkCreateDebugUtilsMessenger);
+
+        VkDebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT,
+            .messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT |
+                               VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT,
+            .messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT |
+                           VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                           VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT,
+            .pfnUserCallback = vkDebugUtilsMessengerCallback
+        };
+
+        VK_CHECK_ERROR(vkCreateDebugUtilsMessenger(mInstance,
+                                                   &debugUtilsMessengerCreateInfo,
+                                                   nullptr,
+                                                   &mDebugUtilsMessenger));
+    }
+
+    // ================================================================================
+    // 3. VkPhysicalDevice 선택
     // ================================================================================
-    uint32_t physicalDeviceCount;
-    VK_CHECK_ERROR(vkEnumeratePhysicalDevices(mInstance, &physicalDeviceCount, nullptr));
+    VK_TRACE_NEXT_STEP(traceSteps, "VkPhysicalDevice 선택");
+    // Chromebook이나 에뮬레이터처럼 VkPhysicalDevice가 여러 개일 수 있으므로 점수가 가장 높은 것을 선택한다.
+    vector<const char *> optionalDeviceExtensionNames{mConfig.optionalDeviceExtensionNames};
+    if (mConfig.displayTiming && !mOffscreen) {
+        optionalDeviceExtensionNames.push_back(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+    }
+    if (mConfig.memoryBudget) {
+        optionalDeviceExtensionNames.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    vector<const char *> requiredDeviceExtensionNames;
+    if (!mOffscreen) {
+        requiredDeviceExtensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+    VkPhysicalDeviceSelectInfo physicalDeviceSelectInfo{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SELECT_INFO,
+        .minApiVersion = VK_API_VERSION_1_0,
+        .requiredExtensionCount = static_cast<uint32_t>(requiredDeviceExtensionNames.size()),
+        .ppRequiredExtensionNames = requiredDeviceExtensionNames.data(),
+        .optionalExtensionCount = static_cast<uint32_t>(optionalDeviceExtensionNames.size()),
+        .ppOptionalExtensionNames = optionalDeviceExtensionNames.data()
+    };
 
-    vector<VkPhysicalDevice> physicalDevices(physicalDeviceCount);
-    VK_CHECK_ERROR(vkEnumeratePhysicalDevices(mInstance,
-                                              &physicalDeviceCount,
-                                              physicalDevices.data()));
+    VkPhysicalDeviceSelection physicalDeviceSelection;
+    VK_CHECK_ERROR(vkSelectPhysicalDevice(mInstance,
+                                          &physicalDeviceSelectInfo,
+                                          &physicalDeviceSelection));
 
-    mPhysicalDevice = physicalDevices[0];
+    mPhysicalDevice = physicalDeviceSelection.physicalDevice;
+    mQueueFamilyIndex = physicalDeviceSelection.graphicsQueueFamilyIndex;
+    mTransferQueueFamilyIndex = physicalDeviceSelection.transferQueueFamilyIndex;
 
     VkPhysicalDeviceProperties physicalDeviceProperties;
     vkGetPhysicalDeviceProperties(mPhysicalDevice, &physicalDeviceProperties);
@@ -162,37 +348,55 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
     aout << setw(16) << left << " - Driver Version: "
          << VK_API_VERSION_MAJOR(physicalDeviceProperties.driverVersion) << "."
          << VK_API_VERSION_MINOR(physicalDeviceProperties.driverVersion) << endl;
+    aout << setw(16) << left << " - Graphics Queue: " << mQueueFamilyIndex << endl;
+    aout << setw(16) << left << " - Compute Queue: "
+         << physicalDeviceSelection.computeQueueFamilyIndex << endl;
+    aout << setw(16) << left << " - Transfer Queue: " << mTransferQueueFamilyIndex << endl;
+
+    // 깊이 Attachment도 같은 샘플 수를 사용하므로 두 한도를 모두 만족해야 한다.
+    auto supportedSampleCounts = physicalDeviceProperties.limits.framebufferColorSampleCounts;
+    if (mConfig.depthTest) {
+        supportedSampleCounts &= physicalDeviceProperties.limits.framebufferDepthSampleCounts;
+    }
+    for (auto sampleCount = static_cast<uint32_t>(mConfig.msaaSamples); sampleCount; sampleCount >>= 1) {
+        if (supportedSampleCounts & sampleCount) {
+            mSampleCount = static_cast<VkSampleCountFlagBits>(sampleCount);
+            break;
+        }
+    }
+    aout << setw(16) << left << " - MSAA Samples: " << mSampleCount << endl;
 
     // ================================================================================
-    // 3. VkPhysicalDeviceMemoryProperties 얻기
+    // 4. VkPhysicalDeviceMemoryProperties 얻기
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkPhysicalDeviceMemoryProperties 얻기");
     vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &mPhysicalDeviceMemoryProperties);
 
     // ================================================================================
-    // 4. VkDevice 생성
+    // 5. VkDevice 생성
     // ================================================================================
-    uint32_t queueFamilyPropertiesCount;
-    vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &queueFamilyPropertiesCount, nullptr);
-
-    vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyPropertiesCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(mPhysicalDevice, &queueFamilyPropertiesCount,
-                                             queueFamilyProperties.data());
-
-    for (mQueueFamilyIndex = 0;
-         mQueueFamilyIndex != queueFamilyPropertiesCount; ++mQueueFamilyIndex) {
-        if (queueFamilyProperties[mQueueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-            break;
-        }
-    }
-
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDevice 생성");
+    // 텍스처 업로드는 전용 전송 큐가 있으면 그 큐를 사용해서 렌더링과 겹쳐서 실행한다.
+    // 전용 전송 큐가 없다면 그래픽스 큐를 함께 사용한다.
     const vector<float> queuePriorities{1.0};
-    VkDeviceQueueCreateInfo deviceQueueCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-        .queueFamilyIndex = mQueueFamilyIndex,
-        .queueCount = 1,
-        .pQueuePriorities = queuePriorities.data()
+    vector<VkDeviceQueueCreateInfo> deviceQueueCreateInfos{
+        VkDeviceQueueCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = mQueueFamilyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = queuePriorities.data()
+        }
     };
 
+    if (mTransferQueueFamilyIndex != mQueueFamilyIndex) {
+        deviceQueueCreateInfos.push_back(VkDeviceQueueCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = mTransferQueueFamilyIndex,
+            .queueCount = 1,
+            .pQueuePriorities = queuePriorities.data()
+        });
+    }
+
     uint32_t deviceExtensionCount;
     VK_CHECK_ERROR(vkEnumerateDeviceExtensionProperties(mPhysicalDevice,
                                                         nullptr,
@@ -205,166 +409,323 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
                                                         &deviceExtensionCount,
                                                         deviceExtensionProperties.data()));
 
-    vector<const char *> deviceExtensionNames;
-    for (const auto &properties: deviceExtensionProperties) {
-        if (properties.extensionName == string("VK_KHR_swapchain")) {
-            deviceExtensionNames.push_back(properties.extensionName);
+    // 선택 확장 중 지원하는 확장만 활성화한다.
+    vector<const char *> deviceExtensionNames{requiredDeviceExtensionNames.begin(),
+                                              requiredDeviceExtensionNames.end()};
+    for (auto extensionName: optionalDeviceExtensionNames) {
+        if (find_if(deviceExtensionNames.begin(),
+                    deviceExtensionNames.end(),
+                    [=](auto name) { return name == string(extensionName); }) !=
+            deviceExtensionNames.end()) {
+            continue;
+        }
+
+        if (vkHasExtension(deviceExtensionProperties, extensionName)) {
+            deviceExtensionNames.push_back(extensionName);
+        } else {
+            aout << "Device extension is not supported: " << extensionName << endl;
         }
     }
-    assert(deviceExtensionNames.size() == 1);
 
-    VkDeviceCreateInfo deviceCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-        .queueCreateInfoCount = 1,
-        .pQueueCreateInfos = &deviceQueueCreateInfo,
-        .enabledExtensionCount = static_cast<uint32_t>(deviceExtensionNames.size()),
-        .ppEnabledExtensionNames = deviceExtensionNames.data()
+    const auto displayTimingEnabled =
+            mConfig.displayTiming && !mOffscreen &&
+            vkHasExtension(deviceExtensionProperties, VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+
+    // 예산은 Vulkan 1.1부터 코어인 vkGetPhysicalDeviceMemoryProperties2로 질의한다.
+    const auto memoryBudgetEnabled =
+            mConfig.memoryBudget && physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_1 &&
+            vkHasExtension(deviceExtensionProperties, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
+    // Bindless 텍스처에 필요한 Descriptor Indexing 기능은 Vulkan 1.2부터 코어이므로
+    // VkPhysicalDevice가 1.2 이상이고 필요한 기능을 모두 지원할 때만 사용한다.
+    // VkPhysicalDeviceVulkan12Features는 VkPhysicalDeviceDescriptorIndexingFeatures의 기능을 모두 포함한다.
+    // Dynamic Rendering은 Vulkan 1.3부터 코어이며 1.3 미만의 VkPhysicalDevice에는
+    // VkPhysicalDeviceVulkan13Features를 연결할 수 없다.
+    VkPhysicalDeviceVulkan13Features physicalDeviceVulkan13Features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES
     };
 
-    VK_CHECK_ERROR(vkCreateDevice(mPhysicalDevice, &deviceCreateInfo, nullptr, &mDevice));
-    vkGetDeviceQueue(mDevice, mQueueFamilyIndex, 0, &mQueue);
+    VkPhysicalDeviceVulkan12Features physicalDeviceVulkan12Features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_3 ? &physicalDeviceVulkan13Features
+                                                                           : nullptr
+    };
 
-    // ================================================================================
-    // 5. VkSurface 생성
-    // ================================================================================
-    VkAndroidSurfaceCreateInfoKHR surfaceCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
-        .window = nativeWindow
+    // VRS는 확장을 지원할 때만 기능 구조체를 연결할 수 있으며 Descriptor Indexing과 같이 1.2 이상에서만 질의한다.
+    const auto fragmentShadingRateRequested = mConfig.shadingRate.width > 1 || mConfig.shadingRate.height > 1;
+    const auto fragmentShadingRateSupported =
+            fragmentShadingRateRequested && physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2 &&
+            vkHasExtension(deviceExtensionProperties, VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
+
+    VkPhysicalDeviceFragmentShadingRateFeaturesKHR physicalDeviceFragmentShadingRateFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR,
+        .pNext = &physicalDeviceVulkan12Features
     };
 
-    VK_CHECK_ERROR(vkCreateAndroidSurfaceKHR(mInstance, &surfaceCreateInfo, nullptr, &mSurface));
+    VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = fragmentShadingRateSupported ? static_cast<void *>(&physicalDeviceFragmentShadingRateFeatures)
+                                              : &physicalDeviceVulkan12Features
+    };
 
-    VkBool32 supported;
-    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceSupportKHR(mPhysicalDevice,
-                                                        mQueueFamilyIndex,
-                                                        mSurface,
-                                                        &supported));
-    assert(supported);
+    if (physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+        vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &physicalDeviceFeatures2);
+        mBindlessTextures = mConfig.bindlessTextures &&
+                            physicalDeviceFeatures2.features.shaderSampledImageArrayDynamicIndexing &&
+                            physicalDeviceVulkan12Features.descriptorIndexing &&
+                            physicalDeviceVulkan12Features.runtimeDescriptorArray &&
+                            physicalDeviceVulkan12Features.descriptorBindingPartiallyBound &&
+                            physicalDeviceVulkan12Features.descriptorBindingSampledImageUpdateAfterBind &&
+                            physicalDeviceVulkan12Features.descriptorBindingUpdateUnusedWhilePending;
+    }
 
-    // ================================================================================
-    // 6. VkSwapchain 생성
-    // ================================================================================
-    VkSurfaceCapabilitiesKHR surfaceCapabilities;
-    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(mPhysicalDevice,
-                                                             mSurface,
-                                                             &surfaceCapabilities));
-    mSwapchainImageExtent = surfaceCapabilities.currentExtent;
+    // 기능을 지원해도 UPDATE_AFTER_BIND VkDescriptorSetLayout에 kMaxTextureCount개의 텍스처를 둘 수 있어야 한다.
+    if (mBindlessTextures) {
+        VkPhysicalDeviceDescriptorIndexingProperties physicalDeviceDescriptorIndexingProperties{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES
+        };
 
-    VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_FLAG_BITS_MAX_ENUM_KHR;
-    for (auto i = 0; i <= 4; ++i) {
-        if (auto flag = 0x1u << i; surfaceCapabilities.supportedCompositeAlpha & flag) {
-            compositeAlpha = static_cast<VkCompositeAlphaFlagBitsKHR>(flag);
-            break;
+        VkPhysicalDeviceProperties2 physicalDeviceProperties2{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &physicalDeviceDescriptorIndexingProperties
+        };
+
+        vkGetPhysicalDeviceProperties2(mPhysicalDevice, &physicalDeviceProperties2);
+
+        const auto &properties = physicalDeviceDescriptorIndexingProperties;
+        mBindlessTextures = properties.maxUpdateAfterBindDescriptorsInAllPools >= kMaxTextureCount &&
+                            properties.maxPerStageDescriptorUpdateAfterBindSamplers >= kMaxTextureCount &&
+                            properties.maxPerStageDescriptorUpdateAfterBindSampledImages >= kMaxTextureCount &&
+                            properties.maxPerStageUpdateAfterBindResources >= kMaxTextureCount &&
+                            properties.maxDescriptorSetUpdateAfterBindSamplers >= kMaxTextureCount &&
+                            properties.maxDescriptorSetUpdateAfterBindSampledImages >= kMaxTextureCount;
+    }
+    if (mConfig.bindlessTextures && !mBindlessTextures) {
+        aout << "Descriptor indexing is not supported, falling back to bound textures." << endl;
+    }
+
+    // 타임라인 VkSemaphore도 Vulkan 1.2부터 코어이며 지원하면 항상 사용한다.
+    const VkBool32 timelineSemaphore = physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2 &&
+                                       physicalDeviceVulkan12Features.timelineSemaphore;
+
+    mDynamicRendering = mConfig.dynamicRendering &&
+                        physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_3 &&
+                        physicalDeviceVulkan13Features.dynamicRendering;
+    if (mConfig.dynamicRendering && !mDynamicRendering) {
+        aout << "Dynamic rendering is not supported, falling back to render passes." << endl;
+    }
+
+    // 동적 해상도의 Blit 지원은 VkSurface의 포맷을 선택한 후에 확인한다.
+    // 그 전에 정하는 기능은 동적 해상도를 사용한다고 가정하므로 나중에 꺼져도 다시 켜지 않는다.
+    mDynamicResolution = mConfig.dynamicResolution;
+
+    // 셰이딩 비율 목록은 넓이가 큰 크기부터 정렬되어 있고 1x1은 항상 포함되므로
+    // 샘플 수를 지원하면서 요청한 크기를 넘지 않는 첫번째 크기가 가장 큰 크기다.
+    if (fragmentShadingRateSupported && physicalDeviceFragmentShadingRateFeatures.pipelineFragmentShadingRate) {
+        auto getPhysicalDeviceFragmentShadingRates = reinterpret_cast<PFN_vkGetPhysicalDeviceFragmentShadingRatesKHR>(
+                vkGetInstanceProcAddr(mInstance, "vkGetPhysicalDeviceFragmentShadingRatesKHR"));
+
+        uint32_t fragmentShadingRateCount;
+        VK_CHECK_ERROR(getPhysicalDeviceFragmentShadingRates(mPhysicalDevice, &fragmentShadingRateCount, nullptr));
+
+        vector<VkPhysicalDeviceFragmentShadingRateKHR> fragmentShadingRates(
+                fragmentShadingRateCount,
+                {.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_KHR});
+        VK_CHECK_ERROR(getPhysicalDeviceFragmentShadingRates(mPhysicalDevice,
+                                                             &fragmentShadingRateCount,
+                                                             fragmentShadingRates.data()));
+
+        for (const auto &fragmentShadingRate: fragmentShadingRates) {
+            if ((fragmentShadingRate.sampleCounts & mSampleCount) &&
+                fragmentShadingRate.fragmentSize.width <= mConfig.shadingRate.width &&
+                fragmentShadingRate.fragmentSize.height <= mConfig.shadingRate.height) {
+                mShadingRate = fragmentShadingRate.fragmentSize;
+                break;
+            }
         }
     }
-    assert(compositeAlpha != VK_COMPOSITE_ALPHA_FLAG_BITS_MAX_ENUM_KHR);
+    if (fragmentShadingRateRequested && mShadingRate.width == 1 && mShadingRate.height == 1) {
+        aout << "Fragment shading rate is not supported, shading every pixel." << endl;
+    }
+
+    // 셰이딩 비율 Attachment는 R8_UINT 텍셀마다 log2(너비) << 2 | log2(높이)로 인코딩된 셰이딩 비율을 읽는다.
+    // VkRenderPass로 사용하려면 VkRenderPass2가 필요하므로 Dynamic Rendering을 사용할 때만 지원하며,
+    // 동적 해상도는 그리는 영역이 바뀌어서 화면 중심이 움직이므로 함께 사용하지 않는다.
+    if (mConfig.foveatedShading && (mShadingRate.width > 1 || mShadingRate.height > 1)) {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, VK_FORMAT_R8_UINT, &formatProperties);
+
+        mFoveatedShading = mDynamicRendering && !mDynamicResolution &&
+                           physicalDeviceFragmentShadingRateFeatures.attachmentFragmentShadingRate &&
+                           (formatProperties.optimalTilingFeatures &
+                            VK_FORMAT_FEATURE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR);
+    }
+    if (mConfig.foveatedShading && !mFoveatedShading) {
+        aout << "Shading rate attachments are not supported, disabling foveated shading." << endl;
+    }
 
-    VkImageUsageFlags swapchainImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
-                                            VK_IMAGE_USAGE_TRANSFER_DST_BIT;
-    assert(surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT);
+    if (mFoveatedShading) {
+        VkPhysicalDeviceFragmentShadingRatePropertiesKHR physicalDeviceFragmentShadingRateProperties{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_PROPERTIES_KHR
+        };
 
-    uint32_t surfaceFormatCount = 0;
-    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceFormatsKHR(mPhysicalDevice,
-                                                        mSurface,
-                                                        &surfaceFormatCount,
-                                                        nullptr));
+        VkPhysicalDeviceProperties2 physicalDeviceProperties2{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &physicalDeviceFragmentShadingRateProperties
+        };
 
-    vector<VkSurfaceFormatKHR> surfaceFormats(surfaceFormatCount);
-    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceFormatsKHR(mPhysicalDevice,
-                                                        mSurface,
-                                                        &surfaceFormatCount,
-                                                        surfaceFormats.data()));
+        vkGetPhysicalDeviceProperties2(mPhysicalDevice, &physicalDeviceProperties2);
 
-    uint32_t surfaceFormatIndex = VK_FORMAT_MAX_ENUM;
-    for (auto i = 0; i != surfaceFormatCount; ++i) {
-        if (surfaceFormats[i].format == VK_FORMAT_R8G8B8A8_UNORM) {
-            surfaceFormatIndex = i;
-            break;
-        }
+        // 텍셀 크기는 2의 거듭제곱이며 16x16 픽셀이면 경계가 보이지 않을 만큼 촘촘하다.
+        const auto &minTexelSize = physicalDeviceFragmentShadingRateProperties.minFragmentShadingRateAttachmentTexelSize;
+        const auto &maxTexelSize = physicalDeviceFragmentShadingRateProperties.maxFragmentShadingRateAttachmentTexelSize;
+        mShadingRateTexelSize = {
+            .width = clamp(16u, minTexelSize.width, maxTexelSize.width),
+            .height = clamp(16u, minTexelSize.height, maxTexelSize.height)
+        };
+
+        // 그리기의 셰이딩 비율과 Attachment의 셰이딩 비율 중 작은 쪽을 사용해서 1x1로 그리는 변형은 계속 1x1로 그린다.
+        // KEEP과 REPLACE 외의 연산을 지원하지 않으면 Attachment의 셰이딩 비율로 바꾼다.
+        mShadingRateCombinerOps[1] = physicalDeviceFragmentShadingRateProperties.fragmentShadingRateNonTrivialCombinerOps
+                                     ? VK_FRAGMENT_SHADING_RATE_COMBINER_OP_MIN_KHR
+                                     : VK_FRAGMENT_SHADING_RATE_COMBINER_OP_REPLACE_KHR;
     }
-    assert(surfaceFormatIndex != VK_FORMAT_MAX_ENUM);
 
-    uint32_t presentModeCount;
-    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice,
-                                                             mSurface,
-                                                             &presentModeCount,
-                                                             nullptr));
-
-    vector<VkPresentModeKHR> presentModes(presentModeCount);
-    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice,
-                                                             mSurface,
-                                                             &presentModeCount,
-                                                             presentModes.data()));
-
-    uint32_t presentModeIndex = VK_PRESENT_MODE_MAX_ENUM_KHR;
-    for (auto i = 0; i != presentModeCount; ++i) {
-        if (presentModes[i] == VK_PRESENT_MODE_FIFO_KHR) {
-            presentModeIndex = i;
-            break;
-        }
+    const auto fragmentShadingRate = mShadingRate.width > 1 || mShadingRate.height > 1;
+    if (fragmentShadingRate &&
+        find_if(deviceExtensionNames.begin(),
+                deviceExtensionNames.end(),
+                [](auto name) { return name == string(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME); }) ==
+        deviceExtensionNames.end()) {
+        deviceExtensionNames.push_back(VK_KHR_FRAGMENT_SHADING_RATE_EXTENSION_NAME);
     }
-    assert(presentModeIndex != VK_PRESENT_MODE_MAX_ENUM_KHR);
+    aout << setw(16) << left << " - Shading Rate: " << mShadingRate.width << "x" << mShadingRate.height
+         << (mFoveatedShading ? " (foveated)" : "") << endl;
 
-    VkSwapchainCreateInfoKHR swapchainCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
-        .surface = mSurface,
-        .minImageCount = surfaceCapabilities.minImageCount,
-        .imageFormat = surfaceFormats[surfaceFormatIndex].format,
-        .imageColorSpace = surfaceFormats[surfaceFormatIndex].colorSpace,
-        .imageExtent = mSwapchainImageExtent,
-        .imageArrayLayers = 1,
-        .imageUsage = swapchainImageUsage,
-        .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
-        .preTransform = surfaceCapabilities.currentTransform,
-        .compositeAlpha = compositeAlpha,
-        .presentMode = presentModes[presentModeIndex]
+    // 사용하는 기능만 활성화한다.
+    physicalDeviceFeatures2.features = {
+        .shaderSampledImageArrayDynamicIndexing = mBindlessTextures
+    };
+    physicalDeviceFeatures2.pNext = fragmentShadingRate ? static_cast<void *>(&physicalDeviceFragmentShadingRateFeatures)
+                                                        : &physicalDeviceVulkan12Features;
+    physicalDeviceFragmentShadingRateFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FRAGMENT_SHADING_RATE_FEATURES_KHR,
+        .pNext = &physicalDeviceVulkan12Features,
+        .pipelineFragmentShadingRate = fragmentShadingRate,
+        .attachmentFragmentShadingRate = mFoveatedShading
+    };
+    physicalDeviceVulkan12Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = mDynamicRendering ? &physicalDeviceVulkan13Features : nullptr,
+        .descriptorIndexing = mBindlessTextures,
+        .descriptorBindingSampledImageUpdateAfterBind = mBindlessTextures,
+        .descriptorBindingUpdateUnusedWhilePending = mBindlessTextures,
+        .descriptorBindingPartiallyBound = mBindlessTextures,
+        .runtimeDescriptorArray = mBindlessTextures,
+        .timelineSemaphore = timelineSemaphore
+    };
+    physicalDeviceVulkan13Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering = mDynamicRendering
+    };
+
+    VkDeviceCreateInfo deviceCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = mBindlessTextures || mDynamicRendering || timelineSemaphore || fragmentShadingRate
+                 ? &physicalDeviceFeatures2
+                 : nullptr,
+        .queueCreateInfoCount = static_cast<uint32_t>(deviceQueueCreateInfos.size()),
+        .pQueueCreateInfos = deviceQueueCreateInfos.data(),
+        .enabledExtensionCount = static_cast<uint32_t>(deviceExtensionNames.size()),
+        .ppEnabledExtensionNames = deviceExtensionNames.data()
     };
 
-    VK_CHECK_ERROR(vkCreateSwapchainKHR(mDevice, &swapchainCreateInfo, nullptr, &mSwapchain));
+    VK_CHECK_ERROR(vkCreateDevice(mPhysicalDevice, &deviceCreateInfo, nullptr, &mDevice));
+    vkGetDeviceQueue(mDevice, mQueueFamilyIndex, 0, &mQueue);
+    vkGetDeviceQueue(mDevice, mTransferQueueFamilyIndex, 0, &mTransferQueue);
+
+    // 확장 함수는 로더가 제공하지 않으므로 vkGetDeviceProcAddr로 얻는다.
+    if (displayTimingEnabled) {
+        mVkGetRefreshCycleDurationGOOGLE = reinterpret_cast<PFN_vkGetRefreshCycleDurationGOOGLE>(
+                vkGetDeviceProcAddr(mDevice, "vkGetRefreshCycleDurationGOOGLE"));
+        mVkGetPastPresentationTimingGOOGLE = reinterpret_cast<PFN_vkGetPastPresentationTimingGOOGLE>(
+                vkGetDeviceProcAddr(mDevice, "vkGetPastPresentationTimingGOOGLE"));
+    }
 
-    uint32_t swapchainImageCount;
-    VK_CHECK_ERROR(vkGetSwapchainImagesKHR(mDevice, mSwapchain, &swapchainImageCount, nullptr));
+    // 로더가 Vulkan 1.3 함수를 내보내지 않는 Android 버전이 있으므로 vkGetDeviceProcAddr로 얻는다.
+    if (mDynamicRendering) {
+        mVkCmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRendering>(
+                vkGetDeviceProcAddr(mDevice, "vkCmdBeginRendering"));
+        mVkCmdEndRendering = reinterpret_cast<PFN_vkCmdEndRendering>(
+                vkGetDeviceProcAddr(mDevice, "vkCmdEndRendering"));
+    }
 
-    mSwapchainImages.resize(swapchainImageCount);
-    VK_CHECK_ERROR(vkGetSwapchainImagesKHR(mDevice,
-                                           mSwapchain,
-                                           &swapchainImageCount,
-                                           mSwapchainImages.data()));
+    if (fragmentShadingRate) {
+        mVkCmdSetFragmentShadingRateKHR = reinterpret_cast<PFN_vkCmdSetFragmentShadingRateKHR>(
+                vkGetDeviceProcAddr(mDevice, "vkCmdSetFragmentShadingRateKHR"));
+    }
 
-    mSwapchainImageViews.resize(swapchainImageCount);
-    for (auto i = 0; i != swapchainImageCount; ++i) {
-        // ================================================================================
-        // 7. VkImageView 생성
-        // ================================================================================
-        VkImageViewCreateInfo imageViewCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-            .image = mSwapchainImages[i],
-            .viewType = VK_IMAGE_VIEW_TYPE_2D,
-            .format = surfaceFormats[surfaceFormatIndex].format,
-            .components = {
-                .r = VK_COMPONENT_SWIZZLE_R,
-                .g = VK_COMPONENT_SWIZZLE_G,
-                .b = VK_COMPONENT_SWIZZLE_B,
-                .a = VK_COMPONENT_SWIZZLE_A,
-            },
-            .subresourceRange = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                .baseMipLevel = 0,
-                .levelCount = 1,
-                .baseArrayLayer = 0,
-                .layerCount = 1
-            }
+    // ================================================================================
+    // 6. VkMemoryAllocator 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkMemoryAllocator 생성");
+    VkMemoryAllocatorCreateInfo memoryAllocatorCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATOR_CREATE_INFO,
+        .flags = memoryBudgetEnabled ? VK_MEMORY_ALLOCATOR_CREATE_MEMORY_BUDGET_BIT : 0u,
+        .physicalDevice = mPhysicalDevice,
+        .blockSize = 16 * 1024 * 1024,
+        .strategy = VK_MEMORY_ALLOCATOR_STRATEGY_FREE_LIST
+    };
+
+    VK_CHECK_ERROR(vkCreateMemoryAllocator(mDevice,
+                                           &memoryAllocatorCreateInfo,
+                                           nullptr,
+                                           &mMemoryAllocator));
+
+    // ================================================================================
+    // 7. VkSurface 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkSurface 생성");
+    // 오프스크린 이미지는 VkSurface의 포맷 중 항상 선택하던 포맷으로 만든다.
+    if (mOffscreen) {
+        mSurfaceFormat = {
+            .format = VK_FORMAT_R8G8B8A8_UNORM,
+            .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR
         };
+    } else {
+        createSurface(nativeWindow);
+    }
 
-        VK_CHECK_ERROR(vkCreateImageView(mDevice,
-                                         &imageViewCreateInfo,
-                                         nullptr,
-                                         &mSwapchainImageViews[i]));
+    // 장면 이미지와 스왑체인 이미지는 같은 포맷이므로 선택한 포맷이 Blit과 선형 필터링을 지원해야 하고,
+    // 스왑체인 이미지는 복사 대상이 될 수 있어야 한다.
+    // VkRenderPass의 finalLayout과 VkGpuProfiler가 동적 해상도에 따라 정해지므로 만들기 전에 한번만 확인한다.
+    if (mDynamicResolution) {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, mSurfaceFormat.format, &formatProperties);
+
+        constexpr VkFormatFeatureFlags blitFormatFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                                                            VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                            VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        if ((formatProperties.optimalTilingFeatures & blitFormatFeatures) != blitFormatFeatures) {
+            aout << "Linear blits are not supported, disabling dynamic resolution." << endl;
+            mDynamicResolution = false;
+        }
+    }
+    if (mDynamicResolution && !mOffscreen) {
+        VkSurfaceCapabilitiesKHR surfaceCapabilities;
+        VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(mPhysicalDevice,
+                                                                 mSurface,
+                                                                 &surfaceCapabilities));
+        if (!(surfaceCapabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT)) {
+            aout << "Swapchain images can't be blit destinations, disabling dynamic resolution." << endl;
+            mDynamicResolution = false;
+        }
     }
 
     // ================================================================================
     // 8. VkCommandPool 생성
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkCommandPool 생성");
     VkCommandPoolCreateInfo commandPoolCreateInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
         .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT |
@@ -377,46 +738,89 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
     // ================================================================================
     // 9. VkCommandBuffer 할당
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkCommandBuffer 할당");
     VkCommandBufferAllocateInfo commandBufferAllocateInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .commandPool = mCommandPool,
         .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = swapchainImageCount
+        .commandBufferCount = kMaxFramesInFlight
     };
 
-    mCommandBuffers.resize(swapchainImageCount);
+    // 프레임마다 사용하는 리소스는 스왑체인 이미지 개수와 상관없이 kMaxFramesInFlight개 만든다.
+    mCommandBuffers.resize(kMaxFramesInFlight);
     VK_CHECK_ERROR(vkAllocateCommandBuffers(mDevice, &commandBufferAllocateInfo, mCommandBuffers.data()));
 
-    mFencesForSubmit.resize(swapchainImageCount);
-    for (auto& fence : mFencesForSubmit) {
+    if (mConfig.recordThreadCount && !mConfig.prerecordCommandBuffers) {
         // ================================================================================
-        // 10. VkFence 생성
+        // 10. VkCommandRecorder 생성
         // ================================================================================
-        VkFenceCreateInfo fenceCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-            .flags = VK_FENCE_CREATE_SIGNALED_BIT
+        VK_TRACE_NEXT_STEP(traceSteps, "VkCommandRecorder 생성");
+        VkCommandRecorderCreateInfo commandRecorderCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_RECORDER_CREATE_INFO,
+            .queueFamilyIndex = mQueueFamilyIndex,
+            .threadCount = mConfig.recordThreadCount,
+            .frameCount = kMaxFramesInFlight
         };
 
-        VK_CHECK_ERROR(vkCreateFence(mDevice, &fenceCreateInfo, nullptr, &fence));
+        VK_CHECK_ERROR(vkCreateCommandRecorder(mDevice,
+                                               &commandRecorderCreateInfo,
+                                               nullptr,
+                                               &mCommandRecorder));
     }
 
-    mFencesForAcquire.resize(swapchainImageCount);
-    for (auto& fence : mFencesForAcquire) {
+    // ================================================================================
+    // 11. VkTimeline 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkTimeline 생성");
+    // 타임라인 VkSemaphore를 지원하지 않으면 VkTimeline이 제출마다 VkFence를 사용한다.
+    VkTimelineCreateInfo timelineCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_CREATE_INFO,
+        .timelineSemaphore = timelineSemaphore
+    };
+
+    VK_CHECK_ERROR(vkCreateTimeline(mDevice, &timelineCreateInfo, nullptr, &mTimeline));
+
+    // ================================================================================
+    // 12. VkDeletionQueue 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDeletionQueue 생성");
+    VkDeletionQueueCreateInfo deletionQueueCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_DELETION_QUEUE_CREATE_INFO,
+        .timeline = mTimeline
+    };
+
+    VK_CHECK_ERROR(vkCreateDeletionQueue(mDevice, &deletionQueueCreateInfo, nullptr, &mDeletionQueue));
+
+    // 동적 해상도는 GPU 프레임 시간으로 조절하므로 통계를 출력하지 않아도 만든다.
+    if (mConfig.gpuProfilerInterval || mDynamicResolution) {
         // ================================================================================
-        // 11. VkFence 생성
+        // 13. VkGpuProfiler 생성
         // ================================================================================
-        VkFenceCreateInfo fenceCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        VK_TRACE_NEXT_STEP(traceSteps, "VkGpuProfiler 생성");
+        VkGpuProfilerCreateInfo gpuProfilerCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_GPU_PROFILER_CREATE_INFO,
+            .physicalDevice = mPhysicalDevice,
+            .queueFamilyIndex = mQueueFamilyIndex,
+            .frameCount = kMaxFramesInFlight,
+            .maxScopeCount = kGpuProfilerMaxScopeCount,
+            .historyLength = kGpuProfilerHistoryLength
         };
 
-        VK_CHECK_ERROR(vkCreateFence(mDevice, &fenceCreateInfo, nullptr, &fence));
+        const auto result = vkCreateGpuProfiler(mDevice, &gpuProfilerCreateInfo, nullptr, &mGpuProfiler);
+        assert(result == VK_SUCCESS || result == VK_ERROR_FEATURE_NOT_PRESENT);
+        if (result != VK_SUCCESS) {
+            aout << "Timestamps are not supported, disabling the GPU profiler." << endl;
+            mDynamicResolution = false;
+        }
     }
 
-    mSemaphores.resize(swapchainImageCount);
-    for (auto& semaphore : mSemaphores) {
+    // 이미지를 얻는 VkSemaphore는 제출된 작업이 기다리므로 프레임의 타임라인 값을 기다린 후 다시 사용할 수 있다.
+    mSemaphoresForAcquire.resize(kMaxFramesInFlight);
+    for (auto& semaphore : mSemaphoresForAcquire) {
         // ================================================================================
-        // 12. VkSemaphore 생성
+        // 14. VkSemaphore 생성
         // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "VkSemaphore 생성");
         VkSemaphoreCreateInfo semaphoreCreateInfo{
             .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
         };
@@ -425,90 +829,128 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
     }
 
     // ================================================================================
-    // 13. VkRenderPass 생성
-    // ================================================================================
-    VkAttachmentDescription attachmentDescription{
-        .format = surfaceFormats[surfaceFormatIndex].format,
-        .samples = VK_SAMPLE_COUNT_1_BIT,
-        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+    // 15. VkRenderPass 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkRenderPass 생성");
+    // 멀티샘플링을 하면 스왑체인 이미지는 Resolve 대상이 되므로 CLEAR하지 않는다.
+    // 동적 해상도를 사용하면 첫번째 Attachment는 장면 이미지이며 렌더 패스가 끝난 후 복사 원본으로 변환한다.
+    vector<VkAttachmentDescription> attachmentDescriptions{
+        {
+            .format = mSurfaceFormat.format,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp = mSampleCount == VK_SAMPLE_COUNT_1_BIT ? VK_ATTACHMENT_LOAD_OP_CLEAR
+                                                            : VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout = mDynamicResolution ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                                              : mSwapchainImageFinalLayout
+        }
+    };
+    mClearValues = {{.color{.float32{0.15, 0.15, 0.15, 1.0}}}};
+
+    VkAttachmentReference colorAttachmentReference{
+        .attachment = 0,
+        .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
     };
 
-    VkAttachmentReference attachmentReference{
+    VkAttachmentReference resolveAttachmentReference{
         .attachment = 0,
         .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
     };
 
+    // 멀티샘플 Attachment는 서브패스가 끝날 때 Resolve되므로 저장하지 않는다.
+    // 타일 기반 GPU는 타일 메모리에서 Resolve한 결과만 메인 메모리에 쓴다.
+    if (mSampleCount != VK_SAMPLE_COUNT_1_BIT) {
+        colorAttachmentReference.attachment = attachmentDescriptions.size();
+        attachmentDescriptions.push_back({
+            .format = mSurfaceFormat.format,
+            .samples = mSampleCount,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+        });
+        mClearValues.push_back(mClearValues[0]);
+    }
+
+    // 깊이는 렌더 패스 밖에서 읽지 않으므로 CLEAR로 시작하고 저장하지 않는다.
+    // 타일 기반 GPU는 깊이를 타일 메모리에서만 처리하고 메인 메모리에 쓰지 않는다.
+    VkAttachmentReference depthAttachmentReference{
+        .attachment = static_cast<uint32_t>(attachmentDescriptions.size()),
+        .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+    };
+
+    if (mConfig.depthTest) {
+        attachmentDescriptions.push_back({
+            .format = kDepthFormat,
+            .samples = mSampleCount,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+        });
+        mClearValues.push_back({.depthStencil{.depth = 1.0f, .stencil = 0}});
+    }
+
     VkSubpassDescription subpassDescription{
         .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
         .colorAttachmentCount = 1,
-        .pColorAttachments = &attachmentReference
+        .pColorAttachments = &colorAttachmentReference,
+        .pResolveAttachments = mSampleCount != VK_SAMPLE_COUNT_1_BIT ? &resolveAttachmentReference : nullptr,
+        .pDepthStencilAttachment = mConfig.depthTest ? &depthAttachmentReference : nullptr
     };
 
-    VkRenderPassCreateInfo renderPassCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-        .attachmentCount = 1,
-        .pAttachments = &attachmentDescription,
-        .subpassCount = 1,
-        .pSubpasses = &subpassDescription
+    // 이미지를 얻는 VkSemaphore를 COLOR_ATTACHMENT_OUTPUT 단계에서 기다리므로
+    // 레이아웃 변환과 CLEAR도 이 단계 이후에 실행되도록 한다.
+    // 깊이 Attachment는 모든 프레임이 공유하므로 이전 프레임의 깊이 쓰기가 끝난 후 CLEAR한다.
+    VkSubpassDependency subpassDependency{
+        .srcSubpass = VK_SUBPASS_EXTERNAL,
+        .dstSubpass = 0,
+        .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        .srcAccessMask = VK_ACCESS_NONE,
+        .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
     };
 
-    VK_CHECK_ERROR(vkCreateRenderPass(mDevice, &renderPassCreateInfo, nullptr, &mRenderPass));
+    // 멀티샘플 Attachment도 모든 프레임이 공유하므로 이전 프레임의 쓰기가 끝난 후 CLEAR한다.
+    if (mSampleCount != VK_SAMPLE_COUNT_1_BIT) {
+        subpassDependency.srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    }
 
-    mFramebuffers.resize(swapchainImageCount);
-    for (auto i = 0; i != swapchainImageCount; ++i) {
-        // ================================================================================
-        // 14. VkFramebuffer 생성
-        // ================================================================================
-        VkFramebufferCreateInfo framebufferCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass = mRenderPass,
-            .attachmentCount = 1,
-            .pAttachments = &mSwapchainImageViews[i],
-            .width = mSwapchainImageExtent.width,
-            .height = mSwapchainImageExtent.height,
-            .layers = 1
-        };
+    if (mConfig.depthTest) {
+        subpassDependency.srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        subpassDependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        subpassDependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        subpassDependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
 
-        VK_CHECK_ERROR(vkCreateFramebuffer(mDevice,
-                                           &framebufferCreateInfo,
-                                           nullptr,
-                                           &mFramebuffers[i]));
-    }
-
-    // ================================================================================
-    // 15. Vertex VkShaderModule 생성
-    // ================================================================================
-    string_view vertexShaderCode = {
-        "#version 310 es                                                         \n"
-        "                                                                        \n"
-        "layout(location = 0) in vec3 inPosition;                                \n"
-        "layout(location = 1) in vec3 inColor;                                   \n"
-        "layout(location = 2) in vec2 inUv;                                      \n"
-        "                                                                        \n"
-        "layout(location = 0) out vec3 outColor;                                 \n"
-        "layout(location = 1) out vec2 outUv;                                    \n"
-        "                                                                        \n"
-        "layout(set = 0, binding = 0) uniform Uniform {                          \n"
-        "    float position[2];                                                  \n"
-        "    float ratio;                                                        \n"
-        "};                                                                      \n"
-        "                                                                        \n"
-        "void main() {                                                           \n"
-        "    gl_Position = vec4(inPosition, 1.0);                                \n"
-        "    gl_Position.x *= ratio;                                             \n"
-        "    gl_Position.x += position[0];                                       \n"
-        "    gl_Position.y += position[1];                                       \n"
-        "    outColor = inColor;                                                 \n"
-        "    outUv = inUv;                                                       \n"
-        "}                                                                       \n"
+    VkRenderPassCreateInfo renderPassCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .attachmentCount = static_cast<uint32_t>(attachmentDescriptions.size()),
+        .pAttachments = attachmentDescriptions.data(),
+        .subpassCount = 1,
+        .pSubpasses = &subpassDescription,
+        .dependencyCount = 1,
+        .pDependencies = &subpassDependency
     };
 
+    // Dynamic Rendering은 Attachment 정보를 기록할 때 전달하므로 Clear 값만 사용한다.
+    if (!mDynamicRendering) {
+        VK_CHECK_ERROR(vkCreateRenderPass(mDevice, &renderPassCreateInfo, nullptr, &mRenderPass));
+    }
+
+    // ================================================================================
+    // 16. Vertex VkShaderModule 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex VkShaderModule 생성");
     std::vector<uint32_t> vertexShaderBinary;
-    VK_CHECK_ERROR(vkCompileShader(vertexShaderCode,
+    VK_CHECK_ERROR(vkCompileShader(kTriangleVertexShaderCode,
                                    VK_SHADER_TYPE_VERTEX,
+                                   mInternalDataPath,
                                    &vertexShaderBinary));
 
     VkShaderModuleCreateInfo vertexShaderModuleCreateInfo{
@@ -523,28 +965,18 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
                                         &mVertexShaderModule));
 
     // ================================================================================
-    // 16. Fragment VkShaderModule 생성
+    // 17. Fragment VkShaderModule 생성
     // ================================================================================
-    string_view fragmentShaderCode = {
-        "#version 310 es                                                         \n"
-        "precision mediump float;                                                \n"
-        "                                                                        \n"
-        "layout(location = 0) in vec3 inColor;                                   \n"
-        "layout(location = 1) in vec2 inUv;                                      \n"
-        "                                                                        \n"
-        "layout(location = 0) out vec4 outColor;                                 \n"
-        "                                                                        \n"
-        "layout(set = 0, binding = 1) uniform sampler2D combinedImageSampler;    \n"
-        "                                                                        \n"
-        "void main() {                                                           \n"
-        "    vec4 texColor = texture(combinedImageSampler, inUv);                \n"
-        "    outColor = vec4(inColor * texColor.rgb, 1.0);                       \n"
-        "}                                                                       \n"
-    };
-
+    VK_TRACE_NEXT_STEP(traceSteps, "Fragment VkShaderModule 생성");
     std::vector<uint32_t> fragmentShaderBinary;
-    VK_CHECK_ERROR(vkCompileShader(fragmentShaderCode,
+    VK_CHECK_ERROR(mBindlessTextures ?
+                   vkCompileShader(kTriangleBindlessFragmentShaderCode,
+                                   VK_SHADER_TYPE_FRAGMENT,
+                                   mInternalDataPath,
+                                   &fragmentShaderBinary) :
+                   vkCompileShader(kTriangleFragmentShaderCode,
                                    VK_SHADER_TYPE_FRAGMENT,
+                                   mInternalDataPath,
                                    &fragmentShaderBinary));
 
     VkShaderModuleCreateInfo fragmentShaderModuleCreateInfo{
@@ -559,190 +991,241 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
                                         &mFragmentShaderModule));
 
     // ================================================================================
-    // 17. VkDescriptorSetLayout 생성
+    // 18. Compute VkShaderModule 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Compute VkShaderModule 생성");
+    std::vector<uint32_t> computeShaderBinary;
+    VK_CHECK_ERROR(vkCompileShader(kAnimateComputeShaderCode,
+                                   VK_SHADER_TYPE_COMPUTE,
+                                   mInternalDataPath,
+                                   &computeShaderBinary));
+
+    VkShaderModuleCreateInfo computeShaderModuleCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = computeShaderBinary.size() * sizeof(uint32_t),
+        .pCode = computeShaderBinary.data()
+    };
+
+    VK_CHECK_ERROR(vkCreateShaderModule(mDevice,
+                                        &computeShaderModuleCreateInfo,
+                                        nullptr,
+                                        &mComputeShaderModule));
+
+    // ================================================================================
+    // 19. VkStateCache 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkStateCache 생성");
+    VkStateCacheCreateInfo stateCacheCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_STATE_CACHE_CREATE_INFO
+    };
+
+    VK_CHECK_ERROR(vkCreateStateCache(mDevice, &stateCacheCreateInfo, nullptr, &mStateCache));
+
+    // ================================================================================
+    // 20. VkDescriptorSetLayout 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDescriptorSetLayout 생성");
+    // Uniform은 Compute 셰이더만 사용하고 그리기마다의 데이터는 Push Constant로 전달하므로
+    // Dynamic Uniform이 없어서 Bindless 텍스처 배열도 같은 VkDescriptorSet에 둘 수 있다.
+    // 사용 중인 VkDescriptorSet이라도 사용되지 않는 원소는 언제든지 갱신할 수 있다.
+    const VkDescriptorBindingFlags descriptorBindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                                                            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                                                            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo descriptorSetLayoutBindingFlagsCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = 1,
+        .pBindingFlags = &descriptorBindingFlags
+    };
+
+    VkDescriptorSetLayoutBinding descriptorSetLayoutBinding{
+        .binding = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .descriptorCount = mBindlessTextures ? kMaxTextureCount : 1,
+        .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+    };
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = mBindlessTextures ? &descriptorSetLayoutBindingFlagsCreateInfo : nullptr,
+        .flags = mBindlessTextures ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT : 0u,
+        .bindingCount = 1,
+        .pBindings = &descriptorSetLayoutBinding
+    };
+
+    VK_CHECK_ERROR(vkAcquireDescriptorSetLayout(mStateCache,
+                                                &descriptorSetLayoutCreateInfo,
+                                                &mDescriptorSetLayout));
+
+    // ================================================================================
+    // 21. Compute VkDescriptorSetLayout 생성
     // ================================================================================
-    array<VkDescriptorSetLayoutBinding, 2> descriptorSetLayoutBindings{
+    VK_TRACE_NEXT_STEP(traceSteps, "Compute VkDescriptorSetLayout 생성");
+    // 텍스처가 업로드되는 동안 그래픽스 VkDescriptorSet이 갱신되므로 Compute는 따로 사용한다.
+    array<VkDescriptorSetLayoutBinding, 4> computeDescriptorSetLayoutBindings{
         VkDescriptorSetLayoutBinding{
             .binding = 0,
-            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
             .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
         },
         VkDescriptorSetLayoutBinding{
             .binding = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        },
+        VkDescriptorSetLayoutBinding{
+            .binding = 2,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
+        },
+        VkDescriptorSetLayoutBinding{
+            .binding = 3,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
             .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT
         }
     };
 
-    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+    VkDescriptorSetLayoutCreateInfo computeDescriptorSetLayoutCreateInfo{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount = descriptorSetLayoutBindings.size(),
-        .pBindings = descriptorSetLayoutBindings.data()
+        .bindingCount = computeDescriptorSetLayoutBindings.size(),
+        .pBindings = computeDescriptorSetLayoutBindings.data()
     };
 
-    VK_CHECK_ERROR(vkCreateDescriptorSetLayout(mDevice,
-                                               &descriptorSetLayoutCreateInfo,
-                                               nullptr,
-                                               &mDescriptorSetLayout));
+    VK_CHECK_ERROR(vkAcquireDescriptorSetLayout(mStateCache,
+                                                &computeDescriptorSetLayoutCreateInfo,
+                                                &mComputeDescriptorSetLayout));
 
     // ================================================================================
-    // 18. VkPipelineLayout 생성
+    // 22. VkPipelineLayout 생성
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkPipelineLayout 생성");
+    // 회전, 화면 비율과 텍스처 인덱스는 VkCommandBuffer에 직접 기록한다.
+    // 128바이트는 모든 구현이 지원해야 하는 maxPushConstantsSize의 최소값이다.
+    static_assert(sizeof(PushConstant) <= 128);
+    VkPushConstantRange pushConstantRange{
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        .offset = 0,
+        .size = sizeof(PushConstant)
+    };
+
     VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .setLayoutCount = 1,
-        .pSetLayouts = &mDescriptorSetLayout
+        .pSetLayouts = &mDescriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
     };
 
-    VK_CHECK_ERROR(vkCreatePipelineLayout(mDevice,
-                                          &pipelineLayoutCreateInfo,
-                                          nullptr,
-                                          &mPipelineLayout));
+    VK_CHECK_ERROR(vkAcquirePipelineLayout(mStateCache,
+                                           &pipelineLayoutCreateInfo,
+                                           &mPipelineLayout));
 
     // ================================================================================
-    // 19. Graphics VkPipeline 생성
+    // 23. Compute VkPipelineLayout 생성
     // ================================================================================
-    array<VkPipelineShaderStageCreateInfo, 2> pipelineShaderStageCreateInfos{
-        VkPipelineShaderStageCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_VERTEX_BIT,
-            .module = mVertexShaderModule,
-            .pName = "main"
-        },
-        VkPipelineShaderStageCreateInfo{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-            .module = mFragmentShaderModule,
-            .pName = "main"
-        }
+    VK_TRACE_NEXT_STEP(traceSteps, "Compute VkPipelineLayout 생성");
+    VkPipelineLayoutCreateInfo computePipelineLayoutCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &mComputeDescriptorSetLayout
     };
 
-    VkVertexInputBindingDescription vertexInputBindingDescription{
-        .binding = 0,
-        .stride = sizeof(Vertex),
-        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
-    };
+    VK_CHECK_ERROR(vkAcquirePipelineLayout(mStateCache,
+                                           &computePipelineLayoutCreateInfo,
+                                           &mComputePipelineLayout));
 
-    array<VkVertexInputAttributeDescription, 3> vertexInputAttributeDescriptions{
-        VkVertexInputAttributeDescription{
-            .location = 0,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, position)
-        },
-        VkVertexInputAttributeDescription{
-            .location = 1,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = offsetof(Vertex, color)
-        },
-        VkVertexInputAttributeDescription{
-            .location = 2,
-            .binding = 0,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = offsetof(Vertex, uv)
+    // ================================================================================
+    // 24. VkPipelineCache 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkPipelineCache 생성");
+    std::vector<uint8_t> pipelineCacheData;
+    if (mInternalDataPath) {
+        if (vkReadFile(string(mInternalDataPath) + "/pipeline_cache.bin",
+                       &pipelineCacheData) != VK_SUCCESS ||
+            !vkIsPipelineCacheCompatible(physicalDeviceProperties, pipelineCacheData)) {
+            pipelineCacheData.clear();
         }
-    };
-
-    VkPipelineVertexInputStateCreateInfo pipelineVertexInputStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount = 1,
-        .pVertexBindingDescriptions = &vertexInputBindingDescription,
-        .vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributeDescriptions.size()),
-        .pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data()
-    };
-
-    VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
-    };
-
-    VkViewport viewport{
-        .width = static_cast<float>(mSwapchainImageExtent.width),
-        .height = static_cast<float>(mSwapchainImageExtent.height),
-        .maxDepth = 1.0f
-    };
-
-    VkRect2D scissor{
-        .extent = mSwapchainImageExtent
-    };
-
-    VkPipelineViewportStateCreateInfo pipelineViewportStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
-        .viewportCount = 1,
-        .pViewports = &viewport,
-        .scissorCount = 1,
-        .pScissors = &scissor
-    };
+    }
 
-    VkPipelineRasterizationStateCreateInfo pipelineRasterizationStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-        .polygonMode = VK_POLYGON_MODE_FILL,
-        .cullMode = VK_CULL_MODE_NONE,
-        .lineWidth = 1.0f
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = pipelineCacheData.size(),
+        .pInitialData = pipelineCacheData.data()
     };
 
-    VkPipelineMultisampleStateCreateInfo pipelineMultisampleStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT
-    };
+    VK_CHECK_ERROR(vkCreatePipelineCache(mDevice,
+                                         &pipelineCacheCreateInfo,
+                                         nullptr,
+                                         &mPipelineCache));
 
-    VkPipelineDepthStencilStateCreateInfo pipelineDepthStencilStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO
-    };
+    if (mConfig.frameCaptureCount || mConfig.frameTraceDataSize) {
+        // ================================================================================
+        // 25. VkFrameTrace 생성
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "VkFrameTrace 생성");
+        VkFrameTraceCreateInfo frameTraceCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_FRAME_TRACE_CREATE_INFO,
+            .initialDataSize = mConfig.frameTraceDataSize,
+            .pInitialData = mConfig.pFrameTraceData
+        };
 
-    VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentState{
-        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
-                          VK_COLOR_COMPONENT_G_BIT |
-                          VK_COLOR_COMPONENT_B_BIT |
-                          VK_COLOR_COMPONENT_A_BIT
-    };
+        VK_CHECK_ERROR(vkCreateFrameTrace(&frameTraceCreateInfo, nullptr, &mFrameTrace));
 
-    VkPipelineColorBlendStateCreateInfo pipelineColorBlendStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-        .attachmentCount = 1,
-        .pAttachments = &pipelineColorBlendAttachmentState
-    };
+        // 재생하는 프레임이 트레이스와 같은 VkPipeline으로 그려지도록 변형을 바로 컴파일한다.
+        VkFrameTraceProperties frameTraceProperties;
+        vkGetFrameTraceProperties(mFrameTrace, &frameTraceProperties);
+        if (mConfig.frameTraceDataSize && frameTraceProperties.frameCount) {
+            mFrameTraceReplay = true;
+            mConfig.pipelineCompileThreadCount = 0;
+        }
+    }
 
-    constexpr array<VkDynamicState, 2> dynamicStates{
-        VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR
-    };
+    // ================================================================================
+    // 26. Graphics VkPipeline 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Graphics VkPipeline 생성");
+    // 가벼운 변형은 VkPipelineCompiler를 만들기 전에 요청해서 바로 컴파일한다.
+    // 다른 변형은 필요할 때 같은 VkShaderModule과 VkPipelineCache로 만든다.
+    VkPipeline pipeline;
+    VK_CHECK_ERROR(getPipelineVariant(kFallbackShaderVariant, &pipeline));
+    bindPipelineVariant(kFallbackShaderVariant, pipeline);
 
-    VkPipelineDynamicStateCreateInfo pipelineDynamicStateCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount = dynamicStates.size(),
-        .pDynamicStates = dynamicStates.data()
-    };
+    if (mConfig.pipelineCompileThreadCount) {
+        // ================================================================================
+        // 27. VkPipelineCompiler 생성
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "VkPipelineCompiler 생성");
+        VkPipelineCompilerCreateInfo pipelineCompilerCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_COMPILER_CREATE_INFO,
+            .threadCount = mConfig.pipelineCompileThreadCount
+        };
 
-    VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .stageCount = pipelineShaderStageCreateInfos.size(),
-        .pStages = pipelineShaderStageCreateInfos.data(),
-        .pVertexInputState = &pipelineVertexInputStateCreateInfo,
-        .pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo,
-        .pViewportState = &pipelineViewportStateCreateInfo,
-        .pRasterizationState = &pipelineRasterizationStateCreateInfo,
-        .pMultisampleState = &pipelineMultisampleStateCreateInfo,
-        .pDepthStencilState = &pipelineDepthStencilStateCreateInfo,
-        .pColorBlendState = &pipelineColorBlendStateCreateInfo,
-        .pDynamicState = &pipelineDynamicStateCreateInfo,
-        .layout = mPipelineLayout,
-        .renderPass = mRenderPass
-    };
+        VK_CHECK_ERROR(vkCreatePipelineCompiler(mDevice,
+                                                &pipelineCompilerCreateInfo,
+                                                nullptr,
+                                                &mPipelineCompiler));
+    }
 
-    VK_CHECK_ERROR(vkCreateGraphicsPipelines(mDevice,
-                                             VK_NULL_HANDLE,
-                                             1,
-                                             &graphicsPipelineCreateInfo,
-                                             nullptr,
-                                             &mPipeline));
+    // ================================================================================
+    // 28. 설정한 Graphics VkPipeline 컴파일 시작
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "설정한 Graphics VkPipeline 컴파일 시작");
+    // 워커 스레드가 없거나 가벼운 변형과 같으면 바로 결과를 얻는다.
+    const auto pipelineResult = getPipelineVariant({mConfig.textured, mConfig.tonemap}, &pipeline);
+    if (pipelineResult != VK_NOT_READY) {
+        VK_CHECK_ERROR(pipelineResult);
+        bindPipelineVariant({mConfig.textured, mConfig.tonemap}, pipeline);
+        mPipelineReady = true;
+    }
 
     // ================================================================================
-    // 20. Vertex 정의
+    // 29. Vertex 정의
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex 정의");
     constexpr array<Vertex, 3> vertices{
         Vertex{
             .position{0.0, -0.5, 0.0},
@@ -760,402 +1243,347 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
             .uv{0.0, 1.0}
         },
     };
-    constexpr VkDeviceSize vertexDataSize{vertices.size() * sizeof(Vertex)};
 
     // ================================================================================
-    // 21. Staging VkBuffer 생성
+    // 30. VkMesh 생성
     // ================================================================================
-    VkBufferCreateInfo stagingBufferCreateInfo{
-        .sType =VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = vertexDataSize,
-        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+    VK_TRACE_NEXT_STEP(traceSteps, "VkMesh 생성");
+    // 메시 에셋이 없으면 삼각형 하나를 메시로 사용한다. 어느 경우든 중복된 정점을 합치고
+    // 정점 캐시와 오버드로를 위해 삼각형 순서를 바꾼 인덱스를 만든다.
+    VkMeshCreateInfo meshCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MESH_CREATE_INFO,
+        .flags = VK_MESH_CREATE_OPTIMIZE_VERTEX_CACHE_BIT | VK_MESH_CREATE_OPTIMIZE_OVERDRAW_BIT,
+        .pAssetManager = mAssetManager,
+        .pFileName = mConfig.meshFileName,
+        .vertexCount = vertices.size(),
+        .pVertices = vertices.data()
     };
 
-    VkBuffer stagingBuffer;
-    VK_CHECK_ERROR(vkCreateBuffer(mDevice, &stagingBufferCreateInfo, nullptr, &stagingBuffer));
+    VkMesh mesh;
+    VK_CHECK_ERROR(vkCreateMesh(mDevice, &meshCreateInfo, nullptr, &mesh));
+
+    VkMeshProperties meshProperties;
+    vkGetMeshProperties(mesh, &meshProperties);
+    mIndexType = meshProperties.indexType;
+    mMeshExtent = {meshProperties.extent.x, meshProperties.extent.y};
+
+    vector<CompactVertex> compactVertices;
+    if (mConfig.compactVertices) {
+        compactVertices.resize(meshProperties.vertexCount);
+        transform(meshProperties.pVertices,
+                  meshProperties.pVertices + meshProperties.vertexCount,
+                  compactVertices.begin(),
+                  toCompactVertex);
+    }
 
-    // ================================================================================
-    // 22. Staging VkBuffer의 VkMemoryRequirements 얻기
-    // ================================================================================
-    VkMemoryRequirements stagingMemoryRequirements;
-    vkGetBufferMemoryRequirements(mDevice, stagingBuffer, &stagingMemoryRequirements);
+    const void *vertexData = mConfig.compactVertices ? static_cast<const void *>(compactVertices.data()) :
+                                                       static_cast<const void *>(meshProperties.pVertices);
+    const VkDeviceSize vertexDataSize{meshProperties.vertexCount *
+                                      (mConfig.compactVertices ? sizeof(CompactVertex) : sizeof(Vertex))};
+
+    // ================================================================================
+    // 31. Instance 정의
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Instance 정의");
+    // 인스턴스가 하나면 기존처럼 가운데에서 오른쪽으로 움직이고,
+    // 여러 개면 임의의 위치와 방향으로 움직이며 개수에 따라 크기를 줄인다.
+    // 텍스처 배열의 레이어는 인스턴스 순서대로 돌아가며 사용한다.
+    vector<Instance> instances(max(mConfig.instanceCount, 1u));
+    const auto textureLayerCount = max(static_cast<uint32_t>(mConfig.textureLayerFileNames.size()), 1u);
+    instances[0] = {
+        .position{0.0, 0.0},
+        .velocity{1.0, 0.0},
+        .scale = 1.0f / sqrt(static_cast<float>(instances.size())),
+        .layer = 0
+    };
 
-    // ================================================================================
-    // 23. Staging VkDeviceMemory를 할당 할 수 있는 메모리 타입 인덱스 얻기
-    // ================================================================================
-    uint32_t stagingMemoryTypeIndex;
-    VK_CHECK_ERROR(vkGetMemoryTypeIndex(mPhysicalDeviceMemoryProperties,
-                                        stagingMemoryRequirements,
-                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                        &stagingMemoryTypeIndex));
+    mt19937 generator(instances.size());
+    uniform_real_distribution<float> offsetDistribution(-1.5f, 1.5f);
+    uniform_real_distribution<float> angleDistribution(0.0f, 2.0f * M_PI);
+    uniform_real_distribution<float> speedDistribution(0.5f, 1.5f);
+    for (auto i = 1; i != instances.size(); ++i) {
+        const auto angle = angleDistribution(generator);
+        const auto speed = speedDistribution(generator);
+        instances[i] = {
+            .position{offsetDistribution(generator), offsetDistribution(generator)},
+            .velocity{speed * cos(angle), speed * sin(angle)},
+            .scale = instances[0].scale,
+            .layer = static_cast<uint32_t>(i) % textureLayerCount
+        };
+    }
 
     // ================================================================================
-    // 24. Staging VkDeviceMemory 할당
+    // 32. 간접 그리기 명령 정의
     // ================================================================================
-    VkMemoryAllocateInfo stagingMemoryAllocateInfo{
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = stagingMemoryRequirements.size,
-        .memoryTypeIndex = stagingMemoryTypeIndex
-    };
+    VK_TRACE_NEXT_STEP(traceSteps, "간접 그리기 명령 정의");
+    // 기록하는 스레드마다 하나의 간접 그리기 명령을 사용하며 각 명령은 연속된 인스턴스 영역을 담당한다.
+    // Compute 셰이더가 화면에 보이는 인스턴스를 영역에 채우고 instanceCount를 센다.
+    uint32_t drawCommandCount = 1;
+    if (mCommandRecorder) {
+        VkCommandRecorderProperties commandRecorderProperties;
+        vkGetCommandRecorderProperties(mCommandRecorder, &commandRecorderProperties);
+        drawCommandCount = commandRecorderProperties.threadCount;
+    }
 
-    VkDeviceMemory stagingMemory;
-    VK_CHECK_ERROR(vkAllocateMemory(mDevice, &stagingMemoryAllocateInfo, nullptr, &stagingMemory));
+    const auto instanceCount = static_cast<uint32_t>(instances.size());
+    mInstancesPerDrawCommand = (instanceCount + drawCommandCount - 1) / drawCommandCount;
+    mDrawCommands.resize(drawCommandCount);
+    for (uint32_t i = 0; i != drawCommandCount; ++i) {
+        mDrawCommands[i] = {
+            .indexCount = meshProperties.indexCount,
+            .instanceCount = 0,
+            .firstIndex = 0,
+            .vertexOffset = 0,
+            .firstInstance = i * mInstancesPerDrawCommand
+        };
+    }
 
-    // ================================================================================
-    // 25. Staging VkBuffer와 Staging VkDeviceMemory 바인드
-    // ================================================================================
-    VK_CHECK_ERROR(vkBindBufferMemory(mDevice, stagingBuffer, stagingMemory, 0));
+    // Vertex 데이터 뒤에 Index 데이터, Instance 데이터, 보이는 Instance 데이터, 간접 그리기 명령을 순서대로 배치한다.
+    // Index 데이터 뒤는 모두 Storage VkBuffer로도 사용되므로 오프셋을 정렬한다.
+    const auto storageAlignment = physicalDeviceProperties.limits.minStorageBufferOffsetAlignment;
+    const VkDeviceSize instanceDataSize{instances.size() * sizeof(Instance)};
+    const VkDeviceSize drawCommandDataSize{mDrawCommands.size() * sizeof(VkDrawIndexedIndirectCommand)};
+    mIndexDataOffset = vkAlignUp(vertexDataSize, sizeof(uint32_t));
+    mInstanceDataOffset = vkAlignUp(mIndexDataOffset + meshProperties.indexDataSize, storageAlignment);
+    mVisibleInstanceDataOffset = vkAlignUp(mInstanceDataOffset + instanceDataSize, storageAlignment);
+    mDrawCommandOffset = vkAlignUp(mVisibleInstanceDataOffset + instanceDataSize, storageAlignment);
+    const VkDeviceSize bufferDataSize{mDrawCommandOffset + drawCommandDataSize};
+
+    // ================================================================================
+    // 33. Compute VkPipeline 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Compute VkPipeline 생성");
+    // 인스턴스 개수와 그리기 명령마다의 인스턴스 개수는 바뀌지 않으므로 특수화 상수로 전달한다.
+    const array<uint32_t, 2> computeSpecializationConstants{instanceCount, mInstancesPerDrawCommand};
+    array<VkSpecializationMapEntry, 2> computeSpecializationMapEntries;
+    const auto computeSpecializationInfo = vkGetSpecializationInfo(computeSpecializationConstants,
+                                                                   &computeSpecializationMapEntries);
+
+    VkComputePipelineCreateInfo computePipelineCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = mComputeShaderModule,
+            .pName = "main",
+            .pSpecializationInfo = &computeSpecializationInfo
+        },
+        .layout = mComputePipelineLayout
+    };
 
-    // ================================================================================
-    // 26. Vertex 데이터 복사
-    // ================================================================================
-    void *stagingData;
-    VK_CHECK_ERROR(vkMapMemory(mDevice, stagingMemory, 0, vertexDataSize, 0, &stagingData));
-    memcpy(stagingData, vertices.data(), vertexDataSize);
-    vkUnmapMemory(mDevice, stagingMemory);
+    VK_CHECK_ERROR(vkCreateComputePipelines(mDevice,
+                                            mPipelineCache,
+                                            1,
+                                            &computePipelineCreateInfo,
+                                            nullptr,
+                                            &mComputePipeline));
 
     // ================================================================================
-    // 27. Vertex VkBuffer 생성
+    // 34. Vertex VkBuffer 생성
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex VkBuffer 생성");
     VkBufferCreateInfo vertexBufferCreateInfo{
         .sType =VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = vertexDataSize,
-        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+        .size = bufferDataSize,
+        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                 VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                 VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
     };
 
     VK_CHECK_ERROR(vkCreateBuffer(mDevice, &vertexBufferCreateInfo, nullptr, &mVertexBuffer));
 
     // ================================================================================
-    // 28. Vertex VkBuffer의 VkMemoryRequirements 얻기
+    // 35. Vertex VkBuffer의 VkMemoryRequirements 얻기
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex VkBuffer의 VkMemoryRequirements 얻기");
     VkMemoryRequirements vertexMemoryRequirements;
     vkGetBufferMemoryRequirements(mDevice, mVertexBuffer, &vertexMemoryRequirements);
 
     // ================================================================================
-    // 29. Vertex VkDeviceMemory를 할당 할 수 있는 메모리 타입 인덱스 얻기
-    // ================================================================================
-    uint32_t vertexMemoryTypeIndex;
-    VK_CHECK_ERROR(vkGetMemoryTypeIndex(mPhysicalDeviceMemoryProperties,
-                                        vertexMemoryRequirements,
-                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                        &vertexMemoryTypeIndex));
-
-    // ================================================================================
-    // 30. Vertex VkDeviceMemory 할당
+    // 36. Vertex VkMemoryAllocation 생성
     // ================================================================================
-    VkMemoryAllocateInfo vertexMemoryAllocateInfo{
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = vertexMemoryRequirements.size,
-        .memoryTypeIndex = vertexMemoryTypeIndex
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex VkMemoryAllocation 생성");
+    VkMemoryAllocationCreateInfo vertexMemoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = vertexMemoryRequirements,
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .preferredMemoryPropertyFlags = mConfig.directUpload ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT : 0u
     };
 
-    VK_CHECK_ERROR(vkAllocateMemory(mDevice, &vertexMemoryAllocateInfo, nullptr, &mVertexMemory));
+    VK_CHECK_ERROR(vkCreateMemoryAllocation(mMemoryAllocator,
+                                            &vertexMemoryAllocationCreateInfo,
+                                            &mVertexAllocation));
 
-    // ================================================================================
-    // 31. Vertex VkBuffer와 Vertex VkDeviceMemory 바인드
-    // ================================================================================
-    VK_CHECK_ERROR(vkBindBufferMemory(mDevice, mVertexBuffer, mVertexMemory, 0));
+    VkMemoryAllocationProperties vertexAllocationProperties;
+    vkGetMemoryAllocationProperties(mVertexAllocation, &vertexAllocationProperties);
 
     // ================================================================================
-    // 32. VkCommandBuffer 기록 시작
+    // 37. Vertex VkBuffer와 Vertex VkMemoryAllocation 바인드
     // ================================================================================
-    VkCommandBufferBeginInfo commandBufferBeginInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
-
-    auto commandBuffer = mCommandBuffers[0];
-    VK_CHECK_ERROR(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex VkBuffer와 Vertex VkMemoryAllocation 바인드");
+    VK_CHECK_ERROR(vkBindBufferMemory(mDevice,
+                                      mVertexBuffer,
+                                      vertexAllocationProperties.memory,
+                                      vertexAllocationProperties.offset));
 
     // ================================================================================
-    // 33. Staging VkBuffer에서 Vertex VkBuffer로 복사
+    // 38. VkStagingUploader 생성
     // ================================================================================
-    VkBufferCopy bufferCopy{
-        .size = vertexDataSize
-    };
-
-    vkCmdCopyBuffer(commandBuffer, stagingBuffer, mVertexBuffer, 1, &bufferCopy);
-
-    mUniformBuffers.resize(swapchainImageCount);
-    mUniformMemories.resize(swapchainImageCount);
-    mUniformData.resize(swapchainImageCount);
-    for (auto i = 0; i != swapchainImageCount; ++i) {
-        auto& uniformBuffer = mUniformBuffers[i];
-        auto& uniformMemory = mUniformMemories[i];
-        auto& uniformData = mUniformData[i];
-
-        // ================================================================================
-        // 34. Uniform VkBuffer 생성
-        // ================================================================================
-        VkBufferCreateInfo uniformBufferCreateInfo{
-            .sType =VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = sizeof(Uniform),
-            .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
-        };
-
-        VK_CHECK_ERROR(vkCreateBuffer(mDevice, &uniformBufferCreateInfo, nullptr, &uniformBuffer));
-
-        // ================================================================================
-        // 35. Uniform VkBuffer의 VkMemoryRequirements 얻기
-        // ================================================================================
-        VkMemoryRequirements uniformMemoryRequirements;
-        vkGetBufferMemoryRequirements(mDevice, uniformBuffer, &uniformMemoryRequirements);
-
-        // ================================================================================
-        // 36. Uniform VkDeviceMemory를 할당 할 수 있는 메모리 타입 인덱스 얻기
-        // ================================================================================
-        uint32_t uniformMemoryTypeIndex;
-        VK_CHECK_ERROR(vkGetMemoryTypeIndex(mPhysicalDeviceMemoryProperties,
-                                            uniformMemoryRequirements,
-                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                            &uniformMemoryTypeIndex));
-
-        // ================================================================================
-        // 37. Uniform VkDeviceMemory 할당
-        // ================================================================================
-        VkMemoryAllocateInfo uniformMemoryAllocateInfo{
-            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-            .allocationSize = uniformMemoryRequirements.size,
-            .memoryTypeIndex = uniformMemoryTypeIndex
+    VK_TRACE_NEXT_STEP(traceSteps, "VkStagingUploader 생성");
+    // 계속 맵핑된 하나의 스테이징 영역에 여러 업로드를 모아서 한번에 제출하고,
+    // 영역은 큐를 기다리지 않고 제출의 타임라인 값이 완료되면 회수한다.
+    // Vertex VkBuffer가 맵핑되어 있으면 스테이징 영역이 필요 없으므로 메모리를 할당하지 않는다.
+    // 셰이딩 비율 Attachment도 스테이징 영역을 거쳐서 업로드한다.
+    if (!vertexAllocationProperties.pMappedData || mFoveatedShading) {
+        VkStagingUploaderCreateInfo stagingUploaderCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_STAGING_UPLOADER_CREATE_INFO,
+            .memoryAllocator = mMemoryAllocator,
+            .queueFamilyIndex = mQueueFamilyIndex,
+            .queue = mQueue,
+            .timeline = mTimeline,
+            .arenaSize = kStagingArenaSize
         };
 
-        VK_CHECK_ERROR(vkAllocateMemory(mDevice, &uniformMemoryAllocateInfo, nullptr, &uniformMemory));
-
-        // ================================================================================
-        // 38. Uniform VkBuffer와 Vertex VkDeviceMemory 바인드
-        // ================================================================================
-        VK_CHECK_ERROR(vkBindBufferMemory(mDevice, uniformBuffer, uniformMemory, 0));
-
-        // ================================================================================
-        // 39. Uniform 데이터 초기화
-        // ================================================================================
-        VK_CHECK_ERROR(vkMapMemory(mDevice, uniformMemory, 0, VK_WHOLE_SIZE, 0, &uniformData));
-        memset(uniformData, 0, sizeof(Uniform));
+        VK_CHECK_ERROR(vkCreateStagingUploader(mDevice,
+                                               &stagingUploaderCreateInfo,
+                                               nullptr,
+                                               &mStagingUploader));
     }
 
     // ================================================================================
-    // 40. VkTexture 생성
-    // ================================================================================
-    VkTextureCreateInfo textureCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO,
-        .pAssetManager = mAssetManager,
-        .pFileName = "vulkan.png"
-    };
-
-    VK_CHECK_ERROR(vkCreateTexture(mDevice, &textureCreateInfo, nullptr, &mTexture));
-
-    // ================================================================================
-    // 41. VkTexture 속성 얻기
-    // ================================================================================
-    VkTextureProperties textureProperties;
-    vkGetTextureProperties(mTexture, &textureProperties);
-
-    // ================================================================================
-    // 42. VkImage 생성
-    // ================================================================================
-    VkImageCreateInfo imageCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
-        .imageType = VK_IMAGE_TYPE_2D,
-        .format = textureProperties.format,
-        .extent = textureProperties.extent,
-        .mipLevels = 1,
-        .arrayLayers = 1,
-        .samples = VK_SAMPLE_COUNT_1_BIT,
-        .tiling = VK_IMAGE_TILING_LINEAR,
-        .usage = VK_IMAGE_USAGE_SAMPLED_BIT,
-        .initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED,
-    };
-
-    VK_CHECK_ERROR(vkCreateImage(mDevice,
-                                 &imageCreateInfo,
-                                 nullptr,
-                                 &mImage));
-
-    // ================================================================================
-    // 43. VkImage의 VkMemoryRequirements 얻기
-    // ================================================================================
-    VkMemoryRequirements imageMemoryRequirements;
-    vkGetImageMemoryRequirements(mDevice, mImage, &imageMemoryRequirements);
-
-
-    // ================================================================================
-    // 44. Image VkDeviceMemory를 할당 할 수 있는 메모리 타입 인덱스 얻기
-    // ================================================================================
-    uint32_t imageMemoryTypeIndex;
-    VK_CHECK_ERROR(vkGetMemoryTypeIndex(mPhysicalDeviceMemoryProperties,
-                                        imageMemoryRequirements,
-                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                        &imageMemoryTypeIndex));
-
-    // ================================================================================
-    // 45. Image VkDeviceMemory 할당
-    // ================================================================================
-    VkMemoryAllocateInfo imageMemoryAllocateInfo{
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = imageMemoryRequirements.size,
-        .memoryTypeIndex = imageMemoryTypeIndex
-    };
-
-    VK_CHECK_ERROR(vkAllocateMemory(mDevice, &imageMemoryAllocateInfo, nullptr, &mMemory));
-
-    // ================================================================================
-    // 46. VkImage와 Image VkDeviceMemory 바인드
-    // ================================================================================
-    VK_CHECK_ERROR(vkBindImageMemory(mDevice, mImage, mMemory, 0));
-
-    // ================================================================================
-    // 47. VkImage의 VkImageSubresource 얻기
-    // ================================================================================
-    VkImageSubresource imageSubresource{
-        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-        .mipLevel = 0,
-        .arrayLayer = 0
-    };
-
-    VkSubresourceLayout subresourceLayout;
-    vkGetImageSubresourceLayout(mDevice,
-                                mImage,
-                                &imageSubresource,
-                                &subresourceLayout);
-
-    // ================================================================================
-    // 48. Image 데이터 초기화
-    // ================================================================================
-    void* imageData;
-    VK_CHECK_ERROR(vkMapMemory(mDevice, mMemory, 0, VK_WHOLE_SIZE, 0, &imageData));
-
-    for (auto h = 0; h < textureProperties.extent.height; ++h) {
-        const auto dstOffset = h * subresourceLayout.rowPitch;
-        const auto srcRowPitch = textureProperties.extent.width * 4;
-        const auto srcOffset = h * srcRowPitch;
-        memcpy(static_cast<uint8_t *>(imageData) + dstOffset,
-               static_cast<uint8_t *>(textureProperties.pData) + srcOffset,
-               srcRowPitch);
+    // 39. Vertex, Index와 Instance 데이터 업로드
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Vertex, Index와 Instance 데이터 업로드");
+    if (!vertexAllocationProperties.pMappedData) {
+        // 복사 결과는 같은 큐에 나중에 제출되는 Vertex 입력과 Compute 셰이더에서 사용한다.
+        VK_CHECK_ERROR(vkUploadBuffer(mStagingUploader, mVertexBuffer, 0, vertexDataSize, vertexData));
+        VK_CHECK_ERROR(vkUploadBuffer(mStagingUploader,
+                                      mVertexBuffer,
+                                      mIndexDataOffset,
+                                      meshProperties.indexDataSize,
+                                      meshProperties.pIndexData));
+        VK_CHECK_ERROR(vkUploadBuffer(mStagingUploader,
+                                      mVertexBuffer,
+                                      mInstanceDataOffset,
+                                      instanceDataSize,
+                                      instances.data()));
+        VK_CHECK_ERROR(vkFlushStagingUploader(mStagingUploader));
+    } else {
+        // 호스트 쓰기는 vkQueueSubmit에서 디바이스에 보이게 되므로 HOST_COHERENT가 아닐 때만 플러시한다.
+        auto bufferData = static_cast<uint8_t *>(vertexAllocationProperties.pMappedData);
+        memcpy(bufferData, vertexData, vertexDataSize);
+        memcpy(bufferData + mIndexDataOffset, meshProperties.pIndexData, meshProperties.indexDataSize);
+        memcpy(bufferData + mInstanceDataOffset, instances.data(), instanceDataSize);
+        VK_CHECK_ERROR(vkFlushMemoryAllocation(mMemoryAllocator, mVertexAllocation, 0, VK_WHOLE_SIZE));
     }
-
-    vkUnmapMemory(mDevice, mMemory);
+    vkDestroyMesh(mDevice, mesh, nullptr);
 
     // ================================================================================
-    // 49. VkImageView 생성
+    // 40. Uniform VkRingBuffer 생성
     // ================================================================================
-    VkImageViewCreateInfo imageViewCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-        .image = mImage,
-        .viewType = VK_IMAGE_VIEW_TYPE_2D,
-        .format = textureProperties.format,
-        .components = {
-            .r = VK_COMPONENT_SWIZZLE_R,
-            .g = VK_COMPONENT_SWIZZLE_G,
-            .b = VK_COMPONENT_SWIZZLE_B,
-            .a = VK_COMPONENT_SWIZZLE_A,
-        },
-        .subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1
-        }
+    VK_TRACE_NEXT_STEP(traceSteps, "Uniform VkRingBuffer 생성");
+    VkRingBufferCreateInfo uniformRingBufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_RING_BUFFER_CREATE_INFO,
+        .physicalDevice = mPhysicalDevice,
+        .memoryAllocator = mMemoryAllocator,
+        .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        .frameSize = 64 * 1024,
+        .frameCount = kMaxFramesInFlight
     };
 
-    VK_CHECK_ERROR(vkCreateImageView(mDevice, &imageViewCreateInfo, nullptr, &mImageView));
+    VK_CHECK_ERROR(vkCreateRingBuffer(mDevice,
+                                      &uniformRingBufferCreateInfo,
+                                      nullptr,
+                                      &mUniformRingBuffer));
 
     // ================================================================================
-    // 50. VkImageLayout 변환
+    // 41. VkResidencyManager 생성
     // ================================================================================
-    VkImageMemoryBarrier imageMemoryBarrier{
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_NONE,
-        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_PREINITIALIZED,
-        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-        .image = mImage,
-        .subresourceRange = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1
-        }
+    VK_TRACE_NEXT_STEP(traceSteps, "VkResidencyManager 생성");
+    VkResidencyManagerCreateInfo residencyManagerCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_RESIDENCY_MANAGER_CREATE_INFO,
+        .memoryAllocator = mMemoryAllocator,
+        .budgetRatio = mConfig.residencyBudgetRatio
     };
 
-    vkCmdPipelineBarrier(commandBuffer,
-                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                         0,
-                         0,
-                         nullptr,
-                         0,
-                         nullptr,
-                         1,
-                         &imageMemoryBarrier);
+    VK_CHECK_ERROR(vkCreateResidencyManager(mDevice,
+                                            &residencyManagerCreateInfo,
+                                            nullptr,
+                                            &mResidencyManager));
 
     // ================================================================================
-    // 51. VkCommandBuffer 기록 종료
+    // 42. VkTextureLoader 생성
     // ================================================================================
-    VK_CHECK_ERROR(vkEndCommandBuffer(commandBuffer));
-
-    // ================================================================================
-    // 52. VkCommandBuffer 제출
-    // ================================================================================
-    VkSubmitInfo submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &commandBuffer
+    VK_TRACE_NEXT_STEP(traceSteps, "VkTextureLoader 생성");
+    VkTextureLoaderCreateInfo textureLoaderCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_TEXTURE_LOADER_CREATE_INFO,
+        .physicalDevice = mPhysicalDevice,
+        .memoryAllocator = mMemoryAllocator,
+        .pAssetManager = mAssetManager,
+        .queueFamilyIndex = mTransferQueueFamilyIndex,
+        .queue = mTransferQueue,
+        .dstQueueFamilyIndex = mQueueFamilyIndex,
+        .threadCount = 2
     };
 
-    VK_CHECK_ERROR(vkQueueSubmit(mQueue, 1, &submitInfo, VK_NULL_HANDLE));
-    VK_CHECK_ERROR(vkQueueWaitIdle(mQueue));
-
-    // ================================================================================
-    // 53. Staging VkBuffer 파괴
-    // ================================================================================
-    vkFreeMemory(mDevice, stagingMemory, nullptr);
+    VK_CHECK_ERROR(vkCreateTextureLoader(mDevice,
+                                         &textureLoaderCreateInfo,
+                                         nullptr,
+                                         &mTextureLoader));
 
     // ================================================================================
-    // 54. VkSampler 생성
+    // 43. VkTextureLoad 생성
     // ================================================================================
-    vkDestroyBuffer(mDevice, stagingBuffer, nullptr);
+    VK_TRACE_NEXT_STEP(traceSteps, "VkTextureLoad 생성");
+    createTextureLoad();
 
     // ================================================================================
-    // 55. VkSampler 생성
+    // 44. VkSampler 생성
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkSampler 생성");
+    // Mipmap 레벨 개수는 업로드가 끝나야 알 수 있으므로 LOD를 제한하지 않는다.
     const VkSamplerCreateInfo samplerCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
         .magFilter = VK_FILTER_NEAREST,
-        .minFilter = VK_FILTER_NEAREST,
+        .minFilter = VK_FILTER_LINEAR,
+        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
         .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
         .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .minLod = 0.0f,
+        .maxLod = VK_LOD_CLAMP_NONE
     };
 
-    VK_CHECK_ERROR(vkCreateSampler(mDevice,
-                                   &samplerCreateInfo,
-                                   nullptr,
-                                   &mSampler));
+    VK_CHECK_ERROR(vkAcquireSampler(mStateCache,
+                                    &samplerCreateInfo,
+                                    &mSampler));
 
     // ================================================================================
-    // 56. VkDescriptorPool 생성
+    // 45. VkDescriptorPool 생성
     // ================================================================================
-    array<VkDescriptorPoolSize, 2> descriptorPoolSizes{
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDescriptorPool 생성");
+    array<VkDescriptorPoolSize, 3> descriptorPoolSizes{
         VkDescriptorPoolSize{
-            .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount = 1 * swapchainImageCount
+            .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .descriptorCount = 1
         },
         VkDescriptorPoolSize{
             .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1 * swapchainImageCount
+            .descriptorCount = mBindlessTextures ? kMaxTextureCount : 1
+        },
+        VkDescriptorPoolSize{
+            .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = 3
         }
     };
 
     VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
-        .maxSets = swapchainImageCount,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT |
+                 (mBindlessTextures ? VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT : 0),
+        .maxSets = 2,
         .poolSizeCount = descriptorPoolSizes.size(),
         .pPoolSizes = descriptorPoolSizes.data()
     };
@@ -1166,8 +1594,9 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
                                           &mDescriptorPool));
 
     // ================================================================================
-    // 57. VkDescriptorSet 할당
+    // 46. VkDescriptorSet 할당
     // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDescriptorSet 할당");
     VkDescriptorSetAllocateInfo descriptorSetAllocateInfo{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .descriptorPool = mDescriptorPool,
@@ -1175,275 +1604,2791 @@ VkRenderer::VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager)
         .pSetLayouts = &mDescriptorSetLayout
     };
 
-    mDescriptorSets.resize(swapchainImageCount);
-    for (auto &descriptorSet : mDescriptorSets) {
-        VK_CHECK_ERROR(vkAllocateDescriptorSets(mDevice, &descriptorSetAllocateInfo, &descriptorSet));
-    }
+    VK_CHECK_ERROR(vkAllocateDescriptorSets(mDevice, &descriptorSetAllocateInfo, &mDescriptorSet));
 
-    for (auto i = 0; i != swapchainImageCount; ++i) {
-        auto uniformBuffer = mUniformBuffers[i];
-        auto descriptorSet = mDescriptorSets[i];
+    VkDescriptorSetAllocateInfo computeDescriptorSetAllocateInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = mDescriptorPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &mComputeDescriptorSetLayout
+    };
 
-        // ================================================================================
-        // 58. VkDescriptorSet 갱신
-        // ================================================================================
-        VkDescriptorBufferInfo descriptorBufferInfo{
-            .buffer = uniformBuffer,
-            .range = VK_WHOLE_SIZE
-        };
+    VK_CHECK_ERROR(vkAllocateDescriptorSets(mDevice, &computeDescriptorSetAllocateInfo, &mComputeDescriptorSet));
 
-        VkDescriptorImageInfo descriptorImageInfo{
-            .sampler = mSampler,
-            .imageView = mImageView,
-            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-        };
+    // ================================================================================
+    // 47. VkDescriptorSet 갱신
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkDescriptorSet 갱신");
+    VkRingBufferProperties uniformRingBufferProperties;
+    vkGetRingBufferProperties(mUniformRingBuffer, &uniformRingBufferProperties);
 
-        array<VkWriteDescriptorSet, 2> writeDescriptorSets{
-            VkWriteDescriptorSet{
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = descriptorSet,
-                .dstBinding = 0,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .pBufferInfo = &descriptorBufferInfo
-            },
-            VkWriteDescriptorSet{
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet = descriptorSet,
-                .dstBinding = 1,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                .pImageInfo = &descriptorImageInfo
-            }
-        };
+    VkDescriptorBufferInfo descriptorBufferInfo{
+        .buffer = uniformRingBufferProperties.buffer,
+        .range = sizeof(Uniform)
+    };
 
-        vkUpdateDescriptorSets(mDevice,
-                               writeDescriptorSets.size(),
-                               writeDescriptorSets.data(),
-                               0,
-                               nullptr);
-    }
+    array<VkDescriptorBufferInfo, 3> storageDescriptorBufferInfos{
+        VkDescriptorBufferInfo{
+            .buffer = mVertexBuffer,
+            .offset = mInstanceDataOffset,
+            .range = instanceDataSize
+        },
+        VkDescriptorBufferInfo{
+            .buffer = mVertexBuffer,
+            .offset = mVisibleInstanceDataOffset,
+            .range = instanceDataSize
+        },
+        VkDescriptorBufferInfo{
+            .buffer = mVertexBuffer,
+            .offset = mDrawCommandOffset,
+            .range = drawCommandDataSize
+        }
+    };
+
+    // 텍스처는 업로드가 완료된 후 render()에서 갱신한다.
+    array<VkWriteDescriptorSet, 2> writeDescriptorSets{
+        VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = mComputeDescriptorSet,
+            .dstBinding = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .pBufferInfo = &descriptorBufferInfo
+        },
+        VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = mComputeDescriptorSet,
+            // 종류가 같은 binding 1부터 3까지 연속해서 갱신한다.
+            .dstBinding = 1,
+            .descriptorCount = storageDescriptorBufferInfos.size(),
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = storageDescriptorBufferInfos.data()
+        }
+    };
+
+    vkUpdateDescriptorSets(mDevice, writeDescriptorSets.size(), writeDescriptorSets.data(), 0, nullptr);
+
+    // ================================================================================
+    // 48. VkSwapchain 생성
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "VkSwapchain 생성");
+    createSwapchain(VK_NULL_HANDLE);
+
+    // ================================================================================
+    // 49. 렌더 스레드 시작
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "렌더 스레드 시작");
+    // 이후로 Vulkan 객체는 렌더 스레드에서만 사용한다.
+    mRenderThread = thread(&VkRenderer::runRenderThread, this);
 }
 
 VkRenderer::~VkRenderer() {
-    VK_CHECK_ERROR(vkDeviceWaitIdle(mDevice));
-    vkFreeDescriptorSets(mDevice, mDescriptorPool, mDescriptorSets.size(), mDescriptorSets.data());
+    postRenderCommand({.type = RENDER_COMMAND_TYPE_QUIT});
+    mRenderThread.join();
+
+    // 디바이스 전체가 아니라 렌더 스레드가 제출한 프레임만 기다린다.
+    // 텍스처 업로드는 VkTextureLoad를 파괴할 때 자신의 VkFence를 기다린다.
+    // VkSwapchain도 VkDeletionQueue에 예약되어 마지막으로 제출된 프레임이 끝난 후 파괴된다.
+    destroySwapchain();
+    // 디바이스를 잃었으면 기다릴 작업이 없으며 오브젝트는 그대로 파괴할 수 있다.
+    VkTimelineProperties timelineProperties;
+    vkGetTimelineProperties(mTimeline, &timelineProperties);
+    const auto waitResult = VK_COUNT_RESULT(vkWaitTimeline(mTimeline, timelineProperties.submittedValue, UINT64_MAX));
+    if (waitResult == VK_ERROR_DEVICE_LOST) {
+        handleDeviceLost();
+    } else {
+        VK_CHECK_ERROR(waitResult);
+    }
+    vkDestroyDeletionQueue(mDevice, mDeletionQueue, nullptr);
+    if (mGpuProfiler) {
+        if (mInternalDataPath) {
+            writeGpuProfilerStatistics(string(mInternalDataPath) + "/gpu_profile.json");
+        }
+        vkDestroyGpuProfiler(mDevice, mGpuProfiler, nullptr);
+    }
+    if (mFrameTrace) {
+        if (mInternalDataPath && !mFrameTraceReplay) {
+            const auto frameTraceData = getFrameTraceData();
+            vkWriteFile(string(mInternalDataPath) + "/frame_trace.bin",
+                        frameTraceData.data(),
+                        frameTraceData.size());
+        }
+        vkDestroyFrameTrace(mFrameTrace, nullptr);
+    }
+    vkFreeDescriptorSets(mDevice, mDescriptorPool, 1, &mComputeDescriptorSet);
+    vkFreeDescriptorSets(mDevice, mDescriptorPool, 1, &mDescriptorSet);
     vkDestroyDescriptorPool(mDevice, mDescriptorPool, nullptr);
-    vkDestroySampler(mDevice, mSampler, nullptr);
-    vkDestroyImageView(mDevice, mImageView, nullptr);
-    vkFreeMemory(mDevice, mMemory, nullptr);
-    vkDestroyImage(mDevice, mImage, nullptr);
-    vkDestroyTexture(mDevice, mTexture, nullptr);
-    mUniformData.clear();
-    for (auto uniformMemory : mUniformMemories) {
-        vkUnmapMemory(mDevice, uniformMemory);
-    }
-    for (auto uniformMemory : mUniformMemories) {
-        vkFreeMemory(mDevice, uniformMemory, nullptr);
-    }
-    mUniformMemories.clear();
-    for (auto uniformBuffer : mUniformBuffers) {
-        vkDestroyBuffer(mDevice, uniformBuffer, nullptr);
-    }
-    mUniformBuffers.clear();
-    vkFreeMemory(mDevice, mVertexMemory, nullptr);
+    vkReleaseStateObject(mStateCache, VK_OBJECT_TYPE_SAMPLER, reinterpret_cast<uint64_t>(mSampler));
+    if (mTextureResource) {
+        vkDestroyResidentResource(mResidencyManager, mTextureResource);
+    }
+    vkDestroyResidencyManager(mDevice, mResidencyManager, nullptr);
+    if (mTextureLoad) {
+        vkDestroyTextureLoad(mTextureLoader, mTextureLoad);
+    }
+    vkDestroyTextureLoader(mDevice, mTextureLoader, nullptr);
+    if (mStagingUploader) {
+        vkDestroyStagingUploader(mDevice, mStagingUploader, nullptr);
+    }
+    vkDestroyRingBuffer(mDevice, mUniformRingBuffer, nullptr);
+    // Vertex VkMemoryAllocation은 VkMemoryAllocator를 파괴할 때 블록과 함께 해제된다.
     vkDestroyBuffer(mDevice, mVertexBuffer, nullptr);
-    vkDestroyDescriptorSetLayout(mDevice, mDescriptorSetLayout, nullptr);
-    vkDestroyPipelineLayout(mDevice, mPipelineLayout, nullptr);
-    vkDestroyPipeline(mDevice, mPipeline, nullptr);
+    vkReleaseStateObject(mStateCache,
+                         VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                         reinterpret_cast<uint64_t>(mComputeDescriptorSetLayout));
+    vkReleaseStateObject(mStateCache,
+                         VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                         reinterpret_cast<uint64_t>(mDescriptorSetLayout));
+    vkReleaseStateObject(mStateCache,
+                         VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+                         reinterpret_cast<uint64_t>(mComputePipelineLayout));
+    vkReleaseStateObject(mStateCache,
+                         VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+                         reinterpret_cast<uint64_t>(mPipelineLayout));
+    vkDestroyPipeline(mDevice, mComputePipeline, nullptr);
+    // 컴파일 중인 변형은 끝날 때까지 기다리고 시작하지 않은 변형은 취소한다.
+    for (const auto &[variant, pipelineVariant]: mPipelineVariants) {
+        if (pipelineVariant.compile) {
+            vkDestroyPipelineCompile(mPipelineCompiler, pipelineVariant.compile);
+        }
+        vkDestroyPipeline(mDevice, pipelineVariant.pipeline, nullptr);
+    }
+    if (mPipelineCompiler) {
+        vkDestroyPipelineCompiler(mDevice, mPipelineCompiler, nullptr);
+    }
+    // 워커 스레드의 컴파일이 VkPipelineLayout을 사용하므로 VkPipelineCompiler가 파괴된 후에 파괴한다.
+    vkDestroyStateCache(mDevice, mStateCache, nullptr);
+    if (mInternalDataPath) {
+        size_t pipelineCacheDataSize;
+        VK_CHECK_ERROR(vkGetPipelineCacheData(mDevice, mPipelineCache, &pipelineCacheDataSize, nullptr));
+
+        vector<uint8_t> pipelineCacheData(pipelineCacheDataSize);
+        VK_CHECK_ERROR(vkGetPipelineCacheData(mDevice,
+                                              mPipelineCache,
+                                              &pipelineCacheDataSize,
+                                              pipelineCacheData.data()));
+
+        vkWriteFile(string(mInternalDataPath) + "/pipeline_cache.bin",
+                    pipelineCacheData.data(),
+                    pipelineCacheDataSize);
+    }
+    vkDestroyPipelineCache(mDevice, mPipelineCache, nullptr);
     vkDestroyShaderModule(mDevice, mVertexShaderModule, nullptr);
     vkDestroyShaderModule(mDevice, mFragmentShaderModule, nullptr);
-    for (auto framebuffer: mFramebuffers) {
-        vkDestroyFramebuffer(mDevice, framebuffer, nullptr);
-    }
-    mFramebuffers.clear();
+    vkDestroyShaderModule(mDevice, mComputeShaderModule, nullptr);
     vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
-    for (auto imageView: mSwapchainImageViews) {
-        vkDestroyImageView(mDevice, imageView, nullptr);
-    }
-    mSwapchainImageViews.clear();
-    for (auto semaphore : mSemaphores) {
+    for (auto semaphore : mSemaphoresForAcquire) {
         vkDestroySemaphore(mDevice, semaphore, nullptr);
     }
-    mSemaphores.clear();
-    for (auto fence : mFencesForAcquire) {
-        vkDestroyFence(mDevice, fence, nullptr);
-    }
-    mFencesForAcquire.clear();
-    for (auto fence : mFencesForSubmit) {
-        vkDestroyFence(mDevice, fence, nullptr);
+    mSemaphoresForAcquire.clear();
+    vkDestroyTimeline(mDevice, mTimeline, nullptr);
+    if (mCommandRecorder) {
+        vkDestroyCommandRecorder(mDevice, mCommandRecorder, nullptr);
     }
-    mFencesForSubmit.clear();
     vkFreeCommandBuffers(mDevice, mCommandPool, mCommandBuffers.size(), mCommandBuffers.data());
     vkDestroyCommandPool(mDevice, mCommandPool, nullptr);
-    vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
-    vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
+    if (mSurface) {
+        vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
+    }
+    vkDestroyMemoryAllocator(mDevice, mMemoryAllocator, nullptr);
     vkDestroyDevice(mDevice, nullptr);
+    if (mDebugUtilsMessenger) {
+        auto vkDestroyDebugUtilsMessenger = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>(
+                vkGetInstanceProcAddr(mInstance, "vkDestroyDebugUtilsMessengerEXT"));
+        vkDestroyDebugUtilsMessenger(mInstance, mDebugUtilsMessenger, nullptr);
+    }
     vkDestroyInstance(mInstance, nullptr);
 }
 
+vector<uint64_t> VkRenderer::waitOffscreenFrames() {
+    assert(mOffscreen && mConfig.offscreenFrameCount);
+
+    // 디바이스를 잃으면 그린 프레임까지만 반환한다.
+    unique_lock<mutex> guard(mRenderLock);
+    mRenderCondition.wait(guard, [this] {
+        return mOffscreenFrameTimes.size() == mConfig.offscreenFrameCount || mDeviceLost;
+    });
+    return mOffscreenFrameTimes;
+}
+
+void VkRenderer::handleDeviceLost() {
+    // 이후 제출과 기다리기는 모두 바로 실패하므로 더 이상 그리지 않고 파괴될 때까지 명령만 처리한다.
+    // 오브젝트는 디바이스를 잃어도 파괴할 수 있으므로 소멸자는 그대로 진행된다.
+    if (!mDeviceLost.exchange(true)) {
+        aout << "Device lost, stopping rendering." << endl;
+    }
+}
+
+vector<uint8_t> VkRenderer::getFrameTraceData() {
+    vector<uint8_t> frameTraceData;
+    if (!mFrameTrace) {
+        return frameTraceData;
+    }
+
+    lock_guard<mutex> guard(mRenderLock);
+    size_t frameTraceDataSize;
+    VK_CHECK_ERROR(vkGetFrameTraceData(mFrameTrace, &frameTraceDataSize, nullptr));
+
+    frameTraceData.resize(frameTraceDataSize);
+    VK_CHECK_ERROR(vkGetFrameTraceData(mFrameTrace, &frameTraceDataSize, frameTraceData.data()));
+    return frameTraceData;
+}
+
+void VkRenderer::printFrameTimeHistogram() {
+#ifdef VK_TRACE
+    mFrameTimeHistogram.print();
+#endif
+}
+
 void VkRenderer::render() {
-    auto fenceForSubmit = mFencesForSubmit[mFrameIndex];
-    auto fenceForAcquire = mFencesForAcquire[mFrameIndex];
-    auto commandBuffer = mCommandBuffers[mFrameIndex];
-    auto uniformData = static_cast<Uniform *>(mUniformData[mFrameIndex]);
-    auto descriptorSet = mDescriptorSets[mFrameIndex];
-    auto semaphore = mSemaphores[mFrameIndex];
+    // 윈도우가 없는 동안에는 그리지 않는다.
+    if (!mSurface && !mOffscreen) {
+        return;
+    }
 
-    // ================================================================================
-    // 1. VkFence 기다린 후 초기화
-    // ================================================================================
-    VK_CHECK_ERROR(vkWaitForFences(mDevice, 1, &fenceForSubmit, VK_TRUE, UINT64_MAX));
-    VK_CHECK_ERROR(vkResetFences(mDevice, 1, &fenceForSubmit));
+    VK_TRACE_SCOPE("VkRenderer::render");
 
-    // ================================================================================
-    // 2. 위치 정보 갱신
-    // ================================================================================
-    for (auto i = 0; i < 8; i += 4) {
-        uniformData->position[i] += 0.01;
-        if (uniformData->position[i] > 1.5) {
-            uniformData->position[i] = -1.5;
+    // 90Hz나 120Hz 화면에서도 실제 주사율로 간격을 맞추도록 측정된 갱신 주기를 먼저 구한다.
+    const auto refreshDuration = mRefreshDuration ? mRefreshDuration : kDefaultRefreshDuration;
+
+    // 열 상태가 나빠지면 출력 간격을 늘리고, 출력 시간을 지정할 수 없으면 CPU에서 기다려서
+    // 쓰로틀링이 걸리기 전에 CPU와 GPU가 쉬는 시간을 만든다.
+    auto presentInterval = max(mConfig.presentInterval, 1u);
+    if (mPerformanceHint && !mOffscreen) {
+        const auto thermalStatus = vkGetPerformanceHintThermalStatus(mPerformanceHint);
+        if (thermalStatus != mThermalStatus) {
+            aout << "Thermal status changed: " << mThermalStatus << " -> " << thermalStatus << endl;
+            mThermalStatus = thermalStatus;
+        }
+
+        if (thermalStatus >= mConfig.thermalThrottleStatus) {
+            presentInterval *= 2;
+            if (!mVkGetPastPresentationTimingGOOGLE) {
+                this_thread::sleep_until(mLastFrameStartTime +
+                                         chrono::nanoseconds(presentInterval * refreshDuration));
+            }
         }
     }
-    auto ratio = mSwapchainImageExtent.height / static_cast<float>(mSwapchainImageExtent.width);
-    uniformData->ratio = ratio;
+
+    const auto frameStartTime = chrono::steady_clock::now();
+    mLastFrameStartTime = frameStartTime;
+
+    const auto targetFrameDuration = presentInterval * refreshDuration;
+
+    if (mSwapchainOutdated) {
+        VK_TRACE_SCOPE("VkRenderer::recreateSwapchain");
+        recreateSwapchain();
+    }
+
+    auto semaphoreForAcquire = mSemaphoresForAcquire[mFrameIndex];
+    auto commandBuffer = mCommandBuffers[mFrameIndex];
+
+    VK_TRACE_STEPS(traceSteps);
 
     // ================================================================================
-    // 3. 화면에 출력할 수 있는 VkImage 얻기
+    // 1. 프레임의 타임라인 값 기다리기
     // ================================================================================
-    uint32_t swapchainImageIndex;
-    VK_CHECK_ERROR(vkAcquireNextImageKHR(mDevice,
-                                         mSwapchain,
-                                         UINT64_MAX,
-                                         VK_NULL_HANDLE,
-                                         fenceForAcquire,
-                                         &swapchainImageIndex));
-    auto framebuffer = mFramebuffers[swapchainImageIndex];
+    VK_TRACE_NEXT_STEP(traceSteps, "프레임의 타임라인 값 기다리기");
+    // 타임라인 값은 초기화할 필요가 없으며 한번도 제출하지 않은 프레임의 값 0은 바로 반환된다.
+    // 기다린 시간은 CPU 작업이 아니므로 APerformanceHintSession에 보고하지 않는다.
+    const auto waitStartTime = chrono::steady_clock::now();
+    const auto waitResult = VK_COUNT_RESULT(vkWaitTimeline(mTimeline, mFrameTimelineValues[mFrameIndex], UINT64_MAX));
+    if (waitResult == VK_ERROR_DEVICE_LOST) {
+        handleDeviceLost();
+        return;
+    }
+    VK_CHECK_ERROR(waitResult);
+    auto blockedTime = chrono::steady_clock::now() - waitStartTime;
+
+    // 이 프레임의 보조 VkCommandBuffer도 실행이 끝났으므로 VkCommandPool을 초기화한다.
+    if (mCommandRecorder) {
+        VK_CHECK_ERROR(vkBeginCommandRecorderFrame(mCommandRecorder, mFrameIndex));
+    }
 
     // ================================================================================
-    // 4. VkFence 기다린 후 초기화
+    // 2. 지연된 오브젝트 파괴
     // ================================================================================
-    VK_CHECK_ERROR(vkWaitForFences(mDevice, 1, &fenceForAcquire, VK_TRUE, UINT64_MAX));
-    VK_CHECK_ERROR(vkResetFences(mDevice, 1, &fenceForAcquire));
+    VK_TRACE_NEXT_STEP(traceSteps, "지연된 오브젝트 파괴");
+    const auto collectResult = VK_COUNT_RESULT(vkCollectDeletionQueue(mDeletionQueue));
+    if (collectResult == VK_ERROR_DEVICE_LOST) {
+        handleDeviceLost();
+        return;
+    }
+    VK_CHECK_ERROR(collectResult);
 
     // ================================================================================
-    // 5. VkCommandBuffer 초기화
+    // 3. 텍스처 레지던시 갱신
     // ================================================================================
-    vkResetCommandBuffer(commandBuffer, 0);
+    VK_TRACE_NEXT_STEP(traceSteps, "텍스처 레지던시 갱신");
+    // 이 프레임의 타임라인 값을 기다렸으므로 kMaxFramesInFlight 프레임 전까지의 GPU 작업은 끝났다.
+    // 예산을 넘어도 그릴 수는 있으므로 VK_INCOMPLETE는 무시한다.
+    if (mFrameCount >= kMaxFramesInFlight) {
+        vkUpdateResidency(mResidencyManager, mFrameCount - kMaxFramesInFlight, 0);
+    }
+
+    // 축출된 텍스처는 다시 그릴 때 불러오고, 메모리가 부족해서 불러오지 못했으면 잠시 후 다시 불러온다.
+    if (mTextureAcquired) {
+        vkTouchResidentResource(mResidencyManager, mTextureResource, mFrameCount);
+    } else if (mTextureLoad) {
+        const auto textureLoadStatus = vkGetTextureLoadStatus(mTextureLoad);
+        if (textureLoadStatus == VK_ERROR_OUT_OF_DEVICE_MEMORY) {
+            aout << "Out of memory budget, retrying the texture load later." << endl;
+            vkDestroyTextureLoad(mTextureLoader, mTextureLoad);
+            mTextureLoad = VK_NULL_HANDLE;
+            mTextureRetryTime = chrono::steady_clock::now() + kTextureRetryInterval;
+        } else if (textureLoadStatus != VK_SUCCESS && textureLoadStatus != VK_NOT_READY) {
+            // 파일이 없거나 지원하지 않는 포맷이면 다시 불러와도 실패하므로 텍스처 없이 배경만 그린다.
+            aout << "Fail to load the texture: " << vkToString(textureLoadStatus) << "." << endl;
+            vkDestroyTextureLoad(mTextureLoader, mTextureLoad);
+            mTextureLoad = VK_NULL_HANDLE;
+            mTextureLoadFailed = true;
+        }
+    } else if (!mTextureLoadFailed && chrono::steady_clock::now() >= mTextureRetryTime) {
+        createTextureLoad();
+    }
 
     // ================================================================================
-    // 6. VkCommandBuffer 기록 시작
+    // 4. 텍스처 업로드 제출
     // ================================================================================
-    VkCommandBufferBeginInfo commandBufferBeginInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-    };
+    VK_TRACE_NEXT_STEP(traceSteps, "텍스처 업로드 제출");
+    const auto textureSubmitResult = VK_COUNT_RESULT(vkSubmitTextureLoads(mTextureLoader));
+    if (textureSubmitResult == VK_ERROR_DEVICE_LOST) {
+        handleDeviceLost();
+        return;
+    }
+    VK_CHECK_ERROR(textureSubmitResult);
+
+    TraceFrame traceFrame{};
+    if (mFrameTraceReplay) {
+        // ================================================================================
+        // 5. 트레이스 프레임 읽기
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "트레이스 프레임 읽기");
+        readTraceFrame(&traceFrame);
+
+        // 변형은 렌더러를 만들 때와 같이 바로 컴파일되므로 트레이스의 VkPipeline으로 그린다.
+        ShaderVariant variant;
+        if (readTraceOp(traceFrame[TRACE_OP_TYPE_BIND_PIPELINE], &variant) && variant != mPipelineVariant) {
+            VkPipeline pipeline;
+            if (getPipelineVariant(variant, &pipeline) == VK_SUCCESS) {
+                bindPipelineVariant(variant, pipeline);
+
+                // VkPipeline이 바뀌었으므로 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+                ++mSceneVersion;
+            }
+        }
+
+        // 텍스처를 그린 프레임은 불러오기가 끝나기 전에 배경만 그리지 않도록 기다린다.
+        if (traceFrame[TRACE_OP_TYPE_BIND_TEXTURE] && !mTextureAcquired) {
+            waitTextureLoad();
+        }
+    }
 
-    VK_CHECK_ERROR(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+    if (!mPipelineReady) {
+        // ================================================================================
+        // 6. Graphics VkPipeline 교체
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "Graphics VkPipeline 교체");
+        // 컴파일을 기다리지 않으며 실패하면 계속 가벼운 변형으로 그린다.
+        VkPipeline pipeline;
+        const auto result = getPipelineVariant({mConfig.textured, mConfig.tonemap}, &pipeline);
+        if (result != VK_NOT_READY) {
+            mPipelineReady = true;
+            if (result == VK_SUCCESS) {
+                bindPipelineVariant({mConfig.textured, mConfig.tonemap}, pipeline);
+
+                // VkPipeline이 바뀌었으므로 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+                ++mSceneVersion;
+            } else {
+                aout << "Fail to compile the pipeline variant, keeping the fallback pipeline." << endl;
+            }
+        }
+    }
 
     // ================================================================================
-    // 7. VkRenderPass 시작
+    // 7. Uniform 데이터 할당
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "Uniform 데이터 할당");
+    vkBeginRingBufferFrame(mUniformRingBuffer, mFrameIndex);
+
+    VkDeviceSize uniformOffset;
+    void *uniformData;
+    VK_CHECK_ERROR(vkAllocateRingBuffer(mUniformRingBuffer,
+                                        sizeof(Uniform),
+                                        &uniformOffset,
+                                        &uniformData));
+
+    // 인스턴스의 위치는 Compute 셰이더에서 갱신하므로 인스턴스 개수와 상관없이 이 값만 쓴다.
+    // 이전처럼 프레임마다 0.01만큼 움직인다.
+    auto uniform = static_cast<Uniform *>(uniformData);
+    uniform->deltaTime = 0.01f;
+    uniform->meshExtent = mMeshExtent;
+
+    // 스왑체인 이미지는 화면의 기본 방향으로 만들어지므로 90도나 270도 회전된 경우
+    // 사용자가 보는 가로 세로는 반대가 된다.
+    const auto rotated = mPreTransform & (VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR |
+                                          VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR);
+    const auto width = static_cast<float>(rotated ? mSwapchainImageExtent.height : mSwapchainImageExtent.width);
+    const auto height = static_cast<float>(rotated ? mSwapchainImageExtent.width : mSwapchainImageExtent.height);
+    uniform->ratio = height / width;
+    mPushConstant.ratio = uniform->ratio;
+
+    // 컴포지터가 회전하지 않도록 Vertex 셰이더에서 미리 회전한다.
+    auto angle = 0.0f;
+    switch (mPreTransform) {
+        case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:
+            angle = M_PI_2;
+            break;
+        case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR:
+            angle = M_PI;
+            break;
+        case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR:
+            angle = M_PI + M_PI_2;
+            break;
+        default:
+            break;
+    }
+
+    mPushConstant.rotation[0] = cos(angle);
+    mPushConstant.rotation[1] = sin(angle);
+    mPushConstant.rotation[2] = -sin(angle);
+    mPushConstant.rotation[3] = cos(angle);
+
+    // 재생할 때는 트레이스의 값으로 덮어쓰며 Push Constant가 바뀌면 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+    if (mFrameTraceReplay) {
+        const auto pushConstant = mPushConstant;
+        readTraceOp(traceFrame[TRACE_OP_TYPE_UPDATE_UNIFORM], uniform);
+        readTraceOp(traceFrame[TRACE_OP_TYPE_PUSH_CONSTANTS], &mPushConstant);
+        if (memcmp(&pushConstant, &mPushConstant, sizeof(PushConstant)) != 0) {
+            ++mSceneVersion;
+        }
+    }
+
     // ================================================================================
-    VkRenderPassBeginInfo renderPassBeginInfo{
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = mRenderPass,
-        .framebuffer = framebuffer,
-        .renderArea{
-            .extent = mSwapchainImageExtent
-        },
-        .clearValueCount = 1,
-        .pClearValues = &mClearValue
-    };
+    // 8. 화면에 출력할 수 있는 VkImage 얻기
+    // ================================================================================
+    VK_TRACE_NEXT_STEP(traceSteps, "화면에 출력할 수 있는 VkImage 얻기");
+    // VkSwapchain이 VkSurface와 맞지 않으면 다시 만든 후 다음 프레임을 그린다.
+    // 이번 프레임은 아무것도 제출하지 않았으므로 다음 프레임에서 기다려도 바로 반환된다.
+    // 오프스크린 이미지는 프레임마다 하나씩 있으므로 프레임의 타임라인 값을 기다린 후 바로 사용할 수 있다.
+    uint32_t swapchainImageIndex = mFrameIndex;
+    if (!mOffscreen) {
+        const auto acquireStartTime = chrono::steady_clock::now();
+        auto result = VK_COUNT_RESULT(vkAcquireNextImageKHR(mDevice,
+                                                            mSwapchain,
+                                                            UINT64_MAX,
+                                                            semaphoreForAcquire,
+                                                            VK_NULL_HANDLE,
+                                                            &swapchainImageIndex));
+        blockedTime += chrono::steady_clock::now() - acquireStartTime;
+
+        // 실패하면 VkSemaphore가 신호되지 않으므로 이번 프레임은 제출하지 않고 건너뛴다.
+        // VkSurface를 잃으면 윈도우를 다시 붙일 때까지 그리지 않고, 디바이스를 잃으면 더 이상 그리지 않는다.
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+            if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+                recreateSwapchain();
+            } else if (result == VK_ERROR_SURFACE_LOST_KHR) {
+                aout << "Surface lost, waiting for a new window." << endl;
+                destroySurface();
+            } else if (result == VK_ERROR_DEVICE_LOST) {
+                handleDeviceLost();
+            } else {
+                VK_CHECK_ERROR(result);
+            }
+            return;
+        }
+        mSwapchainOutdated = result == VK_SUBOPTIMAL_KHR;
+    }
+
+    if (mGpuProfiler) {
+        // ================================================================================
+        // 9. GPU 시간 수집
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "GPU 시간 수집");
+        // 이미지를 얻지 못한 프레임은 기록하지 않으므로 같은 결과를 두번 수집하지 않도록 여기서 수집한다.
+        const auto collectGpuProfilerResult = VK_COUNT_RESULT(vkCollectGpuProfilerFrame(mGpuProfiler, mFrameIndex));
+        if (collectGpuProfilerResult == VK_ERROR_DEVICE_LOST) {
+            handleDeviceLost();
+            return;
+        }
+        VK_CHECK_ERROR(collectGpuProfilerResult);
+        if (mConfig.gpuProfilerInterval && ++mProfiledFrameCount % mConfig.gpuProfilerInterval == 0) {
+            printGpuProfilerStatistics();
+        }
+
+        if (mDynamicResolution) {
+            // ================================================================================
+            // 10. 렌더링 해상도 조절
+            // ================================================================================
+            VK_TRACE_NEXT_STEP(traceSteps, "렌더링 해상도 조절");
+            // 재생할 때는 GPU 시간과 상관없이 트레이스의 렌더링 영역으로 그린다.
+            VkExtent2D renderExtent;
+            if (!mFrameTraceReplay) {
+                updateRenderExtent(targetFrameDuration);
+            } else if (readTraceOp(traceFrame[TRACE_OP_TYPE_DRAW], &renderExtent)) {
+                renderExtent.width = clamp(renderExtent.width, 1u, mSwapchainImageExtent.width);
+                renderExtent.height = clamp(renderExtent.height, 1u, mSwapchainImageExtent.height);
+                if (renderExtent.width != mRenderExtent.width || renderExtent.height != mRenderExtent.height) {
+                    mRenderExtent = renderExtent;
+                    ++mSceneVersion;
+                }
+            }
+        }
+    }
+
+    auto semaphoreForPresent = mSemaphoresForPresent[swapchainImageIndex];
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    const auto dynamicOffset = static_cast<uint32_t>(uniformOffset);
+    // 실패한 텍스처는 획득하지 않고 다음 프레임에 파괴한다.
+    const auto textureLoadStatus = mTextureLoad ? vkGetTextureLoadStatus(mTextureLoad) : VK_NOT_READY;
+    auto acquireTexture = !mTextureAcquired && textureLoadStatus == VK_SUCCESS;
+
+    // 축출된 텍스처를 그린 제출이 끝나기 전에는 그 제출이 사용하는 VkDescriptorSet을 갱신하지 않는다.
+    if (acquireTexture && mTextureReleaseValue) {
+        uint64_t completedValue;
+        const auto completedResult = VK_COUNT_RESULT(vkGetTimelineCompletedValue(mTimeline, &completedValue));
+        if (completedResult == VK_ERROR_DEVICE_LOST) {
+            handleDeviceLost();
+            return;
+        }
+        VK_CHECK_ERROR(completedResult);
+        acquireTexture = completedValue >= mTextureReleaseValue;
+    }
+
+    // 텍스처를 획득하면 장면을 그리지만 재생할 때는 트레이스가 그린 프레임에만 그린다.
+    const auto drawScene = (mTextureAcquired || acquireTexture) &&
+                           (!mFrameTraceReplay || traceFrame[TRACE_OP_TYPE_DRAW]);
+    if (drawScene != mDrawScene) {
+        mDrawScene = drawScene;
+
+        // 장면이 바뀌었으므로 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+        ++mSceneVersion;
+    }
+
+    // frameCaptureCount가 0이 아니면 VkFrameTrace가 만들어져 있다.
+    VkFrameTraceProperties frameTraceProperties{};
+    if (mFrameTrace) {
+        vkGetFrameTraceProperties(mFrameTrace, &frameTraceProperties);
+    }
+
+    if (!mFrameTraceReplay && frameTraceProperties.frameCount < mConfig.frameCaptureCount) {
+        // ================================================================================
+        // 11. 프레임 트레이스 기록
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "프레임 트레이스 기록");
+        // 연산은 TraceOpType의 순서로 기록하며 장면을 그리지 않는 프레임은 BIND_TEXTURE부터 생략한다.
+        // 장면이 바뀌지 않으면 모든 연산이 반복으로 기록되므로 프레임마다 몇 바이트만 늘어난다.
+        const auto frameUniform = *uniform;
+        const array<VkFrameTraceOp, TRACE_OP_TYPE_COUNT> frameTraceOps{
+            VkFrameTraceOp{
+                .type = TRACE_OP_TYPE_UPDATE_UNIFORM,
+                .dataSize = sizeof(frameUniform),
+                .pData = &frameUniform
+            },
+            VkFrameTraceOp{
+                .type = TRACE_OP_TYPE_PUSH_CONSTANTS,
+                .dataSize = sizeof(mPushConstant),
+                .pData = &mPushConstant
+            },
+            VkFrameTraceOp{
+                .type = TRACE_OP_TYPE_BIND_PIPELINE,
+                .dataSize = sizeof(mPipelineVariant),
+                .pData = &mPipelineVariant
+            },
+            VkFrameTraceOp{
+                .type = TRACE_OP_TYPE_BIND_TEXTURE,
+                .dataSize = sizeof(mPushConstant.textureIndex),
+                .pData = &mPushConstant.textureIndex
+            },
+            VkFrameTraceOp{
+                .type = TRACE_OP_TYPE_DRAW,
+                .dataSize = sizeof(mRenderExtent),
+                .pData = &mRenderExtent
+            }
+        };
+
+        lock_guard<mutex> guard(mRenderLock);
+        VK_CHECK_ERROR(vkAppendFrameTrace(mFrameTrace,
+                                          drawScene ? TRACE_OP_TYPE_COUNT : TRACE_OP_TYPE_BIND_TEXTURE,
+                                          frameTraceOps.data()));
+    }
+
+    // 이번 프레임에 제출할 VkCommandBuffer로 텍스처를 획득하는 프레임이나
+    // 즉시 기록 모드에서만 프레임마다의 VkCommandBuffer를 기록한다.
+    uint32_t submitCommandBufferCount = 0;
+    array<VkCommandBuffer, 2> submitCommandBuffers{};
+
+    if (acquireTexture || !mConfig.prerecordCommandBuffers) {
+        // ================================================================================
+        // 12. VkCommandBuffer 초기화
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "VkCommandBuffer 초기화");
+        vkResetCommandBuffer(commandBuffer, 0);
+
+        // ================================================================================
+        // 13. VkCommandBuffer 기록 시작
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "VkCommandBuffer 기록 시작");
+        VkCommandBufferBeginInfo commandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        };
+
+        VK_CHECK_ERROR(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+        // ================================================================================
+        // 14. 텍스처 획득
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "텍스처 획득");
+        // 업로드가 완료된 첫 프레임에서 한번만 소유권을 가져오고 VkDescriptorSet을 갱신한다.
+        // 그 전까지 VkDescriptorSet은 사용되지 않으므로 바로 갱신할 수 있고,
+        // Bindless 텍스처는 사용되지 않는 원소이므로 사용 중인 VkDescriptorSet이라도 갱신할 수 있다.
+        if (acquireTexture) {
+            vkCmdAcquireTextureLoad(commandBuffer, mTextureLoad);
+
+            VkTextureLoadProperties textureLoadProperties;
+            vkGetTextureLoadProperties(mTextureLoad, &textureLoadProperties);
+
+            VkMemoryAllocationProperties textureAllocationProperties;
+            vkGetMemoryAllocationProperties(textureLoadProperties.allocation, &textureAllocationProperties);
+
+            if (mTextureResource) {
+                vkMakeResidentResource(mResidencyManager, mTextureResource, textureAllocationProperties.size);
+            } else {
+                const auto memoryTypeIndex = textureAllocationProperties.memoryTypeIndex;
+                VkResidentResourceCreateInfo residentResourceCreateInfo{
+                    .sType = VK_STRUCTURE_TYPE_RESIDENT_RESOURCE_CREATE_INFO,
+                    .heapIndex = mPhysicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].heapIndex,
+                    .size = textureAllocationProperties.size,
+                    .pfnEvict = [](void *pUserData) {
+                        static_cast<VkRenderer *>(pUserData)->evictTexture();
+                    },
+                    .pUserData = this
+                };
+
+                VK_CHECK_ERROR(vkCreateResidentResource(mResidencyManager,
+                                                        &residentResourceCreateInfo,
+                                                        &mTextureResource));
+            }
+
+            VkDescriptorImageInfo descriptorImageInfo{
+                .sampler = mSampler,
+                .imageView = textureLoadProperties.imageView,
+                .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            };
+
+            VkWriteDescriptorSet writeDescriptorSet{
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = mDescriptorSet,
+                .dstBinding = 1,
+                .dstArrayElement = mPushConstant.textureIndex,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .pImageInfo = &descriptorImageInfo
+            };
+
+            vkUpdateDescriptorSets(mDevice, 1, &writeDescriptorSet, 0, nullptr);
+            mTextureAcquired = true;
+
+            // 장면이 바뀌었으므로 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+            ++mSceneVersion;
+        }
+
+        // 즉시 기록 모드에서는 매 프레임 애니메이션과 VkRenderPass를 다시 기록한다.
+        if (!mConfig.prerecordCommandBuffers) {
+            recordFrame(commandBuffer, dynamicOffset, swapchainImageIndex);
+        }
+
+        // ================================================================================
+        // 15. VkCommandBuffer 기록 종료
+        // ================================================================================
+        VK_TRACE_NEXT_STEP(traceSteps, "VkCommandBuffer 기록 종료");
+        VK_CHECK_ERROR(vkEndCommandBuffer(commandBuffer));
+        submitCommandBuffers[submitCommandBufferCount++] = commandBuffer;
+    }
 
     // ================================================================================
-    // 8. Viewport 설정
+    // 16. 미리 기록된 VkCommandBuffer 선택
     // ================================================================================
-    const VkViewport viewport{
-        .width = static_cast<float>(mSwapchainImageExtent.width),
-        .height = static_cast<float>(mSwapchainImageExtent.height),
-        .maxDepth = 1.0f
-    };
+    VK_TRACE_NEXT_STEP(traceSteps, "미리 기록된 VkCommandBuffer 선택");
+    // 프레임마다 Uniform 오프셋이 다르므로 프레임과 스왑체인 이미지의 조합마다 기록해 두고,
+    // 장면이나 오프셋이 바뀐 경우에만 다시 기록한다. Push Constant는 VkSwapchain을 다시 만들 때만
+    // 바뀌고 그때 모두 다시 기록하므로 비교하지 않는다. 같은 프레임의 타임라인 값을 기다렸으므로
+    // 이 VkCommandBuffer는 더 이상 실행 중이 아니다.
+    if (mConfig.prerecordCommandBuffers) {
+        auto &recordedCommandBuffer =
+                mRecordedCommandBuffers[mFrameIndex * mSwapchainImages.size() + swapchainImageIndex];
+        if (recordedCommandBuffer.sceneVersion != mSceneVersion ||
+            recordedCommandBuffer.dynamicOffset != dynamicOffset) {
+            VK_CHECK_ERROR(vkResetCommandBuffer(recordedCommandBuffer.commandBuffer, 0));
 
-    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+            VkCommandBufferBeginInfo recordedCommandBufferBeginInfo{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
+            };
+
+            VK_CHECK_ERROR(vkBeginCommandBuffer(recordedCommandBuffer.commandBuffer,
+                                                &recordedCommandBufferBeginInfo));
+            recordFrame(recordedCommandBuffer.commandBuffer, dynamicOffset, swapchainImageIndex);
+            VK_CHECK_ERROR(vkEndCommandBuffer(recordedCommandBuffer.commandBuffer));
+
+            recordedCommandBuffer.sceneVersion = mSceneVersion;
+            recordedCommandBuffer.dynamicOffset = dynamicOffset;
+        }
+        submitCommandBuffers[submitCommandBufferCount++] = recordedCommandBuffer.commandBuffer;
+    }
 
     // ================================================================================
-    // 9. Scissor 설정
+    // 17. VkCommandBuffer 제출
     // ================================================================================
-    VkRect2D scissor{
-        .extent = mSwapchainImageExtent
+    VK_TRACE_NEXT_STEP(traceSteps, "VkCommandBuffer 제출");
+    // CPU에서 이미지를 기다리지 않고 GPU가 색상을 쓰기 전에만 기다린다.
+    // 동적 해상도를 사용하면 스왑체인 이미지에는 복사로 쓴다.
+    const VkPipelineStageFlags waitDstStageMask = mDynamicResolution ? VK_PIPELINE_STAGE_TRANSFER_BIT
+                                                                     : VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkSubmitInfo submitInfo{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .waitSemaphoreCount = mOffscreen ? 0u : 1u,
+        .pWaitSemaphores = &semaphoreForAcquire,
+        .pWaitDstStageMask = &waitDstStageMask,
+        .commandBufferCount = submitCommandBufferCount,
+        .pCommandBuffers = submitCommandBuffers.data(),
+        .signalSemaphoreCount = mOffscreen ? 0u : 1u,
+        .pSignalSemaphores = &semaphoreForPresent
     };
 
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    const auto submitResult = VK_COUNT_RESULT(vkQueueSubmitTimeline(mTimeline,
+                                                                   mQueue,
+                                                                   1,
+                                                                   &submitInfo,
+                                                                   &mFrameTimelineValues[mFrameIndex]));
+    if (submitResult == VK_ERROR_DEVICE_LOST) {
+        handleDeviceLost();
+        return;
+    }
+    VK_CHECK_ERROR(submitResult);
 
     // ================================================================================
-    // 10. Graphics VkPipeline 바인드
+    // 18. VkImage 화면에 출력
     // ================================================================================
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+    VK_TRACE_NEXT_STEP(traceSteps, "VkImage 화면에 출력");
+    // 오프스크린 모드에서는 출력하지 않으므로 수직 동기화를 기다리지 않는다.
+    if (!mOffscreen) {
+        // Display Timing이 활성화되면 마지막으로 출력된 시간을 기준으로
+        // presentInterval 주사율 간격마다 출력되도록 시간을 지정해서 프레임 간격을 일정하게 유지한다.
+        VkPresentTimeGOOGLE presentTime{
+            .presentID = ++mPresentID
+        };
+
+        VkPresentTimesInfoGOOGLE presentTimesInfo{
+            .sType = VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE,
+            .swapchainCount = 1,
+            .pTimes = &presentTime
+        };
+
+        if (mVkGetPastPresentationTimingGOOGLE) {
+            uint32_t pastPresentationTimingCount;
+            VK_CHECK_ERROR(mVkGetPastPresentationTimingGOOGLE(mDevice,
+                                                              mSwapchain,
+                                                              &pastPresentationTimingCount,
+                                                              nullptr));
+
+            if (pastPresentationTimingCount) {
+                vector<VkPastPresentationTimingGOOGLE> pastPresentationTimings(pastPresentationTimingCount);
+                VK_CHECK_ERROR(mVkGetPastPresentationTimingGOOGLE(mDevice,
+                                                                  mSwapchain,
+                                                                  &pastPresentationTimingCount,
+                                                                  pastPresentationTimings.data()));
+                mLastPresentationTiming = pastPresentationTimings[pastPresentationTimingCount - 1];
+            }
+
+            if (mLastPresentationTiming.presentID) {
+                const auto presentCount = presentTime.presentID - mLastPresentationTiming.presentID;
+                presentTime.desiredPresentTime = mLastPresentationTiming.actualPresentTime +
+                                                 presentCount * presentInterval * mRefreshDuration;
+            }
+        }
+
+        VkPresentInfoKHR presentInfo{
+            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .pNext = mVkGetPastPresentationTimingGOOGLE ? &presentTimesInfo : nullptr,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &semaphoreForPresent,
+            .swapchainCount = 1,
+            .pSwapchains = &mSwapchain,
+            .pImageIndices = &swapchainImageIndex
+        };
+
+        // SUBOPTIMAL이어도 출력은 되었으므로 다음 프레임을 그리기 전에 VkSwapchain을 다시 만든다.
+        const auto presentStartTime = chrono::steady_clock::now();
+        const auto result = VK_COUNT_RESULT(vkQueuePresentKHR(mQueue, &presentInfo));
+        blockedTime += chrono::steady_clock::now() - presentStartTime;
+        if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+            mSwapchainOutdated = true;
+        } else if (result == VK_ERROR_SURFACE_LOST_KHR) {
+            aout << "Surface lost, waiting for a new window." << endl;
+            destroySurface();
+        } else if (result == VK_ERROR_DEVICE_LOST) {
+            handleDeviceLost();
+        } else {
+            VK_CHECK_ERROR(result);
+        }
+    }
 
     // ================================================================================
-    // 11. Vertex VkBuffer 바인드
+    // 19. 프레임 인덱스 갱신
     // ================================================================================
-    VkDeviceSize vertexBufferOffset{0};
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mVertexBuffer, &vertexBufferOffset);
+    VK_TRACE_NEXT_STEP(traceSteps, "프레임 인덱스 갱신");
+    mFrameIndex = ++mFrameIndex % kMaxFramesInFlight;
+    ++mFrameCount;
+
+    // 스왑체인이 맞지 않아서 그리지 않은 프레임은 기록하지 않는다.
+    const auto frameTime = chrono::steady_clock::now() - frameStartTime;
+#ifdef VK_TRACE
+    mFrameTimeHistogram.record(frameTime);
+#endif
+
+    // 목표 시간은 출력 간격으로 정해지며 바뀌었을 때만 세션에 전달된다.
+    if (mPerformanceHint) {
+        VK_CHECK_ERROR(vkUpdatePerformanceHintTargetDuration(mPerformanceHint, targetFrameDuration));
+
+        const auto workDuration = chrono::duration_cast<chrono::nanoseconds>(frameTime - blockedTime);
+        VK_CHECK_ERROR(vkReportPerformanceHintWorkDuration(mPerformanceHint, workDuration.count()));
+    }
+
+    // 정해진 개수만 그리므로 모든 프레임의 시간을 저장해도 메모리가 계속 늘어나지 않는다.
+    if (mOffscreen && mConfig.offscreenFrameCount) {
+        {
+            lock_guard<mutex> guard(mRenderLock);
+            mOffscreenFrameTimes.push_back(chrono::duration_cast<chrono::nanoseconds>(frameTime).count());
+        }
+        mRenderCondition.notify_all();
+    }
+}
 
+void VkRenderer::recordFrame(VkCommandBuffer commandBuffer,
+                             uint32_t dynamicOffset,
+                             uint32_t swapchainImageIndex) {
     // ================================================================================
-    // 12. VkDescriptorSet 바인드
+    // 1. GPU 프로파일러 프레임 시작
     // ================================================================================
-    vkCmdBindDescriptorSets(commandBuffer,
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            mPipelineLayout,
-                            0,
-                            1,
-                            &descriptorSet,
-                            0,
-                            nullptr);
+    if (mGpuProfiler) {
+        vkCmdBeginGpuProfilerFrame(mGpuProfiler, commandBuffer, mFrameIndex);
+        vkCmdBeginGpuProfilerScope(mGpuProfiler, commandBuffer, "Frame");
+    }
 
     // ================================================================================
-    // 13. 삼각형 그리기
+    // 2. 애니메이션 기록
     // ================================================================================
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    if (mGpuProfiler) {
+        vkCmdBeginGpuProfilerScope(mGpuProfiler, commandBuffer, "Animation");
+    }
+    recordAnimation(commandBuffer, dynamicOffset);
+    if (mGpuProfiler) {
+        vkCmdEndGpuProfilerScope(mGpuProfiler, commandBuffer);
+    }
 
     // ================================================================================
-    // 14. VkRenderPass 종료
+    // 3. 렌더 패스 기록
     // ================================================================================
-    vkCmdEndRenderPass(commandBuffer);
+    if (mGpuProfiler) {
+        vkCmdBeginGpuProfilerScope(mGpuProfiler, commandBuffer, "Render Pass");
+    }
+    recordRenderPass(commandBuffer, swapchainImageIndex);
+    if (mGpuProfiler) {
+        vkCmdEndGpuProfilerScope(mGpuProfiler, commandBuffer);
+    }
+
+    if (mDynamicResolution) {
+        // ================================================================================
+        // 4. 확대 기록
+        // ================================================================================
+        if (mGpuProfiler) {
+            vkCmdBeginGpuProfilerScope(mGpuProfiler, commandBuffer, "Upscale");
+        }
+        recordUpscale(commandBuffer, swapchainImageIndex);
+        if (mGpuProfiler) {
+            vkCmdEndGpuProfilerScope(mGpuProfiler, commandBuffer);
+        }
+    }
+
+    if (mGpuProfiler) {
+        vkCmdEndGpuProfilerScope(mGpuProfiler, commandBuffer);
+    }
+}
 
+void VkRenderer::recordAnimation(VkCommandBuffer commandBuffer, uint32_t dynamicOffset) {
     // ================================================================================
-    // 15. VkCommandBuffer 기록 종료
+    // 1. 이전 프레임 그리기 기다리기
     // ================================================================================
-    VK_CHECK_ERROR(vkEndCommandBuffer(commandBuffer));
+    // 이전 프레임이 간접 그리기 명령과 보이는 Instance 데이터를 다 읽은 후에 쓰도록 실행 순서를 보장한다.
+    // Instance의 위치는 Compute 셰이더가 제자리에서 갱신하므로 이전 프레임이 쓴 값도 보이게 한다.
+    VkBufferMemoryBarrier instanceBufferMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = mVertexBuffer,
+        .offset = mInstanceDataOffset,
+        .size = mVisibleInstanceDataOffset - mInstanceDataOffset
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                         VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &instanceBufferMemoryBarrier,
+                         0,
+                         nullptr);
 
     // ================================================================================
-    // 16. VkCommandBuffer 제출
+    // 2. 간접 그리기 명령 초기화
     // ================================================================================
-    VkSubmitInfo submitInfo{
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &commandBuffer,
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores = &semaphore
+    vkCmdUpdateBuffer(commandBuffer,
+                      mVertexBuffer,
+                      mDrawCommandOffset,
+                      mDrawCommands.size() * sizeof(VkDrawIndexedIndirectCommand),
+                      mDrawCommands.data());
+
+    VkBufferMemoryBarrier drawCommandBufferMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = mVertexBuffer,
+        .offset = mDrawCommandOffset,
+        .size = VK_WHOLE_SIZE
     };
 
-    VK_CHECK_ERROR(vkQueueSubmit(mQueue, 1, &submitInfo, fenceForSubmit));
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &drawCommandBufferMemoryBarrier,
+                         0,
+                         nullptr);
 
     // ================================================================================
-    // 17. VkImage 화면에 출력
+    // 3. Compute VkPipeline 바인드
     // ================================================================================
-    VkPresentInfoKHR presentInfo{
-        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &semaphore,
-        .swapchainCount = 1,
-        .pSwapchains = &mSwapchain,
-        .pImageIndices = &swapchainImageIndex
-    };
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mComputePipeline);
 
-    VK_CHECK_ERROR(vkQueuePresentKHR(mQueue, &presentInfo));
+    // ================================================================================
+    // 4. Compute VkDescriptorSet 바인드
+    // ================================================================================
+    vkCmdBindDescriptorSets(commandBuffer,
+                            VK_PIPELINE_BIND_POINT_COMPUTE,
+                            mComputePipelineLayout,
+                            0,
+                            1,
+                            &mComputeDescriptorSet,
+                            1,
+                            &dynamicOffset);
 
     // ================================================================================
-    // 18. 프레임 인덱스 갱신
+    // 5. 인스턴스 위치 갱신 및 컬링
     // ================================================================================
-    mFrameIndex = ++mFrameIndex % mSwapchainImages.size();
+    // Compute 셰이더의 local_size_x와 같아야 한다.
+    constexpr uint32_t workGroupSize = 64;
+    vkCmdDispatch(commandBuffer, (max(mConfig.instanceCount, 1u) + workGroupSize - 1) / workGroupSize, 1, 1);
+
+    // ================================================================================
+    // 6. 간접 그리기에 결과 전달
+    // ================================================================================
+    VkBufferMemoryBarrier bufferMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = mVertexBuffer,
+        .offset = mVisibleInstanceDataOffset,
+        .size = VK_WHOLE_SIZE
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &bufferMemoryBarrier,
+                         0,
+                         nullptr);
+}
+
+void VkRenderer::recordRenderPass(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex) {
+    // ================================================================================
+    // 1. 렌더링 시작
+    // ================================================================================
+    recordBeginRendering(commandBuffer, swapchainImageIndex);
+
+    if (mCommandRecorder) {
+        // ================================================================================
+        // 2. 보조 VkCommandBuffer 기록
+        // ================================================================================
+        // 워커 스레드마다 자신의 간접 그리기 명령 하나를 기록한다.
+        // Dynamic Rendering은 VkRenderPass 대신 Attachment 포맷을 상속한다.
+        VkCommandBufferInheritanceRenderingInfo commandBufferInheritanceRenderingInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+            .colorAttachmentCount = 1,
+            .pColorAttachmentFormats = &mSurfaceFormat.format,
+            .depthAttachmentFormat = mConfig.depthTest ? kDepthFormat : VK_FORMAT_UNDEFINED,
+            .rasterizationSamples = mSampleCount
+        };
+
+        VkCommandBufferInheritanceInfo commandBufferInheritanceInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .pNext = mDynamicRendering ? &commandBufferInheritanceRenderingInfo : nullptr,
+            .renderPass = mRenderPass,
+            .subpass = 0,
+            .framebuffer = mDynamicRendering ? VK_NULL_HANDLE : mFramebuffers[swapchainImageIndex]
+        };
+
+        auto recordCommands = [](void *pUserData,
+                                 VkCommandBuffer commandBuffer,
+                                 uint32_t threadIndex,
+                                 uint32_t threadCount) {
+            static_cast<VkRenderer *>(pUserData)->recordDraws(commandBuffer, threadIndex);
+        };
+
+        VkCommandRecorderProperties commandRecorderProperties;
+        vkGetCommandRecorderProperties(mCommandRecorder, &commandRecorderProperties);
+
+        vector<VkCommandBuffer> secondaryCommandBuffers(commandRecorderProperties.threadCount);
+        VK_CHECK_ERROR(vkRecordCommands(mCommandRecorder,
+                                        &commandBufferInheritanceInfo,
+                                        recordCommands,
+                                        this,
+                                        secondaryCommandBuffers.data()));
+
+        // ================================================================================
+        // 3. 보조 VkCommandBuffer 실행
+        // ================================================================================
+        vkCmdExecuteCommands(commandBuffer,
+                             secondaryCommandBuffers.size(),
+                             secondaryCommandBuffers.data());
+    } else {
+        recordDraws(commandBuffer, 0);
+    }
+
+    // ================================================================================
+    // 4. 렌더링 종료
+    // ================================================================================
+    recordEndRendering(commandBuffer, swapchainImageIndex);
+}
+
+void VkRenderer::recordBeginRendering(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex) {
+    if (!mDynamicRendering) {
+        // ================================================================================
+        // 1. VkRenderPass 시작
+        // ================================================================================
+        VkRenderPassBeginInfo renderPassBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = mRenderPass,
+            .framebuffer = mFramebuffers[swapchainImageIndex],
+            .renderArea{
+                .extent = mRenderExtent
+            },
+            .clearValueCount = static_cast<uint32_t>(mClearValues.size()),
+            .pClearValues = mClearValues.data()
+        };
+
+        vkCmdBeginRenderPass(commandBuffer,
+                             &renderPassBeginInfo,
+                             mCommandRecorder ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+                                              : VK_SUBPASS_CONTENTS_INLINE);
+        return;
+    }
+
+    // ================================================================================
+    // 2. Attachment 레이아웃 변환
+    // ================================================================================
+    // VkRenderPass의 레이아웃 변환과 VkSubpassDependency가 하던 일을 직접 기록한다.
+    // 모든 Attachment를 CLEAR하므로 이전 내용은 버리고 UNDEFINED에서 변환한다.
+    // 장면 이미지를 이전 프레임이 복사하는 것은 확대할 때 기록한 의존성이 기다린다.
+    const auto colorImage = mDynamicResolution ? mSceneAttachment.image : mSwapchainImages[swapchainImageIndex];
+    const auto colorImageView = mDynamicResolution ? mSceneAttachment.imageView
+                                                   : mSwapchainImageViews[swapchainImageIndex];
+    constexpr VkImageSubresourceRange colorSubresourceRange{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1
+    };
+
+    vector<VkImageMemoryBarrier> imageMemoryBarriers{
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_NONE,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = colorImage,
+            .subresourceRange = colorSubresourceRange
+        }
+    };
+    VkPipelineStageFlags srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkPipelineStageFlags dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+    // 모든 프레임이 공유하는 Attachment는 이전 프레임의 쓰기가 끝난 후 CLEAR한다.
+    if (mSampleCount != VK_SAMPLE_COUNT_1_BIT) {
+        imageMemoryBarriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = mColorAttachment.image,
+            .subresourceRange = colorSubresourceRange
+        });
+    }
+
+    if (mConfig.depthTest) {
+        imageMemoryBarriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = mDepthAttachment.image,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        });
+        srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    }
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         srcStageMask,
+                         dstStageMask,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         imageMemoryBarriers.size(),
+                         imageMemoryBarriers.data());
+
+    // ================================================================================
+    // 3. Dynamic Rendering 시작
+    // ================================================================================
+    // 멀티샘플링을 하면 VkRenderPass와 같이 렌더링이 끝날 때 스왑체인 이미지로 Resolve한다.
+    VkRenderingAttachmentInfo colorAttachmentInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = colorImageView,
+        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .clearValue = mClearValues.front()
+    };
+
+    if (mSampleCount != VK_SAMPLE_COUNT_1_BIT) {
+        colorAttachmentInfo.imageView = mColorAttachment.imageView;
+        colorAttachmentInfo.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        colorAttachmentInfo.resolveImageView = colorImageView;
+        colorAttachmentInfo.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachmentInfo.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    }
+
+    VkRenderingAttachmentInfo depthAttachmentInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = mDepthAttachment.imageView,
+        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .clearValue = mClearValues.back()
+    };
+
+    VkRenderingFragmentShadingRateAttachmentInfoKHR renderingFragmentShadingRateAttachmentInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_INFO_KHR,
+        .imageView = mShadingRateAttachment.imageView,
+        .imageLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR,
+        .shadingRateAttachmentTexelSize = mShadingRateTexelSize
+    };
+
+    VkRenderingInfo renderingInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+        .pNext = mFoveatedShading ? &renderingFragmentShadingRateAttachmentInfo : nullptr,
+        .flags = mCommandRecorder ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0u,
+        .renderArea{
+            .extent = mRenderExtent
+        },
+        .layerCount = 1,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colorAttachmentInfo,
+        .pDepthAttachment = mConfig.depthTest ? &depthAttachmentInfo : nullptr
+    };
+
+    mVkCmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void VkRenderer::recordEndRendering(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex) {
+    if (!mDynamicRendering) {
+        // ================================================================================
+        // 1. VkRenderPass 종료
+        // ================================================================================
+        vkCmdEndRenderPass(commandBuffer);
+        return;
+    }
+
+    // ================================================================================
+    // 2. Dynamic Rendering 종료
+    // ================================================================================
+    mVkCmdEndRendering(commandBuffer);
+
+    // 장면 이미지는 확대할 때 복사 원본으로 변환한다.
+    if (mDynamicResolution) {
+        return;
+    }
+
+    // ================================================================================
+    // 3. 출력을 위한 레이아웃 변환
+    // ================================================================================
+    // 출력은 VkSemaphore로 동기화되므로 이후 단계를 기다릴 필요가 없다.
+    // 오프스크린 이미지는 출력하지 않고 복사할 수 있는 레이아웃으로 바꾼다.
+    VkImageMemoryBarrier imageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_NONE,
+        .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .newLayout = mSwapchainImageFinalLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = mSwapchainImages[swapchainImageIndex],
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+}
+
+void VkRenderer::recordUpscale(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex) {
+    constexpr VkImageSubresourceRange colorSubresourceRange{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1
+    };
+
+    // ================================================================================
+    // 1. 복사를 위한 레이아웃 변환
+    // ================================================================================
+    // 스왑체인 이미지는 전부 덮어쓰므로 이전 내용은 버리고 UNDEFINED에서 변환한다.
+    // 이미지를 얻는 VkSemaphore는 TRANSFER 단계에서 기다린다.
+    const VkImageMemoryBarrier imageMemoryBarriers[]{
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = mSceneAttachment.image,
+            .subresourceRange = colorSubresourceRange
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_NONE,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = mSwapchainImages[swapchainImageIndex],
+            .subresourceRange = colorSubresourceRange
+        }
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         size(imageMemoryBarriers),
+                         imageMemoryBarriers);
+
+    // ================================================================================
+    // 2. 장면 이미지 확대
+    // ================================================================================
+    // 장면은 이미지의 왼쪽 위 mRenderExtent 영역에만 그려져 있다.
+    const VkImageBlit imageBlit{
+        .srcSubresource{
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .layerCount = 1
+        },
+        .srcOffsets{
+            {0, 0, 0},
+            {static_cast<int32_t>(mRenderExtent.width), static_cast<int32_t>(mRenderExtent.height), 1}
+        },
+        .dstSubresource{
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .layerCount = 1
+        },
+        .dstOffsets{
+            {0, 0, 0},
+            {static_cast<int32_t>(mSwapchainImageExtent.width),
+             static_cast<int32_t>(mSwapchainImageExtent.height),
+             1}
+        }
+    };
+
+    vkCmdBlitImage(commandBuffer,
+                   mSceneAttachment.image,
+                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   mSwapchainImages[swapchainImageIndex],
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   1,
+                   &imageBlit,
+                   VK_FILTER_LINEAR);
+
+    // ================================================================================
+    // 3. 출력을 위한 레이아웃 변환
+    // ================================================================================
+    // 다음 프레임이 장면 이미지에 그리기 전에 복사가 끝나도록 COLOR_ATTACHMENT_OUTPUT 단계를 기다리게 한다.
+    const VkImageMemoryBarrier imageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_NONE,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = mSwapchainImageFinalLayout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = mSwapchainImages[swapchainImageIndex],
+        .subresourceRange = colorSubresourceRange
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+}
+
+void VkRenderer::updateRenderExtent(uint64_t targetFrameDuration) {
+    // ================================================================================
+    // 1. 프레임 GPU 시간 조회
+    // ================================================================================
+    array<VkGpuProfilerScopeStatistics, kGpuProfilerMaxScopeCount> statistics;
+    auto scopeCount = static_cast<uint32_t>(statistics.size());
+    const auto result = vkGetGpuProfilerStatistics(mGpuProfiler, &scopeCount, statistics.data());
+    if (result != VK_SUCCESS && result != VK_INCOMPLETE) {
+        VK_CHECK_ERROR(result);
+    }
+
+    const auto pFrameStatistics = find_if(statistics.begin(),
+                                          statistics.begin() + scopeCount,
+                                          [](const auto &scopeStatistics) {
+                                              return strcmp(scopeStatistics.name, "Frame") == 0;
+                                          });
+
+    // 새로 수집된 시간이 없으면 같은 결과로 두번 조절하지 않는다.
+    if (pFrameStatistics == statistics.begin() + scopeCount ||
+        pFrameStatistics->sampleCount == mResolutionSampleCount ||
+        pFrameStatistics->lastTime <= 0.0) {
+        return;
+    }
+    mResolutionSampleCount = pFrameStatistics->sampleCount;
+
+    // ================================================================================
+    // 2. 해상도 배율 계산
+    // ================================================================================
+    // GPU 시간은 화소 수, 즉 배율의 제곱에 비례한다고 보고 목표 시간에 여유를 남긴다.
+    // 한 프레임의 튀는 값에 해상도가 흔들리지 않도록 목표 배율에 천천히 다가간다.
+    const auto targetTime = targetFrameDuration * 1e-6 * kTargetGpuUtilization;
+    const auto desiredScale = clamp(mResolutionScale * sqrt(targetTime / pFrameStatistics->lastTime),
+                                    static_cast<double>(mConfig.minResolutionScale),
+                                    1.0);
+    mResolutionScale += 0.1 * (desiredScale - mResolutionScale);
+
+    // ================================================================================
+    // 3. 렌더링 영역 갱신
+    // ================================================================================
+    // 영역은 8 화소 단위로 바뀌므로 배율이 조금 바뀔 때마다 다시 기록하지 않는다.
+    const auto renderExtent = vkScaleExtent(mSwapchainImageExtent, mResolutionScale);
+    if (renderExtent.width != mRenderExtent.width || renderExtent.height != mRenderExtent.height) {
+        mRenderExtent = renderExtent;
+
+        // 뷰포트와 렌더링 영역이 바뀌었으므로 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+        ++mSceneVersion;
+    }
+}
+
+void VkRenderer::recordDraws(VkCommandBuffer commandBuffer, uint32_t drawCommandIndex) {
+    // ================================================================================
+    // 1. Viewport 설정
+    // ================================================================================
+    // 보조 VkCommandBuffer는 동적 상태를 상속받지 않으므로 VkCommandBuffer마다 설정한다.
+    const VkViewport viewport{
+        .width = static_cast<float>(mRenderExtent.width),
+        .height = static_cast<float>(mRenderExtent.height),
+        .maxDepth = 1.0f
+    };
+
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    // ================================================================================
+    // 2. Scissor 설정
+    // ================================================================================
+    VkRect2D scissor{
+        .extent = mRenderExtent
+    };
+
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    // 텍스처가 준비되기 전까지는 배경만 그린다.
+    if (mDrawScene) {
+        // ================================================================================
+        // 3. Graphics VkPipeline 바인드
+        // ================================================================================
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+
+        if (mVkCmdSetFragmentShadingRateKHR) {
+            // ================================================================================
+            // 4. 셰이딩 비율 설정
+            // ================================================================================
+            // Foveated 셰이딩을 사용하면 Attachment의 셰이딩 비율과 합쳐진다.
+            mVkCmdSetFragmentShadingRateKHR(commandBuffer, &mPipelineShadingRate, mShadingRateCombinerOps.data());
+        }
+
+        // ================================================================================
+        // 5. Vertex VkBuffer 바인드
+        // ================================================================================
+        const array<VkBuffer, 2> vertexBuffers{mVertexBuffer, mVertexBuffer};
+        const array<VkDeviceSize, 2> vertexBufferOffsets{0, mVisibleInstanceDataOffset};
+        vkCmdBindVertexBuffers(commandBuffer,
+                               0,
+                               vertexBuffers.size(),
+                               vertexBuffers.data(),
+                               vertexBufferOffsets.data());
+
+        // ================================================================================
+        // 6. VkDescriptorSet 바인드
+        // ================================================================================
+        vkCmdBindDescriptorSets(commandBuffer,
+                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                mPipelineLayout,
+                                0,
+                                1,
+                                &mDescriptorSet,
+                                0,
+                                nullptr);
+
+        // ================================================================================
+        // 7. Push Constant 설정
+        // ================================================================================
+        // Bindless 텍스처를 사용하면 텍스처는 인덱스로 선택한다.
+        vkCmdPushConstants(commandBuffer,
+                           mPipelineLayout,
+                           VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                           0,
+                           sizeof(mPushConstant),
+                           &mPushConstant);
+
+        // ================================================================================
+        // 8. 메시 그리기
+        // ================================================================================
+        // 보이는 인스턴스의 개수는 GPU가 정하므로 CPU가 기록하는 명령의 개수는 장면의 크기와 상관없다.
+        vkCmdBindIndexBuffer(commandBuffer, mVertexBuffer, mIndexDataOffset, mIndexType);
+        vkCmdDrawIndexedIndirect(commandBuffer,
+                                 mVertexBuffer,
+                                 mDrawCommandOffset + drawCommandIndex * sizeof(VkDrawIndexedIndirectCommand),
+                                 1,
+                                 sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
+
+void VkRenderer::createTextureLoad() {
+    // 미리 압축된 KTX2 텍스처를 우선 사용하고 지원되지 않으면 PNG를 디코딩한다.
+    // 디코딩과 업로드는 워커 스레드에서 진행되고 완료되면 render()에서 사용하기 시작한다.
+    const array<const char *, 3> textureFileNames{
+        "vulkan.astc.ktx2",
+        "vulkan.etc2.ktx2",
+        "vulkan.png"
+    };
+
+    VkTextureDataInfo textureDataInfo{
+        .sType = VK_STRUCTURE_TYPE_TEXTURE_DATA_INFO,
+        .dataSize = mConfig.textureDataSize,
+        .pData = mConfig.pTextureData
+    };
+
+    // 셰이더는 항상 텍스처 배열을 샘플링하므로 텍스처가 하나여도 레이어가 하나인 배열로 불러온다.
+    vector<VkTextureCreateInfo> textureCreateInfos;
+    if (mConfig.textureLayerFileNames.empty()) {
+        textureCreateInfos.push_back({
+            .sType = VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO,
+            .pNext = mConfig.textureDataSize ? &textureDataInfo : nullptr,
+            .fileNameCount = textureFileNames.size(),
+            .ppFileNames = textureFileNames.data()
+        });
+    } else {
+        for (const auto &fileName : mConfig.textureLayerFileNames) {
+            textureCreateInfos.push_back({
+                .sType = VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO,
+                .fileNameCount = 1,
+                .ppFileNames = &fileName
+            });
+        }
+    }
+
+    VkTextureArrayCreateInfo textureArrayCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_TEXTURE_ARRAY_CREATE_INFO,
+        .layerCount = static_cast<uint32_t>(textureCreateInfos.size()),
+        .pLayerCreateInfos = textureCreateInfos.data()
+    };
+
+    VK_CHECK_ERROR(vkCreateTextureArrayLoad(mTextureLoader, &textureArrayCreateInfo, &mTextureLoad));
+}
+
+void VkRenderer::waitTextureLoad() {
+    // 메모리가 부족해서 다시 불러오기를 기다리는 중이면 바로 불러온다.
+    if (!mTextureLoad) {
+        if (mTextureLoadFailed) {
+            return;
+        }
+        createTextureLoad();
+    }
+
+    // 업로드는 vkSubmitTextureLoads로 제출되므로 디코딩이 끝날 때까지 제출을 반복한다.
+    // 디바이스를 잃으면 불러오기가 실패하므로 반복이 끝난다.
+    while (vkGetTextureLoadStatus(mTextureLoad) == VK_NOT_READY) {
+        const auto submitResult = VK_COUNT_RESULT(vkSubmitTextureLoads(mTextureLoader));
+        if (submitResult == VK_ERROR_DEVICE_LOST) {
+            handleDeviceLost();
+            return;
+        }
+        VK_CHECK_ERROR(submitResult);
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    // 축출된 텍스처를 그린 제출이 끝나야 VkDescriptorSet을 갱신할 수 있다.
+    if (mTextureReleaseValue) {
+        const auto waitResult = VK_COUNT_RESULT(vkWaitTimeline(mTimeline, mTextureReleaseValue, UINT64_MAX));
+        if (waitResult == VK_ERROR_DEVICE_LOST) {
+            handleDeviceLost();
+            return;
+        }
+        VK_CHECK_ERROR(waitResult);
+    }
+}
+
+void VkRenderer::readTraceFrame(TraceFrame *pTraceFrame) {
+    VkFrameTraceProperties frameTraceProperties;
+    vkGetFrameTraceProperties(mFrameTrace, &frameTraceProperties);
+    if (mFrameTraceFrameIndex >= frameTraceProperties.frameCount) {
+        mFrameTraceFrameIndex = 0;
+    }
+
+    uint32_t opCount;
+    VK_CHECK_ERROR(vkGetFrameTraceOps(mFrameTrace, mFrameTraceFrameIndex, &opCount, nullptr));
+
+    mFrameTraceOps.resize(opCount);
+    VK_CHECK_ERROR(vkGetFrameTraceOps(mFrameTrace, mFrameTraceFrameIndex, &opCount, mFrameTraceOps.data()));
+    ++mFrameTraceFrameIndex;
+
+    // 이 빌드가 모르는 연산은 무시한다.
+    for (const auto &op : mFrameTraceOps) {
+        if (op.type < TRACE_OP_TYPE_COUNT) {
+            (*pTraceFrame)[op.type] = &op;
+        }
+    }
+}
+
+void VkRenderer::evictTexture() {
+    // 마지막으로 제출된 프레임까지 이 텍스처를 그렸을 수 있으므로 그 제출이 끝난 후 파괴한다.
+    VkTimelineProperties timelineProperties;
+    vkGetTimelineProperties(mTimeline, &timelineProperties);
+    mTextureReleaseValue = timelineProperties.submittedValue;
+
+    vkDeferDestroy(mDeletionQueue,
+                   mTextureReleaseValue,
+                   [](void *pUserData, uint64_t object) {
+                       vkDestroyTextureLoad(static_cast<VkRenderer *>(pUserData)->mTextureLoader,
+                                            reinterpret_cast<VkTextureLoad>(object));
+                   },
+                   this,
+                   reinterpret_cast<uint64_t>(mTextureLoad));
+    mTextureLoad = VK_NULL_HANDLE;
+    mTextureAcquired = false;
+
+    // 장면이 바뀌었으므로 미리 기록된 VkCommandBuffer를 모두 다시 기록한다.
+    ++mSceneVersion;
+}
+
+void VkRenderer::attachWindow(ANativeWindow *nativeWindow) {
+    // 윈도우는 detachWindow가 끝날 때까지 유효하므로 기다리지 않는다.
+    postRenderCommand({.type = RENDER_COMMAND_TYPE_ATTACH_WINDOW, .nativeWindow = nativeWindow});
+}
+
+void VkRenderer::detachWindow() {
+    postRenderCommand({.type = RENDER_COMMAND_TYPE_DETACH_WINDOW});
+    waitRenderCommands();
+}
+
+void VkRenderer::resize() {
+    postRenderCommand({.type = RENDER_COMMAND_TYPE_RESIZE});
+}
+
+void VkRenderer::trimMemory() {
+    postRenderCommand({.type = RENDER_COMMAND_TYPE_TRIM_MEMORY});
+}
+
+void VkRenderer::postRenderCommand(const RenderCommand &renderCommand) {
+    // 큐가 가득 차면 렌더 스레드가 꺼낼 때까지 양보한다.
+    while (!mRenderCommands.push(renderCommand)) {
+        this_thread::yield();
+    }
+    ++mPostedRenderCommandCount;
+
+    // 렌더 스레드가 큐를 확인한 직후 잠들더라도 깨어나도록 잠금을 거친 후 알린다.
+    {
+        lock_guard<mutex> guard(mRenderLock);
+    }
+    mRenderCondition.notify_all();
+}
+
+void VkRenderer::waitRenderCommands() {
+    unique_lock<mutex> guard(mRenderLock);
+    mRenderCondition.wait(guard, [this] {
+        return mProcessedRenderCommandCount == mPostedRenderCommandCount;
+    });
+}
+
+bool VkRenderer::processRenderCommands() {
+    auto quit = false;
+    RenderCommand renderCommand;
+    while (mRenderCommands.pop(&renderCommand)) {
+        switch (renderCommand.type) {
+            case RENDER_COMMAND_TYPE_ATTACH_WINDOW:
+                assert(!mSurface && !mOffscreen);
+                createSurface(renderCommand.nativeWindow);
+                // 디바이스를 잃었으면 다시 그리지 않으므로 VkSwapchain을 만들지 않는다.
+                if (!mDeviceLost) {
+                    createSwapchain(VK_NULL_HANDLE);
+                }
+                break;
+            case RENDER_COMMAND_TYPE_DETACH_WINDOW:
+                assert(!mOffscreen);
+                // VkSurface를 잃어서 이미 파괴했을 수 있다.
+                if (mSurface) {
+                    destroySurface();
+                }
+                break;
+            case RENDER_COMMAND_TYPE_RESIZE:
+                // 오프스크린 이미지의 크기는 윈도우와 상관없다.
+                mSwapchainOutdated = !mOffscreen;
+                break;
+            case RENDER_COMMAND_TYPE_TRIM_MEMORY:
+                // 사용 중인 텍스처도 축출하며 그 텍스처를 그린 프레임이 끝난 후 파괴된다.
+                VK_CHECK_ERROR(vkUpdateResidency(mResidencyManager, UINT64_MAX, VK_RESIDENCY_UPDATE_TRIM_BIT));
+                // 생성자가 끝난 후에는 렌더 스레드만 VkStateCache를 사용하므로 찾는 스레드와 겹치지 않으며,
+                // 해제된 오브젝트만 파괴하므로 제출된 프레임이 사용 중인 오브젝트는 남는다.
+                vkTrimStateCache(mStateCache);
+                break;
+            case RENDER_COMMAND_TYPE_QUIT:
+                quit = true;
+                break;
+        }
+
+        {
+            lock_guard<mutex> guard(mRenderLock);
+            ++mProcessedRenderCommandCount;
+        }
+        mRenderCondition.notify_all();
+    }
+
+    return !quit;
+}
+
+void VkRenderer::runRenderThread() {
+    if (mConfig.performanceHint) {
+        // ================================================================================
+        // 1. VkPerformanceHint 생성
+        // ================================================================================
+        // 목표 시간은 첫 프레임에서 출력 간격과 주사율로 갱신된다.
+        const int32_t threadId = gettid();
+        VkPerformanceHintCreateInfo performanceHintCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PERFORMANCE_HINT_CREATE_INFO,
+            .threadIdCount = 1,
+            .pThreadIds = &threadId,
+            .targetWorkDuration = kDefaultRefreshDuration
+        };
+
+        VK_CHECK_ERROR(vkCreatePerformanceHint(&performanceHintCreateInfo, nullptr, &mPerformanceHint));
+
+        VkPerformanceHintProperties performanceHintProperties;
+        vkGetPerformanceHintProperties(mPerformanceHint, &performanceHintProperties);
+        if (!performanceHintProperties.performanceHint) {
+            aout << "Performance hint is not supported." << endl;
+        }
+        if (!performanceHintProperties.thermalStatus) {
+            aout << "Thermal status is not supported." << endl;
+        }
+    }
+
+    // ================================================================================
+    // 2. 렌더 명령 처리
+    // ================================================================================
+    while (processRenderCommands()) {
+        // 프레임 시간은 렌더 스레드만 추가하므로 잠금 없이 개수를 확인할 수 있다.
+        const auto offscreenFramesRemaining =
+                mOffscreen && (!mConfig.offscreenFrameCount ||
+                               mOffscreenFrameTimes.size() < mConfig.offscreenFrameCount);
+        if ((mSurface || offscreenFramesRemaining) && !mDeviceLost) {
+            render();
+
+            // 오프스크린 프레임을 기다리는 스레드가 더 이상 그려지지 않을 프레임을 기다리지 않도록 깨운다.
+            if (mDeviceLost) {
+                {
+                    lock_guard<mutex> guard(mRenderLock);
+                }
+                mRenderCondition.notify_all();
+            }
+            continue;
+        }
+
+        // 윈도우가 없거나 오프스크린 프레임을 모두 그렸으면 명령이 들어올 때까지 잠든다.
+        unique_lock<mutex> guard(mRenderLock);
+        mRenderCondition.wait(guard, [this] {
+            return !mRenderCommands.empty();
+        });
+    }
+
+    // ================================================================================
+    // 3. VkPerformanceHint 파괴
+    // ================================================================================
+    if (mPerformanceHint) {
+        vkDestroyPerformanceHint(mPerformanceHint, nullptr);
+        mPerformanceHint = VK_NULL_HANDLE;
+    }
+}
+
+void VkRenderer::destroySurface() {
+    destroySwapchain();
+
+    // VkSurface는 VkSwapchain이 파괴된 후에 파괴해야 하므로 같은 타임라인 값에 뒤이어 예약한다.
+    VkTimelineProperties timelineProperties;
+    vkGetTimelineProperties(mTimeline, &timelineProperties);
+    vkDeferDestroy(mDeletionQueue,
+                   timelineProperties.submittedValue,
+                   [](void *pUserData, uint64_t object) {
+                       vkDestroySurfaceKHR(static_cast<VkRenderer *>(pUserData)->mInstance,
+                                           reinterpret_cast<VkSurfaceKHR>(object),
+                                           nullptr);
+                   },
+                   this,
+                   reinterpret_cast<uint64_t>(mSurface));
+    mSurface = VK_NULL_HANDLE;
+
+    // 윈도우가 사라지기 전에 스왑체인 이미지를 돌려줘야 하므로 디바이스 전체가 아니라
+    // 렌더 스레드가 제출한 프레임만 기다린 후 바로 파괴한다. 디바이스를 잃었으면 기다릴 작업이 없다.
+    const auto waitResult = VK_COUNT_RESULT(vkWaitTimeline(mTimeline, timelineProperties.submittedValue, UINT64_MAX));
+    if (waitResult == VK_ERROR_DEVICE_LOST) {
+        handleDeviceLost();
+    } else {
+        VK_CHECK_ERROR(waitResult);
+    }
+    vkFlushDeletionQueue(mDeletionQueue);
+}
+
+void VkRenderer::createSurface(ANativeWindow *nativeWindow) {
+    // ================================================================================
+    // 1. VkSurface 생성
+    // ================================================================================
+    VkAndroidSurfaceCreateInfoKHR surfaceCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
+        .window = nativeWindow
+    };
+
+    VK_CHECK_ERROR(vkCreateAndroidSurfaceKHR(mInstance, &surfaceCreateInfo, nullptr, &mSurface));
+
+    VkBool32 supported;
+    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceSupportKHR(mPhysicalDevice,
+                                                        mQueueFamilyIndex,
+                                                        mSurface,
+                                                        &supported));
+    assert(supported);
+
+    // ================================================================================
+    // 2. VkSurfaceFormat 선택
+    // ================================================================================
+    uint32_t surfaceFormatCount = 0;
+    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceFormatsKHR(mPhysicalDevice,
+                                                        mSurface,
+                                                        &surfaceFormatCount,
+                                                        nullptr));
+
+    vector<VkSurfaceFormatKHR> surfaceFormats(surfaceFormatCount);
+    VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceFormatsKHR(mPhysicalDevice,
+                                                        mSurface,
+                                                        &surfaceFormatCount,
+                                                        surfaceFormats.data()));
+
+    // VkRenderPass가 이 포맷으로 만들어지므로 VkSurface를 다시 만들어도 같은 포맷을 사용해야 한다.
+    uint32_t surfaceFormatIndex = VK_FORMAT_MAX_ENUM;
+    for (auto i = 0; i != surfaceFormatCount; ++i) {
+        if (surfaceFormats[i].format == VK_FORMAT_R8G8B8A8_UNORM) {
+            surfaceFormatIndex = i;
+            break;
+        }
+    }
+    assert(surfaceFormatIndex != VK_FORMAT_MAX_ENUM);
+    mSurfaceFormat = surfaceFormats[surfaceFormatIndex];
+}
+
+void VkRenderer::createSwapchain(VkSwapchainKHR oldSwapchain) {
+    if (mOffscreen) {
+        mPreTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+        mSwapchainImageExtent = mConfig.offscreenExtent;
+
+        // 프레임마다 하나의 이미지를 사용하며 렌더 패스가 CLEAR하거나 Resolve하므로 이전 내용은 필요 없다.
+        mSwapchainImages.resize(kMaxFramesInFlight);
+        mOffscreenImageAllocations.resize(kMaxFramesInFlight);
+        for (auto i = 0; i != kMaxFramesInFlight; ++i) {
+            // ================================================================================
+            // 1. 오프스크린 VkImage 생성
+            // ================================================================================
+            VkImageCreateInfo imageCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                .imageType = VK_IMAGE_TYPE_2D,
+                .format = mSurfaceFormat.format,
+                .extent = {
+                    .width = mSwapchainImageExtent.width,
+                    .height = mSwapchainImageExtent.height,
+                    .depth = 1
+                },
+                .mipLevels = 1,
+                .arrayLayers = 1,
+                .samples = VK_SAMPLE_COUNT_1_BIT,
+                .tiling = VK_IMAGE_TILING_OPTIMAL,
+                .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                         VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+            };
+
+            VK_CHECK_ERROR(vkCreateImage(mDevice, &imageCreateInfo, nullptr, &mSwapchainImages[i]));
+
+            // ================================================================================
+            // 2. 오프스크린 VkMemoryAllocation 생성
+            // ================================================================================
+            VkMemoryRequirements memoryRequirements;
+            vkGetImageMemoryRequirements(mDevice, mSwapchainImages[i], &memoryRequirements);
+
+            VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+                .type = VK_MEMORY_ALLOCATION_TYPE_IMAGE_OPTIMAL,
+                .memoryRequirements = memoryRequirements,
+                .memoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+            };
+
+            VK_CHECK_ERROR(vkCreateMemoryAllocation(mMemoryAllocator,
+                                                    &memoryAllocationCreateInfo,
+                                                    &mOffscreenImageAllocations[i]));
+
+            VkMemoryAllocationProperties memoryAllocationProperties;
+            vkGetMemoryAllocationProperties(mOffscreenImageAllocations[i], &memoryAllocationProperties);
+
+            VK_CHECK_ERROR(vkBindImageMemory(mDevice,
+                                             mSwapchainImages[i],
+                                             memoryAllocationProperties.memory,
+                                             memoryAllocationProperties.offset));
+        }
+    } else {
+        // ================================================================================
+        // 3. VkSwapchain 생성
+        // ================================================================================
+        VkSurfaceCapabilitiesKHR surfaceCapabilities;
+        VK_CHECK_ERROR(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(mPhysicalDevice,
+                                                                 mSurface,
+                                                                 &surfaceCapabilities));
+        // 회전된 화면에서는 currentExtent도 회전되어 있으므로 기본 방향의 크기로 되돌린다.
+        // 기본 방향으로 만들고 preTransform으로 회전을 알려주면 컴포지터가 회전하지 않는다.
+        mPreTransform = surfaceCapabilities.currentTransform;
+        mSwapchainImageExtent = surfaceCapabilities.currentExtent;
+        if (mPreTransform & (VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR |
+                             VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR)) {
+            swap(mSwapchainImageExtent.width, mSwapchainImageExtent.height);
+        }
+
+        VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_FLAG_BITS_MAX_ENUM_KHR;
+        for (auto i = 0; i <= 4; ++i) {
+            if (auto flag = 0x1u << i; surfaceCapabilities.supportedCompositeAlpha & flag) {
+                compositeAlpha = static_cast<VkCompositeAlphaFlagBitsKHR>(flag);
+                break;
+            }
+        }
+        assert(compositeAlpha != VK_COMPOSITE_ALPHA_FLAG_BITS_MAX_ENUM_KHR);
+
+        // 동적 해상도를 사용할 때만 장면 이미지를 Blit하므로 복사 대상 사용법을 추가한다.
+        // 생성자에서 처음 VkSurface로 확인했으므로 다시 만든 VkSurface도 같은 사용법을 지원해야 한다.
+        VkImageUsageFlags swapchainImageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        if (mDynamicResolution) {
+            swapchainImageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        }
+        assert((surfaceCapabilities.supportedUsageFlags & swapchainImageUsage) == swapchainImageUsage);
+
+        uint32_t presentModeCount;
+        VK_CHECK_ERROR(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice,
+                                                                 mSurface,
+                                                                 &presentModeCount,
+                                                                 nullptr));
+
+        vector<VkPresentModeKHR> presentModes(presentModeCount);
+        VK_CHECK_ERROR(vkGetPhysicalDeviceSurfacePresentModesKHR(mPhysicalDevice,
+                                                                 mSurface,
+                                                                 &presentModeCount,
+                                                                 presentModes.data()));
+
+        // 정책에 맞는 VkPresentModeKHR이 지원되지 않으면 항상 지원되는 FIFO를 사용한다.
+        const auto isPresentModeSupported = [&presentModes](VkPresentModeKHR presentMode) {
+            return find(presentModes.begin(), presentModes.end(), presentMode) != presentModes.end();
+        };
+
+        auto presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        auto minImageCount = surfaceCapabilities.minImageCount;
+        switch (mConfig.presentPolicy) {
+            case VK_PRESENT_POLICY_FIFO_TRIPLE_BUFFERING:
+                minImageCount = max(minImageCount, 3u);
+                break;
+            case VK_PRESENT_POLICY_FIFO_RELAXED:
+                if (isPresentModeSupported(VK_PRESENT_MODE_FIFO_RELAXED_KHR)) {
+                    presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+                }
+                break;
+            case VK_PRESENT_POLICY_MAILBOX:
+                // 출력 중인 이미지와 대기 중인 이미지 외에 그릴 이미지가 하나 더 있어야 기다리지 않는다.
+                // MAILBOX가 지원되지 않으면 FIFO 트리플 버퍼링이 된다.
+                if (isPresentModeSupported(VK_PRESENT_MODE_MAILBOX_KHR)) {
+                    presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+                }
+                minImageCount = max(minImageCount + 1, 3u);
+                break;
+            default:
+                break;
+        }
+
+        if (surfaceCapabilities.maxImageCount) {
+            minImageCount = min(minImageCount, surfaceCapabilities.maxImageCount);
+        }
+
+        VkSwapchainCreateInfoKHR swapchainCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
+            .surface = mSurface,
+            .minImageCount = minImageCount,
+            .imageFormat = mSurfaceFormat.format,
+            .imageColorSpace = mSurfaceFormat.colorSpace,
+            .imageExtent = mSwapchainImageExtent,
+            .imageArrayLayers = 1,
+            .imageUsage = swapchainImageUsage,
+            .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .preTransform = mPreTransform,
+            .compositeAlpha = compositeAlpha,
+            .presentMode = presentMode,
+            .clipped = VK_TRUE,
+            .oldSwapchain = oldSwapchain
+        };
+
+        VK_CHECK_ERROR(vkCreateSwapchainKHR(mDevice, &swapchainCreateInfo, nullptr, &mSwapchain));
+
+        // ================================================================================
+        // 4. Display Timing 초기화
+        // ================================================================================
+        if (mVkGetRefreshCycleDurationGOOGLE) {
+            VkRefreshCycleDurationGOOGLE refreshCycleDuration;
+            VK_CHECK_ERROR(mVkGetRefreshCycleDurationGOOGLE(mDevice, mSwapchain, &refreshCycleDuration));
+            mRefreshDuration = refreshCycleDuration.refreshDuration;
+            mPresentID = 0;
+            mLastPresentationTiming = {};
+
+            aout << setw(16) << left << " - Refresh Duration: " << mRefreshDuration << "ns" << endl;
+        }
+
+        uint32_t swapchainImageCount;
+        VK_CHECK_ERROR(vkGetSwapchainImagesKHR(mDevice, mSwapchain, &swapchainImageCount, nullptr));
+
+        mSwapchainImages.resize(swapchainImageCount);
+        VK_CHECK_ERROR(vkGetSwapchainImagesKHR(mDevice,
+                                               mSwapchain,
+                                               &swapchainImageCount,
+                                               mSwapchainImages.data()));
+    }
+
+    const auto swapchainImageCount = static_cast<uint32_t>(mSwapchainImages.size());
+
+    mSwapchainImageViews.resize(swapchainImageCount);
+    for (auto i = 0; i != swapchainImageCount; ++i) {
+        // ================================================================================
+        // 5. VkImageView 생성
+        // ================================================================================
+        VkImageViewCreateInfo imageViewCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = mSwapchainImages[i],
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = mSurfaceFormat.format,
+            .components = {
+                .r = VK_COMPONENT_SWIZZLE_R,
+                .g = VK_COMPONENT_SWIZZLE_G,
+                .b = VK_COMPONENT_SWIZZLE_B,
+                .a = VK_COMPONENT_SWIZZLE_A,
+            },
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            }
+        };
+
+        VK_CHECK_ERROR(vkCreateImageView(mDevice,
+                                         &imageViewCreateInfo,
+                                         nullptr,
+                                         &mSwapchainImageViews[i]));
+    }
+
+    if (mSampleCount != VK_SAMPLE_COUNT_1_BIT) {
+        // ================================================================================
+        // 6. 멀티샘플 Attachment 생성
+        // ================================================================================
+        createTransientAttachment(mSwapchainImageExtent,
+                                  mSurfaceFormat.format,
+                                  mSampleCount,
+                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                                  VK_IMAGE_ASPECT_COLOR_BIT,
+                                  &mColorAttachment);
+    }
+
+    if (mConfig.depthTest) {
+        // ================================================================================
+        // 7. 깊이 Attachment 생성
+        // ================================================================================
+        createTransientAttachment(mSwapchainImageExtent,
+                                  kDepthFormat,
+                                  mSampleCount,
+                                  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                  VK_IMAGE_ASPECT_DEPTH_BIT,
+                                  &mDepthAttachment);
+    }
+
+    if (mDynamicResolution) {
+        // ================================================================================
+        // 8. 장면 Attachment 생성
+        // ================================================================================
+        // 배율과 상관없이 가장 큰 크기로 만들고 일부 영역에만 그려서 배율이 바뀌어도 다시 만들지 않는다.
+        createTransientAttachment(mSwapchainImageExtent,
+                                  mSurfaceFormat.format,
+                                  VK_SAMPLE_COUNT_1_BIT,
+                                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                  VK_IMAGE_ASPECT_COLOR_BIT,
+                                  &mSceneAttachment);
+    }
+
+    if (mFoveatedShading) {
+        // ================================================================================
+        // 9. 셰이딩 비율 Attachment 생성
+        // ================================================================================
+        createShadingRateAttachment();
+    }
+
+    // 해상도 배율은 VkSwapchain을 다시 만들어도 유지된다.
+    mRenderExtent = vkScaleExtent(mSwapchainImageExtent, mResolutionScale);
+
+    // 출력을 기다리는 VkSemaphore는 출력이 끝나야 다시 사용할 수 있으므로 스왑체인 이미지마다 만든다.
+    // 같은 이미지를 다시 얻었다면 이전 출력은 이미 이 VkSemaphore를 기다린 상태다.
+    mSemaphoresForPresent.resize(swapchainImageCount);
+    for (auto& semaphore : mSemaphoresForPresent) {
+        // ================================================================================
+        // 10. VkSemaphore 생성
+        // ================================================================================
+        VkSemaphoreCreateInfo semaphoreCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        };
+
+        VK_CHECK_ERROR(vkCreateSemaphore(mDevice, &semaphoreCreateInfo, nullptr, &semaphore));
+    }
+
+    // Dynamic Rendering은 VkImageView를 기록할 때 직접 전달한다.
+    if (!mDynamicRendering) {
+        mFramebuffers.resize(swapchainImageCount);
+        for (auto i = 0; i != swapchainImageCount; ++i) {
+            // ================================================================================
+            // 11. VkFramebuffer 생성
+            // ================================================================================
+            // VkRenderPass의 Attachment 순서와 같아야 한다.
+            vector<VkImageView> attachments{mDynamicResolution ? mSceneAttachment.imageView
+                                                               : mSwapchainImageViews[i]};
+            if (mSampleCount != VK_SAMPLE_COUNT_1_BIT) {
+                attachments.push_back(mColorAttachment.imageView);
+            }
+            if (mConfig.depthTest) {
+                attachments.push_back(mDepthAttachment.imageView);
+            }
+
+            VkFramebufferCreateInfo framebufferCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+                .renderPass = mRenderPass,
+                .attachmentCount = static_cast<uint32_t>(attachments.size()),
+                .pAttachments = attachments.data(),
+                .width = mSwapchainImageExtent.width,
+                .height = mSwapchainImageExtent.height,
+                .layers = 1
+            };
+
+            VK_CHECK_ERROR(vkCreateFramebuffer(mDevice,
+                                               &framebufferCreateInfo,
+                                               nullptr,
+                                               &mFramebuffers[i]));
+        }
+    }
+
+    if (mConfig.prerecordCommandBuffers) {
+        // ================================================================================
+        // 12. 미리 기록할 VkCommandBuffer 할당
+        // ================================================================================
+        // 프레임과 스왑체인 이미지의 조합마다 하나씩 할당하며 처음 사용할 때 기록된다.
+        const auto recordedCommandBufferCount = kMaxFramesInFlight * swapchainImageCount;
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = mCommandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = recordedCommandBufferCount
+        };
+
+        vector<VkCommandBuffer> commandBuffers(recordedCommandBufferCount);
+        VK_CHECK_ERROR(vkAllocateCommandBuffers(mDevice, &commandBufferAllocateInfo, commandBuffers.data()));
+
+        mRecordedCommandBuffers.resize(recordedCommandBufferCount);
+        for (auto i = 0; i != recordedCommandBufferCount; ++i) {
+            mRecordedCommandBuffers[i] = {
+                .commandBuffer = commandBuffers[i],
+                .sceneVersion = UINT64_MAX,
+                .dynamicOffset = 0
+            };
+        }
+    }
+}
+
+void VkRenderer::destroySwapchain() {
+    VkTimelineProperties timelineProperties;
+    vkGetTimelineProperties(mTimeline, &timelineProperties);
+    const auto timelineValue = timelineProperties.submittedValue;
+
+    for (auto &recordedCommandBuffer: mRecordedCommandBuffers) {
+        vkDeferDestroy(mDeletionQueue,
+                       timelineValue,
+                       [](void *pUserData, uint64_t object) {
+                           auto pRenderer = static_cast<VkRenderer *>(pUserData);
+                           auto commandBuffer = reinterpret_cast<VkCommandBuffer>(object);
+                           vkFreeCommandBuffers(pRenderer->mDevice, pRenderer->mCommandPool, 1, &commandBuffer);
+                       },
+                       this,
+                       reinterpret_cast<uint64_t>(recordedCommandBuffer.commandBuffer));
+    }
+    mRecordedCommandBuffers.clear();
+    for (auto framebuffer: mFramebuffers) {
+        vkDeferDestroyObject(mDeletionQueue,
+                             timelineValue,
+                             VK_OBJECT_TYPE_FRAMEBUFFER,
+                             reinterpret_cast<uint64_t>(framebuffer));
+    }
+    mFramebuffers.clear();
+    for (auto imageView: mSwapchainImageViews) {
+        vkDeferDestroyObject(mDeletionQueue,
+                             timelineValue,
+                             VK_OBJECT_TYPE_IMAGE_VIEW,
+                             reinterpret_cast<uint64_t>(imageView));
+    }
+    mSwapchainImageViews.clear();
+    destroyTransientAttachment(&mColorAttachment, timelineValue);
+    destroyTransientAttachment(&mDepthAttachment, timelineValue);
+    destroyTransientAttachment(&mSceneAttachment, timelineValue);
+    destroyTransientAttachment(&mShadingRateAttachment, timelineValue);
+    // 출력 엔진이 VkSemaphore를 기다리는 것은 타임라인으로 알 수 없지만 Android는 vkQueuePresentKHR에서
+    // 기다릴 VkSemaphore를 네이티브 펜스로 바꾸므로 이 VkSemaphore를 시그널하는 제출이 끝나면 파괴할 수 있다.
+    for (auto semaphore : mSemaphoresForPresent) {
+        vkDeferDestroyObject(mDeletionQueue,
+                             timelineValue,
+                             VK_OBJECT_TYPE_SEMAPHORE,
+                             reinterpret_cast<uint64_t>(semaphore));
+    }
+    mSemaphoresForPresent.clear();
+    for (auto i = 0; i != mOffscreenImageAllocations.size(); ++i) {
+        vkDeferDestroyObject(mDeletionQueue,
+                             timelineValue,
+                             VK_OBJECT_TYPE_IMAGE,
+                             reinterpret_cast<uint64_t>(mSwapchainImages[i]));
+        deferDestroyMemoryAllocation(mOffscreenImageAllocations[i], timelineValue);
+    }
+    mOffscreenImageAllocations.clear();
+    mSwapchainImages.clear();
+    if (mSwapchain) {
+        vkDeferDestroyObject(mDeletionQueue,
+                             timelineValue,
+                             VK_OBJECT_TYPE_SWAPCHAIN_KHR,
+                             reinterpret_cast<uint64_t>(mSwapchain));
+        mSwapchain = VK_NULL_HANDLE;
+    }
+}
+
+void VkRenderer::recreateSwapchain() {
+    // 이전 VkSwapchain은 새 VkSwapchain을 만들 때 넘겨서 출력 중인 이미지를 재사용할 수 있게 한다.
+    // 이전 VkSwapchain의 오브젝트는 디바이스를 기다리지 않고 마지막으로 제출된 프레임이 끝난 후 파괴된다.
+    auto oldSwapchain = mSwapchain;
+    mSwapchain = VK_NULL_HANDLE;
+    destroySwapchain();
+    createSwapchain(oldSwapchain);
+    if (oldSwapchain) {
+        VkTimelineProperties timelineProperties;
+        vkGetTimelineProperties(mTimeline, &timelineProperties);
+        vkDeferDestroyObject(mDeletionQueue,
+                             timelineProperties.submittedValue,
+                             VK_OBJECT_TYPE_SWAPCHAIN_KHR,
+                             reinterpret_cast<uint64_t>(oldSwapchain));
+    }
+    mSwapchainOutdated = false;
+}
+
+void VkRenderer::createTransientAttachment(VkExtent2D extent,
+                                           VkFormat format,
+                                           VkSampleCountFlagBits samples,
+                                           VkImageUsageFlags usage,
+                                           VkImageAspectFlags aspectMask,
+                                           TransientAttachment *pAttachment) {
+    // ================================================================================
+    // 1. VkImage 생성
+    // ================================================================================
+    // TRANSIENT 이미지는 Attachment로만 사용할 수 있으며 드라이버가 메모리를 실제로 할당하지 않을 수 있다.
+    const auto transient = !(usage & (VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT));
+    VkImageCreateInfo imageCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = format,
+        .extent = {
+            .width = extent.width,
+            .height = extent.height,
+            .depth = 1
+        },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = samples,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = transient ? usage | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+
+    VK_CHECK_ERROR(vkCreateImage(mDevice, &imageCreateInfo, nullptr, &pAttachment->image));
+
+    // ================================================================================
+    // 2. VkMemoryAllocation 생성
+    // ================================================================================
+    VkMemoryRequirements memoryRequirements;
+    vkGetImageMemoryRequirements(mDevice, pAttachment->image, &memoryRequirements);
+
+    // 타일 기반 GPU는 LAZILY_ALLOCATED 메모리를 제공하며 타일 메모리가 넘칠 때만 실제로 할당한다.
+    // 지원하지 않는 기기는 DEVICE_LOCAL 메모리를 사용한다.
+    uint32_t memoryTypeIndex;
+    const auto lazilyAllocated = transient &&
+                                 vkGetMemoryTypeIndex(mPhysicalDeviceMemoryProperties,
+                                                      memoryRequirements,
+                                                      VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                                                      &memoryTypeIndex) == VK_SUCCESS;
+
+    VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .flags = VK_MEMORY_ALLOCATION_CREATE_DEDICATED_BIT,
+        .type = VK_MEMORY_ALLOCATION_TYPE_IMAGE_OPTIMAL,
+        .memoryRequirements = memoryRequirements,
+        .memoryPropertyFlags = lazilyAllocated ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT
+                                               : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    };
+
+    VK_CHECK_ERROR(vkCreateMemoryAllocation(mMemoryAllocator,
+                                            &memoryAllocationCreateInfo,
+                                            &pAttachment->allocation));
+
+    VkMemoryAllocationProperties memoryAllocationProperties;
+    vkGetMemoryAllocationProperties(pAttachment->allocation, &memoryAllocationProperties);
+
+    VK_CHECK_ERROR(vkBindImageMemory(mDevice,
+                                     pAttachment->image,
+                                     memoryAllocationProperties.memory,
+                                     memoryAllocationProperties.offset));
+
+    // ================================================================================
+    // 3. VkImageView 생성
+    // ================================================================================
+    VkImageViewCreateInfo imageViewCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = pAttachment->image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = format,
+        .subresourceRange = {
+            .aspectMask = aspectMask,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+
+    VK_CHECK_ERROR(vkCreateImageView(mDevice, &imageViewCreateInfo, nullptr, &pAttachment->imageView));
+}
+
+void VkRenderer::destroyTransientAttachment(TransientAttachment *pAttachment, uint64_t timelineValue) {
+    if (pAttachment->image == VK_NULL_HANDLE) {
+        return;
+    }
+
+    vkDeferDestroyObject(mDeletionQueue,
+                         timelineValue,
+                         VK_OBJECT_TYPE_IMAGE_VIEW,
+                         reinterpret_cast<uint64_t>(pAttachment->imageView));
+    vkDeferDestroyObject(mDeletionQueue,
+                         timelineValue,
+                         VK_OBJECT_TYPE_IMAGE,
+                         reinterpret_cast<uint64_t>(pAttachment->image));
+    deferDestroyMemoryAllocation(pAttachment->allocation, timelineValue);
+    *pAttachment = {};
+}
+
+void VkRenderer::deferDestroyMemoryAllocation(VkMemoryAllocation allocation, uint64_t timelineValue) {
+    vkDeferDestroy(mDeletionQueue,
+                   timelineValue,
+                   [](void *pUserData, uint64_t object) {
+                       vkDestroyMemoryAllocation(static_cast<VkRenderer *>(pUserData)->mMemoryAllocator,
+                                                 reinterpret_cast<VkMemoryAllocation>(object));
+                   },
+                   this,
+                   reinterpret_cast<uint64_t>(allocation));
+}
+
+void VkRenderer::createShadingRateAttachment() {
+    // ================================================================================
+    // 1. 셰이딩 비율 Attachment 생성
+    // ================================================================================
+    // 텍셀 하나가 mShadingRateTexelSize 크기의 영역을 덮으므로 스왑체인 이미지를 덮도록 올림한다.
+    const VkExtent2D extent{
+        .width = (mSwapchainImageExtent.width + mShadingRateTexelSize.width - 1) / mShadingRateTexelSize.width,
+        .height = (mSwapchainImageExtent.height + mShadingRateTexelSize.height - 1) / mShadingRateTexelSize.height
+    };
+
+    createTransientAttachment(extent,
+                              VK_FORMAT_R8_UINT,
+                              VK_SAMPLE_COUNT_1_BIT,
+                              VK_IMAGE_USAGE_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR |
+                              VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                              VK_IMAGE_ASPECT_COLOR_BIT,
+                              &mShadingRateAttachment);
+
+    // ================================================================================
+    // 2. 셰이딩 비율 계산
+    // ================================================================================
+    // 화면 중심에서 텍셀 중심까지의 거리를 화면 대각선의 절반에 대한 비율로 foveaRadius와 비교한다.
+    const auto peripheralShadingRate = static_cast<uint8_t>(__builtin_ctz(mShadingRate.width) << 2 |
+                                                            __builtin_ctz(mShadingRate.height));
+    const auto halfWidth = 0.5f * static_cast<float>(mSwapchainImageExtent.width);
+    const auto halfHeight = 0.5f * static_cast<float>(mSwapchainImageExtent.height);
+    const auto foveaRadius = mConfig.foveaRadius * sqrt(halfWidth * halfWidth + halfHeight * halfHeight);
+
+    vector<uint8_t> shadingRates(extent.width * extent.height);
+    for (auto y = 0; y != extent.height; ++y) {
+        for (auto x = 0; x != extent.width; ++x) {
+            const auto dx = (static_cast<float>(x) + 0.5f) * mShadingRateTexelSize.width - halfWidth;
+            const auto dy = (static_cast<float>(y) + 0.5f) * mShadingRateTexelSize.height - halfHeight;
+            shadingRates[y * extent.width + x] = dx * dx + dy * dy > foveaRadius * foveaRadius
+                                                 ? peripheralShadingRate
+                                                 : 0;
+        }
+    }
+
+    // ================================================================================
+    // 3. 셰이딩 비율 업로드
+    // ================================================================================
+    // 복사가 끝나면 렌더링에서 읽는 레이아웃으로 바뀌며 같은 큐에 나중에 제출되는 렌더링이 결과를 사용한다.
+    const VkBufferImageCopy bufferImageCopy{
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        },
+        .imageExtent = {
+            .width = extent.width,
+            .height = extent.height,
+            .depth = 1
+        }
+    };
+
+    VkStagingImageUploadInfo stagingImageUploadInfo{
+        .image = mShadingRateAttachment.image,
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        },
+        .finalLayout = VK_IMAGE_LAYOUT_FRAGMENT_SHADING_RATE_ATTACHMENT_OPTIMAL_KHR,
+        .regionCount = 1,
+        .pRegions = &bufferImageCopy,
+        .dataSize = shadingRates.size(),
+        .pData = shadingRates.data()
+    };
+
+    VK_CHECK_ERROR(vkUploadImage(mStagingUploader, &stagingImageUploadInfo));
+    VK_CHECK_ERROR(vkFlushStagingUploader(mStagingUploader));
+}
+
+VkResult VkRenderer::getPipelineVariant(const ShaderVariant &variant, VkPipeline *pPipeline) {
+    auto [iter, inserted] = mPipelineVariants.try_emplace(variant, PipelineVariant{
+        .pRenderer = this,
+        .variant = variant,
+        .compile = VK_NULL_HANDLE,
+        .result = VK_NOT_READY,
+        .pipeline = VK_NULL_HANDLE
+    });
+    auto &pipelineVariant = iter->second;
+
+    if (inserted) {
+        // ================================================================================
+        // 1. 컴파일 시작
+        // ================================================================================
+        if (mPipelineCompiler) {
+            auto createPipeline = [](void *pUserData, VkPipeline *pPipeline) {
+                auto pPipelineVariant = static_cast<PipelineVariant *>(pUserData);
+                return pPipelineVariant->pRenderer->createGraphicsPipeline(pPipelineVariant->variant, pPipeline);
+            };
+
+            const VkPipelineCompileInfo pipelineCompileInfo{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_COMPILE_INFO,
+                .pfnCreatePipeline = createPipeline,
+                .pUserData = &pipelineVariant
+            };
+
+            VK_CHECK_ERROR(vkCreatePipelineCompile(mPipelineCompiler,
+                                                   &pipelineCompileInfo,
+                                                   &pipelineVariant.compile));
+        } else {
+            pipelineVariant.result = createGraphicsPipeline(variant, &pipelineVariant.pipeline);
+        }
+    }
+
+    if (pipelineVariant.compile) {
+        // ================================================================================
+        // 2. 컴파일 결과 확인
+        // ================================================================================
+        // 기다리지 않으며 끝났으면 결과를 가져오고 VkPipelineCompile은 바로 파괴한다.
+        pipelineVariant.result = vkAcquirePipelineCompile(pipelineVariant.compile, &pipelineVariant.pipeline);
+        if (pipelineVariant.result != VK_NOT_READY) {
+            vkDestroyPipelineCompile(mPipelineCompiler, pipelineVariant.compile);
+            pipelineVariant.compile = VK_NULL_HANDLE;
+        }
+    }
+
+    *pPipeline = pipelineVariant.pipeline;
+    return pipelineVariant.result;
+}
+
+void VkRenderer::bindPipelineVariant(const ShaderVariant &variant, VkPipeline pipeline) {
+    mPipeline = pipeline;
+    mPipelineVariant = variant;
+    mPipelineShadingRate = getShadingRate(variant);
+}
+
+VkExtent2D VkRenderer::getShadingRate(const ShaderVariant &variant) const {
+    return variant[SHADER_VARIANT_CONSTANT_TEXTURED] ? mShadingRate : VkExtent2D{1, 1};
+}
+
+VkResult VkRenderer::createGraphicsPipeline(const ShaderVariant &variant, VkPipeline *pPipeline) {
+    // ================================================================================
+    // 1. 특수화 상수 정의
+    // ================================================================================
+    // 변형마다 드라이버가 상수를 대입하고 사용하지 않는 분기를 제거해서 컴파일한다.
+    array<VkSpecializationMapEntry, SHADER_VARIANT_CONSTANT_COUNT> specializationMapEntries;
+    const auto specializationInfo = vkGetSpecializationInfo(variant, &specializationMapEntries);
+
+    array<VkPipelineShaderStageCreateInfo, 2> pipelineShaderStageCreateInfos{
+        VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .module = mVertexShaderModule,
+            .pName = "main"
+        },
+        VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .module = mFragmentShaderModule,
+            .pName = "main",
+            .pSpecializationInfo = &specializationInfo
+        }
+    };
+
+    array<VkVertexInputBindingDescription, 2> vertexInputBindingDescriptions{
+        VkVertexInputBindingDescription{
+            .binding = 0,
+            .stride = static_cast<uint32_t>(mConfig.compactVertices ? sizeof(CompactVertex) : sizeof(Vertex)),
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        },
+        VkVertexInputBindingDescription{
+            .binding = 1,
+            .stride = sizeof(Instance),
+            .inputRate = VK_VERTEX_INPUT_RATE_INSTANCE
+        }
+    };
+
+    vector<VkVertexInputAttributeDescription> vertexInputAttributeDescriptions;
+    if (mConfig.compactVertices) {
+        appendVertexInputAttributeDescriptions<CompactVertex>(0, &vertexInputAttributeDescriptions);
+    } else {
+        appendVertexInputAttributeDescriptions<Vertex>(0, &vertexInputAttributeDescriptions);
+    }
+    appendVertexInputAttributeDescriptions<Instance>(1, &vertexInputAttributeDescriptions);
+
+    VkPipelineVertexInputStateCreateInfo pipelineVertexInputStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount = static_cast<uint32_t>(vertexInputBindingDescriptions.size()),
+        .pVertexBindingDescriptions = vertexInputBindingDescriptions.data(),
+        .vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributeDescriptions.size()),
+        .pVertexAttributeDescriptions = vertexInputAttributeDescriptions.data()
+    };
+
+    VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST
+    };
+
+    // Viewport와 Scissor는 동적 상태이므로 VkSwapchain을 다시 만들어도 VkPipeline은 그대로 사용한다.
+    VkPipelineViewportStateCreateInfo pipelineViewportStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
+        .scissorCount = 1
+    };
+
+    VkPipelineRasterizationStateCreateInfo pipelineRasterizationStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode = VK_CULL_MODE_NONE,
+        .lineWidth = 1.0f
+    };
+
+    VkPipelineMultisampleStateCreateInfo pipelineMultisampleStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+        .rasterizationSamples = mSampleCount
+    };
+
+    // 같은 깊이의 삼각형은 나중에 그린 삼각형이 보이도록 LESS_OR_EQUAL로 비교한다.
+    VkPipelineDepthStencilStateCreateInfo pipelineDepthStencilStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable = mConfig.depthTest,
+        .depthWriteEnable = mConfig.depthTest,
+        .depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL
+    };
+
+    VkPipelineColorBlendAttachmentState pipelineColorBlendAttachmentState{
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT |
+                          VK_COLOR_COMPONENT_G_BIT |
+                          VK_COLOR_COMPONENT_B_BIT |
+                          VK_COLOR_COMPONENT_A_BIT
+    };
+
+    VkPipelineColorBlendStateCreateInfo pipelineColorBlendStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+        .attachmentCount = 1,
+        .pAttachments = &pipelineColorBlendAttachmentState
+    };
+
+    // 셰이딩 비율은 변형마다 다르지만 그리기마다 설정하므로 VRS를 사용하지 않을 때만 마지막 상태를 뺀다.
+    constexpr array<VkDynamicState, 3> dynamicStates{
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
+        VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR
+    };
+
+    VkPipelineDynamicStateCreateInfo pipelineDynamicStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = static_cast<uint32_t>(mVkCmdSetFragmentShadingRateKHR ? dynamicStates.size()
+                                                                                  : dynamicStates.size() - 1),
+        .pDynamicStates = dynamicStates.data()
+    };
+
+    // Dynamic Rendering은 VkRenderPass 대신 Attachment 포맷으로 호환성을 결정한다.
+    VkPipelineRenderingCreateInfo pipelineRenderingCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &mSurfaceFormat.format,
+        .depthAttachmentFormat = mConfig.depthTest ? kDepthFormat : VK_FORMAT_UNDEFINED
+    };
+
+    VkGraphicsPipelineCreateInfo graphicsPipelineCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = mDynamicRendering ? &pipelineRenderingCreateInfo : nullptr,
+        .flags = mFoveatedShading ? VK_PIPELINE_CREATE_RENDERING_FRAGMENT_SHADING_RATE_ATTACHMENT_BIT_KHR : 0u,
+        .stageCount = pipelineShaderStageCreateInfos.size(),
+        .pStages = pipelineShaderStageCreateInfos.data(),
+        .pVertexInputState = &pipelineVertexInputStateCreateInfo,
+        .pInputAssemblyState = &pipelineInputAssemblyStateCreateInfo,
+        .pViewportState = &pipelineViewportStateCreateInfo,
+        .pRasterizationState = &pipelineRasterizationStateCreateInfo,
+        .pMultisampleState = &pipelineMultisampleStateCreateInfo,
+        .pDepthStencilState = &pipelineDepthStencilStateCreateInfo,
+        .pColorBlendState = &pipelineColorBlendStateCreateInfo,
+        .pDynamicState = &pipelineDynamicStateCreateInfo,
+        .layout = mPipelineLayout,
+        .renderPass = mRenderPass
+    };
+
+    // ================================================================================
+    // 2. Graphics VkPipeline 생성
+    // ================================================================================
+    return vkCreateGraphicsPipelines(mDevice,
+                                     mPipelineCache,
+                                     1,
+                                     &graphicsPipelineCreateInfo,
+                                     nullptr,
+                                     pPipeline);
+}
+
+void VkRenderer::printGpuProfilerStatistics() {
+    uint32_t scopeCount;
+    VK_CHECK_ERROR(vkGetGpuProfilerStatistics(mGpuProfiler, &scopeCount, nullptr));
+
+    vector<VkGpuProfilerScopeStatistics> statistics(scopeCount);
+    VK_CHECK_ERROR(vkGetGpuProfilerStatistics(mGpuProfiler, &scopeCount, statistics.data()));
+
+    aout << "GPU Profiler Statistics ↓" << endl;
+    for (const auto &scopeStatistics: statistics) {
+        aout << " - " << setw(16) << left << scopeStatistics.name
+             << fixed << setprecision(3)
+             << "avg " << scopeStatistics.averageTime << "ms, "
+             << "min " << scopeStatistics.minTime << "ms, "
+             << "max " << scopeStatistics.maxTime << "ms"
+             << defaultfloat << endl;
+    }
+
+    if (mDynamicResolution) {
+        aout << " - " << setw(16) << left << "Render Extent"
+             << mRenderExtent.width << "x" << mRenderExtent.height << endl;
+    }
+
+    // 렌더 패스의 시간을 셰이딩 비율이 1x1인 실행과 비교해서 VRS로 줄어든 시간을 확인한다.
+    if (mVkCmdSetFragmentShadingRateKHR) {
+        aout << " - " << setw(16) << left << "Shading Rate"
+             << mPipelineShadingRate.width << "x" << mPipelineShadingRate.height
+             << (mFoveatedShading ? " (foveated)" : "") << endl;
+    }
+
+    // 프로파일러와 함께 릴리스 빌드에서도 스왑체인 재생성이나 시간 초과가 얼마나 일어났는지 확인할 수 있다.
+    for (const auto &resultStatistics: getGpuProfilerResultStatistics()) {
+        aout << " - " << resultStatistics.fileName << ":" << resultStatistics.line << " "
+             << vkToString(resultStatistics.result) << " x" << resultStatistics.count << endl;
+    }
+}
+
+vector<VkGpuProfilerResultStatistics> VkRenderer::getGpuProfilerResultStatistics() {
+    // 다른 스레드가 새 결과를 셀 수 있으므로 개수가 늘어나면 다시 가져온다.
+    vector<VkGpuProfilerResultStatistics> statistics;
+    VkResult result;
+    do {
+        uint32_t resultCount;
+        VK_CHECK_ERROR(vkGetGpuProfilerResultStatistics(mGpuProfiler, &resultCount, nullptr));
+
+        statistics.resize(resultCount);
+        result = vkGetGpuProfilerResultStatistics(mGpuProfiler, &resultCount, statistics.data());
+        statistics.resize(resultCount);
+    } while (result == VK_INCOMPLETE);
+    return statistics;
+}
+
+void VkRenderer::writeGpuProfilerStatistics(const string &path) {
+    uint32_t scopeCount;
+    VK_CHECK_ERROR(vkGetGpuProfilerStatistics(mGpuProfiler, &scopeCount, nullptr));
+
+    vector<VkGpuProfilerScopeStatistics> statistics(scopeCount);
+    VK_CHECK_ERROR(vkGetGpuProfilerStatistics(mGpuProfiler, &scopeCount, statistics.data()));
+
+    // 범위 이름은 렌더러가 정하므로 JSON 문자열로 이스케이프하지 않는다.
+    ostringstream json;
+    json << "{\n  \"shadingRate\": {"
+         << "\"width\": " << mPipelineShadingRate.width << ", "
+         << "\"height\": " << mPipelineShadingRate.height << ", "
+         << "\"foveated\": " << (mFoveatedShading ? "true" : "false") << "},"
+         << "\n  \"scopes\": [";
+    for (auto i = 0; i != statistics.size(); ++i) {
+        const auto &scopeStatistics = statistics[i];
+        json << (i ? "," : "") << "\n    {"
+             << "\"name\": \"" << scopeStatistics.name << "\", "
+             << "\"samples\": " << scopeStatistics.sampleCount << ", "
+             << "\"lastMs\": " << scopeStatistics.lastTime << ", "
+             << "\"averageMs\": " << scopeStatistics.averageTime << ", "
+             << "\"minMs\": " << scopeStatistics.minTime << ", "
+             << "\"maxMs\": " << scopeStatistics.maxTime << "}";
+    }
+    json << "\n  ],\n  \"results\": [";
+
+    // 호출식은 따옴표를 포함할 수 있으므로 파일 이름과 줄 번호로 호출 위치를 구분한다.
+    const auto resultStatistics = getGpuProfilerResultStatistics();
+    for (auto i = 0; i != resultStatistics.size(); ++i) {
+        json << (i ? "," : "") << "\n    {"
+             << "\"file\": \"" << resultStatistics[i].fileName << "\", "
+             << "\"line\": " << resultStatistics[i].line << ", "
+             << "\"result\": \"" << vkToString(resultStatistics[i].result) << "\", "
+             << "\"count\": " << resultStatistics[i].count << "}";
+    }
+    json << "\n  ]\n}\n";
+
+    const auto data = json.str();
+    vkWriteFile(path, data.data(), data.size());
 }
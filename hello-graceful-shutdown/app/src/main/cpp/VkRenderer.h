@@ -20,56 +20,414 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include <game-activity/GameActivity.h>
 #include <vulkan/vulkan.h>
 
-#include "VkTexture.h"
+#include "VkCommandRecorder.h"
+#include "VkDeletionQueue.h"
+#include "VkFrameTrace.h"
+#include "VkGpuProfiler.h"
+#include "VkMemoryAllocator.h"
+#include "VkMesh.h"
+#include "VkPerformanceHint.h"
+#include "VkPipelineCompiler.h"
+#include "VkRendererConfig.h"
+#include "VkResidencyManager.h"
+#include "VkRingBuffer.h"
+#include "VkStagingUploader.h"
+#include "VkStateCache.h"
+#include "VkTextureLoader.h"
+#include "VkTimeline.h"
+#include "VkTrace.h"
+#include "VkUtil.h"
 
+// 렌더링은 렌더러가 소유한 렌더 스레드에서 하며 public 함수는 이벤트 루프 스레드에서 호출한다.
 class VkRenderer {
 public:
-    explicit VkRenderer(ANativeWindow *nativeWindow, AAssetManager *assetManager);
+    // 오프스크린 모드에서는 nativeWindow를 사용하지 않으며, 텍스처 데이터가 설정되어 있고
+    // 메시 에셋을 사용하지 않으면 assetManager도 nullptr일 수 있다.
+    explicit VkRenderer(ANativeWindow *nativeWindow,
+                        AAssetManager *assetManager,
+                        const char *internalDataPath,
+                        const VkRendererConfig &config = {});
 
     ~VkRenderer();
 
-    void render();
+    // 윈도우가 다시 생성되면 VkSurface와 VkSwapchain만 다시 만든다.
+    void attachWindow(ANativeWindow *nativeWindow);
+
+    // 윈도우가 파괴되기 전에 VkSurface와 VkSwapchain을 파괴하며 렌더 스레드가 처리할 때까지 기다린다.
+    void detachWindow();
+
+    // 윈도우 크기나 방향이 바뀌면 다음 프레임에서 VkSwapchain을 다시 만든다.
+    void resize();
+
+    // 시스템 메모리가 부족하면 GPU 작업이 끝나기를 기다린 후 텍스처를 모두 해제하고
+    // 다시 그릴 때 불러온다.
+    void trimMemory();
+
+    // render()의 CPU 시간 히스토그램을 출력하며 렌더 스레드가 그리는 중에도 호출할 수 있다.
+    // VK_TRACE가 정의되지 않으면 아무것도 하지 않는다.
+    void printFrameTimeHistogram();
+
+    // 오프스크린 모드에서 offscreenFrameCount개의 프레임을 모두 그릴 때까지 기다리고
+    // 프레임마다 render()에 걸린 CPU 시간을 나노초 단위로 반환한다.
+    std::vector<uint64_t> waitOffscreenFrames();
+
+    // 지금까지 캡처한 프레임 트레이스의 데이터로 VkRendererConfig::pFrameTraceData로 재생할 수 있다.
+    // 렌더 스레드가 그리는 중에도 호출할 수 있으며 캡처하지 않으면 비어있다.
+    std::vector<uint8_t> getFrameTraceData();
 
 private:
+    enum RenderCommandType {
+        RENDER_COMMAND_TYPE_ATTACH_WINDOW,
+        RENDER_COMMAND_TYPE_DETACH_WINDOW,
+        RENDER_COMMAND_TYPE_RESIZE,
+        RENDER_COMMAND_TYPE_TRIM_MEMORY,
+        RENDER_COMMAND_TYPE_QUIT
+    };
+
+    struct RenderCommand {
+        RenderCommandType type;
+        ANativeWindow *nativeWindow;
+    };
+
+    void postRenderCommand(const RenderCommand &renderCommand);
+
+    void waitRenderCommands();
+
+    bool processRenderCommands();
+
+    void runRenderThread();
+
+    void render();
+
+    void createSurface(ANativeWindow *nativeWindow);
+
+    // 윈도우를 떼거나 VkSurface를 잃으면 호출되며 다시 윈도우를 붙일 때까지 그리지 않는다.
+    void destroySurface();
+
+    void createSwapchain(VkSwapchainKHR oldSwapchain);
+
+    // 마지막으로 제출된 프레임이 사용했을 수 있으므로 그 타임라인 값이 완료되면 파괴되도록 예약한다.
+    void destroySwapchain();
+
+    void recreateSwapchain();
+
+    // 렌더 패스 안에서만 사용되는 Attachment로 가능하면 LAZILY_ALLOCATED 메모리에 만든다.
+    // 복사 원본으로 사용되는 Attachment는 렌더 패스가 끝난 후에도 내용이 필요하고
+    // 복사 대상으로 사용되는 Attachment는 렌더 패스 전에 내용이 필요하므로 DEVICE_LOCAL 메모리에 만든다.
+    struct TransientAttachment {
+        VkImage image{VK_NULL_HANDLE};
+        VkMemoryAllocation allocation{VK_NULL_HANDLE};
+        VkImageView imageView{VK_NULL_HANDLE};
+    };
+
+    void createTransientAttachment(VkExtent2D extent,
+                                   VkFormat format,
+                                   VkSampleCountFlagBits samples,
+                                   VkImageUsageFlags usage,
+                                   VkImageAspectFlags aspectMask,
+                                   TransientAttachment *pAttachment);
+
+    void destroyTransientAttachment(TransientAttachment *pAttachment, uint64_t timelineValue);
+
+    void deferDestroyMemoryAllocation(VkMemoryAllocation allocation, uint64_t timelineValue);
+
+    // 화면 중심에서 멀어질수록 성기게 셰이딩하는 셰이딩 비율 Attachment를 만들고 내용을 업로드한다.
+    void createShadingRateAttachment();
+
+    void printGpuProfilerStatistics();
+
+    void writeGpuProfilerStatistics(const std::string &path);
+
+    // VkGpuProfiler로 VK_COUNT_RESULT와 VK_CHECK_ERROR가 센 성공이 아닌 결과를 가져온다.
+    std::vector<VkGpuProfilerResultStatistics> getGpuProfilerResultStatistics();
+
+    void recordFrame(VkCommandBuffer commandBuffer, uint32_t dynamicOffset, uint32_t swapchainImageIndex);
+
+    void recordAnimation(VkCommandBuffer commandBuffer, uint32_t dynamicOffset);
+
+    void recordRenderPass(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex);
+
+    void recordBeginRendering(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex);
+
+    void recordEndRendering(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex);
+
+    void recordUpscale(VkCommandBuffer commandBuffer, uint32_t swapchainImageIndex);
+
+    void updateRenderExtent(uint64_t targetFrameDuration);
+
+    void recordDraws(VkCommandBuffer commandBuffer, uint32_t drawCommandIndex);
+
+    void createTextureLoad();
+
+    // 출력, 제출과 기다리기가 VK_ERROR_DEVICE_LOST를 반환하면 호출되며 이 렌더러의 렌더링을 멈춘다.
+    void handleDeviceLost();
+
+    // 트레이스를 재생할 때 텍스처를 그린 프레임에서 불러오기가 끝날 때까지 기다린다.
+    void waitTextureLoad();
+
+    // vkUpdateResidency에서 호출되며 텍스처는 사용한 프레임의 GPU 작업이 끝난 후 파괴된다.
+    void evictTexture();
+
+    // Fragment 셰이더의 특수화 상수로 constant_id 순서와 같으며 모든 변형이 하나의 VkShaderModule을 공유한다.
+    enum ShaderVariantConstant {
+        SHADER_VARIANT_CONSTANT_TEXTURED,
+        SHADER_VARIANT_CONSTANT_TONEMAP,
+        SHADER_VARIANT_CONSTANT_COUNT
+    };
+
+    using ShaderVariant = std::array<uint32_t, SHADER_VARIANT_CONSTANT_COUNT>;
+
+    struct PipelineVariant {
+        VkRenderer *pRenderer;
+        ShaderVariant variant;
+        // 워커 스레드에서 컴파일 중일 때만 존재한다.
+        VkPipelineCompile compile;
+        VkResult result;
+        VkPipeline pipeline;
+    };
+
+    // 특수화 상수 값이 같은 Graphics VkPipeline은 한번만 만들고 렌더러가 파괴될 때 파괴한다.
+    // VkPipelineCompiler가 있으면 처음 요청할 때 컴파일을 시작하고 끝날 때까지 VK_NOT_READY를 반환한다.
+    VkResult getPipelineVariant(const ShaderVariant &variant, VkPipeline *pPipeline);
+
+    // 생성 후 바뀌지 않는 멤버만 읽으므로 워커 스레드에서도 호출할 수 있다.
+    VkResult createGraphicsPipeline(const ShaderVariant &variant, VkPipeline *pPipeline);
+
+    // 그릴 때 사용할 Graphics VkPipeline과 변형을 바꾸며 미리 기록된 VkCommandBuffer는 호출한 쪽이 다시 기록한다.
+    void bindPipelineVariant(const ShaderVariant &variant, VkPipeline pipeline);
+
+    // 텍스처를 샘플링하지 않는 변형은 Fragment 셰이더가 가벼워서 성기게 셰이딩해도 줄어드는 시간이 작으므로 1x1로 그린다.
+    VkExtent2D getShadingRate(const ShaderVariant &variant) const;
+
+    // 그리기마다 셰이더에 전달하는 데이터로 Uniform VkBuffer를 거치지 않는다.
+    // std430에서 mat2의 각 열은 8바이트 간격으로 배치된다.
+    struct PushConstant {
+        float rotation[4];
+        float ratio;
+        uint32_t textureIndex;
+    };
+
+    // 프레임 트레이스에 기록하는 렌더러 수준의 연산으로 순서나 데이터 형식이 바뀌면 이전 트레이스는 재생할 수 없다.
+    // BIND_TEXTURE와 DRAW는 장면을 그린 프레임에만 기록되며 DRAW의 데이터는 렌더링 영역이다.
+    enum TraceOpType {
+        TRACE_OP_TYPE_UPDATE_UNIFORM,
+        TRACE_OP_TYPE_PUSH_CONSTANTS,
+        TRACE_OP_TYPE_BIND_PIPELINE,
+        TRACE_OP_TYPE_BIND_TEXTURE,
+        TRACE_OP_TYPE_DRAW,
+        TRACE_OP_TYPE_COUNT
+    };
+
+    using TraceFrame = std::array<const VkFrameTraceOp *, TRACE_OP_TYPE_COUNT>;
+
+    // 재생할 다음 프레임의 연산을 종류별로 찾으며 프레임에 없는 종류는 nullptr이다.
+    void readTraceFrame(TraceFrame *pTraceFrame);
+
+    struct RecordedCommandBuffer {
+        VkCommandBuffer commandBuffer;
+        // 기록할 때의 장면 버전과 Uniform 오프셋으로 둘 중 하나라도 다르면 다시 기록한다.
+        uint64_t sceneVersion;
+        uint32_t dynamicOffset;
+    };
+
+    // CPU가 GPU보다 앞서서 기록할 수 있는 프레임 개수로 지연 시간과 메모리 사용량을 결정한다.
+    static constexpr uint32_t kMaxFramesInFlight = 2;
+
+    // Bindless 텍스처 배열의 크기로 Descriptor Indexing의 최소 한도보다 충분히 작다.
+    static constexpr uint32_t kMaxTextureCount = 1024;
+
+    // 이보다 큰 VkBuffer 업로드는 나눠서 복사한다.
+    static constexpr VkDeviceSize kStagingArenaSize = 4 * 1024 * 1024;
+
+    // 컴파일을 기다리지 않도록 렌더러를 만들 때 컴파일하는 변형으로 텍스처를 샘플링하지 않는다.
+    static constexpr ShaderVariant kFallbackShaderVariant{VK_FALSE, VK_FALSE};
+
+    // 모든 기기가 깊이 Attachment로 지원해야 하는 포맷이다.
+    static constexpr VkFormat kDepthFormat = VK_FORMAT_D16_UNORM;
+
+    // Display Timing이 없으면 주사율을 알 수 없으므로 60Hz로 가정한다.
+    static constexpr uint64_t kDefaultRefreshDuration = 16666667;
+
+    // 동적 해상도는 GPU 프레임 시간이 목표 프레임 시간의 이 비율이 되도록 조절해서 여유를 남긴다.
+    static constexpr double kTargetGpuUtilization = 0.85;
+
+    // GPU 프로파일러가 프레임마다 측정하는 범위의 최대 개수와 통계를 계산할 프레임 개수.
+    static constexpr uint32_t kGpuProfilerMaxScopeCount = 8;
+    static constexpr uint32_t kGpuProfilerHistoryLength = 120;
+
+    // 메모리가 부족해서 텍스처를 불러오지 못하면 다른 메모리가 해제될 때까지 이 시간 동안 기다린다.
+    static constexpr std::chrono::seconds kTextureRetryInterval{1};
+
     AAssetManager *mAssetManager;
+    const char *mInternalDataPath;
     VkInstance mInstance;
+    VkDebugUtilsMessengerEXT mDebugUtilsMessenger{VK_NULL_HANDLE};
     VkPhysicalDevice mPhysicalDevice;
     VkPhysicalDeviceMemoryProperties mPhysicalDeviceMemoryProperties;
     uint32_t mQueueFamilyIndex;
     VkDevice mDevice;
     VkQueue mQueue;
-    VkSurfaceKHR mSurface;
-    VkSwapchainKHR mSwapchain;
+    uint32_t mTransferQueueFamilyIndex;
+    VkQueue mTransferQueue;
+    VkMemoryAllocator mMemoryAllocator;
+    VkRendererConfig mConfig;
+    VkSurfaceKHR mSurface{VK_NULL_HANDLE};
+    VkSurfaceFormatKHR mSurfaceFormat;
+    VkSwapchainKHR mSwapchain{VK_NULL_HANDLE};
+    bool mSwapchainOutdated{false};
+    PFN_vkGetRefreshCycleDurationGOOGLE mVkGetRefreshCycleDurationGOOGLE{nullptr};
+    PFN_vkGetPastPresentationTimingGOOGLE mVkGetPastPresentationTimingGOOGLE{nullptr};
+    bool mDynamicRendering{false};
+    PFN_vkCmdBeginRendering mVkCmdBeginRendering{nullptr};
+    PFN_vkCmdEndRendering mVkCmdEndRendering{nullptr};
+    // VRS를 사용하지 않으면 mShadingRate는 {1, 1}이고 mVkCmdSetFragmentShadingRateKHR은 nullptr이다.
+    // mPipelineShadingRate는 바인드하는 Graphics VkPipeline 변형의 셰이딩 비율로 그리기마다 설정한다.
+    VkExtent2D mShadingRate{1, 1};
+    VkExtent2D mPipelineShadingRate{1, 1};
+    std::array<VkFragmentShadingRateCombinerOpKHR, 2> mShadingRateCombinerOps{
+        VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+        VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR
+    };
+    PFN_vkCmdSetFragmentShadingRateKHR mVkCmdSetFragmentShadingRateKHR{nullptr};
+    // Foveated 셰이딩을 사용할 때만 만들어지며 텍셀 하나가 mShadingRateTexelSize 크기 영역의 셰이딩 비율이다.
+    bool mFoveatedShading{false};
+    VkExtent2D mShadingRateTexelSize{1, 1};
+    TransientAttachment mShadingRateAttachment;
+    uint64_t mRefreshDuration{0};
+    uint32_t mPresentID{0};
+    VkPastPresentationTimingGOOGLE mLastPresentationTiming{};
     std::vector<VkImage> mSwapchainImages;
     VkExtent2D mSwapchainImageExtent;
+    VkSurfaceTransformFlagBitsKHR mPreTransform;
+    // 오프스크린 모드에서는 VkSwapchain 대신 만든 이미지를 mSwapchainImages에 넣고 출력하지 않는다.
+    bool mOffscreen{false};
+    std::vector<VkMemoryAllocation> mOffscreenImageAllocations;
+    // 그린 프레임마다의 CPU 시간으로 waitOffscreenFrames가 mRenderLock을 잡고 가져간다.
+    std::vector<uint64_t> mOffscreenFrameTimes;
+    // 오프스크린 모드에서 그린 후 스왑체인 이미지의 레이아웃으로 출력하지 않으면 복사할 수 있는 레이아웃에 둔다.
+    VkImageLayout mSwapchainImageFinalLayout{VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
     VkCommandPool mCommandPool;
     std::vector<VkCommandBuffer> mCommandBuffers;
-    std::vector<VkFence> mFencesForSubmit;
-    std::vector<VkFence> mFencesForAcquire;
-    VkClearValue mClearValue{.color{.float32{0.15, 0.15, 0.15, 1.0}}};
-    std::vector<VkSemaphore> mSemaphores;
+    VkCommandRecorder mCommandRecorder{VK_NULL_HANDLE};
+    // mQueue에 제출하는 모든 작업이 순서대로 값을 발급받으며 프레임과 스테이징 영역의 재사용은 이 값을 기다린다.
+    VkTimeline mTimeline;
+    // 프레임마다 마지막으로 제출한 VkCommandBuffer가 끝나면 완료되는 값이다.
+    std::array<uint64_t, kMaxFramesInFlight> mFrameTimelineValues{};
+    // 프레임 중에 교체된 오브젝트는 디바이스를 기다리지 않고 사용한 제출이 끝난 후 파괴한다.
+    VkDeletionQueue mDeletionQueue;
+    VkGpuProfiler mGpuProfiler{VK_NULL_HANDLE};
+    uint64_t mProfiledFrameCount{0};
+    // 렌더 스레드의 ID로 만들어지므로 렌더 스레드가 시작할 때 만들고 끝날 때 파괴한다.
+    VkPerformanceHint mPerformanceHint{VK_NULL_HANDLE};
+    VkThermalStatus mThermalStatus{VK_THERMAL_STATUS_NONE};
+    std::chrono::steady_clock::time_point mLastFrameStartTime;
+#ifdef VK_TRACE
+    VkFrameTimeHistogram mFrameTimeHistogram;
+#endif
+    std::vector<VkSemaphore> mSemaphoresForAcquire;
+    // Attachment 순서대로 저장되며 CLEAR하지 않는 Attachment의 값은 무시된다.
+    std::vector<VkClearValue> mClearValues;
+    std::vector<VkSemaphore> mSemaphoresForPresent;
     std::vector<VkImageView> mSwapchainImageViews;
-    VkRenderPass mRenderPass;
+    // 렌더 패스 사이의 의존성으로 프레임 간 순서가 보장되므로 모든 스왑체인 이미지가 공유한다.
+    TransientAttachment mDepthAttachment;
+    // mSampleCount가 1보다 클 때만 만들어진다.
+    TransientAttachment mColorAttachment;
+    VkSampleCountFlagBits mSampleCount{VK_SAMPLE_COUNT_1_BIT};
+    // 동적 해상도를 사용하면 장면을 스왑체인 이미지 크기의 mSceneAttachment 중 mRenderExtent 영역에 그린 후
+    // 스왑체인 이미지로 확대하며, 사용하지 않으면 mRenderExtent는 스왑체인 이미지 크기와 같다.
+    bool mDynamicResolution{false};
+    TransientAttachment mSceneAttachment;
+    VkExtent2D mRenderExtent;
+    double mResolutionScale{1.0};
+    // 마지막으로 해상도 배율을 조절할 때 사용한 GPU 시간의 표본 개수로 같은 표본을 다시 사용하지 않는다.
+    uint32_t mResolutionSampleCount{0};
+    // Dynamic Rendering을 사용하면 만들지 않는다.
+    VkRenderPass mRenderPass{VK_NULL_HANDLE};
     std::vector<VkFramebuffer> mFramebuffers;
+    std::vector<RecordedCommandBuffer> mRecordedCommandBuffers;
+    uint64_t mSceneVersion{0};
     VkShaderModule mVertexShaderModule;
     VkShaderModule mFragmentShaderModule;
+    VkShaderModule mComputeShaderModule;
+    // VkSampler, VkDescriptorSetLayout과 VkPipelineLayout은 내용이 같으면 공유되도록 캐시에서 얻는다.
+    VkStateCache mStateCache;
     VkDescriptorSetLayout mDescriptorSetLayout;
+    VkDescriptorSetLayout mComputeDescriptorSetLayout;
+    VkPipelineCache mPipelineCache;
     VkPipelineLayout mPipelineLayout;
+    VkPipelineLayout mComputePipelineLayout;
+    VkPipelineCompiler mPipelineCompiler{VK_NULL_HANDLE};
+    // 원소의 주소가 바뀌지 않아야 워커 스레드에 PipelineVariant를 전달할 수 있다.
+    std::map<ShaderVariant, PipelineVariant> mPipelineVariants;
+    // 설정에 맞는 변형으로 컴파일이 끝나기 전까지는 kFallbackShaderVariant의 VkPipeline이며
+    // 모두 mPipelineVariants가 소유한다.
     VkPipeline mPipeline;
+    ShaderVariant mPipelineVariant{kFallbackShaderVariant};
+    bool mPipelineReady{false};
+    VkPipeline mComputePipeline;
+    // Vertex VkBuffer에 바로 쓸 수 있으면 만들지 않는다.
+    VkStagingUploader mStagingUploader{VK_NULL_HANDLE};
     VkBuffer mVertexBuffer;
-    VkDeviceMemory mVertexMemory;
-    std::vector<VkBuffer> mUniformBuffers;
-    std::vector<VkDeviceMemory> mUniformMemories;
-    std::vector<void*> mUniformData;
+    VkMemoryAllocation mVertexAllocation;
+    VkDeviceSize mIndexDataOffset;
+    VkIndexType mIndexType;
+    Vector2 mMeshExtent;
+    VkDeviceSize mInstanceDataOffset;
+    VkDeviceSize mVisibleInstanceDataOffset;
+    VkDeviceSize mDrawCommandOffset;
+    // 매 프레임 Compute 셰이더가 instanceCount를 채우기 전에 이 값으로 초기화한다.
+    std::vector<VkDrawIndexedIndirectCommand> mDrawCommands;
+    uint32_t mInstancesPerDrawCommand;
+    VkRingBuffer mUniformRingBuffer;
     VkDescriptorPool mDescriptorPool;
-    std::vector<VkDescriptorSet> mDescriptorSets;
-    VkTexture mTexture;
-    VkImage mImage;
-    VkDeviceMemory mMemory;
-    VkImageView mImageView;
+    VkDescriptorSet mDescriptorSet;
+    VkDescriptorSet mComputeDescriptorSet;
+    bool mBindlessTextures{false};
+    PushConstant mPushConstant{};
+    VkTextureLoader mTextureLoader;
+    // 축출되었거나 메모리가 부족해서 불러오지 못하면 VK_NULL_HANDLE이며 다시 그릴 때 불러온다.
+    VkTextureLoad mTextureLoad{VK_NULL_HANDLE};
+    bool mTextureAcquired{false};
+    // 메모리 부족이 아닌 이유로 불러오지 못했으면 다시 불러와도 실패하므로 배경만 그린다.
+    bool mTextureLoadFailed{false};
+    // 텍스처를 획득한 후에는 항상 그리지만 트레이스를 재생할 때는 트레이스가 그린 프레임에만 그린다.
+    bool mDrawScene{false};
+    // 축출된 텍스처를 마지막으로 그렸을 수 있는 제출의 타임라인 값이다.
+    uint64_t mTextureReleaseValue{0};
+    std::chrono::steady_clock::time_point mTextureRetryTime;
+    // 프레임을 캡처하거나 재생할 때만 만들어지며 캡처한 프레임은 렌더 스레드가 mRenderLock을 잡고 추가한다.
+    VkFrameTrace mFrameTrace{VK_NULL_HANDLE};
+    bool mFrameTraceReplay{false};
+    uint32_t mFrameTraceFrameIndex{0};
+    std::vector<VkFrameTraceOp> mFrameTraceOps;
+    VkResidencyManager mResidencyManager;
+    // 텍스처를 처음 획득할 때 만들어지고 다시 불러오면 같은 리소스를 다시 상주시킨다.
+    VkResidentResource mTextureResource{VK_NULL_HANDLE};
     VkSampler mSampler;
     uint64_t mFrameIndex;
+    // 레지던시 관리에 사용하는 프레임 번호로 계속 증가한다.
+    uint64_t mFrameCount{0};
+    // 이벤트 루프 스레드가 넣고 렌더 스레드가 꺼내며, 잠금은 잠들거나 깨울 때만 사용한다.
+    VkSpscQueue<RenderCommand, 16> mRenderCommands;
+    uint64_t mPostedRenderCommandCount{0};
+    uint64_t mProcessedRenderCommandCount{0};
+    // 렌더 스레드가 설정하고 오프스크린 프레임을 기다리는 스레드가 읽으며
+    // 설정되면 렌더 스레드는 파괴될 때까지 그리지 않는다.
+    std::atomic<bool> mDeviceLost{false};
+    std::mutex mRenderLock;
+    std::condition_variable mRenderCondition;
+    std::thread mRenderThread;
 };
\ No newline at end of file
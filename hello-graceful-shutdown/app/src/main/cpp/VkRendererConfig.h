@@ -0,0 +1,151 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKRENDERERCONFIG_H
+#define PRACTICE_VULKAN_VKRENDERERCONFIG_H
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "VkPerformanceHint.h"
+
+#ifdef NDEBUG
+constexpr bool kVkDebugBuild = false;
+#else
+constexpr bool kVkDebugBuild = true;
+#endif
+
+// 릴리스 빌드는 레이어가 모든 호출에 끼어들지 않도록 아무 레이어도 활성화하지 않는다.
+inline std::vector<const char *> vkGetDefaultInstanceLayerNames() {
+    if (kVkDebugBuild) {
+        return {"VK_LAYER_KHRONOS_validation"};
+    }
+    return {};
+}
+
+typedef enum VkPresentPolicy {
+    // 항상 지원되며 minImageCount개의 이미지를 사용한다.
+    VK_PRESENT_POLICY_FIFO = 0,
+    // 3개 이상의 이미지를 사용해서 GPU가 출력을 기다리는 시간을 줄인다.
+    VK_PRESENT_POLICY_FIFO_TRIPLE_BUFFERING = 1,
+    // 출력이 늦어지면 수직 동기화를 기다리지 않는다.
+    VK_PRESENT_POLICY_FIFO_RELAXED = 2,
+    // 가장 최근 이미지를 출력해서 지연 시간을 줄인다.
+    VK_PRESENT_POLICY_MAILBOX = 3
+} VkPresentPolicy;
+
+struct VkRendererConfig {
+    VkPresentPolicy presentPolicy{VK_PRESENT_POLICY_FIFO};
+    // VK_GOOGLE_display_timing이 지원되면 출력 시간을 지정해서 프레임 간격을 일정하게 유지한다.
+    bool displayTiming{false};
+    // 출력 간격(주사율 단위)으로 2이면 60Hz 화면에서 30fps로 출력한다.
+    uint32_t presentInterval{1};
+    // 장면 구조가 바뀌지 않으면 VkRenderPass를 기록한 VkCommandBuffer를 다시 기록하지 않고 제출한다.
+    bool prerecordCommandBuffers{false};
+    // 0보다 크면 VkRenderPass 안의 명령을 이 개수의 워커 스레드에서 보조 VkCommandBuffer로 나눠서 기록한다.
+    // 미리 기록된 VkCommandBuffer가 프레임마다 초기화되는 보조 VkCommandBuffer를 참조할 수 없으므로
+    // prerecordCommandBuffers와 함께 사용하면 무시된다.
+    uint32_t recordThreadCount{0};
+    // 한번의 vkCmdDraw로 그리는 삼각형 개수.
+    uint32_t instanceCount{1};
+    // Vulkan 1.2의 Descriptor Indexing을 지원하면 모든 텍스처를 하나의 배열로 바인드하고
+    // Push Constant로 전달된 인덱스로 선택한다. 지원하지 않으면 텍스처마다 바인드한다.
+    bool bindlessTextures{false};
+    // 거짓이면 텍스처를 샘플링하지 않고 정점 색상만 출력하는 Fragment 셰이더 변형을 사용한다.
+    bool textured{true};
+    // 출력 색상에 Reinhard 톤 매핑을 적용하는 Fragment 셰이더 변형을 사용한다.
+    bool tonemap{false};
+    // 0보다 크면 textured와 tonemap에 맞는 Graphics VkPipeline을 이 개수의 워커 스레드에서 컴파일하고
+    // 끝날 때까지는 두 변형을 모두 끈 가벼운 VkPipeline으로 그린다. 0이면 렌더러를 만들 때 컴파일한다.
+    uint32_t pipelineCompileThreadCount{1};
+    // 위치는 SNORM16, 색상은 UNORM8, 텍스처 좌표는 UNORM16으로 양자화해서 정점 크기를 절반으로 줄인다.
+    bool compactVertices{false};
+    // DEVICE_LOCAL이면서 HOST_VISIBLE인 메모리 타입이 있으면(UMA GPU) Vertex VkBuffer에 바로 쓰고
+    // 스테이징 복사를 하지 않는다. 없으면 항상 스테이징 VkBuffer를 거쳐서 복사한다.
+    bool directUpload{true};
+    // 메시 에셋의 이름으로 nullptr이면 삼각형 하나를 그린다. 정점 위치는 [-0.5, 0.5] 범위를 권장한다.
+    const char *meshFileName{nullptr};
+    // 깊이 Attachment를 만들고 깊이 테스트를 한다. 렌더 패스가 끝나면 버려지므로 타일 메모리에만 존재한다.
+    bool depthTest{false};
+    // 1보다 크면 멀티샘플 Attachment에 그리고 렌더 패스 안에서 스왑체인 이미지로 Resolve한다.
+    // 지원하지 않는 샘플 수는 지원하는 가장 큰 샘플 수로 낮춘다.
+    VkSampleCountFlagBits msaaSamples{VK_SAMPLE_COUNT_1_BIT};
+    // Vulkan 1.3의 Dynamic Rendering을 지원하면 VkRenderPass와 VkFramebuffer 없이 그린다.
+    // 지원하지 않으면 VkRenderPass를 사용한다.
+    bool dynamicRendering{false};
+    // 0보다 크면 GPU 타임스탬프로 Compute와 렌더 패스의 시간을 측정하고 이 프레임 간격마다 출력한다.
+    // 렌더러가 파괴될 때 마지막 통계를 internalDataPath의 gpu_profile.json에 저장한다.
+    uint32_t gpuProfilerInterval{0};
+    // 설치되어 있으면 활성화할 인스턴스 레이어로 목록에 없는 레이어는 설치되어 있어도 활성화하지 않는다.
+    std::vector<const char *> instanceLayerNames{vkGetDefaultInstanceLayerNames()};
+    // VK_EXT_debug_utils를 지원하면 레이어의 메시지를 aout으로 출력한다.
+    bool debugMessenger{kVkDebugBuild};
+    // 지원하면 활성화할 추가 디바이스 확장으로 지원하지 않는 확장은 경고를 출력하고 무시한다.
+    std::vector<const char *> optionalDeviceExtensionNames;
+    // 크기가 0이 아니면 윈도우 없이 디바이스가 소유한 색상 이미지에 이 크기로 그리며 출력하지 않는다.
+    // VK_KHR_android_surface와 VK_KHR_swapchain이 필요 없고 수직 동기화를 기다리지 않으므로
+    // 백그라운드나 디바이스 팜에서 처리량을 측정할 때 사용한다.
+    VkExtent2D offscreenExtent{0, 0};
+    // 오프스크린 모드에서 그릴 프레임 개수로 0이면 렌더러가 파괴될 때까지 그린다.
+    uint32_t offscreenFrameCount{0};
+    // 크기가 0이 아니면 텍스처 에셋 대신 메모리에 있는 이 파일 데이터를 디코딩한다.
+    // AAssetManager가 없는 벤치마크에서 사용하며 렌더러가 파괴될 때까지 유효해야 한다.
+    size_t textureDataSize{0};
+    const void *pTextureData{nullptr};
+    // 비어있지 않으면 각 파일을 텍스처 배열의 레이어로 불러오고 인스턴스마다 순서대로 다른 레이어를 샘플링한다.
+    // 서로 다른 텍스처를 쓰는 인스턴스도 하나의 VkDescriptorSet과 한번의 간접 그리기로 그려진다.
+    // 모든 파일의 포맷과 크기가 같아야 하며 textureDataSize보다 우선한다.
+    std::vector<const char *> textureLayerFileNames;
+    // 0보다 크면 처음 이 개수의 프레임마다 Uniform, Push Constant, Graphics VkPipeline 변형과 그리기를 기록하고
+    // 렌더러가 파괴될 때 internalDataPath의 frame_trace.bin에 저장한다. VkRenderer::getFrameTraceData로도 얻을 수 있다.
+    uint32_t frameCaptureCount{0};
+    // 크기가 0이 아니면 렌더러의 상태 대신 캡처한 프레임 트레이스를 처음부터 반복해서 재생하며 frameCaptureCount보다 우선한다.
+    // 텍스처 불러오기와 Graphics VkPipeline 컴파일을 기다리므로 오프스크린 모드에서 같은 프레임들을 반복해서 측정할 때 사용한다.
+    // 렌더러가 파괴될 때까지 유효해야 한다.
+    size_t frameTraceDataSize{0};
+    const void *pFrameTraceData{nullptr};
+    // Android 13 이상에서 렌더 스레드의 APerformanceHintSession에 render()의 CPU 작업 시간을 보고해서
+    // 목표 프레임 시간에 맞게 CPU 클럭과 코어 배치를 조정하게 한다.
+    bool performanceHint{true};
+    // 열 상태가 이 값 이상이면 출력 간격을 두배로 늘려서 쓰로틀링이 걸리기 전에 작업을 줄인다.
+    // VK_THERMAL_STATUS_MAX_ENUM이면 줄이지 않으며 오프스크린 모드에서는 무시된다.
+    VkThermalStatus thermalThrottleStatus{VK_THERMAL_STATUS_MODERATE};
+    // GPU 타임스탬프로 측정한 프레임 시간이 목표 프레임 시간 안에 들어오도록 장면을 그리는 해상도를 조절하고
+    // 렌더 패스가 끝나면 스왑체인 이미지로 Bilinear 확대한다. 측정을 위해 GPU 프로파일러가 함께 만들어진다.
+    bool dynamicResolution{false};
+    // 가로와 세로에 각각 곱해지는 해상도 배율의 최솟값.
+    float minResolutionScale{0.5f};
+    // {1, 1}보다 크면 VK_KHR_fragment_shading_rate를 지원할 때 텍스처를 샘플링하는 그리기를
+    // 이 크기의 픽셀 블록마다 한번씩 셰이딩한다. 지원하는 크기 중 이 크기를 넘지 않는 가장 큰 크기로 낮춘다.
+    VkExtent2D shadingRate{1, 1};
+    // Dynamic Rendering과 셰이딩 비율 Attachment를 지원하면 화면 중심에서 foveaRadius 안쪽은 1x1로,
+    // 바깥쪽만 shadingRate로 셰이딩한다. foveaRadius는 화면 대각선 절반에 대한 비율이다.
+    bool foveatedShading{false};
+    float foveaRadius{0.5f};
+    // VK_EXT_memory_budget을 지원하면 드라이버가 보고하는 힙 예산으로 텍스처의 레지던시를 관리한다.
+    // 지원하지 않으면 힙 크기의 80%를 예산으로 보고 렌더러가 할당한 메모리만 사용량으로 센다.
+    bool memoryBudget{true};
+    // 힙 사용량이 예산의 이 비율을 넘으면 오래 사용하지 않은 텍스처를 해제하고 다시 그릴 때 불러온다.
+    float residencyBudgetRatio{0.9f};
+};
+
+#endif //PRACTICE_VULKAN_VKRENDERERCONFIG_H
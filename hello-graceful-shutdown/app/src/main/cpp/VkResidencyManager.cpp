@@ -0,0 +1,194 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <list>
+#include <memory>
+
+#include "VkResidencyManager.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+struct VkResidentResourceImpl {
+    uint32_t heapIndex;
+    VkDeviceSize size;
+    PFN_vkEvictResourceFunction pfnEvict;
+    void *pUserData;
+    uint64_t lastUsedFrameIndex;
+    bool resident;
+    // 상주할 때만 유효하다.
+    list<VkResidentResourceImpl *>::iterator iter;
+};
+
+struct VkResidencyManagerImpl {
+    VkMemoryAllocator memoryAllocator;
+    float budgetRatio;
+    // 기록된 가장 큰 프레임으로 새로 상주하는 리소스는 이 프레임에 사용한 것으로 본다.
+    uint64_t frameIndex;
+    // 오래 전에 사용한 리소스가 앞에 있다.
+    list<VkResidentResourceImpl *> residentResources;
+};
+
+void vkInsertResidentResource(VkResidencyManagerImpl *pImpl, VkResidentResourceImpl *pResource) {
+    pResource->lastUsedFrameIndex = pImpl->frameIndex;
+    pResource->resident = true;
+    pResource->iter = pImpl->residentResources.insert(pImpl->residentResources.end(), pResource);
+}
+
+}
+
+VkResult vkCreateResidencyManager(
+    VkDevice                                    device,
+    const VkResidencyManagerCreateInfo*         pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkResidencyManager*                         pResidencyManager) {
+    auto pImpl = make_unique<VkResidencyManagerImpl>();
+    pImpl->memoryAllocator = pCreateInfo->memoryAllocator;
+    pImpl->budgetRatio = pCreateInfo->budgetRatio;
+    pImpl->frameIndex = 0;
+
+    *pResidencyManager = reinterpret_cast<VkResidencyManager>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyResidencyManager(
+    VkDevice                                    device,
+    VkResidencyManager                          residencyManager,
+    const VkAllocationCallbacks*                pAllocator) {
+    delete reinterpret_cast<VkResidencyManagerImpl*>(residencyManager);
+}
+
+VkResult vkCreateResidentResource(
+    VkResidencyManager                          residencyManager,
+    const VkResidentResourceCreateInfo*         pCreateInfo,
+    VkResidentResource*                         pResidentResource) {
+    auto pImpl = reinterpret_cast<VkResidencyManagerImpl*>(residencyManager);
+
+    auto pResource = new VkResidentResourceImpl{
+        .heapIndex = pCreateInfo->heapIndex,
+        .size = pCreateInfo->size,
+        .pfnEvict = pCreateInfo->pfnEvict,
+        .pUserData = pCreateInfo->pUserData
+    };
+    vkInsertResidentResource(pImpl, pResource);
+
+    *pResidentResource = reinterpret_cast<VkResidentResource>(pResource);
+    return VK_SUCCESS;
+}
+
+void vkDestroyResidentResource(
+    VkResidencyManager                          residencyManager,
+    VkResidentResource                          residentResource) {
+    auto pImpl = reinterpret_cast<VkResidencyManagerImpl*>(residencyManager);
+    auto pResource = reinterpret_cast<VkResidentResourceImpl*>(residentResource);
+    if (pResource->resident) {
+        pImpl->residentResources.erase(pResource->iter);
+    }
+    delete pResource;
+}
+
+VkBool32 vkTouchResidentResource(
+    VkResidencyManager                          residencyManager,
+    VkResidentResource                          residentResource,
+    uint64_t                                    frameIndex) {
+    auto pImpl = reinterpret_cast<VkResidencyManagerImpl*>(residencyManager);
+    auto pResource = reinterpret_cast<VkResidentResourceImpl*>(residentResource);
+    pImpl->frameIndex = max(pImpl->frameIndex, frameIndex);
+    if (!pResource->resident) {
+        return VK_FALSE;
+    }
+
+    // 가장 최근에 사용한 리소스로 목록의 끝으로 옮긴다.
+    auto &residentResources = pImpl->residentResources;
+    residentResources.splice(residentResources.end(), residentResources, pResource->iter);
+    pResource->lastUsedFrameIndex = frameIndex;
+    return VK_TRUE;
+}
+
+void vkMakeResidentResource(
+    VkResidencyManager                          residencyManager,
+    VkResidentResource                          residentResource,
+    VkDeviceSize                                size) {
+    auto pImpl = reinterpret_cast<VkResidencyManagerImpl*>(residencyManager);
+    auto pResource = reinterpret_cast<VkResidentResourceImpl*>(residentResource);
+    if (pResource->resident) {
+        pImpl->residentResources.erase(pResource->iter);
+    }
+    pResource->size = size;
+    vkInsertResidentResource(pImpl, pResource);
+}
+
+VkResult vkUpdateResidency(
+    VkResidencyManager                          residencyManager,
+    uint64_t                                    evictableFrameIndex,
+    VkResidencyUpdateFlags                      flags) {
+    auto pImpl = reinterpret_cast<VkResidencyManagerImpl*>(residencyManager);
+
+    // ================================================================================
+    // 1. 힙 사용량 계산
+    // ================================================================================
+    VkMemoryAllocatorBudget budget;
+    vkGetMemoryAllocatorBudget(pImpl->memoryAllocator, &budget);
+
+    VkMemoryAllocatorStatistics statistics;
+    vkGetMemoryAllocatorStatistics(pImpl->memoryAllocator, &statistics);
+
+    // 할당자의 VkDeviceMemory 안에 남은 빈 영역은 새 할당에 재사용되므로 사용량에서 뺀다.
+    VkDeviceSize heapUsage[VK_MAX_MEMORY_HEAPS];
+    for (uint32_t i = 0; i != budget.heapCount; ++i) {
+        heapUsage[i] = budget.heapUsage[i] - (statistics.heapDeviceMemoryBytes[i] - statistics.heapAllocationBytes[i]);
+    }
+
+    const auto trim = (flags & VK_RESIDENCY_UPDATE_TRIM_BIT) != 0;
+    const auto overBudget = [&](uint32_t heapIndex) {
+        return heapUsage[heapIndex] > static_cast<VkDeviceSize>(budget.heapBudget[heapIndex] * pImpl->budgetRatio);
+    };
+
+    // ================================================================================
+    // 2. 리소스 축출
+    // ================================================================================
+    // 축출한 리소스의 크기만큼 사용량이 줄었다고 보고 예산을 다시 질의하지 않는다.
+    auto &residentResources = pImpl->residentResources;
+    auto iter = residentResources.begin();
+    while (iter != residentResources.end()) {
+        auto pResource = *iter;
+        if (pResource->lastUsedFrameIndex > evictableFrameIndex || !(trim || overBudget(pResource->heapIndex))) {
+            ++iter;
+            continue;
+        }
+
+        iter = residentResources.erase(iter);
+        pResource->resident = false;
+        heapUsage[pResource->heapIndex] -= min(pResource->size, heapUsage[pResource->heapIndex]);
+        pResource->pfnEvict(pResource->pUserData);
+    }
+
+    for (uint32_t i = 0; i != budget.heapCount; ++i) {
+        if (!trim && overBudget(i)) {
+            return VK_INCOMPLETE;
+        }
+    }
+    return VK_SUCCESS;
+}
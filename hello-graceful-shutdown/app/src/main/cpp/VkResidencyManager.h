@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKRESIDENCYMANAGER_H
+#define PRACTICE_VULKAN_VKRESIDENCYMANAGER_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkMemoryAllocator.h"
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkResidencyManager)
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkResidentResource)
+
+// vkUpdateResidency 안에서 호출되며 리소스의 메모리를 해제한다.
+// 다시 필요해지면 호출한 쪽이 다시 불러오고 vkMakeResidentResource를 호출한다.
+typedef void (VKAPI_PTR *PFN_vkEvictResourceFunction)(
+    void*                                       pUserData);
+
+typedef enum VkResidencyUpdateFlagBits {
+    // 예산과 상관없이 축출할 수 있는 리소스를 모두 축출한다.
+    // 앱이 백그라운드에 있거나 시스템 메모리가 부족할 때 사용한다.
+    VK_RESIDENCY_UPDATE_TRIM_BIT = 0x00000001
+} VkResidencyUpdateFlagBits;
+typedef VkFlags VkResidencyUpdateFlags;
+
+typedef struct VkResidencyManagerCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // 힙 예산과 사용량은 이 할당자로 얻는다.
+    VkMemoryAllocator                memoryAllocator;
+    // 힙 사용량이 예산의 이 비율을 넘으면 축출해서 다른 할당이 예산을 넘지 않도록 여유를 남긴다.
+    float                            budgetRatio;
+} VkResidencyManagerCreateInfo;
+
+typedef struct VkResidentResourceCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    uint32_t                         heapIndex;
+    VkDeviceSize                     size;
+    PFN_vkEvictResourceFunction      pfnEvict;
+    void*                            pUserData;
+} VkResidentResourceCreateInfo;
+
+// 모든 함수는 외부에서 동기화해야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateResidencyManager(
+    VkDevice                                    device,
+    const VkResidencyManagerCreateInfo*         pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkResidencyManager*                         pResidencyManager);
+
+// 생성된 모든 VkResidentResource를 먼저 파괴해야 한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyResidencyManager(
+    VkDevice                                    device,
+    VkResidencyManager                          residencyManager,
+    const VkAllocationCallbacks*                pAllocator);
+
+// 이미 메모리를 가진 리소스를 등록하며 가장 최근에 사용한 리소스가 된다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateResidentResource(
+    VkResidencyManager                          residencyManager,
+    const VkResidentResourceCreateInfo*         pCreateInfo,
+    VkResidentResource*                         pResidentResource);
+
+// pfnEvict를 호출하지 않으므로 리소스의 메모리는 호출한 쪽이 해제한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyResidentResource(
+    VkResidencyManager                          residencyManager,
+    VkResidentResource                          residentResource);
+
+// frameIndex에서 사용한다고 기록하며 축출되었으면 VK_FALSE를 반환한다.
+VKAPI_ATTR VkBool32 VKAPI_CALL vkTouchResidentResource(
+    VkResidencyManager                          residencyManager,
+    VkResidentResource                          residentResource,
+    uint64_t                                    frameIndex);
+
+// 축출된 리소스를 다시 불러온 후 호출하며 크기는 바뀔 수 있다.
+VKAPI_ATTR void VKAPI_CALL vkMakeResidentResource(
+    VkResidencyManager                          residencyManager,
+    VkResidentResource                          residentResource,
+    VkDeviceSize                                size);
+
+// 힙 사용량이 예산을 넘으면 마지막으로 사용한 프레임이 evictableFrameIndex 이하인 리소스를
+// 오래 전에 사용한 순서대로 축출한다. GPU가 사용 중일 수 있는 리소스는 축출하지 않도록
+// evictableFrameIndex는 GPU 작업이 끝난 프레임이어야 한다.
+// 축출할 수 있는 리소스를 모두 축출해도 예산을 넘으면 VK_INCOMPLETE를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkUpdateResidency(
+    VkResidencyManager                          residencyManager,
+    uint64_t                                    evictableFrameIndex,
+    VkResidencyUpdateFlags                      flags);
+
+#endif //PRACTICE_VULKAN_VKRESIDENCYMANAGER_H
@@ -0,0 +1,168 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "VkRingBuffer.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+struct VkRingBufferImpl {
+    VkBuffer buffer;
+    VkMemoryAllocator memoryAllocator;
+    VkMemoryAllocation memoryAllocation;
+    uint8_t *pMappedData;
+    VkDeviceSize alignment;
+    VkDeviceSize frameSize;
+    uint32_t frameCount;
+    VkDeviceSize frameBegin;
+    atomic<VkDeviceSize> frameOffset;
+};
+
+}
+
+VkResult vkCreateRingBuffer(
+    VkDevice                                    device,
+    const VkRingBufferCreateInfo*               pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkRingBuffer*                               pRingBuffer) {
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(pCreateInfo->physicalDevice, &physicalDeviceProperties);
+    const auto &limits = physicalDeviceProperties.limits;
+
+    VkDeviceSize alignment = 1;
+    if (pCreateInfo->usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+        alignment = max(alignment, limits.minUniformBufferOffsetAlignment);
+    }
+    if (pCreateInfo->usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+        alignment = max(alignment, limits.minStorageBufferOffsetAlignment);
+    }
+
+    auto pImpl = make_unique<VkRingBufferImpl>();
+    pImpl->memoryAllocator = pCreateInfo->memoryAllocator;
+    pImpl->alignment = alignment;
+    pImpl->frameSize = vkAlignUp(pCreateInfo->frameSize, alignment);
+    pImpl->frameCount = pCreateInfo->frameCount;
+    pImpl->frameBegin = 0;
+    pImpl->frameOffset = 0;
+
+    const VkBufferCreateInfo bufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = pImpl->frameSize * pImpl->frameCount,
+        .usage = pCreateInfo->usage
+    };
+
+    auto result = vkCreateBuffer(device, &bufferCreateInfo, nullptr, &pImpl->buffer);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(device, pImpl->buffer, &memoryRequirements);
+
+    const VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = memoryRequirements,
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
+
+    result = vkCreateMemoryAllocation(pImpl->memoryAllocator,
+                                      &memoryAllocationCreateInfo,
+                                      &pImpl->memoryAllocation);
+    if (result != VK_SUCCESS) {
+        vkDestroyBuffer(device, pImpl->buffer, nullptr);
+        return result;
+    }
+
+    VkMemoryAllocationProperties memoryAllocationProperties;
+    vkGetMemoryAllocationProperties(pImpl->memoryAllocation, &memoryAllocationProperties);
+    pImpl->pMappedData = static_cast<uint8_t *>(memoryAllocationProperties.pMappedData);
+
+    result = vkBindBufferMemory(device,
+                                pImpl->buffer,
+                                memoryAllocationProperties.memory,
+                                memoryAllocationProperties.offset);
+    if (result != VK_SUCCESS) {
+        vkDestroyBuffer(device, pImpl->buffer, nullptr);
+        vkDestroyMemoryAllocation(pImpl->memoryAllocator, pImpl->memoryAllocation);
+        return result;
+    }
+
+    *pRingBuffer = reinterpret_cast<VkRingBuffer>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyRingBuffer(
+    VkDevice                                    device,
+    VkRingBuffer                                ringBuffer,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkRingBufferImpl*>(ringBuffer);
+    vkDestroyBuffer(device, pImpl->buffer, nullptr);
+    vkDestroyMemoryAllocation(pImpl->memoryAllocator, pImpl->memoryAllocation);
+    delete pImpl;
+}
+
+void vkGetRingBufferProperties(
+    VkRingBuffer                                ringBuffer,
+    VkRingBufferProperties*                     pRingBufferProperties) {
+    auto pImpl = reinterpret_cast<VkRingBufferImpl*>(ringBuffer);
+    *pRingBufferProperties = {
+        .buffer = pImpl->buffer,
+        .size = pImpl->frameSize * pImpl->frameCount,
+        .alignment = pImpl->alignment,
+        .pMappedData = pImpl->pMappedData
+    };
+}
+
+void vkBeginRingBufferFrame(
+    VkRingBuffer                                ringBuffer,
+    uint32_t                                    frameIndex) {
+    auto pImpl = reinterpret_cast<VkRingBufferImpl*>(ringBuffer);
+    pImpl->frameBegin = (frameIndex % pImpl->frameCount) * pImpl->frameSize;
+    pImpl->frameOffset = 0;
+}
+
+VkResult vkAllocateRingBuffer(
+    VkRingBuffer                                ringBuffer,
+    VkDeviceSize                                size,
+    VkDeviceSize*                               pOffset,
+    void**                                      ppData) {
+    auto pImpl = reinterpret_cast<VkRingBufferImpl*>(ringBuffer);
+
+    // 크기를 정렬 단위로 올려서 할당하면 다음 오프셋도 항상 정렬되므로 잠금 없이 할당할 수 있다.
+    const auto alignedSize = vkAlignUp(size, pImpl->alignment);
+    const auto frameOffset = pImpl->frameOffset.fetch_add(alignedSize);
+    if (frameOffset + alignedSize > pImpl->frameSize) {
+        return VK_ERROR_OUT_OF_POOL_MEMORY;
+    }
+
+    *pOffset = pImpl->frameBegin + frameOffset;
+    *ppData = pImpl->pMappedData + *pOffset;
+    return VK_SUCCESS;
+}
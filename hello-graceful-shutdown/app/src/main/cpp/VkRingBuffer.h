@@ -0,0 +1,82 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKRINGBUFFER_H
+#define PRACTICE_VULKAN_VKRINGBUFFER_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkMemoryAllocator.h"
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkRingBuffer)
+
+typedef struct VkRingBufferCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    VkPhysicalDevice                 physicalDevice;
+    VkMemoryAllocator                memoryAllocator;
+    VkBufferUsageFlags               usage;
+    // 프레임마다 사용할 수 있는 크기이며 전체 크기는 frameSize * frameCount가 된다.
+    VkDeviceSize                     frameSize;
+    uint32_t                         frameCount;
+} VkRingBufferCreateInfo;
+
+typedef struct VkRingBufferProperties {
+    VkBuffer                         buffer;
+    VkDeviceSize                     size;
+    // 사용처에 따라 minUniformBufferOffsetAlignment 또는 minStorageBufferOffsetAlignment.
+    VkDeviceSize                     alignment;
+    void*                            pMappedData;
+} VkRingBufferProperties;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateRingBuffer(
+    VkDevice                                    device,
+    const VkRingBufferCreateInfo*               pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkRingBuffer*                               pRingBuffer);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyRingBuffer(
+    VkDevice                                    device,
+    VkRingBuffer                                ringBuffer,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR void VKAPI_CALL vkGetRingBufferProperties(
+    VkRingBuffer                                ringBuffer,
+    VkRingBufferProperties*                     pRingBufferProperties);
+
+// frameIndex에 해당하는 영역을 처음부터 다시 사용한다.
+// 호출하기 전에 이 영역을 사용한 이전 프레임의 GPU 작업이 끝나야 한다.
+VKAPI_ATTR void VKAPI_CALL vkBeginRingBufferFrame(
+    VkRingBuffer                                ringBuffer,
+    uint32_t                                    frameIndex);
+
+// 현재 프레임 영역에서 size 만큼 할당하며 여러 스레드에서 동시에 호출할 수 있다.
+// 영역이 부족하면 VK_ERROR_OUT_OF_POOL_MEMORY를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateRingBuffer(
+    VkRingBuffer                                ringBuffer,
+    VkDeviceSize                                size,
+    VkDeviceSize*                               pOffset,
+    void**                                      ppData);
+
+#endif //PRACTICE_VULKAN_VKRINGBUFFER_H
@@ -0,0 +1,157 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <vulkan/vulkan.h>
+
+#include "VkDeviceTest.h"
+#include "VkRingBuffer.h"
+
+class VkRingBufferTest : public VkDeviceTest {
+protected:
+    VkRingBufferTest() : VkDeviceTest(kBlockSize) {
+    }
+
+    void SetUp() override {
+        VkDeviceTest::SetUp();
+        if (HasFatalFailure()) {
+            return;
+        }
+
+        VkRingBufferCreateInfo ringBufferCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_RING_BUFFER_CREATE_INFO,
+            .physicalDevice = mPhysicalDevice,
+            .memoryAllocator = mMemoryAllocator,
+            .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            .frameSize = kFrameSize,
+            .frameCount = kFrameCount
+        };
+
+        ASSERT_EQ(vkCreateRingBuffer(mDevice, &ringBufferCreateInfo, nullptr, &mRingBuffer), VK_SUCCESS);
+        vkGetRingBufferProperties(mRingBuffer, &mProperties);
+    }
+
+    void TearDown() override {
+        if (mRingBuffer) {
+            vkDestroyRingBuffer(mDevice, mRingBuffer, nullptr);
+        }
+        VkDeviceTest::TearDown();
+    }
+
+    VkDeviceSize allocate(VkDeviceSize size) {
+        VkDeviceSize offset = VK_WHOLE_SIZE;
+        void *pData = nullptr;
+        EXPECT_EQ(vkAllocateRingBuffer(mRingBuffer, size, &offset, &pData), VK_SUCCESS);
+        EXPECT_EQ(pData, static_cast<uint8_t *>(mProperties.pMappedData) + offset);
+        return offset;
+    }
+
+    static constexpr VkDeviceSize kBlockSize = 1024 * 1024;
+    static constexpr VkDeviceSize kFrameSize = 4096;
+    static constexpr uint32_t kFrameCount = 3;
+
+    VkRingBuffer mRingBuffer = VK_NULL_HANDLE;
+    VkRingBufferProperties mProperties{};
+};
+
+TEST_F(VkRingBufferTest, allocate) {
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(mPhysicalDevice, &physicalDeviceProperties);
+    EXPECT_EQ(mProperties.alignment, physicalDeviceProperties.limits.minUniformBufferOffsetAlignment);
+    EXPECT_GE(mProperties.size, kFrameSize * kFrameCount);
+    EXPECT_NE(mProperties.pMappedData, nullptr);
+
+    vkBeginRingBufferFrame(mRingBuffer, 0);
+    const auto first = allocate(1);
+    const auto second = allocate(1);
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(second, mProperties.alignment);
+}
+
+TEST_F(VkRingBufferTest, outOfPoolMemory) {
+    const auto frameSize = mProperties.size / kFrameCount;
+
+    vkBeginRingBufferFrame(mRingBuffer, 1);
+    allocate(frameSize);
+
+    // 프레임 영역을 넘으면 다음 프레임 영역을 침범하지 않고 실패해야 한다.
+    VkDeviceSize offset;
+    void *pData;
+    EXPECT_EQ(vkAllocateRingBuffer(mRingBuffer, 1, &offset, &pData), VK_ERROR_OUT_OF_POOL_MEMORY);
+}
+
+TEST_F(VkRingBufferTest, beginFrame) {
+    const auto frameSize = mProperties.size / kFrameCount;
+
+    // 프레임을 시작하면 그 프레임 영역의 처음부터 다시 할당한다.
+    for (uint32_t frameIndex = 0; frameIndex != kFrameCount; ++frameIndex) {
+        vkBeginRingBufferFrame(mRingBuffer, frameIndex);
+        EXPECT_EQ(allocate(100), frameIndex * frameSize);
+        EXPECT_EQ(allocate(100), frameIndex * frameSize + mProperties.alignment);
+
+        vkBeginRingBufferFrame(mRingBuffer, frameIndex);
+        EXPECT_EQ(allocate(100), frameIndex * frameSize);
+    }
+}
+
+TEST_F(VkRingBufferTest, wrapAround) {
+    const auto frameSize = mProperties.size / kFrameCount;
+
+    // 프레임 인덱스가 frameCount를 넘으면 처음 영역으로 돌아간다.
+    for (uint32_t frameIndex = 0; frameIndex != kFrameCount * 2 + 1; ++frameIndex) {
+        vkBeginRingBufferFrame(mRingBuffer, frameIndex);
+        EXPECT_EQ(allocate(frameSize), (frameIndex % kFrameCount) * frameSize);
+    }
+}
+
+TEST_F(VkRingBufferTest, concurrentAllocate) {
+    constexpr uint32_t kThreadCount = 4;
+    const auto allocationCount = mProperties.size / kFrameCount / mProperties.alignment / kThreadCount;
+
+    vkBeginRingBufferFrame(mRingBuffer, 0);
+
+    // 여러 스레드에서 동시에 할당해도 같은 오프셋을 두번 반환하면 안된다.
+    std::vector<std::vector<VkDeviceSize>> offsets(kThreadCount);
+    std::vector<std::thread> threads;
+    for (auto &threadOffsets: offsets) {
+        threads.emplace_back([&, pOffsets = &threadOffsets]() {
+            for (auto i = 0; i != allocationCount; ++i) {
+                pOffsets->push_back(allocate(1));
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    std::vector<bool> allocated(allocationCount * kThreadCount);
+    for (const auto &threadOffsets: offsets) {
+        for (auto offset: threadOffsets) {
+            const auto index = offset / mProperties.alignment;
+            ASSERT_LT(index, allocated.size());
+            EXPECT_FALSE(allocated[index]);
+            allocated[index] = true;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKSHADERS_H
+#define PRACTICE_VULKAN_VKSHADERS_H
+
+#include <cstdint>
+#include <string_view>
+
+// 각 .inc 파일은 빌드 시간에 shaders 디렉토리의 GLSL 소스로부터 생성된다.
+// VK_PRECOMPILED_SHADERS가 정의되면 SPIR-V 바이너리를, 아니면 GLSL 소스를 담고 있다.
+#ifdef VK_PRECOMPILED_SHADERS
+#define VK_SHADER_CODE(name) constexpr uint32_t name[] =
+#else
+#define VK_SHADER_CODE(name) constexpr std::string_view name =
+#endif
+
+VK_SHADER_CODE(kTriangleVertexShaderCode)
+#include "triangle.vert.inc"
+;
+
+VK_SHADER_CODE(kTriangleFragmentShaderCode)
+#include "triangle.frag.inc"
+;
+
+VK_SHADER_CODE(kTriangleBindlessFragmentShaderCode)
+#include "triangle_bindless.frag.inc"
+;
+
+VK_SHADER_CODE(kAnimateComputeShaderCode)
+#include "animate.comp.inc"
+;
+
+#undef VK_SHADER_CODE
+
+#endif //PRACTICE_VULKAN_VKSHADERS_H
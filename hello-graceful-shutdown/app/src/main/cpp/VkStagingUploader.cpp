@@ -0,0 +1,440 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "VkStagingUploader.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+// VkImage 복사의 bufferOffset은 4와 텍셀(블록) 크기의 배수여야 하므로 모든 포맷을 만족하도록 정렬한다.
+constexpr VkDeviceSize kStagingAlignment = 16;
+
+struct VkStagingBatch {
+    VkCommandBuffer commandBuffer;
+    // 이 제출이 끝나면 완료되는 VkTimeline 값이다.
+    uint64_t value;
+    // 이 제출이 끝나면 스테이징 영역의 시작을 여기로 옮긴다.
+    VkDeviceSize arenaEnd;
+};
+
+struct VkStagingUploaderImpl {
+    VkDevice device;
+    VkQueue queue;
+    VkTimeline timeline;
+    VkMemoryAllocator memoryAllocator;
+    VkBuffer buffer;
+    VkMemoryAllocation memoryAllocation;
+    uint8_t *pMappedData;
+    VkDeviceSize arenaSize;
+    // 사용 중인 영역은 head부터 tail까지이며 끝에 닿으면 처음으로 돌아간다.
+    VkDeviceSize head;
+    VkDeviceSize tail;
+    VkCommandPool commandPool;
+    // commandBuffer가 VK_NULL_HANDLE이면 기록 중인 복사가 없다.
+    VkStagingBatch recordingBatch;
+    // 같은 큐에 제출된 순서대로 끝나므로 앞에서부터 회수한다.
+    deque<VkStagingBatch> pendingBatches;
+    vector<VkStagingBatch> freeBatches;
+};
+
+VkResult vkBeginStagingBatch(VkStagingUploaderImpl *pImpl) {
+    if (pImpl->recordingBatch.commandBuffer) {
+        return VK_SUCCESS;
+    }
+
+    VkStagingBatch batch{};
+    if (!pImpl->freeBatches.empty()) {
+        batch = pImpl->freeBatches.back();
+        pImpl->freeBatches.pop_back();
+    } else {
+        const VkCommandBufferAllocateInfo commandBufferAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = pImpl->commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1
+        };
+
+        auto result = vkAllocateCommandBuffers(pImpl->device, &commandBufferAllocateInfo, &batch.commandBuffer);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+    }
+
+    const VkCommandBufferBeginInfo commandBufferBeginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    auto result = vkBeginCommandBuffer(batch.commandBuffer, &commandBufferBeginInfo);
+    if (result != VK_SUCCESS) {
+        pImpl->freeBatches.push_back(batch);
+        return result;
+    }
+
+    pImpl->recordingBatch = batch;
+    return VK_SUCCESS;
+}
+
+VkResult vkSubmitStagingBatch(VkStagingUploaderImpl *pImpl) {
+    auto &batch = pImpl->recordingBatch;
+    if (!batch.commandBuffer) {
+        return VK_SUCCESS;
+    }
+
+    // 같은 큐에 나중에 제출되는 모든 명령이 복사 결과를 읽거나 덮어쓸 수 있게 한다.
+    const VkMemoryBarrier memoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT
+    };
+
+    vkCmdPipelineBarrier(batch.commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0,
+                         1,
+                         &memoryBarrier,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr);
+
+    auto result = vkEndCommandBuffer(batch.commandBuffer);
+    if (result == VK_SUCCESS) {
+        const VkSubmitInfo submitInfo{
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &batch.commandBuffer
+        };
+
+        result = vkQueueSubmitTimeline(pImpl->timeline, pImpl->queue, 1, &submitInfo, &batch.value);
+    }
+
+    if (result != VK_SUCCESS) {
+        pImpl->freeBatches.push_back(batch);
+    } else {
+        batch.arenaEnd = pImpl->tail;
+        pImpl->pendingBatches.push_back(batch);
+    }
+
+    batch = {};
+    return result;
+}
+
+// 완료된 제출의 스테이징 영역을 회수하며 wait가 참이면 가장 오래된 제출이 끝날 때까지 기다린다.
+VkResult vkReclaimStagingBatches(VkStagingUploaderImpl *pImpl, bool wait) {
+    if (wait && !pImpl->pendingBatches.empty()) {
+        auto result = vkWaitTimeline(pImpl->timeline, pImpl->pendingBatches.front().value, UINT64_MAX);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+    }
+
+    uint64_t completedValue;
+    auto result = vkGetTimelineCompletedValue(pImpl->timeline, &completedValue);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    while (!pImpl->pendingBatches.empty() && pImpl->pendingBatches.front().value <= completedValue) {
+        pImpl->head = pImpl->pendingBatches.front().arenaEnd;
+        pImpl->freeBatches.push_back(pImpl->pendingBatches.front());
+        pImpl->pendingBatches.pop_front();
+    }
+
+    // 사용 중인 영역이 없으면 처음부터 사용해서 끝에 남는 공간이 생기지 않게 한다.
+    if (pImpl->pendingBatches.empty() && !pImpl->recordingBatch.commandBuffer) {
+        pImpl->head = 0;
+        pImpl->tail = 0;
+    }
+
+    return VK_SUCCESS;
+}
+
+// head와 tail이 같으면 비어 있는 것이므로 사용 중인 영역이 돌아서 head에 닿지 않게 한다.
+bool vkFindStagingSpace(const VkStagingUploaderImpl *pImpl, VkDeviceSize size, VkDeviceSize *pOffset) {
+    const auto offset = vkAlignUp(pImpl->tail, kStagingAlignment);
+    if (pImpl->tail >= pImpl->head) {
+        if (offset + size <= pImpl->arenaSize) {
+            *pOffset = offset;
+            return true;
+        }
+
+        if (size < pImpl->head) {
+            *pOffset = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    if (offset + size < pImpl->head) {
+        *pOffset = offset;
+        return true;
+    }
+
+    return false;
+}
+
+VkResult vkAllocateStagingSpace(VkStagingUploaderImpl *pImpl, VkDeviceSize size, VkDeviceSize *pOffset) {
+    if (size > pImpl->arenaSize) {
+        return VK_ERROR_OUT_OF_POOL_MEMORY;
+    }
+
+    auto result = vkReclaimStagingBatches(pImpl, false);
+    while (result == VK_SUCCESS && !vkFindStagingSpace(pImpl, size, pOffset)) {
+        // 기록 중인 복사가 영역을 차지하고 있다면 제출해야 회수할 수 있다.
+        result = vkSubmitStagingBatch(pImpl);
+        if (result == VK_SUCCESS) {
+            result = vkReclaimStagingBatches(pImpl, true);
+        }
+    }
+
+    if (result == VK_SUCCESS) {
+        result = vkBeginStagingBatch(pImpl);
+    }
+
+    if (result == VK_SUCCESS) {
+        pImpl->tail = *pOffset + size;
+    }
+
+    return result;
+}
+
+}
+
+VkResult vkCreateStagingUploader(
+    VkDevice                                    device,
+    const VkStagingUploaderCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkStagingUploader*                          pStagingUploader) {
+    auto pImpl = make_unique<VkStagingUploaderImpl>();
+    pImpl->device = device;
+    pImpl->queue = pCreateInfo->queue;
+    pImpl->timeline = pCreateInfo->timeline;
+    pImpl->memoryAllocator = pCreateInfo->memoryAllocator;
+    pImpl->arenaSize = pCreateInfo->arenaSize;
+    pImpl->head = 0;
+    pImpl->tail = 0;
+    pImpl->recordingBatch = {};
+
+    const VkBufferCreateInfo bufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = pImpl->arenaSize,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+    };
+
+    auto result = vkCreateBuffer(device, &bufferCreateInfo, nullptr, &pImpl->buffer);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    VkMemoryRequirements memoryRequirements;
+    vkGetBufferMemoryRequirements(device, pImpl->buffer, &memoryRequirements);
+
+    const VkMemoryAllocationCreateInfo memoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = memoryRequirements,
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
+
+    result = vkCreateMemoryAllocation(pImpl->memoryAllocator,
+                                      &memoryAllocationCreateInfo,
+                                      &pImpl->memoryAllocation);
+    if (result != VK_SUCCESS) {
+        vkDestroyBuffer(device, pImpl->buffer, nullptr);
+        return result;
+    }
+
+    VkMemoryAllocationProperties memoryAllocationProperties;
+    vkGetMemoryAllocationProperties(pImpl->memoryAllocation, &memoryAllocationProperties);
+    pImpl->pMappedData = static_cast<uint8_t *>(memoryAllocationProperties.pMappedData);
+
+    result = vkBindBufferMemory(device,
+                                pImpl->buffer,
+                                memoryAllocationProperties.memory,
+                                memoryAllocationProperties.offset);
+    if (result != VK_SUCCESS) {
+        vkDestroyBuffer(device, pImpl->buffer, nullptr);
+        vkDestroyMemoryAllocation(pImpl->memoryAllocator, pImpl->memoryAllocation);
+        return result;
+    }
+
+    const VkCommandPoolCreateInfo commandPoolCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = pCreateInfo->queueFamilyIndex
+    };
+
+    result = vkCreateCommandPool(device, &commandPoolCreateInfo, nullptr, &pImpl->commandPool);
+    if (result != VK_SUCCESS) {
+        vkDestroyBuffer(device, pImpl->buffer, nullptr);
+        vkDestroyMemoryAllocation(pImpl->memoryAllocator, pImpl->memoryAllocation);
+        return result;
+    }
+
+    *pStagingUploader = reinterpret_cast<VkStagingUploader>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyStagingUploader(
+    VkDevice                                    device,
+    VkStagingUploader                           stagingUploader,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkStagingUploaderImpl*>(stagingUploader);
+
+    // 제출되지 않은 복사는 버린다.
+    if (pImpl->recordingBatch.commandBuffer) {
+        pImpl->freeBatches.push_back(pImpl->recordingBatch);
+    }
+
+    // 같은 큐에 제출되었으므로 마지막 제출만 기다린다.
+    if (!pImpl->pendingBatches.empty()) {
+        VK_CHECK_ERROR(vkWaitTimeline(pImpl->timeline, pImpl->pendingBatches.back().value, UINT64_MAX));
+    }
+
+    // VkCommandBuffer는 VkCommandPool과 함께 해제된다.
+    vkDestroyCommandPool(device, pImpl->commandPool, nullptr);
+    vkDestroyBuffer(device, pImpl->buffer, nullptr);
+    vkDestroyMemoryAllocation(pImpl->memoryAllocator, pImpl->memoryAllocation);
+    delete pImpl;
+}
+
+VkResult vkUploadBuffer(
+    VkStagingUploader                           stagingUploader,
+    VkBuffer                                    dstBuffer,
+    VkDeviceSize                                dstOffset,
+    VkDeviceSize                                size,
+    const void*                                 pData) {
+    auto pImpl = reinterpret_cast<VkStagingUploaderImpl*>(stagingUploader);
+    auto pSrcData = static_cast<const uint8_t *>(pData);
+
+    // 스테이징 영역보다 큰 데이터는 나눠서 복사한다.
+    while (size) {
+        const auto copySize = min(size, pImpl->arenaSize);
+
+        VkDeviceSize offset;
+        if (auto result = vkAllocateStagingSpace(pImpl, copySize, &offset); result != VK_SUCCESS) {
+            return result;
+        }
+
+        memcpy(pImpl->pMappedData + offset, pSrcData, copySize);
+
+        const VkBufferCopy bufferCopy{
+            .srcOffset = offset,
+            .dstOffset = dstOffset,
+            .size = copySize
+        };
+
+        vkCmdCopyBuffer(pImpl->recordingBatch.commandBuffer, pImpl->buffer, dstBuffer, 1, &bufferCopy);
+
+        pSrcData += copySize;
+        dstOffset += copySize;
+        size -= copySize;
+    }
+
+    return VK_SUCCESS;
+}
+
+VkResult vkUploadImage(
+    VkStagingUploader                           stagingUploader,
+    const VkStagingImageUploadInfo*             pUploadInfo) {
+    auto pImpl = reinterpret_cast<VkStagingUploaderImpl*>(stagingUploader);
+
+    VkDeviceSize offset;
+    if (auto result = vkAllocateStagingSpace(pImpl, pUploadInfo->dataSize, &offset); result != VK_SUCCESS) {
+        return result;
+    }
+
+    memcpy(pImpl->pMappedData + offset, pUploadInfo->pData, pUploadInfo->dataSize);
+
+    auto commandBuffer = pImpl->recordingBatch.commandBuffer;
+
+    VkImageMemoryBarrier imageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_NONE,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = pUploadInfo->image,
+        .subresourceRange = pUploadInfo->subresourceRange
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+
+    vector<VkBufferImageCopy> bufferImageCopies(pUploadInfo->pRegions,
+                                                pUploadInfo->pRegions + pUploadInfo->regionCount);
+    for (auto &bufferImageCopy: bufferImageCopies) {
+        bufferImageCopy.bufferOffset += offset;
+    }
+
+    vkCmdCopyBufferToImage(commandBuffer,
+                           pImpl->buffer,
+                           pUploadInfo->image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           bufferImageCopies.size(),
+                           bufferImageCopies.data());
+
+    imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    imageMemoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+    imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imageMemoryBarrier.newLayout = pUploadInfo->finalLayout;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+
+    return VK_SUCCESS;
+}
+
+VkResult vkFlushStagingUploader(
+    VkStagingUploader                           stagingUploader) {
+    return vkSubmitStagingBatch(reinterpret_cast<VkStagingUploaderImpl*>(stagingUploader));
+}
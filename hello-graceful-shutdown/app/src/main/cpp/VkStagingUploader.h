@@ -0,0 +1,90 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKSTAGINGUPLOADER_H
+#define PRACTICE_VULKAN_VKSTAGINGUPLOADER_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkMemoryAllocator.h"
+#include "VkTimeline.h"
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkStagingUploader)
+
+typedef struct VkStagingUploaderCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    VkMemoryAllocator                memoryAllocator;
+    uint32_t                         queueFamilyIndex;
+    VkQueue                          queue;
+    // queue에 제출하는 VkTimeline으로 복사가 끝난 값이 지나면 스테이징 영역을 다시 사용한다.
+    VkTimeline                       timeline;
+    // 계속 맵핑되어 있는 스테이징 영역의 크기로 VkBuffer 업로드는 이보다 커도 나눠서 복사하지만
+    // VkImage 업로드는 이보다 작아야 한다.
+    VkDeviceSize                     arenaSize;
+} VkStagingUploaderCreateInfo;
+
+typedef struct VkStagingImageUploadInfo {
+    VkImage                          image;
+    VkImageSubresourceRange          subresourceRange;
+    // 복사한 후에 변환할 레이아웃으로 복사 전의 내용은 버려진다.
+    VkImageLayout                    finalLayout;
+    // bufferOffset은 pData 기준이다.
+    uint32_t                         regionCount;
+    const VkBufferImageCopy*         pRegions;
+    VkDeviceSize                     dataSize;
+    const void*                      pData;
+} VkStagingImageUploadInfo;
+
+// 모든 함수는 외부에서 동기화해야 하며 큐를 사용하므로 같은 큐에 제출하는 스레드에서 호출해야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateStagingUploader(
+    VkDevice                                    device,
+    const VkStagingUploaderCreateInfo*          pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkStagingUploader*                          pStagingUploader);
+
+// 제출된 업로드가 끝날 때까지 기다린 후 파괴한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyStagingUploader(
+    VkDevice                                    device,
+    VkStagingUploader                           stagingUploader,
+    const VkAllocationCallbacks*                pAllocator);
+
+// 데이터를 스테이징 영역에 쓰고 복사 명령을 기록한다. 영역이 부족하면 완료된 제출의 영역을 회수하고,
+// 그래도 부족하면 기록된 복사를 제출한 후 가장 오래된 제출이 끝날 때까지 기다린다.
+VKAPI_ATTR VkResult VKAPI_CALL vkUploadBuffer(
+    VkStagingUploader                           stagingUploader,
+    VkBuffer                                    dstBuffer,
+    VkDeviceSize                                dstOffset,
+    VkDeviceSize                                size,
+    const void*                                 pData);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkUploadImage(
+    VkStagingUploader                           stagingUploader,
+    const VkStagingImageUploadInfo*             pUploadInfo);
+
+// 지금까지 기록된 복사를 한번에 제출한다. 같은 큐에 나중에 제출된 명령은 기다리지 않고 결과를 사용할 수 있다.
+VKAPI_ATTR VkResult VKAPI_CALL vkFlushStagingUploader(
+    VkStagingUploader                           stagingUploader);
+
+#endif //PRACTICE_VULKAN_VKSTAGINGUPLOADER_H
@@ -0,0 +1,434 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "VkStateCache.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+// 생성 정보의 필드를 순서대로 펼친 값으로 해시가 같아도 키 전체를 비교해서 충돌을 구분한다.
+using VkStateKey = vector<uint64_t>;
+
+struct VkStateEntry {
+    VkStateKey key;
+    uint64_t hash;
+    VkObjectType objectType;
+    uint64_t object;
+    atomic<uint32_t> refCount;
+    // 이 오브젝트를 만들 때 사용한 캐시의 오브젝트로 먼저 파괴되지 않도록 참조를 유지한다.
+    vector<VkStateEntry *> dependencies;
+    // 버킷에 발행된 후에는 vkTrimStateCache 외에는 바뀌지 않으므로 락 없이 따라갈 수 있다.
+    VkStateEntry *pNextByKey;
+    VkStateEntry *pNextByObject;
+};
+
+struct VkStateCacheImpl {
+    VkDevice device;
+    uint32_t bucketMask;
+    // 새 항목은 버킷의 앞에 추가되고 release로 발행되므로 acquire로 읽으면 항목의 내용이 보인다.
+    unique_ptr<atomic<VkStateEntry *>[]> keyBuckets;
+    unique_ptr<atomic<VkStateEntry *>[]> objectBuckets;
+    // 오브젝트를 만드는 스레드끼리만 동기화되며 찾는 스레드는 잡지 않는다.
+    mutex lock;
+};
+
+// 다른 오브젝트를 참조하는 타입부터 파괴해야 하므로 참조하는 순서로 나열한다.
+constexpr array<VkObjectType, 3> kStateObjectTypes{
+    VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+    VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+    VK_OBJECT_TYPE_SAMPLER
+};
+
+inline uint64_t vkFloatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template<typename T>
+uint64_t vkHandleBits(T handle) {
+    return reinterpret_cast<uint64_t>(handle);
+}
+
+inline uint64_t vkObjectHash(uint64_t object) {
+    return vkHash(&object, sizeof(object));
+}
+
+VkStateEntry *vkFindStateEntry(VkStateEntry *pEntry, uint64_t hash, const VkStateKey &key) {
+    for (; pEntry; pEntry = pEntry->pNextByKey) {
+        if (pEntry->hash == hash && pEntry->key == key) {
+            return pEntry;
+        }
+    }
+    return nullptr;
+}
+
+VkStateEntry *vkFindStateEntry(VkStateCacheImpl *pImpl, VkObjectType objectType, uint64_t object) {
+    auto &bucket = pImpl->objectBuckets[vkObjectHash(object) & pImpl->bucketMask];
+    for (auto pEntry = bucket.load(memory_order_acquire); pEntry; pEntry = pEntry->pNextByObject) {
+        if (pEntry->objectType == objectType && pEntry->object == object) {
+            return pEntry;
+        }
+    }
+    return nullptr;
+}
+
+void vkDestroyStateEntry(VkStateCacheImpl *pImpl, VkStateEntry *pEntry) {
+    const auto device = pImpl->device;
+    switch (pEntry->objectType) {
+        case VK_OBJECT_TYPE_SAMPLER:
+            vkDestroySampler(device, reinterpret_cast<VkSampler>(pEntry->object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT:
+            vkDestroyDescriptorSetLayout(device, reinterpret_cast<VkDescriptorSetLayout>(pEntry->object), nullptr);
+            break;
+        case VK_OBJECT_TYPE_PIPELINE_LAYOUT:
+            vkDestroyPipelineLayout(device, reinterpret_cast<VkPipelineLayout>(pEntry->object), nullptr);
+            break;
+        default:
+            assert(false);
+            break;
+    }
+
+    for (auto pDependency : pEntry->dependencies) {
+        pDependency->refCount.fetch_sub(1, memory_order_relaxed);
+    }
+    delete pEntry;
+}
+
+// objectType의 항목 중에서 trim이면 참조 개수가 0인 항목만, 아니면 모두 파괴한다.
+void vkDestroyStateEntries(VkStateCacheImpl *pImpl, VkObjectType objectType, bool trim) {
+    for (uint32_t i = 0; i <= pImpl->bucketMask; ++i) {
+        auto pEntry = pImpl->keyBuckets[i].load(memory_order_relaxed);
+        VkStateEntry *pHead = nullptr;
+        VkStateEntry **ppNext = &pHead;
+        while (pEntry) {
+            auto pNext = pEntry->pNextByKey;
+            if (pEntry->objectType == objectType &&
+                (!trim || !pEntry->refCount.load(memory_order_relaxed))) {
+                vkDestroyStateEntry(pImpl, pEntry);
+            } else {
+                *ppNext = pEntry;
+                ppNext = &pEntry->pNextByKey;
+            }
+            pEntry = pNext;
+        }
+        *ppNext = nullptr;
+        pImpl->keyBuckets[i].store(pHead, memory_order_relaxed);
+    }
+}
+
+// 남은 항목으로 오브젝트 버킷을 다시 연결한다.
+void vkRelinkObjectBuckets(VkStateCacheImpl *pImpl) {
+    for (uint32_t i = 0; i <= pImpl->bucketMask; ++i) {
+        pImpl->objectBuckets[i].store(nullptr, memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i <= pImpl->bucketMask; ++i) {
+        for (auto pEntry = pImpl->keyBuckets[i].load(memory_order_relaxed); pEntry; pEntry = pEntry->pNextByKey) {
+            auto &bucket = pImpl->objectBuckets[vkObjectHash(pEntry->object) & pImpl->bucketMask];
+            pEntry->pNextByObject = bucket.load(memory_order_relaxed);
+            bucket.store(pEntry, memory_order_relaxed);
+        }
+    }
+}
+
+// create는 락을 잡은 상태에서 호출되며 오브젝트를 만들고 dependencies를 채운다.
+template<typename Create>
+VkResult vkAcquireStateObject(VkStateCacheImpl *pImpl,
+                              VkObjectType objectType,
+                              VkStateKey key,
+                              Create create,
+                              uint64_t *pObject) {
+    key.push_back(objectType);
+    const auto hash = vkHash(key.data(), key.size() * sizeof(uint64_t));
+    auto &keyBucket = pImpl->keyBuckets[hash & pImpl->bucketMask];
+
+    // ================================================================================
+    // 1. 락 없이 찾기
+    // ================================================================================
+    // 항목은 vkTrimStateCache 전까지 파괴되지 않으므로 찾은 후에 참조 개수를 늘려도 된다.
+    if (auto pEntry = vkFindStateEntry(keyBucket.load(memory_order_acquire), hash, key)) {
+        pEntry->refCount.fetch_add(1, memory_order_relaxed);
+        *pObject = pEntry->object;
+        return VK_SUCCESS;
+    }
+
+    // ================================================================================
+    // 2. 락을 잡고 다시 찾기
+    // ================================================================================
+    // 다른 스레드가 먼저 같은 오브젝트를 만들었을 수 있다.
+    lock_guard<mutex> guard(pImpl->lock);
+    auto pHead = keyBucket.load(memory_order_relaxed);
+    if (auto pEntry = vkFindStateEntry(pHead, hash, key)) {
+        pEntry->refCount.fetch_add(1, memory_order_relaxed);
+        *pObject = pEntry->object;
+        return VK_SUCCESS;
+    }
+
+    // ================================================================================
+    // 3. 오브젝트 생성 및 발행
+    // ================================================================================
+    auto pEntry = make_unique<VkStateEntry>();
+    const auto result = create(&pEntry->object, &pEntry->dependencies);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    for (auto pDependency : pEntry->dependencies) {
+        pDependency->refCount.fetch_add(1, memory_order_relaxed);
+    }
+
+    pEntry->key = std::move(key);
+    pEntry->hash = hash;
+    pEntry->objectType = objectType;
+    pEntry->refCount.store(1, memory_order_relaxed);
+    pEntry->pNextByKey = pHead;
+
+    auto &objectBucket = pImpl->objectBuckets[vkObjectHash(pEntry->object) & pImpl->bucketMask];
+    pEntry->pNextByObject = objectBucket.load(memory_order_relaxed);
+
+    *pObject = pEntry->object;
+    objectBucket.store(pEntry.get(), memory_order_release);
+    keyBucket.store(pEntry.release(), memory_order_release);
+    return VK_SUCCESS;
+}
+
+}
+
+VkResult vkCreateStateCache(
+    VkDevice                                    device,
+    const VkStateCacheCreateInfo*               pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkStateCache*                               pStateCache) {
+    uint32_t bucketCount = 1;
+    while (bucketCount < (pCreateInfo->bucketCount ? pCreateInfo->bucketCount : 256)) {
+        bucketCount <<= 1;
+    }
+
+    auto pImpl = make_unique<VkStateCacheImpl>();
+    pImpl->device = device;
+    pImpl->bucketMask = bucketCount - 1;
+    pImpl->keyBuckets = make_unique<atomic<VkStateEntry *>[]>(bucketCount);
+    pImpl->objectBuckets = make_unique<atomic<VkStateEntry *>[]>(bucketCount);
+    for (uint32_t i = 0; i != bucketCount; ++i) {
+        pImpl->keyBuckets[i].store(nullptr, memory_order_relaxed);
+        pImpl->objectBuckets[i].store(nullptr, memory_order_relaxed);
+    }
+
+    *pStateCache = reinterpret_cast<VkStateCache>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyStateCache(
+    VkDevice                                    device,
+    VkStateCache                                stateCache,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkStateCacheImpl*>(stateCache);
+    for (auto objectType : kStateObjectTypes) {
+        vkDestroyStateEntries(pImpl, objectType, false);
+    }
+    delete pImpl;
+}
+
+VkResult vkAcquireSampler(
+    VkStateCache                                stateCache,
+    const VkSamplerCreateInfo*                  pCreateInfo,
+    VkSampler*                                  pSampler) {
+    auto pImpl = reinterpret_cast<VkStateCacheImpl*>(stateCache);
+    if (pCreateInfo->pNext) {
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    VkStateKey key{
+        pCreateInfo->flags,
+        static_cast<uint64_t>(pCreateInfo->magFilter),
+        static_cast<uint64_t>(pCreateInfo->minFilter),
+        static_cast<uint64_t>(pCreateInfo->mipmapMode),
+        static_cast<uint64_t>(pCreateInfo->addressModeU),
+        static_cast<uint64_t>(pCreateInfo->addressModeV),
+        static_cast<uint64_t>(pCreateInfo->addressModeW),
+        vkFloatBits(pCreateInfo->mipLodBias),
+        pCreateInfo->anisotropyEnable,
+        vkFloatBits(pCreateInfo->maxAnisotropy),
+        pCreateInfo->compareEnable,
+        static_cast<uint64_t>(pCreateInfo->compareOp),
+        vkFloatBits(pCreateInfo->minLod),
+        vkFloatBits(pCreateInfo->maxLod),
+        static_cast<uint64_t>(pCreateInfo->borderColor),
+        pCreateInfo->unnormalizedCoordinates
+    };
+
+    uint64_t object;
+    const auto result = vkAcquireStateObject(
+            pImpl,
+            VK_OBJECT_TYPE_SAMPLER,
+            std::move(key),
+            [pImpl, pCreateInfo](uint64_t *pObject, vector<VkStateEntry *> *pDependencies) {
+                VkSampler sampler;
+                const auto result = vkCreateSampler(pImpl->device, pCreateInfo, nullptr, &sampler);
+                *pObject = vkHandleBits(sampler);
+                return result;
+            },
+            &object);
+    *pSampler = reinterpret_cast<VkSampler>(object);
+    return result;
+}
+
+VkResult vkAcquireDescriptorSetLayout(
+    VkStateCache                                stateCache,
+    const VkDescriptorSetLayoutCreateInfo*      pCreateInfo,
+    VkDescriptorSetLayout*                      pDescriptorSetLayout) {
+    auto pImpl = reinterpret_cast<VkStateCacheImpl*>(stateCache);
+
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo *pBindingFlagsCreateInfo = nullptr;
+    for (auto pStructure = static_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo *>(pCreateInfo->pNext);
+         pStructure;
+         pStructure = static_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo *>(pStructure->pNext)) {
+        if (pStructure->sType != VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO) {
+            return VK_ERROR_FEATURE_NOT_PRESENT;
+        }
+        pBindingFlagsCreateInfo = pStructure;
+    }
+
+    // 불변 VkSampler는 핸들로 비교하므로 캐시에서 얻은 VkSampler를 사용하면 더 많이 공유된다.
+    VkStateKey key{pCreateInfo->flags, pCreateInfo->bindingCount};
+    vector<VkSampler> immutableSamplers;
+    for (uint32_t i = 0; i != pCreateInfo->bindingCount; ++i) {
+        const auto &binding = pCreateInfo->pBindings[i];
+        const auto immutableSamplerCount = binding.pImmutableSamplers ? binding.descriptorCount : 0;
+        key.insert(key.end(), {
+            binding.binding,
+            static_cast<uint64_t>(binding.descriptorType),
+            binding.descriptorCount,
+            binding.stageFlags,
+            immutableSamplerCount
+        });
+        for (uint32_t j = 0; j != immutableSamplerCount; ++j) {
+            key.push_back(vkHandleBits(binding.pImmutableSamplers[j]));
+            immutableSamplers.push_back(binding.pImmutableSamplers[j]);
+        }
+    }
+
+    key.push_back(pBindingFlagsCreateInfo ? pBindingFlagsCreateInfo->bindingCount : 0);
+    for (uint32_t i = 0; pBindingFlagsCreateInfo && i != pBindingFlagsCreateInfo->bindingCount; ++i) {
+        key.push_back(pBindingFlagsCreateInfo->pBindingFlags[i]);
+    }
+
+    uint64_t object;
+    const auto result = vkAcquireStateObject(
+            pImpl,
+            VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+            std::move(key),
+            [pImpl, pCreateInfo, &immutableSamplers](uint64_t *pObject, vector<VkStateEntry *> *pDependencies) {
+                VkDescriptorSetLayout descriptorSetLayout;
+                const auto result = vkCreateDescriptorSetLayout(pImpl->device,
+                                                                pCreateInfo,
+                                                                nullptr,
+                                                                &descriptorSetLayout);
+                *pObject = vkHandleBits(descriptorSetLayout);
+                for (auto sampler : immutableSamplers) {
+                    if (auto pEntry = vkFindStateEntry(pImpl, VK_OBJECT_TYPE_SAMPLER, vkHandleBits(sampler))) {
+                        pDependencies->push_back(pEntry);
+                    }
+                }
+                return result;
+            },
+            &object);
+    *pDescriptorSetLayout = reinterpret_cast<VkDescriptorSetLayout>(object);
+    return result;
+}
+
+VkResult vkAcquirePipelineLayout(
+    VkStateCache                                stateCache,
+    const VkPipelineLayoutCreateInfo*           pCreateInfo,
+    VkPipelineLayout*                           pPipelineLayout) {
+    auto pImpl = reinterpret_cast<VkStateCacheImpl*>(stateCache);
+    if (pCreateInfo->pNext) {
+        return VK_ERROR_FEATURE_NOT_PRESENT;
+    }
+
+    VkStateKey key{pCreateInfo->flags, pCreateInfo->setLayoutCount};
+    for (uint32_t i = 0; i != pCreateInfo->setLayoutCount; ++i) {
+        key.push_back(vkHandleBits(pCreateInfo->pSetLayouts[i]));
+    }
+
+    key.push_back(pCreateInfo->pushConstantRangeCount);
+    for (uint32_t i = 0; i != pCreateInfo->pushConstantRangeCount; ++i) {
+        const auto &pushConstantRange = pCreateInfo->pPushConstantRanges[i];
+        key.insert(key.end(), {
+            pushConstantRange.stageFlags,
+            pushConstantRange.offset,
+            pushConstantRange.size
+        });
+    }
+
+    uint64_t object;
+    const auto result = vkAcquireStateObject(
+            pImpl,
+            VK_OBJECT_TYPE_PIPELINE_LAYOUT,
+            std::move(key),
+            [pImpl, pCreateInfo](uint64_t *pObject, vector<VkStateEntry *> *pDependencies) {
+                VkPipelineLayout pipelineLayout;
+                const auto result = vkCreatePipelineLayout(pImpl->device, pCreateInfo, nullptr, &pipelineLayout);
+                *pObject = vkHandleBits(pipelineLayout);
+                for (uint32_t i = 0; i != pCreateInfo->setLayoutCount; ++i) {
+                    if (auto pEntry = vkFindStateEntry(pImpl,
+                                                       VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                                                       vkHandleBits(pCreateInfo->pSetLayouts[i]))) {
+                        pDependencies->push_back(pEntry);
+                    }
+                }
+                return result;
+            },
+            &object);
+    *pPipelineLayout = reinterpret_cast<VkPipelineLayout>(object);
+    return result;
+}
+
+void vkReleaseStateObject(
+    VkStateCache                                stateCache,
+    VkObjectType                                objectType,
+    uint64_t                                    object) {
+    auto pImpl = reinterpret_cast<VkStateCacheImpl*>(stateCache);
+    auto pEntry = vkFindStateEntry(pImpl, objectType, object);
+    assert(pEntry && pEntry->refCount.load(memory_order_relaxed));
+    pEntry->refCount.fetch_sub(1, memory_order_relaxed);
+}
+
+void vkTrimStateCache(
+    VkStateCache                                stateCache) {
+    auto pImpl = reinterpret_cast<VkStateCacheImpl*>(stateCache);
+    for (auto objectType : kStateObjectTypes) {
+        vkDestroyStateEntries(pImpl, objectType, true);
+    }
+    vkRelinkObjectBuckets(pImpl);
+}
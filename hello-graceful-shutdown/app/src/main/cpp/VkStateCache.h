@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKSTATECACHE_H
+#define PRACTICE_VULKAN_VKSTATECACHE_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkStateCache)
+
+typedef struct VkStateCacheCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // 해시 테이블의 버킷 개수로 2의 거듭제곱으로 올림하며 0이면 256개를 사용한다.
+    // 테이블은 커지지 않으므로 캐시할 오브젝트 개수보다 크게 잡는다.
+    uint32_t                         bucketCount;
+} VkStateCacheCreateInfo;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateStateCache(
+    VkDevice                                    device,
+    const VkStateCacheCreateInfo*               pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkStateCache*                               pStateCache);
+
+// 해제하지 않은 오브젝트까지 모두 파괴하므로 GPU가 사용을 끝낸 후에 호출해야 한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyStateCache(
+    VkDevice                                    device,
+    VkStateCache                                stateCache,
+    const VkAllocationCallbacks*                pAllocator);
+
+// 생성 정보의 내용을 해시해서 같은 내용으로 만든 오브젝트가 있으면 참조 개수를 늘려서 반환하고
+// 없으면 새로 만든다. 찾는 경로는 락을 잡지 않으므로 여러 스레드에서 동시에 호출할 수 있고
+// 새로 만들 때만 락을 잡는다. pNext는 VkDescriptorSetLayoutBindingFlagsCreateInfo만 지원하며
+// 다른 구조체가 연결되어 있으면 VK_ERROR_FEATURE_NOT_PRESENT를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkAcquireSampler(
+    VkStateCache                                stateCache,
+    const VkSamplerCreateInfo*                  pCreateInfo,
+    VkSampler*                                  pSampler);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAcquireDescriptorSetLayout(
+    VkStateCache                                stateCache,
+    const VkDescriptorSetLayoutCreateInfo*      pCreateInfo,
+    VkDescriptorSetLayout*                      pDescriptorSetLayout);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAcquirePipelineLayout(
+    VkStateCache                                stateCache,
+    const VkPipelineLayoutCreateInfo*           pCreateInfo,
+    VkPipelineLayout*                           pPipelineLayout);
+
+// 참조 개수를 줄이며 0이 되어도 다시 사용할 수 있도록 vkTrimStateCache까지 파괴하지 않는다.
+// 지원하는 objectType은 SAMPLER, DESCRIPTOR_SET_LAYOUT과 PIPELINE_LAYOUT이다.
+VKAPI_ATTR void VKAPI_CALL vkReleaseStateObject(
+    VkStateCache                                stateCache,
+    VkObjectType                                objectType,
+    uint64_t                                    object);
+
+// 참조 개수가 0인 오브젝트를 파괴한다. 찾는 경로가 락을 잡지 않으므로 다른 함수와 동시에
+// 호출하면 안되며 GPU가 사용을 끝낸 후에 호출해야 한다.
+VKAPI_ATTR void VKAPI_CALL vkTrimStateCache(
+    VkStateCache                                stateCache);
+
+#endif //PRACTICE_VULKAN_VKSTATECACHE_H
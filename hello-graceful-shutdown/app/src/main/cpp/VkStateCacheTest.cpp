@@ -0,0 +1,170 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <vulkan/vulkan.h>
+
+#include "VkDeviceTest.h"
+#include "VkStateCache.h"
+
+class VkStateCacheTest : public VkDeviceTest {
+protected:
+    VkStateCacheTest() : VkDeviceTest(kBlockSize) {
+    }
+
+    void SetUp() override {
+        VkDeviceTest::SetUp();
+        if (HasFatalFailure()) {
+            return;
+        }
+
+        VkStateCacheCreateInfo stateCacheCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_STATE_CACHE_CREATE_INFO
+        };
+
+        ASSERT_EQ(vkCreateStateCache(mDevice, &stateCacheCreateInfo, nullptr, &mStateCache), VK_SUCCESS);
+    }
+
+    void TearDown() override {
+        if (mStateCache) {
+            vkDestroyStateCache(mDevice, mStateCache, nullptr);
+        }
+        VkDeviceTest::TearDown();
+    }
+
+    VkSampler acquireSampler(VkFilter filter) {
+        VkSamplerCreateInfo samplerCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .magFilter = filter,
+            .minFilter = filter,
+            .maxLod = VK_LOD_CLAMP_NONE
+        };
+
+        VkSampler sampler = VK_NULL_HANDLE;
+        EXPECT_EQ(vkAcquireSampler(mStateCache, &samplerCreateInfo, &sampler), VK_SUCCESS);
+        return sampler;
+    }
+
+    VkDescriptorSetLayout acquireDescriptorSetLayout(VkSampler immutableSampler) {
+        VkDescriptorSetLayoutBinding descriptorSetLayoutBinding{
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .pImmutableSamplers = &immutableSampler
+        };
+
+        VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = 1,
+            .pBindings = &descriptorSetLayoutBinding
+        };
+
+        VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+        EXPECT_EQ(vkAcquireDescriptorSetLayout(mStateCache, &descriptorSetLayoutCreateInfo, &descriptorSetLayout),
+                  VK_SUCCESS);
+        return descriptorSetLayout;
+    }
+
+    void releaseSampler(VkSampler sampler) {
+        vkReleaseStateObject(mStateCache, VK_OBJECT_TYPE_SAMPLER, reinterpret_cast<uint64_t>(sampler));
+    }
+
+    void releaseDescriptorSetLayout(VkDescriptorSetLayout descriptorSetLayout) {
+        vkReleaseStateObject(mStateCache,
+                             VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT,
+                             reinterpret_cast<uint64_t>(descriptorSetLayout));
+    }
+
+    static constexpr VkDeviceSize kBlockSize = 1024 * 1024;
+
+    VkStateCache mStateCache = VK_NULL_HANDLE;
+};
+
+TEST_F(VkStateCacheTest, acquire) {
+    const auto sampler = acquireSampler(VK_FILTER_LINEAR);
+    EXPECT_NE(sampler, VK_NULL_HANDLE);
+
+    // 같은 생성 정보는 같은 오브젝트를, 다른 생성 정보는 다른 오브젝트를 반환한다.
+    EXPECT_EQ(acquireSampler(VK_FILTER_LINEAR), sampler);
+    const auto otherSampler = acquireSampler(VK_FILTER_NEAREST);
+    EXPECT_NE(otherSampler, sampler);
+
+    releaseSampler(sampler);
+    releaseSampler(sampler);
+    releaseSampler(otherSampler);
+}
+
+TEST_F(VkStateCacheTest, trimWithActiveReaders) {
+    constexpr uint32_t kThreadCount = 4;
+
+    // 여러 스레드가 동시에 얻어도 같은 오브젝트를 공유해야 한다.
+    std::vector<VkSampler> samplers(kThreadCount);
+    std::vector<std::thread> threads;
+    for (auto &sampler: samplers) {
+        threads.emplace_back([&, pSampler = &sampler]() {
+            *pSampler = acquireSampler(VK_FILTER_LINEAR);
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (auto sampler: samplers) {
+        EXPECT_EQ(sampler, samplers[0]);
+    }
+
+    // 참조하는 스레드가 남아 있으면 파괴하지 않고 마지막 참조가 해제될 때까지 다시 사용한다.
+    for (uint32_t i = 1; i != kThreadCount; ++i) {
+        releaseSampler(samplers[i]);
+    }
+    vkTrimStateCache(mStateCache);
+    EXPECT_EQ(acquireSampler(VK_FILTER_LINEAR), samplers[0]);
+
+    releaseSampler(samplers[0]);
+    releaseSampler(samplers[0]);
+    vkTrimStateCache(mStateCache);
+
+    // 파괴된 후에도 다시 얻을 수 있어야 한다.
+    const auto sampler = acquireSampler(VK_FILTER_LINEAR);
+    EXPECT_NE(sampler, VK_NULL_HANDLE);
+    releaseSampler(sampler);
+}
+
+TEST_F(VkStateCacheTest, trimKeepsDependencies) {
+    const auto sampler = acquireSampler(VK_FILTER_LINEAR);
+    const auto descriptorSetLayout = acquireDescriptorSetLayout(sampler);
+
+    // 불변 VkSampler는 VkDescriptorSetLayout이 참조하므로 해제해도 파괴되지 않는다.
+    releaseSampler(sampler);
+    vkTrimStateCache(mStateCache);
+    EXPECT_EQ(acquireSampler(VK_FILTER_LINEAR), sampler);
+    EXPECT_EQ(acquireDescriptorSetLayout(sampler), descriptorSetLayout);
+
+    releaseDescriptorSetLayout(descriptorSetLayout);
+    releaseDescriptorSetLayout(descriptorSetLayout);
+    releaseSampler(sampler);
+
+    // 참조하는 오브젝트부터 파괴하므로 한번에 모두 파괴된다.
+    vkTrimStateCache(mStateCache);
+}
@@ -20,63 +20,472 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
 #include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
 #include <stb_image.h>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 #include "VkTexture.h"
 
 using namespace std;
 
-VkResult vkCreateTexture(
-    VkDevice                                    device,
-    const VkTextureCreateInfo*                  pCreateInfo,
-    const VkAllocationCallbacks*                pAllocator,
-    VkTexture*                                  pTexture) {
+namespace {
+
+constexpr uint8_t kKtx2Identifier[12]{
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+struct VkKtx2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t layerCount;
+    uint32_t faceCount;
+    uint32_t levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset;
+    uint32_t dfdByteLength;
+    uint32_t kvdByteOffset;
+    uint32_t kvdByteLength;
+    uint64_t sgdByteOffset;
+    uint64_t sgdByteLength;
+};
+static_assert(sizeof(VkKtx2Header) == 80);
+
+struct VkKtx2Level {
+    uint64_t byteOffset;
+    uint64_t byteLength;
+    uint64_t uncompressedByteLength;
+};
+
+struct VkAssetMapping {
+    // APK에 압축되어 있는 에셋은 AAsset_getBuffer로 읽으며 AAsset이 닫히기 전까지 유효하다.
+    AAsset *pAsset;
+    // 압축되지 않은 에셋은 파일 디스크립터를 mmap해서 복사 없이 읽는다.
+    void *pMapping;
+    size_t mappingSize;
+    const uint8_t *pData;
+    size_t size;
+};
+
+struct VkTextureImpl {
+    VkTextureProperties properties;
+    vector<VkTextureLevel> levels;
+    // KTX2는 에셋 맵핑을 그대로 보관하고 stb로 디코딩한 경우는 pDecodedData를 보관한다.
+    VkAssetMapping assetMapping;
+    stbi_uc *pDecodedData;
+    // 디코딩한 이미지의 채널 개수로 vkWriteTextureData에서 R8G8B8A8로 확장한다.
+    uint32_t component;
+    VkTextureCreateFlags flags;
+};
+
+// 8비트 정규화 값의 곱을 x / 255의 반올림인 (x + 128 + ((x + 128) >> 8)) >> 8로 계산한다.
+inline uint8_t vkMultiplyUnorm8(uint32_t a, uint32_t b) {
+    const auto x = a * b + 128;
+    return static_cast<uint8_t>((x + (x >> 8)) >> 8);
+}
+
+// sRGB 색상에 알파를 곱할 때 사용하는 변환 테이블로 선형 값은 12비트로 양자화한다.
+struct VkSrgbTables {
+    std::array<uint16_t, 256> toLinear;
+    std::array<uint8_t, 4096> toSrgb;
+};
+
+const VkSrgbTables &vkGetSrgbTables() {
+    static const auto tables = [] {
+        VkSrgbTables tables;
+        for (uint32_t i = 0; i != tables.toLinear.size(); ++i) {
+            const auto c = i / 255.0;
+            const auto linear = c <= 0.04045 ? c / 12.92 : pow((c + 0.055) / 1.055, 2.4);
+            tables.toLinear[i] = static_cast<uint16_t>(lround(linear * 4095.0));
+        }
+        for (uint32_t i = 0; i != tables.toSrgb.size(); ++i) {
+            const auto linear = i / 4095.0;
+            const auto c = linear <= 0.0031308 ? linear * 12.92 : 1.055 * pow(linear, 1.0 / 2.4) - 0.055;
+            tables.toSrgb[i] = static_cast<uint8_t>(lround(c * 255.0));
+        }
+        return tables;
+    }();
+    return tables;
+}
+
+#if defined(__ARM_NEON)
+// 16개의 픽셀을 읽어서 채널별 레지스터로 확장한다.
+inline uint8x16x4_t vkLoadRgba(const uint8_t *pSrc, uint32_t component) {
+    uint8x16x4_t rgba;
+    switch (component) {
+        case 1:
+            rgba.val[0] = vld1q_u8(pSrc);
+            rgba.val[1] = rgba.val[0];
+            rgba.val[2] = rgba.val[0];
+            rgba.val[3] = vdupq_n_u8(UINT8_MAX);
+            break;
+        case 2: {
+            const auto ga = vld2q_u8(pSrc);
+            rgba.val[0] = ga.val[0];
+            rgba.val[1] = ga.val[0];
+            rgba.val[2] = ga.val[0];
+            rgba.val[3] = ga.val[1];
+            break;
+        }
+        case 3: {
+            const auto rgb = vld3q_u8(pSrc);
+            rgba.val[0] = rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = rgb.val[2];
+            rgba.val[3] = vdupq_n_u8(UINT8_MAX);
+            break;
+        }
+        default:
+            rgba = vld4q_u8(pSrc);
+            break;
+    }
+    return rgba;
+}
+
+// vkMultiplyUnorm8과 같은 반올림을 vrsraq와 vrshrn으로 계산한다.
+inline uint8x16_t vkMultiplyUnorm8(uint8x16_t a, uint8x16_t b) {
+    const auto low = vmull_u8(vget_low_u8(a), vget_low_u8(b));
+    const auto high = vmull_u8(vget_high_u8(a), vget_high_u8(b));
+    return vcombine_u8(vrshrn_n_u16(vrsraq_n_u16(low, low, 8), 8),
+                       vrshrn_n_u16(vrsraq_n_u16(high, high, 8), 8));
+}
+#endif
+
+// 채널 개수가 component인 픽셀을 R8G8B8A8로 변환하면서 pDst에 한번만 쓴다.
+void vkConvertPixels(const uint8_t *pSrc,
+                     uint32_t component,
+                     VkTextureCreateFlags flags,
+                     size_t pixelCount,
+                     uint8_t *pDst) {
+    // 알파 채널이 없으면 알파가 항상 1이므로 곱하지 않는다.
+    const auto premultiply = (flags & VK_TEXTURE_CREATE_PREMULTIPLIED_ALPHA_BIT) && (component == 2 || component == 4);
+    const auto srgb = (flags & VK_TEXTURE_CREATE_SRGB_BIT) != 0;
+
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    // sRGB 색상의 알파 곱셈은 테이블을 거쳐야 하므로 스칼라로 처리한다.
+    if (!premultiply || !srgb) {
+        for (; i + 16 <= pixelCount; i += 16) {
+            auto rgba = vkLoadRgba(pSrc + i * component, component);
+            if (premultiply) {
+                rgba.val[0] = vkMultiplyUnorm8(rgba.val[0], rgba.val[3]);
+                rgba.val[1] = vkMultiplyUnorm8(rgba.val[1], rgba.val[3]);
+                rgba.val[2] = vkMultiplyUnorm8(rgba.val[2], rgba.val[3]);
+            }
+            vst4q_u8(pDst + i * 4, rgba);
+        }
+    }
+#endif
 
-    auto pAsset = AAssetManager_open(pCreateInfo->pAssetManager,
-                                     pCreateInfo->pFileName,
-                                     AASSET_MODE_BUFFER);
+    const auto &srgbTables = vkGetSrgbTables();
+    for (; i != pixelCount; ++i) {
+        const auto pPixel = pSrc + i * component;
+        uint8_t rgba[4];
+        switch (component) {
+            case 1:
+                rgba[0] = rgba[1] = rgba[2] = pPixel[0];
+                rgba[3] = UINT8_MAX;
+                break;
+            case 2:
+                rgba[0] = rgba[1] = rgba[2] = pPixel[0];
+                rgba[3] = pPixel[1];
+                break;
+            case 3:
+                memcpy(rgba, pPixel, 3);
+                rgba[3] = UINT8_MAX;
+                break;
+            default:
+                memcpy(rgba, pPixel, 4);
+                break;
+        }
+
+        if (premultiply) {
+            for (auto c = 0; c != 3; ++c) {
+                if (srgb) {
+                    const auto linear = srgbTables.toLinear[rgba[c]] * uint32_t{rgba[3]};
+                    rgba[c] = srgbTables.toSrgb[(linear + UINT8_MAX / 2) / UINT8_MAX];
+                } else {
+                    rgba[c] = vkMultiplyUnorm8(rgba[c], rgba[3]);
+                }
+            }
+        }
+
+        memcpy(pDst + i * 4, rgba, 4);
+    }
+}
+
+VkResult vkMapAsset(AAssetManager *pAssetManager, const char *pFileName, VkAssetMapping *pAssetMapping) {
+    auto pAsset = AAssetManager_open(pAssetManager, pFileName, AASSET_MODE_BUFFER);
     if (!pAsset) {
         return VK_ERROR_UNKNOWN;
     }
 
-    auto assetLength = AAsset_getLength(pAsset);
-    vector<uint8_t> asset(assetLength);
-    AAsset_read(pAsset, asset.data(), assetLength);
-    AAsset_close(pAsset);
+    *pAssetMapping = {};
+
+    off64_t start;
+    off64_t length;
+    if (auto fd = AAsset_openFileDescriptor64(pAsset, &start, &length); fd >= 0) {
+        // mmap의 오프셋은 페이지 크기에 맞춰야 한다.
+        const auto pageSize = static_cast<off64_t>(sysconf(_SC_PAGESIZE));
+        const auto mappingStart = start & ~(pageSize - 1);
+        const auto mappingSize = static_cast<size_t>(start + length - mappingStart);
+        auto pMapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, mappingStart);
+        close(fd);
+
+        if (pMapping != MAP_FAILED) {
+            AAsset_close(pAsset);
+            madvise(pMapping, mappingSize, MADV_SEQUENTIAL);
+
+            pAssetMapping->pMapping = pMapping;
+            pAssetMapping->mappingSize = mappingSize;
+            pAssetMapping->pData = static_cast<const uint8_t *>(pMapping) + (start - mappingStart);
+            pAssetMapping->size = static_cast<size_t>(length);
+            return VK_SUCCESS;
+        }
+    }
+
+    auto pBuffer = AAsset_getBuffer(pAsset);
+    if (!pBuffer) {
+        AAsset_close(pAsset);
+        return VK_ERROR_UNKNOWN;
+    }
+
+    pAssetMapping->pAsset = pAsset;
+    pAssetMapping->pData = static_cast<const uint8_t *>(pBuffer);
+    pAssetMapping->size = static_cast<size_t>(AAsset_getLength64(pAsset));
+    return VK_SUCCESS;
+}
+
+void vkUnmapAsset(VkAssetMapping *pAssetMapping) {
+    if (pAssetMapping->pMapping) {
+        munmap(pAssetMapping->pMapping, pAssetMapping->mappingSize);
+    }
+    if (pAssetMapping->pAsset) {
+        AAsset_close(pAssetMapping->pAsset);
+    }
+    *pAssetMapping = {};
+}
+
+bool vkIsKtx2(const VkAssetMapping &assetMapping) {
+    return assetMapping.size >= sizeof(VkKtx2Header) &&
+           !memcmp(assetMapping.pData, kKtx2Identifier, sizeof(kKtx2Identifier));
+}
+
+VkResult vkLoadKtx2(VkPhysicalDevice physicalDevice,
+                    const VkAssetMapping &assetMapping,
+                    VkTextureImpl *pImpl) {
+    VkKtx2Header header;
+    memcpy(&header, assetMapping.pData, sizeof(VkKtx2Header));
+
+    // 슈퍼 압축(BasisLZ, Zstandard)과 배열, 큐브맵, 3D 텍스처는 지원하지 않는다.
+    if (header.supercompressionScheme ||
+        header.layerCount > 1 ||
+        header.faceCount != 1 ||
+        header.pixelDepth > 1) {
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
+
+    const auto format = static_cast<VkFormat>(header.vkFormat);
+    if (format == VK_FORMAT_UNDEFINED) {
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
+
+    if (physicalDevice) {
+        VkFormatProperties formatProperties;
+        vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &formatProperties);
+        if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+    }
+
+    // levelCount가 0이면 런타임에 Mipmap을 생성하라는 의미이므로 레벨 0만 존재한다.
+    const auto levelCount = max(header.levelCount, 1u);
+    if (assetMapping.size < sizeof(VkKtx2Header) + levelCount * sizeof(VkKtx2Level)) {
+        return VK_ERROR_UNKNOWN;
+    }
+
+    vector<VkKtx2Level> ktx2Levels(levelCount);
+    memcpy(ktx2Levels.data(),
+           assetMapping.pData + sizeof(VkKtx2Header),
+           levelCount * sizeof(VkKtx2Level));
+
+    // KTX2는 작은 레벨부터 저장하므로 가장 앞에 있는 레벨을 데이터의 시작으로 사용한다.
+    uint64_t dataBegin = UINT64_MAX;
+    uint64_t dataEnd = 0;
+    for (const auto &ktx2Level : ktx2Levels) {
+        if (ktx2Level.byteOffset + ktx2Level.byteLength > assetMapping.size) {
+            return VK_ERROR_UNKNOWN;
+        }
+        dataBegin = min(dataBegin, ktx2Level.byteOffset);
+        dataEnd = max(dataEnd, ktx2Level.byteOffset + ktx2Level.byteLength);
+    }
 
-    auto pTextureProperties = make_unique<VkTextureProperties>();
+    pImpl->levels.resize(levelCount);
+    for (uint32_t level = 0; level != levelCount; ++level) {
+        pImpl->levels[level] = {
+            .offset = ktx2Levels[level].byteOffset - dataBegin,
+            .size = ktx2Levels[level].byteLength,
+            .extent = {
+                .width = max(header.pixelWidth >> level, 1u),
+                .height = max(header.pixelHeight >> level, 1u),
+                .depth = 1
+            }
+        };
+    }
+
+    // 레벨 데이터는 맵핑된 에셋을 그대로 가리키므로 스테이징 버퍼로 복사할 때까지 복사가 없다.
+    pImpl->assetMapping = assetMapping;
+    pImpl->properties.format = format;
+    pImpl->properties.extent = pImpl->levels[0].extent;
+    pImpl->properties.mipLevels = levelCount;
+    pImpl->properties.dataSize = dataEnd - dataBegin;
+    pImpl->properties.pData = const_cast<uint8_t *>(assetMapping.pData + dataBegin);
+
+    return VK_SUCCESS;
+}
+
+VkResult vkDecodeImage(const VkAssetMapping &assetMapping, VkTextureImpl *pImpl) {
     int width;
     int height;
     int component;
-    pTextureProperties->pData = stbi_load_from_memory(asset.data(),
-                                                      assetLength,
-                                                      &width,
-                                                      &height,
-                                                      &component,
-                                             4);
-    if (!pTextureProperties->pData) {
+    // 원래 채널 개수로 디코딩하고 R8G8B8A8로의 확장은 vkWriteTextureData에서 스테이징에 쓰면서 한다.
+    pImpl->pDecodedData = stbi_load_from_memory(assetMapping.pData,
+                                                static_cast<int>(assetMapping.size),
+                                                &width,
+                                                &height,
+                                                &component,
+                                                0);
+    if (!pImpl->pDecodedData) {
         return VK_ERROR_UNKNOWN;
     }
-    pTextureProperties->format = VK_FORMAT_R8G8B8A8_UNORM;
-    pTextureProperties->extent.width = width;
-    pTextureProperties->extent.height = height;
-    pTextureProperties->extent.depth = 1;
+    pImpl->component = static_cast<uint32_t>(component);
+
+    const VkExtent3D extent{
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+        .depth = 1
+    };
+
+    pImpl->levels = {
+        VkTextureLevel{
+            .offset = 0,
+            .size = extent.width * extent.height * 4,
+            .extent = extent
+        }
+    };
+
+    pImpl->properties.format = (pImpl->flags & VK_TEXTURE_CREATE_SRGB_BIT) ?
+                               VK_FORMAT_R8G8B8A8_SRGB :
+                               VK_FORMAT_R8G8B8A8_UNORM;
+    pImpl->properties.extent = extent;
+    pImpl->properties.mipLevels = 1;
+    pImpl->properties.dataSize = pImpl->levels[0].size;
+    pImpl->properties.pData = nullptr;
 
-    *pTexture = reinterpret_cast<VkTexture>(pTextureProperties.release());
     return VK_SUCCESS;
 }
 
+}
+
+VkResult vkCreateTexture(
+    VkDevice                                    device,
+    const VkTextureCreateInfo*                  pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkTexture*                                  pTexture) {
+    const VkTextureDataInfo *pDataInfo = nullptr;
+    for (auto pStructure = static_cast<const VkTextureDataInfo *>(pCreateInfo->pNext);
+         pStructure;
+         pStructure = static_cast<const VkTextureDataInfo *>(pStructure->pNext)) {
+        if (pStructure->sType == VK_STRUCTURE_TYPE_TEXTURE_DATA_INFO) {
+            pDataInfo = pStructure;
+            break;
+        }
+    }
+
+    auto result = VK_ERROR_UNKNOWN;
+    const auto sourceCount = pDataInfo ? 1 : pCreateInfo->fileNameCount;
+    for (uint32_t i = 0; i != sourceCount; ++i) {
+        VkAssetMapping assetMapping{};
+        if (pDataInfo) {
+            // 에셋을 열지 않았으므로 vkUnmapAsset은 아무것도 해제하지 않는다.
+            assetMapping.pData = static_cast<const uint8_t *>(pDataInfo->pData);
+            assetMapping.size = pDataInfo->dataSize;
+        } else if (vkMapAsset(pCreateInfo->pAssetManager,
+                              pCreateInfo->ppFileNames[i],
+                              &assetMapping) != VK_SUCCESS) {
+            continue;
+        }
+
+        auto pImpl = make_unique<VkTextureImpl>();
+        pImpl->assetMapping = {};
+        pImpl->pDecodedData = nullptr;
+        pImpl->component = 4;
+        pImpl->flags = pCreateInfo->flags;
+
+        const auto isKtx2 = vkIsKtx2(assetMapping);
+        result = isKtx2 ?
+                 vkLoadKtx2(pCreateInfo->physicalDevice, assetMapping, pImpl.get()) :
+                 vkDecodeImage(assetMapping, pImpl.get());
+
+        // 디코딩한 경우에는 원본이 더 이상 필요 없으므로 바로 해제한다.
+        if (result != VK_SUCCESS || !isKtx2) {
+            vkUnmapAsset(&assetMapping);
+        }
+
+        if (result != VK_SUCCESS) {
+            continue;
+        }
+
+        pImpl->properties.pLevels = pImpl->levels.data();
+        *pTexture = reinterpret_cast<VkTexture>(pImpl.release());
+        return VK_SUCCESS;
+    }
+
+    return result;
+}
+
 void vkDestroyTexture(
     VkDevice                                    device,
     VkTexture                                   texture,
     const VkAllocationCallbacks*                pAllocator) {
-    auto pTextureProperties = reinterpret_cast<VkTextureProperties*>(texture);
-    stbi_image_free(pTextureProperties->pData);
-    delete pTextureProperties;
+    auto pImpl = reinterpret_cast<VkTextureImpl*>(texture);
+    if (pImpl->pDecodedData) {
+        stbi_image_free(pImpl->pDecodedData);
+    }
+    vkUnmapAsset(&pImpl->assetMapping);
+    delete pImpl;
 }
 
 void vkGetTextureProperties(
     VkTexture                                   texture,
     VkTextureProperties*                        pTextureProperties) {
-    *pTextureProperties = *reinterpret_cast<VkTextureProperties *>(texture);
+    *pTextureProperties = reinterpret_cast<VkTextureImpl*>(texture)->properties;
+}
+
+void vkWriteTextureData(
+    VkTexture                                   texture,
+    void*                                       pDst) {
+    auto pImpl = reinterpret_cast<VkTextureImpl*>(texture);
+    if (!pImpl->pDecodedData) {
+        memcpy(pDst, pImpl->properties.pData, pImpl->properties.dataSize);
+        return;
+    }
+
+    const auto &extent = pImpl->properties.extent;
+    vkConvertPixels(pImpl->pDecodedData,
+                    pImpl->component,
+                    pImpl->flags,
+                    size_t{extent.width} * extent.height,
+                    static_cast<uint8_t *>(pDst));
 }
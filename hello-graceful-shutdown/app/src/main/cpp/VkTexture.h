@@ -26,23 +26,55 @@
 #include <game-activity/GameActivity.h>
 #include <vulkan/vulkan.h>
 
+#include "VkTypes.h"
+
 VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkTexture)
 
-typedef enum VkStructureTypeEXT {
-    VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO = 2000000000
-} VkStructureTypeEXT;
+// KTX2는 저장된 데이터를 그대로 사용하므로 디코딩하는 이미지에만 적용된다.
+typedef enum VkTextureCreateFlagBits {
+    // 색상에 알파를 미리 곱하며 SRGB_BIT와 함께 사용하면 선형 공간에서 곱한다.
+    VK_TEXTURE_CREATE_PREMULTIPLIED_ALPHA_BIT = 0x00000001,
+    // R8G8B8A8_SRGB 포맷을 사용해서 샘플링할 때 하드웨어가 선형으로 변환하게 한다.
+    VK_TEXTURE_CREATE_SRGB_BIT = 0x00000002
+} VkTextureCreateFlagBits;
+typedef VkFlags VkTextureCreateFlags;
 
 typedef struct VkTextureCreateInfo {
     VkStructureTypeEXT    sType;
     const void*           pNext;
-    VkFlags               flags;
+    VkTextureCreateFlags  flags;
     AAssetManager*        pAssetManager;
-    const char*           pFileName;
+    // KTX2 파일의 VkFormat을 지원하는지 확인할 때 사용하며 VK_NULL_HANDLE이면 확인하지 않는다.
+    VkPhysicalDevice      physicalDevice;
+    // 순서대로 시도해서 처음으로 읽을 수 있는 파일을 사용한다.
+    // KTX2(ASTC, ETC2 등)는 그대로 읽고, 그외의 파일(PNG, JPEG 등)은 R8G8B8A8로 디코딩한다.
+    uint32_t              fileNameCount;
+    const char* const*    ppFileNames;
 } VkTextureCreateInfo;
 
+// VkTextureCreateInfo의 pNext에 연결하면 에셋 대신 메모리에 있는 파일 데이터를 읽으며 ppFileNames는 무시된다.
+// KTX2는 복사하지 않고 그대로 참조하므로 VkTexture가 파괴될 때까지 데이터가 유효해야 한다.
+typedef struct VkTextureDataInfo {
+    VkStructureTypeEXT    sType;
+    const void*           pNext;
+    size_t                dataSize;
+    const void*           pData;
+} VkTextureDataInfo;
+
+typedef struct VkTextureLevel {
+    VkDeviceSize          offset;
+    VkDeviceSize          size;
+    VkExtent3D            extent;
+} VkTextureLevel;
+
 typedef struct VkTextureProperties {
     VkFormat              format;
     VkExtent3D            extent;
+    uint32_t              mipLevels;
+    // 각 레벨의 오프셋은 vkWriteTextureData가 쓰는 데이터 기준이다.
+    const VkTextureLevel* pLevels;
+    VkDeviceSize          dataSize;
+    // KTX2의 레벨 데이터를 가리키며 디코딩한 이미지는 변환 전이므로 nullptr이다.
     void*                 pData;
 } VkTextureProperties;
 
@@ -61,4 +93,10 @@ VKAPI_ATTR void VKAPI_CALL vkGetTextureProperties(
     VkTexture                                   texture,
     VkTextureProperties*                        pTextureProperties);
 
+// 모든 레벨을 dataSize 크기로 pDst에 쓴다. 디코딩한 이미지는 채널 확장과 알파 곱셈을 하면서
+// 한번에 쓰고 pDst를 읽지 않으므로 쓰기 결합 메모리인 스테이징 VkBuffer에 바로 써도 된다.
+VKAPI_ATTR void VKAPI_CALL vkWriteTextureData(
+    VkTexture                                   texture,
+    void*                                       pDst);
+
 #endif //PRACTICE_VULKAN_VKTEXTURE_H
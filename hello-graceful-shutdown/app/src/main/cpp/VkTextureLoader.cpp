@@ -0,0 +1,860 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "VkTextureLoader.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+enum VkTextureLoadState {
+    VK_TEXTURE_LOAD_STATE_QUEUED,
+    VK_TEXTURE_LOAD_STATE_RECORDING,
+    VK_TEXTURE_LOAD_STATE_RECORDED,
+    VK_TEXTURE_LOAD_STATE_SUBMITTED,
+    VK_TEXTURE_LOAD_STATE_COMPLETE,
+    VK_TEXTURE_LOAD_STATE_FAILED
+};
+
+struct VkTextureLoaderImpl;
+
+// 워커 스레드에서 VkTexture를 만들 수 있도록 VkTextureCreateInfo의 파일 이름을 복사해서 보관한다.
+struct VkTextureLoadLayer {
+    vector<string> fileNames;
+    VkTextureCreateFlags flags;
+    // sType이 0이 아니면 pNext로 전달된 데이터를 읽으며 데이터는 복사하지 않는다.
+    VkTextureDataInfo dataInfo;
+};
+
+struct VkTextureLoadImpl {
+    VkTextureLoaderImpl *pLoader;
+    vector<VkTextureLoadLayer> layers;
+    VkImageViewType viewType;
+    VkTextureLoadState state;
+    VkResult result;
+    VkTextureLoadProperties properties;
+    VkMemoryAllocation allocation;
+    bool generateMipmaps;
+    VkBuffer stagingBuffer;
+    VkMemoryAllocation stagingAllocation;
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    VkFence fence;
+};
+
+struct VkTextureLoaderImpl {
+    VkDevice device;
+    VkPhysicalDevice physicalDevice;
+    VkMemoryAllocator memoryAllocator;
+    AAssetManager *pAssetManager;
+    uint32_t queueFamilyIndex;
+    VkQueue queue;
+    uint32_t dstQueueFamilyIndex;
+    mutex lock;
+    // 워커 스레드는 새 불러오기를 기다리고 불러오기를 파괴하는 스레드는 기록이 끝나기를 기다린다.
+    // 하나를 공유하면 notify_one이 깨워야 할 워커 대신 다른 스레드를 깨울 수 있으므로 따로 둔다.
+    condition_variable queueCondition;
+    condition_variable completeCondition;
+    deque<VkTextureLoadImpl *> queuedLoads;
+    vector<VkTextureLoadImpl *> recordedLoads;
+    vector<VkTextureLoadImpl *> submittedLoads;
+    bool quit;
+    vector<thread> threads;
+};
+
+void vkReleaseStagingResources(VkTextureLoaderImpl *pLoader, VkTextureLoadImpl *pLoad) {
+    vkDestroyFence(pLoader->device, pLoad->fence, nullptr);
+    vkDestroyCommandPool(pLoader->device, pLoad->commandPool, nullptr);
+    vkDestroyBuffer(pLoader->device, pLoad->stagingBuffer, nullptr);
+    vkDestroyMemoryAllocation(pLoader->memoryAllocator, pLoad->stagingAllocation);
+    pLoad->fence = VK_NULL_HANDLE;
+    pLoad->commandPool = VK_NULL_HANDLE;
+    pLoad->commandBuffer = VK_NULL_HANDLE;
+    pLoad->stagingBuffer = VK_NULL_HANDLE;
+    pLoad->stagingAllocation = VK_NULL_HANDLE;
+}
+
+void vkDestroyTextures(VkDevice device, const vector<VkTexture> &textures) {
+    for (auto texture : textures) {
+        vkDestroyTexture(device, texture, nullptr);
+    }
+}
+
+VkTextureLoadLayer vkMakeTextureLoadLayer(const VkTextureCreateInfo *pCreateInfo) {
+    VkTextureLoadLayer layer{
+        .flags = pCreateInfo->flags,
+        .dataInfo = {}
+    };
+    for (uint32_t i = 0; i != pCreateInfo->fileNameCount; ++i) {
+        layer.fileNames.emplace_back(pCreateInfo->ppFileNames[i]);
+    }
+    for (auto pStructure = static_cast<const VkTextureDataInfo *>(pCreateInfo->pNext);
+         pStructure;
+         pStructure = static_cast<const VkTextureDataInfo *>(pStructure->pNext)) {
+        if (pStructure->sType == VK_STRUCTURE_TYPE_TEXTURE_DATA_INFO) {
+            layer.dataInfo = *pStructure;
+            layer.dataInfo.pNext = nullptr;
+            break;
+        }
+    }
+    return layer;
+}
+
+void vkQueueTextureLoad(VkTextureLoaderImpl *pLoader, VkTextureLoadImpl *pLoad) {
+    {
+        lock_guard<mutex> guard(pLoader->lock);
+        pLoader->queuedLoads.push_back(pLoad);
+    }
+    pLoader->queueCondition.notify_one();
+}
+
+void vkReleaseImageResources(VkTextureLoaderImpl *pLoader, VkTextureLoadImpl *pLoad) {
+    vkDestroyImageView(pLoader->device, pLoad->properties.imageView, nullptr);
+    vkDestroyImage(pLoader->device, pLoad->properties.image, nullptr);
+    vkDestroyMemoryAllocation(pLoader->memoryAllocator, pLoad->allocation);
+    pLoad->properties.imageView = VK_NULL_HANDLE;
+    pLoad->properties.image = VK_NULL_HANDLE;
+    pLoad->allocation = VK_NULL_HANDLE;
+}
+
+VkResult vkRecordTextureLoad(VkTextureLoaderImpl *pLoader, VkTextureLoadImpl *pLoad) {
+    const auto device = pLoader->device;
+
+    // ================================================================================
+    // 1. VkTexture 생성
+    // ================================================================================
+    // 레이어마다 VkTexture를 만들며 첫번째 레이어의 포맷과 크기를 VkImage에 사용한다.
+    vector<VkTexture> textures;
+    VkResult result = VK_SUCCESS;
+    for (const auto &layer : pLoad->layers) {
+        vector<const char *> fileNames;
+        for (const auto &fileName : layer.fileNames) {
+            fileNames.push_back(fileName.c_str());
+        }
+
+        VkTextureCreateInfo textureCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO,
+            .pNext = layer.dataInfo.sType ? &layer.dataInfo : nullptr,
+            .flags = layer.flags,
+            .pAssetManager = pLoader->pAssetManager,
+            .physicalDevice = pLoader->physicalDevice,
+            .fileNameCount = static_cast<uint32_t>(fileNames.size()),
+            .ppFileNames = fileNames.data()
+        };
+
+        VkTexture texture;
+        result = vkCreateTexture(device, &textureCreateInfo, nullptr, &texture);
+        if (result != VK_SUCCESS) {
+            vkDestroyTextures(device, textures);
+            return result;
+        }
+        textures.push_back(texture);
+    }
+
+    VkTextureProperties textureProperties;
+    vkGetTextureProperties(textures[0], &textureProperties);
+
+    // 레이어는 같은 VkBufferImageCopy 배치로 복사되므로 포맷과 크기가 모두 같아야 한다.
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(pLoader->physicalDevice, &physicalDeviceProperties);
+    if (textures.size() > physicalDeviceProperties.limits.maxImageArrayLayers) {
+        vkDestroyTextures(device, textures);
+        return VK_ERROR_FORMAT_NOT_SUPPORTED;
+    }
+
+    for (auto texture : textures) {
+        VkTextureProperties layerProperties;
+        vkGetTextureProperties(texture, &layerProperties);
+        if (layerProperties.format != textureProperties.format ||
+            layerProperties.extent.width != textureProperties.extent.width ||
+            layerProperties.extent.height != textureProperties.extent.height ||
+            layerProperties.mipLevels != textureProperties.mipLevels ||
+            layerProperties.dataSize != textureProperties.dataSize) {
+            vkDestroyTextures(device, textures);
+            return VK_ERROR_FORMAT_NOT_SUPPORTED;
+        }
+    }
+
+    // ================================================================================
+    // 2. Mipmap 레벨 개수 계산
+    // ================================================================================
+    // 텍스처에 Mipmap이 없으면 Blit으로 생성하며, 이를 위해선 OPTIMAL 타일링에서
+    // Blit과 선형 필터링이 지원되야 한다. 압축 포맷은 Blit을 지원하지 않는다.
+    VkFormatProperties formatProperties;
+    vkGetPhysicalDeviceFormatProperties(pLoader->physicalDevice,
+                                        textureProperties.format,
+                                        &formatProperties);
+
+    constexpr VkFormatFeatureFlags mipmapFormatFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                                                          VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                          VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    pLoad->generateMipmaps =
+            textureProperties.mipLevels == 1 &&
+            (formatProperties.optimalTilingFeatures & mipmapFormatFeatures) == mipmapFormatFeatures;
+
+    auto &properties = pLoad->properties;
+    properties.format = textureProperties.format;
+    properties.extent = textureProperties.extent;
+    properties.mipLevels = pLoad->generateMipmaps ?
+                           vkGetMipLevelCount(textureProperties.extent) :
+                           textureProperties.mipLevels;
+    properties.arrayLayers = static_cast<uint32_t>(textures.size());
+
+    // ================================================================================
+    // 3. VkImage 생성
+    // ================================================================================
+    VkImageCreateInfo imageCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = properties.format,
+        .extent = properties.extent,
+        .mipLevels = properties.mipLevels,
+        .arrayLayers = properties.arrayLayers,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                 VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                 VK_IMAGE_USAGE_SAMPLED_BIT,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+
+    result = vkCreateImage(device, &imageCreateInfo, nullptr, &properties.image);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    // ================================================================================
+    // 4. Image VkMemoryAllocation 생성 및 바인드
+    // ================================================================================
+    VkMemoryRequirements imageMemoryRequirements;
+    vkGetImageMemoryRequirements(device, properties.image, &imageMemoryRequirements);
+
+    // 예산을 넘으면 VK_ERROR_OUT_OF_DEVICE_MEMORY로 실패해서 렌더러가 나중에 다시 불러오게 한다.
+    VkMemoryAllocationCreateInfo imageMemoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .flags = VK_MEMORY_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
+        .type = VK_MEMORY_ALLOCATION_TYPE_IMAGE_OPTIMAL,
+        .memoryRequirements = imageMemoryRequirements,
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    };
+
+    result = vkCreateMemoryAllocation(pLoader->memoryAllocator,
+                                      &imageMemoryAllocationCreateInfo,
+                                      &pLoad->allocation);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    VkMemoryAllocationProperties imageAllocationProperties;
+    vkGetMemoryAllocationProperties(pLoad->allocation, &imageAllocationProperties);
+
+    result = vkBindImageMemory(device,
+                               properties.image,
+                               imageAllocationProperties.memory,
+                               imageAllocationProperties.offset);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    // ================================================================================
+    // 5. VkImageView 생성
+    // ================================================================================
+    VkImageViewCreateInfo imageViewCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = properties.image,
+        .viewType = pLoad->viewType,
+        .format = properties.format,
+        .components = {
+            .r = VK_COMPONENT_SWIZZLE_R,
+            .g = VK_COMPONENT_SWIZZLE_G,
+            .b = VK_COMPONENT_SWIZZLE_B,
+            .a = VK_COMPONENT_SWIZZLE_A,
+        },
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = properties.mipLevels,
+            .baseArrayLayer = 0,
+            .layerCount = properties.arrayLayers
+        }
+    };
+
+    result = vkCreateImageView(device, &imageViewCreateInfo, nullptr, &properties.imageView);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    // ================================================================================
+    // 6. Staging VkBuffer 생성 및 데이터 복사
+    // ================================================================================
+    VkBufferCreateInfo stagingBufferCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = textureProperties.dataSize * properties.arrayLayers,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+    };
+
+    result = vkCreateBuffer(device, &stagingBufferCreateInfo, nullptr, &pLoad->stagingBuffer);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    VkMemoryRequirements stagingMemoryRequirements;
+    vkGetBufferMemoryRequirements(device, pLoad->stagingBuffer, &stagingMemoryRequirements);
+
+    VkMemoryAllocationCreateInfo stagingMemoryAllocationCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO,
+        .type = VK_MEMORY_ALLOCATION_TYPE_BUFFER,
+        .memoryRequirements = stagingMemoryRequirements,
+        .memoryPropertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    };
+
+    result = vkCreateMemoryAllocation(pLoader->memoryAllocator,
+                                      &stagingMemoryAllocationCreateInfo,
+                                      &pLoad->stagingAllocation);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    VkMemoryAllocationProperties stagingAllocationProperties;
+    vkGetMemoryAllocationProperties(pLoad->stagingAllocation, &stagingAllocationProperties);
+
+    result = vkBindBufferMemory(device,
+                                pLoad->stagingBuffer,
+                                stagingAllocationProperties.memory,
+                                stagingAllocationProperties.offset);
+    if (result != VK_SUCCESS) {
+        vkDestroyTextures(device, textures);
+        return result;
+    }
+
+    // 디코딩한 픽셀을 변환하면서 스테이징 VkBuffer에 바로 써서 중간 복사를 없앤다.
+    // 레이어는 dataSize 간격으로 연속해서 배치한다.
+    vector<VkBufferImageCopy> bufferImageCopies;
+    for (uint32_t layer = 0; layer != properties.arrayLayers; ++layer) {
+        const auto layerOffset = textureProperties.dataSize * layer;
+        vkWriteTextureData(textures[layer],
+                           static_cast<uint8_t *>(stagingAllocationProperties.pMappedData) + layerOffset);
+
+        for (uint32_t level = 0; level != textureProperties.mipLevels; ++level) {
+            const auto &textureLevel = textureProperties.pLevels[level];
+            bufferImageCopies.push_back({
+                .bufferOffset = layerOffset + textureLevel.offset,
+                .imageSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = layer,
+                    .layerCount = 1
+                },
+                .imageExtent = textureLevel.extent
+            });
+        }
+    }
+
+    // 스테이징 버퍼로 복사가 끝났으므로 디코딩된 데이터나 에셋 맵핑을 바로 해제한다.
+    vkDestroyTextures(device, textures);
+
+    // ================================================================================
+    // 7. VkCommandPool 생성 및 VkCommandBuffer 할당
+    // ================================================================================
+    // VkCommandPool은 외부 동기화가 필요하므로 업로드마다 따로 생성한다.
+    VkCommandPoolCreateInfo commandPoolCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = pLoader->queueFamilyIndex
+    };
+
+    result = vkCreateCommandPool(device, &commandPoolCreateInfo, nullptr, &pLoad->commandPool);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = pLoad->commandPool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+
+    result = vkAllocateCommandBuffers(device, &commandBufferAllocateInfo, &pLoad->commandBuffer);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    // ================================================================================
+    // 8. VkCommandBuffer 기록
+    // ================================================================================
+    VkCommandBufferBeginInfo commandBufferBeginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    result = vkBeginCommandBuffer(pLoad->commandBuffer, &commandBufferBeginInfo);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    VkImageMemoryBarrier imageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_NONE,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = properties.image,
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = properties.mipLevels,
+            .baseArrayLayer = 0,
+            .layerCount = properties.arrayLayers
+        }
+    };
+
+    vkCmdPipelineBarrier(pLoad->commandBuffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+
+    vkCmdCopyBufferToImage(pLoad->commandBuffer,
+                           pLoad->stagingBuffer,
+                           properties.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           bufferImageCopies.size(),
+                           bufferImageCopies.data());
+
+    // 전송 큐와 그래픽스 큐가 다르면 소유권을 해제한다. 레이아웃은 그대로 두고
+    // Mipmap 생성과 레이아웃 변환은 vkCmdAcquireTextureLoad에서 그래픽스 큐가 수행한다.
+    if (pLoader->queueFamilyIndex != pLoader->dstQueueFamilyIndex) {
+        imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        imageMemoryBarrier.dstAccessMask = VK_ACCESS_NONE;
+        imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        imageMemoryBarrier.srcQueueFamilyIndex = pLoader->queueFamilyIndex;
+        imageMemoryBarrier.dstQueueFamilyIndex = pLoader->dstQueueFamilyIndex;
+
+        vkCmdPipelineBarrier(pLoad->commandBuffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr,
+                             1,
+                             &imageMemoryBarrier);
+    }
+
+    result = vkEndCommandBuffer(pLoad->commandBuffer);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    // ================================================================================
+    // 9. VkFence 생성
+    // ================================================================================
+    VkFenceCreateInfo fenceCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+    };
+
+    return vkCreateFence(device, &fenceCreateInfo, nullptr, &pLoad->fence);
+}
+
+void vkRunTextureLoader(VkTextureLoaderImpl *pLoader) {
+    unique_lock<mutex> guard(pLoader->lock);
+    while (true) {
+        pLoader->queueCondition.wait(guard, [pLoader] {
+            return pLoader->quit || !pLoader->queuedLoads.empty();
+        });
+        if (pLoader->quit) {
+            return;
+        }
+
+        auto pLoad = pLoader->queuedLoads.front();
+        pLoader->queuedLoads.pop_front();
+        pLoad->state = VK_TEXTURE_LOAD_STATE_RECORDING;
+
+        guard.unlock();
+        auto result = vkRecordTextureLoad(pLoader, pLoad);
+        if (result != VK_SUCCESS) {
+            vkReleaseStagingResources(pLoader, pLoad);
+            vkReleaseImageResources(pLoader, pLoad);
+        }
+        guard.lock();
+
+        pLoad->result = result;
+        if (result == VK_SUCCESS) {
+            pLoad->state = VK_TEXTURE_LOAD_STATE_RECORDED;
+            pLoader->recordedLoads.push_back(pLoad);
+        } else {
+            pLoad->state = VK_TEXTURE_LOAD_STATE_FAILED;
+        }
+        pLoader->completeCondition.notify_all();
+    }
+}
+
+}
+
+VkResult vkCreateTextureLoader(
+    VkDevice                                    device,
+    const VkTextureLoaderCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkTextureLoader*                            pTextureLoader) {
+    auto pImpl = make_unique<VkTextureLoaderImpl>();
+    pImpl->device = device;
+    pImpl->physicalDevice = pCreateInfo->physicalDevice;
+    pImpl->memoryAllocator = pCreateInfo->memoryAllocator;
+    pImpl->pAssetManager = pCreateInfo->pAssetManager;
+    pImpl->queueFamilyIndex = pCreateInfo->queueFamilyIndex;
+    pImpl->queue = pCreateInfo->queue;
+    pImpl->dstQueueFamilyIndex = pCreateInfo->dstQueueFamilyIndex;
+    pImpl->quit = false;
+
+    for (uint32_t i = 0; i != max(pCreateInfo->threadCount, 1u); ++i) {
+        pImpl->threads.emplace_back(vkRunTextureLoader, pImpl.get());
+    }
+
+    *pTextureLoader = reinterpret_cast<VkTextureLoader>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyTextureLoader(
+    VkDevice                                    device,
+    VkTextureLoader                             textureLoader,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkTextureLoaderImpl*>(textureLoader);
+    {
+        lock_guard<mutex> guard(pImpl->lock);
+        pImpl->quit = true;
+    }
+    pImpl->queueCondition.notify_all();
+
+    for (auto &thread : pImpl->threads) {
+        thread.join();
+    }
+    delete pImpl;
+}
+
+VkResult vkCreateTextureLoad(
+    VkTextureLoader                             textureLoader,
+    const VkTextureCreateInfo*                  pCreateInfo,
+    VkTextureLoad*                              pTextureLoad) {
+    auto pImpl = reinterpret_cast<VkTextureLoaderImpl*>(textureLoader);
+
+    auto pLoad = new VkTextureLoadImpl{
+        .pLoader = pImpl,
+        .layers = {vkMakeTextureLoadLayer(pCreateInfo)},
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .state = VK_TEXTURE_LOAD_STATE_QUEUED,
+        .result = VK_NOT_READY
+    };
+    vkQueueTextureLoad(pImpl, pLoad);
+
+    *pTextureLoad = reinterpret_cast<VkTextureLoad>(pLoad);
+    return VK_SUCCESS;
+}
+
+VkResult vkCreateTextureArrayLoad(
+    VkTextureLoader                             textureLoader,
+    const VkTextureArrayCreateInfo*             pCreateInfo,
+    VkTextureLoad*                              pTextureLoad) {
+    auto pImpl = reinterpret_cast<VkTextureLoaderImpl*>(textureLoader);
+    if (!pCreateInfo->layerCount) {
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    auto pLoad = new VkTextureLoadImpl{
+        .pLoader = pImpl,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+        .state = VK_TEXTURE_LOAD_STATE_QUEUED,
+        .result = VK_NOT_READY
+    };
+    for (uint32_t i = 0; i != pCreateInfo->layerCount; ++i) {
+        pLoad->layers.push_back(vkMakeTextureLoadLayer(&pCreateInfo->pLayerCreateInfos[i]));
+    }
+    vkQueueTextureLoad(pImpl, pLoad);
+
+    *pTextureLoad = reinterpret_cast<VkTextureLoad>(pLoad);
+    return VK_SUCCESS;
+}
+
+void vkDestroyTextureLoad(
+    VkTextureLoader                             textureLoader,
+    VkTextureLoad                               textureLoad) {
+    auto pImpl = reinterpret_cast<VkTextureLoaderImpl*>(textureLoader);
+    auto pLoad = reinterpret_cast<VkTextureLoadImpl*>(textureLoad);
+
+    unique_lock<mutex> guard(pImpl->lock);
+
+    // 워커 스레드가 기록 중이라면 끝날 때까지 기다린다.
+    pImpl->completeCondition.wait(guard, [pLoad] {
+        return pLoad->state != VK_TEXTURE_LOAD_STATE_RECORDING;
+    });
+
+    const auto erase = [pLoad](auto &loads) {
+        loads.erase(remove(loads.begin(), loads.end(), pLoad), loads.end());
+    };
+    erase(pImpl->queuedLoads);
+    erase(pImpl->recordedLoads);
+    erase(pImpl->submittedLoads);
+
+    if (pLoad->state == VK_TEXTURE_LOAD_STATE_SUBMITTED) {
+        vkWaitForFences(pImpl->device, 1, &pLoad->fence, VK_TRUE, UINT64_MAX);
+    }
+
+    guard.unlock();
+
+    vkReleaseStagingResources(pImpl, pLoad);
+    vkReleaseImageResources(pImpl, pLoad);
+    delete pLoad;
+}
+
+VkResult vkSubmitTextureLoads(
+    VkTextureLoader                             textureLoader) {
+    auto pImpl = reinterpret_cast<VkTextureLoaderImpl*>(textureLoader);
+    lock_guard<mutex> guard(pImpl->lock);
+
+    // 제출하지 못하면 이미 제출한 업로드만 목록에서 제거해서 다음 호출에서 두번 제출하지 않는다.
+    auto &recordedLoads = pImpl->recordedLoads;
+    auto submittedCount = 0;
+    for (; submittedCount != recordedLoads.size(); ++submittedCount) {
+        auto pLoad = recordedLoads[submittedCount];
+        VkSubmitInfo submitInfo{
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &pLoad->commandBuffer
+        };
+
+        auto result = vkQueueSubmit(pImpl->queue, 1, &submitInfo, pLoad->fence);
+        if (result != VK_SUCCESS) {
+            recordedLoads.erase(recordedLoads.begin(), recordedLoads.begin() + submittedCount);
+            return result;
+        }
+
+        pLoad->state = VK_TEXTURE_LOAD_STATE_SUBMITTED;
+        pImpl->submittedLoads.push_back(pLoad);
+    }
+    recordedLoads.clear();
+
+    // 완료된 업로드는 더 이상 필요 없는 스테이징 리소스를 해제한다.
+    auto iter = pImpl->submittedLoads.begin();
+    while (iter != pImpl->submittedLoads.end()) {
+        auto pLoad = *iter;
+        auto result = vkGetFenceStatus(pImpl->device, pLoad->fence);
+        if (result == VK_NOT_READY) {
+            ++iter;
+            continue;
+        }
+
+        vkReleaseStagingResources(pImpl, pLoad);
+        pLoad->result = result;
+        pLoad->state = result == VK_SUCCESS ?
+                       VK_TEXTURE_LOAD_STATE_COMPLETE :
+                       VK_TEXTURE_LOAD_STATE_FAILED;
+        iter = pImpl->submittedLoads.erase(iter);
+    }
+
+    return VK_SUCCESS;
+}
+
+VkResult vkGetTextureLoadStatus(
+    VkTextureLoad                               textureLoad) {
+    auto pLoad = reinterpret_cast<VkTextureLoadImpl*>(textureLoad);
+    lock_guard<mutex> guard(pLoad->pLoader->lock);
+    return pLoad->state == VK_TEXTURE_LOAD_STATE_COMPLETE ||
+           pLoad->state == VK_TEXTURE_LOAD_STATE_FAILED ? pLoad->result : VK_NOT_READY;
+}
+
+void vkCmdAcquireTextureLoad(
+    VkCommandBuffer                             commandBuffer,
+    VkTextureLoad                               textureLoad) {
+    auto pLoad = reinterpret_cast<VkTextureLoadImpl*>(textureLoad);
+    auto pLoader = pLoad->pLoader;
+    const auto &properties = pLoad->properties;
+
+    // ================================================================================
+    // 1. 소유권 획득
+    // ================================================================================
+    // 큐 패밀리가 같다면 전송 쓰기가 보이도록 하는 일반적인 배리어가 된다.
+    const auto transferOwnership = pLoader->queueFamilyIndex != pLoader->dstQueueFamilyIndex;
+    VkImageMemoryBarrier imageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = transferOwnership ? VK_ACCESS_NONE : VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = transferOwnership ? pLoader->queueFamilyIndex : VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = transferOwnership ? pLoader->dstQueueFamilyIndex : VK_QUEUE_FAMILY_IGNORED,
+        .image = properties.image,
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = properties.mipLevels,
+            .baseArrayLayer = 0,
+            .layerCount = properties.arrayLayers
+        }
+    };
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+
+    imageMemoryBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageMemoryBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+    // ================================================================================
+    // 2. Mipmap 생성
+    // ================================================================================
+    if (pLoad->generateMipmaps) {
+        // 이전 레벨을 TRANSFER_SRC_OPTIMAL로 변환한 후 다음 레벨로 Blit하고,
+        // 사용이 끝난 이전 레벨은 SHADER_READ_ONLY_OPTIMAL로 변환한다. 모든 레이어를 한번에 Blit한다.
+        imageMemoryBarrier.subresourceRange.levelCount = 1;
+
+        auto mipWidth = static_cast<int32_t>(properties.extent.width);
+        auto mipHeight = static_cast<int32_t>(properties.extent.height);
+        for (uint32_t level = 1; level < properties.mipLevels; ++level) {
+            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            imageMemoryBarrier.subresourceRange.baseMipLevel = level - 1;
+
+            vkCmdPipelineBarrier(commandBuffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &imageMemoryBarrier);
+
+            const auto nextMipWidth = max(mipWidth / 2, 1);
+            const auto nextMipHeight = max(mipHeight / 2, 1);
+
+            VkImageBlit imageBlit{
+                .srcSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level - 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = properties.arrayLayers
+                },
+                .srcOffsets = {{0, 0, 0}, {mipWidth, mipHeight, 1}},
+                .dstSubresource = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = 0,
+                    .layerCount = properties.arrayLayers
+                },
+                .dstOffsets = {{0, 0, 0}, {nextMipWidth, nextMipHeight, 1}}
+            };
+
+            vkCmdBlitImage(commandBuffer,
+                           properties.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           properties.image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                           1,
+                           &imageBlit,
+                           VK_FILTER_LINEAR);
+
+            imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+            imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+            vkCmdPipelineBarrier(commandBuffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                 0,
+                                 0,
+                                 nullptr,
+                                 0,
+                                 nullptr,
+                                 1,
+                                 &imageMemoryBarrier);
+
+            mipWidth = nextMipWidth;
+            mipHeight = nextMipHeight;
+        }
+    }
+
+    // ================================================================================
+    // 3. VkImageLayout을 SHADER_READ_ONLY_OPTIMAL로 변환
+    // ================================================================================
+    imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageMemoryBarrier.subresourceRange.baseMipLevel = pLoad->generateMipmaps ? properties.mipLevels - 1 : 0;
+    imageMemoryBarrier.subresourceRange.levelCount = pLoad->generateMipmaps ? 1 : properties.mipLevels;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         1,
+                         &imageMemoryBarrier);
+}
+
+void vkGetTextureLoadProperties(
+    VkTextureLoad                               textureLoad,
+    VkTextureLoadProperties*                    pTextureLoadProperties) {
+    auto pLoad = reinterpret_cast<VkTextureLoadImpl*>(textureLoad);
+    *pTextureLoadProperties = pLoad->properties;
+    pTextureLoadProperties->allocation = pLoad->allocation;
+}
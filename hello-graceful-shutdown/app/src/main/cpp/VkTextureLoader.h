@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKTEXTURELOADER_H
+#define PRACTICE_VULKAN_VKTEXTURELOADER_H
+
+#include <game-activity/GameActivity.h>
+#include <vulkan/vulkan.h>
+
+#include "VkMemoryAllocator.h"
+#include "VkTexture.h"
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkTextureLoader)
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkTextureLoad)
+
+typedef struct VkTextureLoaderCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    VkPhysicalDevice                 physicalDevice;
+    VkMemoryAllocator                memoryAllocator;
+    AAssetManager*                   pAssetManager;
+    // 업로드를 제출할 큐이며 전용 전송 큐가 없다면 그래픽스 큐를 사용한다.
+    uint32_t                         queueFamilyIndex;
+    VkQueue                          queue;
+    // 텍스처를 사용할 그래픽스 큐 패밀리로 queueFamilyIndex와 다르면 소유권을 이전한다.
+    uint32_t                         dstQueueFamilyIndex;
+    uint32_t                         threadCount;
+} VkTextureLoaderCreateInfo;
+
+// 모든 레이어는 포맷, 크기, Mipmap 레벨 개수가 같아야 하며 다르면 VK_ERROR_FORMAT_NOT_SUPPORTED로 실패한다.
+// 레이어 개수는 maxImageArrayLayers(최소 256)를 넘을 수 없다.
+typedef struct VkTextureArrayCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    uint32_t                         layerCount;
+    const VkTextureCreateInfo*       pLayerCreateInfos;
+} VkTextureArrayCreateInfo;
+
+typedef struct VkTextureLoadProperties {
+    VkImage                          image;
+    // 텍스처 배열은 VK_IMAGE_VIEW_TYPE_2D_ARRAY, 그외는 VK_IMAGE_VIEW_TYPE_2D이다.
+    VkImageView                      imageView;
+    VkFormat                         format;
+    VkExtent3D                       extent;
+    uint32_t                         mipLevels;
+    uint32_t                         arrayLayers;
+    // 레지던시 관리에 사용할 이미지의 메모리로 VkTextureLoad가 소유한다.
+    VkMemoryAllocation               allocation;
+} VkTextureLoadProperties;
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateTextureLoader(
+    VkDevice                                    device,
+    const VkTextureLoaderCreateInfo*            pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkTextureLoader*                            pTextureLoader);
+
+// 생성된 모든 VkTextureLoad를 먼저 파괴해야 한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyTextureLoader(
+    VkDevice                                    device,
+    VkTextureLoader                             textureLoader,
+    const VkAllocationCallbacks*                pAllocator);
+
+// 워커 스레드에서 디코딩과 업로드 기록을 시작한다. pCreateInfo의 pAssetManager와
+// physicalDevice는 무시되고 VkTextureLoader의 값을 사용한다. pNext의 VkTextureDataInfo는
+// 데이터를 복사하지 않으므로 VkTextureLoad가 파괴될 때까지 유효해야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateTextureLoad(
+    VkTextureLoader                             textureLoader,
+    const VkTextureCreateInfo*                  pCreateInfo,
+    VkTextureLoad*                              pTextureLoad);
+
+// 여러 텍스처를 하나의 VkImage의 레이어로 불러와서 하나의 VkDescriptorSet과 한번의 그리기로
+// 서로 다른 텍스처를 샘플링할 수 있게 한다. 각 레이어의 VkTextureCreateInfo는 vkCreateTextureLoad와 같다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateTextureArrayLoad(
+    VkTextureLoader                             textureLoader,
+    const VkTextureArrayCreateInfo*             pCreateInfo,
+    VkTextureLoad*                              pTextureLoad);
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyTextureLoad(
+    VkTextureLoader                             textureLoader,
+    VkTextureLoad                               textureLoad);
+
+// 기록이 끝난 업로드를 제출하고 완료된 업로드의 스테이징 리소스를 해제한다.
+// 큐를 사용하므로 같은 큐에 제출하는 스레드에서 호출해야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkSubmitTextureLoads(
+    VkTextureLoader                             textureLoader);
+
+// 업로드가 진행 중이면 VK_NOT_READY, 완료되면 VK_SUCCESS, 실패하면 에러를 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkGetTextureLoadStatus(
+    VkTextureLoad                               textureLoad);
+
+// 업로드가 완료된 후 그래픽스 큐의 VkCommandBuffer에 한번만 기록한다.
+// 소유권을 가져오고 필요하면 Mipmap을 생성한 후 SHADER_READ_ONLY_OPTIMAL로 변환한다.
+VKAPI_ATTR void VKAPI_CALL vkCmdAcquireTextureLoad(
+    VkCommandBuffer                             commandBuffer,
+    VkTextureLoad                               textureLoad);
+
+VKAPI_ATTR void VKAPI_CALL vkGetTextureLoadProperties(
+    VkTextureLoad                               textureLoad,
+    VkTextureLoadProperties*                    pTextureLoadProperties);
+
+#endif //PRACTICE_VULKAN_VKTEXTURELOADER_H
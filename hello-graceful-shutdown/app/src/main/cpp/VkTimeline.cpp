@@ -0,0 +1,289 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "VkTimeline.h"
+#include "VkUtil.h"
+
+using namespace std;
+
+namespace {
+
+struct VkTimelineSubmit {
+    uint64_t value;
+    VkFence fence;
+};
+
+struct VkTimelineImpl {
+    VkDevice device;
+    // VK_NULL_HANDLE이면 VkFence로 완료를 확인한다.
+    VkSemaphore semaphore;
+    // 로더가 Vulkan 1.2 함수를 내보내지 않는 Android 버전이 있으므로 vkGetDeviceProcAddr로 얻는다.
+    PFN_vkWaitSemaphores pfnWaitSemaphores;
+    PFN_vkGetSemaphoreCounterValue pfnGetSemaphoreCounterValue;
+    uint64_t submittedValue;
+    uint64_t completedValue;
+    // 같은 큐에 제출된 순서대로 끝나므로 앞에서부터 회수한다.
+    deque<VkTimelineSubmit> pendingSubmits;
+    vector<VkFence> freeFences;
+};
+
+// 완료된 제출의 VkFence를 회수하며 wait가 참이면 value 이하의 제출이 끝날 때까지 기다린다.
+VkResult vkReclaimTimelineSubmits(VkTimelineImpl *pImpl, uint64_t value, uint64_t timeout, bool wait) {
+    while (!pImpl->pendingSubmits.empty()) {
+        const auto &submit = pImpl->pendingSubmits.front();
+        auto result = wait && submit.value <= value ?
+                      vkWaitForFences(pImpl->device, 1, &submit.fence, VK_TRUE, timeout) :
+                      vkGetFenceStatus(pImpl->device, submit.fence);
+        if (result == VK_NOT_READY || result == VK_TIMEOUT) {
+            return submit.value <= value ? result : VK_SUCCESS;
+        }
+
+        if (result == VK_SUCCESS) {
+            result = vkResetFences(pImpl->device, 1, &submit.fence);
+        }
+
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+
+        pImpl->completedValue = submit.value;
+        pImpl->freeFences.push_back(submit.fence);
+        pImpl->pendingSubmits.pop_front();
+    }
+
+    return VK_SUCCESS;
+}
+
+}
+
+VkResult vkCreateTimeline(
+    VkDevice                                    device,
+    const VkTimelineCreateInfo*                 pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkTimeline*                                 pTimeline) {
+    auto pImpl = make_unique<VkTimelineImpl>();
+    pImpl->device = device;
+    pImpl->semaphore = VK_NULL_HANDLE;
+    pImpl->submittedValue = 0;
+    pImpl->completedValue = 0;
+
+    if (pCreateInfo->timelineSemaphore) {
+        // ================================================================================
+        // 1. 타임라인 VkSemaphore 생성
+        // ================================================================================
+        pImpl->pfnWaitSemaphores = reinterpret_cast<PFN_vkWaitSemaphores>(
+                vkGetDeviceProcAddr(device, "vkWaitSemaphores"));
+        pImpl->pfnGetSemaphoreCounterValue = reinterpret_cast<PFN_vkGetSemaphoreCounterValue>(
+                vkGetDeviceProcAddr(device, "vkGetSemaphoreCounterValue"));
+        if (!pImpl->pfnWaitSemaphores || !pImpl->pfnGetSemaphoreCounterValue) {
+            return VK_ERROR_FEATURE_NOT_PRESENT;
+        }
+
+        const VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0
+        };
+
+        const VkSemaphoreCreateInfo semaphoreCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &semaphoreTypeCreateInfo
+        };
+
+        auto result = vkCreateSemaphore(device, &semaphoreCreateInfo, nullptr, &pImpl->semaphore);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+    }
+
+    *pTimeline = reinterpret_cast<VkTimeline>(pImpl.release());
+    return VK_SUCCESS;
+}
+
+void vkDestroyTimeline(
+    VkDevice                                    device,
+    VkTimeline                                  timeline,
+    const VkAllocationCallbacks*                pAllocator) {
+    auto pImpl = reinterpret_cast<VkTimelineImpl*>(timeline);
+
+    VK_CHECK_ERROR(vkWaitTimeline(timeline, pImpl->submittedValue, UINT64_MAX));
+
+    for (auto fence: pImpl->freeFences) {
+        vkDestroyFence(device, fence, nullptr);
+    }
+
+    vkDestroySemaphore(device, pImpl->semaphore, nullptr);
+    delete pImpl;
+}
+
+void vkGetTimelineProperties(
+    VkTimeline                                  timeline,
+    VkTimelineProperties*                       pTimelineProperties) {
+    auto pImpl = reinterpret_cast<VkTimelineImpl*>(timeline);
+
+    *pTimelineProperties = {
+        .semaphore = pImpl->semaphore,
+        .submittedValue = pImpl->submittedValue
+    };
+}
+
+VkResult vkQueueSubmitTimeline(
+    VkTimeline                                  timeline,
+    VkQueue                                     queue,
+    uint32_t                                    submitCount,
+    const VkSubmitInfo*                         pSubmits,
+    uint64_t*                                   pValue) {
+    auto pImpl = reinterpret_cast<VkTimelineImpl*>(timeline);
+    const auto value = pImpl->submittedValue + 1;
+
+    if (pImpl->semaphore) {
+        // ================================================================================
+        // 1. 타임라인 값 Signal 추가
+        // ================================================================================
+        // 마지막 VkSubmitInfo가 끝나면 이전 VkSubmitInfo도 끝나므로 마지막에만 추가한다.
+        // 바이너리 VkSemaphore의 값은 무시되므로 같은 값으로 채운다.
+        vector<VkSubmitInfo> submitInfos(pSubmits, pSubmits + submitCount);
+        if (submitInfos.empty()) {
+            submitInfos.push_back({.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO});
+        }
+
+        auto &submitInfo = submitInfos.back();
+        vector<VkSemaphore> signalSemaphores(submitInfo.pSignalSemaphores,
+                                             submitInfo.pSignalSemaphores + submitInfo.signalSemaphoreCount);
+        signalSemaphores.push_back(pImpl->semaphore);
+        const vector<uint64_t> signalValues(signalSemaphores.size(), value);
+
+        const VkTimelineSemaphoreSubmitInfo timelineSemaphoreSubmitInfo{
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+            .pNext = submitInfo.pNext,
+            .signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size()),
+            .pSignalSemaphoreValues = signalValues.data()
+        };
+
+        submitInfo.pNext = &timelineSemaphoreSubmitInfo;
+        submitInfo.signalSemaphoreCount = signalSemaphores.size();
+        submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+        // ================================================================================
+        // 2. VkQueue에 제출
+        // ================================================================================
+        auto result = vkQueueSubmit(queue, submitInfos.size(), submitInfos.data(), VK_NULL_HANDLE);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+    } else {
+        // ================================================================================
+        // 1. VkFence 준비
+        // ================================================================================
+        // 완료된 VkFence를 먼저 회수해서 VkFence가 계속 늘어나지 않게 한다.
+        auto result = vkReclaimTimelineSubmits(pImpl, 0, 0, false);
+        if (result != VK_SUCCESS) {
+            return result;
+        }
+
+        VkFence fence;
+        if (!pImpl->freeFences.empty()) {
+            fence = pImpl->freeFences.back();
+            pImpl->freeFences.pop_back();
+        } else {
+            const VkFenceCreateInfo fenceCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+            };
+
+            result = vkCreateFence(pImpl->device, &fenceCreateInfo, nullptr, &fence);
+            if (result != VK_SUCCESS) {
+                return result;
+            }
+        }
+
+        // ================================================================================
+        // 2. VkQueue에 제출
+        // ================================================================================
+        result = vkQueueSubmit(queue, submitCount, pSubmits, fence);
+        if (result != VK_SUCCESS) {
+            pImpl->freeFences.push_back(fence);
+            return result;
+        }
+
+        pImpl->pendingSubmits.push_back({
+            .value = value,
+            .fence = fence
+        });
+    }
+
+    pImpl->submittedValue = value;
+    if (pValue) {
+        *pValue = value;
+    }
+
+    return VK_SUCCESS;
+}
+
+VkResult vkGetTimelineCompletedValue(
+    VkTimeline                                  timeline,
+    uint64_t*                                   pValue) {
+    auto pImpl = reinterpret_cast<VkTimelineImpl*>(timeline);
+
+    auto result = pImpl->semaphore ?
+                  pImpl->pfnGetSemaphoreCounterValue(pImpl->device, pImpl->semaphore, &pImpl->completedValue) :
+                  vkReclaimTimelineSubmits(pImpl, 0, 0, false);
+    if (result != VK_SUCCESS) {
+        return result;
+    }
+
+    *pValue = pImpl->completedValue;
+    return VK_SUCCESS;
+}
+
+VkResult vkWaitTimeline(
+    VkTimeline                                  timeline,
+    uint64_t                                    value,
+    uint64_t                                    timeout) {
+    auto pImpl = reinterpret_cast<VkTimelineImpl*>(timeline);
+
+    // 이미 완료된 값은 드라이버를 호출하지 않고 반환한다.
+    if (value <= pImpl->completedValue) {
+        return VK_SUCCESS;
+    }
+
+    if (!pImpl->semaphore) {
+        return vkReclaimTimelineSubmits(pImpl, value, timeout, true);
+    }
+
+    const VkSemaphoreWaitInfo semaphoreWaitInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &pImpl->semaphore,
+        .pValues = &value
+    };
+
+    auto result = pImpl->pfnWaitSemaphores(pImpl->device, &semaphoreWaitInfo, timeout);
+    if (result == VK_SUCCESS) {
+        pImpl->completedValue = max(pImpl->completedValue, value);
+    }
+
+    return result;
+}
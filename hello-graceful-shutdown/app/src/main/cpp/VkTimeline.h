@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKTIMELINE_H
+#define PRACTICE_VULKAN_VKTIMELINE_H
+
+#include <vulkan/vulkan.h>
+
+#include "VkTypes.h"
+
+VK_DEFINE_NON_DISPATCHABLE_HANDLE(VkTimeline)
+
+typedef struct VkTimelineCreateInfo {
+    VkStructureTypeEXT               sType;
+    const void*                      pNext;
+    VkFlags                          flags;
+    // VK_TRUE면 타임라인 VkSemaphore를 사용하며 timelineSemaphore 기능이 활성화되어 있어야 한다.
+    // VK_FALSE면 제출마다 VkFence를 사용해서 같은 동작을 한다.
+    VkBool32                         timelineSemaphore;
+} VkTimelineCreateInfo;
+
+typedef struct VkTimelineProperties {
+    // 다른 제출이 타임라인 값을 기다릴 때 사용하며 VkFence를 사용하면 VK_NULL_HANDLE이다.
+    VkSemaphore                      semaphore;
+    // 마지막으로 제출된 작업이 완료되면 가지는 값이다.
+    uint64_t                         submittedValue;
+} VkTimelineProperties;
+
+// 모든 함수는 외부에서 동기화해야 한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateTimeline(
+    VkDevice                                    device,
+    const VkTimelineCreateInfo*                 pCreateInfo,
+    const VkAllocationCallbacks*                pAllocator,
+    VkTimeline*                                 pTimeline);
+
+// 제출된 모든 작업이 끝날 때까지 기다린 후 파괴한다.
+VKAPI_ATTR void VKAPI_CALL vkDestroyTimeline(
+    VkDevice                                    device,
+    VkTimeline                                  timeline,
+    const VkAllocationCallbacks*                pAllocator);
+
+VKAPI_ATTR void VKAPI_CALL vkGetTimelineProperties(
+    VkTimeline                                  timeline,
+    VkTimelineProperties*                       pTimelineProperties);
+
+// vkQueueSubmit과 같으며 제출이 끝나면 pValue의 값이 완료된다. 값은 1부터 제출 순서대로 증가한다.
+// pSubmits는 VkTimelineSemaphoreSubmitInfo를 포함하지 않아야 하며 submitCount가 0이어도 값을 발급한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmitTimeline(
+    VkTimeline                                  timeline,
+    VkQueue                                     queue,
+    uint32_t                                    submitCount,
+    const VkSubmitInfo*                         pSubmits,
+    uint64_t*                                   pValue);
+
+// 완료된 가장 큰 값으로 이 값 이하의 모든 제출이 끝났다.
+VKAPI_ATTR VkResult VKAPI_CALL vkGetTimelineCompletedValue(
+    VkTimeline                                  timeline,
+    uint64_t*                                   pValue);
+
+// value 이하의 모든 제출이 끝날 때까지 기다리며 시간이 초과되면 VK_TIMEOUT을 반환한다.
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitTimeline(
+    VkTimeline                                  timeline,
+    uint64_t                                    value,
+    uint64_t                                    timeout);
+
+#endif //PRACTICE_VULKAN_VKTIMELINE_H
@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKTRACE_H
+#define PRACTICE_VULKAN_VKTRACE_H
+
+// VK_TRACE가 정의되지 않으면 아래의 매크로는 아무 코드도 만들지 않는다.
+#ifdef VK_TRACE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <android/trace.h>
+
+#include "AndroidOut.h"
+
+// 범위를 벗어날 때 구간을 끝내며 ATrace는 트레이싱 중이 아니면 바로 반환한다.
+class VkTraceScope {
+public:
+    explicit VkTraceScope(const char *name) {
+        ATrace_beginSection(name);
+    }
+
+    ~VkTraceScope() {
+        ATrace_endSection();
+    }
+
+    VkTraceScope(const VkTraceScope &) = delete;
+
+    VkTraceScope &operator=(const VkTraceScope &) = delete;
+};
+
+// 번호가 매겨진 단계처럼 이어지는 구간을 기록하며 다음 단계를 시작하면 이전 단계를 끝낸다.
+class VkTraceSteps {
+public:
+    VkTraceSteps() = default;
+
+    ~VkTraceSteps() {
+        if (mStarted) {
+            ATrace_endSection();
+        }
+    }
+
+    VkTraceSteps(const VkTraceSteps &) = delete;
+
+    VkTraceSteps &operator=(const VkTraceSteps &) = delete;
+
+    void next(const char *name) {
+        if (mStarted) {
+            ATrace_endSection();
+        }
+        ATrace_beginSection(name);
+        mStarted = true;
+    }
+
+private:
+    bool mStarted{false};
+};
+
+// 하나의 스레드가 기록하고 다른 스레드가 언제든 출력할 수 있는 잠금 없는 프레임 시간 히스토그램.
+// 0.5ms 단위의 구간으로 나누며 마지막 구간은 그보다 긴 모든 프레임을 센다.
+class VkFrameTimeHistogram {
+public:
+    static constexpr uint32_t kBucketCount = 80;
+    static constexpr auto kBucketWidth = std::chrono::microseconds{500};
+
+    void record(std::chrono::nanoseconds frameTime) {
+        const auto index = std::min<uint64_t>(frameTime / kBucketWidth, kBucketCount - 1);
+        mCounts[index].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 기록 중에 출력하면 일부 구간은 한 프레임씩 어긋날 수 있다.
+    void print() const {
+        std::array<uint32_t, kBucketCount> counts;
+        uint64_t totalCount = 0;
+        for (auto i = 0; i != kBucketCount; ++i) {
+            counts[i] = mCounts[i].load(std::memory_order_relaxed);
+            totalCount += counts[i];
+        }
+
+        aout << "CPU Frame Time Histogram ↓" << std::endl;
+        if (!totalCount) {
+            return;
+        }
+
+        uint64_t accumulatedCount = 0;
+        for (auto i = 0; i != kBucketCount; ++i) {
+            if (!counts[i]) {
+                continue;
+            }
+
+            accumulatedCount += counts[i];
+            const auto lowerBound = std::chrono::duration<float, std::milli>(kBucketWidth * i);
+            aout << " - " << std::setw(5) << std::fixed << std::setprecision(1)
+                 << lowerBound.count() << (i + 1 == kBucketCount ? "ms+ " : "ms  ")
+                 << std::setw(8) << counts[i]
+                 << std::setw(7) << 100.0f * accumulatedCount / totalCount << "%"
+                 << std::defaultfloat << std::endl;
+        }
+    }
+
+private:
+    std::array<std::atomic<uint32_t>, kBucketCount> mCounts{};
+};
+
+#define VK_TRACE_CONCAT_IMPL(a, b) a##b
+#define VK_TRACE_CONCAT(a, b) VK_TRACE_CONCAT_IMPL(a, b)
+#define VK_TRACE_SCOPE(name) const VkTraceScope VK_TRACE_CONCAT(vkTraceScope, __LINE__){name}
+#define VK_TRACE_STEPS(steps) VkTraceSteps steps
+#define VK_TRACE_NEXT_STEP(steps, name) steps.next(name)
+#else
+#define VK_TRACE_SCOPE(name)
+#define VK_TRACE_STEPS(steps)
+#define VK_TRACE_NEXT_STEP(steps, name) ((void) 0)
+#endif
+
+#endif //PRACTICE_VULKAN_VKTRACE_H
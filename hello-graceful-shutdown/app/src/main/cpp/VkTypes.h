@@ -0,0 +1,50 @@
+// MIT License
+//
+// Copyright (c) 2024 Daemyung Jang
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PRACTICE_VULKAN_VKTYPES_H
+#define PRACTICE_VULKAN_VKTYPES_H
+
+typedef enum VkStructureTypeEXT {
+    VK_STRUCTURE_TYPE_TEXTURE_CREATE_INFO = 2000000000,
+    VK_STRUCTURE_TYPE_MEMORY_ALLOCATOR_CREATE_INFO = 2000000001,
+    VK_STRUCTURE_TYPE_MEMORY_ALLOCATION_CREATE_INFO = 2000000002,
+    VK_STRUCTURE_TYPE_RING_BUFFER_CREATE_INFO = 2000000003,
+    VK_STRUCTURE_TYPE_TEXTURE_LOADER_CREATE_INFO = 2000000004,
+    VK_STRUCTURE_TYPE_COMMAND_RECORDER_CREATE_INFO = 2000000005,
+    VK_STRUCTURE_TYPE_MESH_CREATE_INFO = 2000000006,
+    VK_STRUCTURE_TYPE_STAGING_UPLOADER_CREATE_INFO = 2000000007,
+    VK_STRUCTURE_TYPE_TIMELINE_CREATE_INFO = 2000000008,
+    VK_STRUCTURE_TYPE_GPU_PROFILER_CREATE_INFO = 2000000009,
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SELECT_INFO = 2000000010,
+    VK_STRUCTURE_TYPE_TEXTURE_DATA_INFO = 2000000011,
+    VK_STRUCTURE_TYPE_PERFORMANCE_HINT_CREATE_INFO = 2000000012,
+    VK_STRUCTURE_TYPE_PIPELINE_COMPILER_CREATE_INFO = 2000000013,
+    VK_STRUCTURE_TYPE_PIPELINE_COMPILE_INFO = 2000000014,
+    VK_STRUCTURE_TYPE_RESIDENCY_MANAGER_CREATE_INFO = 2000000015,
+    VK_STRUCTURE_TYPE_RESIDENT_RESOURCE_CREATE_INFO = 2000000016,
+    VK_STRUCTURE_TYPE_DELETION_QUEUE_CREATE_INFO = 2000000017,
+    VK_STRUCTURE_TYPE_TEXTURE_ARRAY_CREATE_INFO = 2000000018,
+    VK_STRUCTURE_TYPE_STATE_CACHE_CREATE_INFO = 2000000019,
+    VK_STRUCTURE_TYPE_FRAME_TRACE_CREATE_INFO = 2000000020
+} VkStructureTypeEXT;
+
+#endif //PRACTICE_VULKAN_VKTYPES_H
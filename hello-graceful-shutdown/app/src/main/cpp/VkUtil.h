@@ -23,18 +23,28 @@
 #ifndef PRACTICE_VULKAN_VKUTIL_H
 #define PRACTICE_VULKAN_VKUTIL_H
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <iterator>
 #include <string_view>
 #include <string>
 #include <vector>
 #include <random>
+#include <unistd.h>
 #include <android/asset_manager.h>
 #include <vulkan/vulkan.h>
+#ifndef VK_PRECOMPILED_SHADERS
 #include <shaderc/shaderc.hpp>
+#endif
 
 #include "AndroidOut.h"
 
-#ifndef NDEBUG
-
 inline std::string vkToString(VkResult vkResult) {
     switch (vkResult) {
         case VK_SUCCESS:
@@ -118,19 +128,93 @@ inline std::string vkToString(VkResult vkResult) {
     }
 }
 
-#define VK_CHECK_ERROR(vkFunction)                                                     \
-    do {                                                                               \
-        if (auto vkResult = vkFunction; vkResult != VK_SUCCESS) {                      \
-            aout << #vkFunction << " returns " << vkToString(vkResult) << "." << endl; \
-            abort();                                                                   \
+#define VK_LIKELY(condition) __builtin_expect(!!(condition), 1)
+#define VK_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+
+// 호출 위치마다 하나씩 존재하며 성공이 아닌 결과를 종류별로 센다.
+// 정적 저장 기간을 가지고 상수로 초기화되므로 성공하는 호출은 비교 한번 외에는 비용이 없다.
+struct VkResultCounter {
+    static constexpr uint32_t kSlotCount = 4;
+
+    const char *expression;
+    const char *file;
+    uint32_t line;
+    // VK_SUCCESS인 슬롯은 비어 있으며 처음 나온 결과부터 차례대로 차지한다.
+    std::atomic<VkResult> results[kSlotCount]{};
+    std::atomic<uint32_t> counts[kSlotCount]{};
+    // 슬롯이 모두 찼을 때 나온 결과의 횟수.
+    std::atomic<uint32_t> overflowCount{0};
+    std::atomic<bool> registered{false};
+    // 처음 성공이 아닌 결과를 반환할 때 목록에 등록된다.
+    VkResultCounter *pNext{nullptr};
+};
+
+inline std::atomic<VkResultCounter *> &vkGetResultCounterHead() {
+    static std::atomic<VkResultCounter *> head{nullptr};
+    return head;
+}
+
+// __FILE__은 빌드 환경에 따라 절대 경로이므로 출력할 때는 파일 이름만 사용한다.
+inline std::string_view vkGetFileName(std::string_view path) {
+    return path.substr(path.find_last_of('/') + 1);
+}
+
+// 한번이라도 성공이 아닌 결과를 반환한 호출 위치를 최근에 등록된 순서로 순회한다.
+inline const VkResultCounter *vkGetFirstResultCounter() {
+    return vkGetResultCounterHead().load(std::memory_order_acquire);
+}
+
+inline void vkCountResult(VkResultCounter *pCounter, VkResult result) {
+    if (!pCounter->registered.exchange(true, std::memory_order_relaxed)) {
+        auto &head = vkGetResultCounterHead();
+        pCounter->pNext = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(pCounter->pNext,
+                                           pCounter,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    for (auto &slot: pCounter->results) {
+        auto expected = VK_SUCCESS;
+        if (slot.compare_exchange_strong(expected, result, std::memory_order_relaxed) ||
+            expected == result) {
+            pCounter->counts[&slot - pCounter->results].fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    pCounter->overflowCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// VK_CHECK_ERROR의 실패는 빌드와 상관없이 출력하고 중단한다.
+// 실패한 결과로 만든 오브젝트를 계속 사용하면 원인과 먼 곳에서 문제가 생긴다.
+inline void vkHandleResult(const VkResultCounter &counter, VkResult result) {
+    aout << vkGetFileName(counter.file) << ":" << counter.line << " "
+         << counter.expression << " returns " << vkToString(result) << "." << std::endl;
+    abort();
+}
+
+// 결과를 그대로 반환하며 VK_SUBOPTIMAL_KHR처럼 성공이 아니어도 처리하는 결과의 횟수를 셀 때 사용한다.
+// VK_ERROR_DEVICE_LOST처럼 복구할 수 있는 실패는 호출한 쪽이 이 결과를 직접 처리한다.
+#define VK_COUNT_RESULT(vkFunction)                                                    \
+    ([&]() {                                                                           \
+        static VkResultCounter vkResultCounter{#vkFunction, __FILE__, __LINE__};       \
+        const VkResult vkResult = vkFunction;                                          \
+        if (VK_UNLIKELY(vkResult != VK_SUCCESS)) {                                     \
+            vkCountResult(&vkResultCounter, vkResult);                                 \
         }                                                                              \
-    } while (0)
-#else
+        return vkResult;                                                               \
+    }())
+
 #define VK_CHECK_ERROR(vkFunction)                                                     \
     do {                                                                               \
-        vkFunction                                                                     \
+        static VkResultCounter vkResultCounter{#vkFunction, __FILE__, __LINE__};       \
+        const VkResult vkResult = vkFunction;                                          \
+        if (VK_UNLIKELY(vkResult != VK_SUCCESS)) {                                     \
+            vkCountResult(&vkResultCounter, vkResult);                                 \
+            vkHandleResult(vkResultCounter, vkResult);                                 \
+        }                                                                              \
     } while (0)
-#endif
 
 inline std::string_view vkToString(VkPhysicalDeviceType physicalDeviceType) {
     switch (physicalDeviceType) {
@@ -150,10 +234,20 @@ inline std::string_view vkToString(VkPhysicalDeviceType physicalDeviceType) {
 }
 
 typedef enum VkShaderType {
-    VK_SHADER_TYPE_VERTEX = shaderc_vertex_shader,
-    VK_SHADER_TYPE_FRAGMENT = shaderc_fragment_shader
+    VK_SHADER_TYPE_VERTEX = 0,
+    VK_SHADER_TYPE_FRAGMENT = 1,
+    VK_SHADER_TYPE_COMPUTE = 2
 } VkShaderType;
 
+#ifndef VK_PRECOMPILED_SHADERS
+static_assert(VK_SHADER_TYPE_VERTEX == static_cast<int>(shaderc_vertex_shader));
+static_assert(VK_SHADER_TYPE_FRAGMENT == static_cast<int>(shaderc_fragment_shader));
+static_assert(VK_SHADER_TYPE_COMPUTE == static_cast<int>(shaderc_compute_shader));
+
+// 빌드 시간에 컴파일하는 glslc의 --target-env=vulkan1.0 -O와 같은 결과가 나오도록 한다.
+constexpr auto kShaderTargetEnvVersion = shaderc_env_version_vulkan_1_0;
+constexpr auto kShaderOptimizationLevel = shaderc_optimization_level_performance;
+
 inline VkResult
 vkCompileShader(std::string_view shaderCode, VkShaderType shaderType,
                 std::vector<uint32_t> *shaderBinary) {
@@ -166,11 +260,19 @@ vkCompileShader(std::string_view shaderCode, VkShaderType shaderType,
         tag[i] = static_cast<char>(distribution(generator));
     }
 
-    shaderc::Compiler compiler;
+    // shaderc::Compiler는 생성 비용이 크고 const 함수는 동시에 호출해도 안전하기 때문에 재사용한다.
+    static const shaderc::Compiler compiler;
+    static const auto options = [] {
+        shaderc::CompileOptions options;
+        options.SetTargetEnvironment(shaderc_target_env_vulkan, kShaderTargetEnvVersion);
+        options.SetOptimizationLevel(kShaderOptimizationLevel);
+        return options;
+    }();
     auto result = compiler.CompileGlslToSpv(shaderCode.data(),
                                             shaderCode.size(),
                                             static_cast<shaderc_shader_kind>(shaderType),
-                                            tag.c_str());
+                                            tag.c_str(),
+                                            options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success) {
         aout << result.GetErrorMessage() << std::endl;
@@ -180,6 +282,152 @@ vkCompileShader(std::string_view shaderCode, VkShaderType shaderType,
     *shaderBinary = std::vector(result.cbegin(), result.cend());
     return VK_SUCCESS;
 }
+#endif
+
+inline VkResult vkReadFile(const std::string &path, std::vector<uint8_t> *data) {
+    auto file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return VK_ERROR_UNKNOWN;
+    }
+
+    fseek(file, 0, SEEK_END);
+    auto size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    data->resize(size > 0 ? size : 0);
+    auto readSize = fread(data->data(), 1, data->size(), file);
+    fclose(file);
+
+    return readSize == data->size() ? VK_SUCCESS : VK_ERROR_UNKNOWN;
+}
+
+inline VkResult vkWriteFile(const std::string &path, const void *data, size_t size) {
+    // 쓰기 도중에 종료되어도 깨진 파일이 남지 않도록 임시 파일에 쓴 후 이름을 바꾼다.
+    // 여러 스레드가 같은 경로에 동시에 쓸 수 있으므로 임시 파일은 쓰는 쪽마다 다른 이름으로 만든다.
+    auto temporaryPath = path + ".XXXXXX";
+    auto fd = mkstemp(temporaryPath.data());
+    if (fd == -1) {
+        return VK_ERROR_UNKNOWN;
+    }
+
+    auto file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        remove(temporaryPath.c_str());
+        return VK_ERROR_UNKNOWN;
+    }
+
+    auto writtenSize = fwrite(data, 1, size, file);
+    if (fclose(file) != 0 || writtenSize != size) {
+        remove(temporaryPath.c_str());
+        return VK_ERROR_UNKNOWN;
+    }
+
+    if (rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        remove(temporaryPath.c_str());
+        return VK_ERROR_UNKNOWN;
+    }
+
+    return VK_SUCCESS;
+}
+
+inline uint64_t vkHash(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325) {
+    // FNV-1a
+    for (auto byte = static_cast<const uint8_t *>(data); size; --size, ++byte) {
+        hash = (hash ^ *byte) * 0x100000001b3;
+    }
+    return hash;
+}
+
+#ifdef VK_PRECOMPILED_SHADERS
+template<size_t N>
+inline VkResult
+vkCompileShader(const uint32_t (&shaderCode)[N], VkShaderType shaderType,
+                const char *pCacheDirectory, std::vector<uint32_t> *shaderBinary) {
+    // 빌드 시간에 이미 SPIR-V로 컴파일 되었기 때문에 복사만 한다.
+    *shaderBinary = std::vector(std::cbegin(shaderCode), std::cend(shaderCode));
+    return VK_SUCCESS;
+}
+#else
+inline VkResult
+vkCompileShader(std::string_view shaderCode, VkShaderType shaderType,
+                const char *pCacheDirectory, std::vector<uint32_t> *shaderBinary) {
+    if (!pCacheDirectory) {
+        return vkCompileShader(shaderCode, shaderType, shaderBinary);
+    }
+
+    // 컴파일 결과에 영향을 주는 모든 입력(소스, 셰이더 종류, 컴파일 옵션, shaderc 버전)으로 키를 만든다.
+    // NDK를 올려서 shaderc가 바뀌면 이전 캐시는 사용되지 않는다.
+    unsigned int spirvVersion;
+    unsigned int spirvRevision;
+    shaderc_get_spv_version(&spirvVersion, &spirvRevision);
+
+    const uint32_t compileOptions[]{
+        static_cast<uint32_t>(kShaderTargetEnvVersion),
+        static_cast<uint32_t>(kShaderOptimizationLevel),
+        spirvVersion,
+        spirvRevision
+    };
+    auto key = vkHash(shaderCode.data(), shaderCode.size());
+    key = vkHash(&shaderType, sizeof(shaderType), key);
+    key = vkHash(compileOptions, sizeof(compileOptions), key);
+
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "/%016llx.spv", static_cast<unsigned long long>(key));
+    auto path = std::string(pCacheDirectory) + fileName;
+
+    constexpr uint32_t spirvMagicNumber{0x07230203};
+    constexpr size_t spirvHeaderSize{5 * sizeof(uint32_t)};
+
+    std::vector<uint8_t> cachedBinary;
+    if (vkReadFile(path, &cachedBinary) == VK_SUCCESS &&
+        cachedBinary.size() >= spirvHeaderSize &&
+        cachedBinary.size() % sizeof(uint32_t) == 0 &&
+        *reinterpret_cast<const uint32_t *>(cachedBinary.data()) == spirvMagicNumber) {
+        shaderBinary->resize(cachedBinary.size() / sizeof(uint32_t));
+        memcpy(shaderBinary->data(), cachedBinary.data(), cachedBinary.size());
+        return VK_SUCCESS;
+    }
+
+    if (auto vkResult = vkCompileShader(shaderCode, shaderType, shaderBinary);
+        vkResult != VK_SUCCESS) {
+        return vkResult;
+    }
+
+    // 캐시에 쓰지 못하더라도 컴파일은 성공했기 때문에 오류를 반환하지 않는다.
+    if (vkWriteFile(path,
+                    shaderBinary->data(),
+                    shaderBinary->size() * sizeof(uint32_t)) != VK_SUCCESS) {
+        aout << "Fail to write the shader cache: " << path << std::endl;
+    }
+
+    return VK_SUCCESS;
+}
+#endif
+
+inline VkBool32
+vkIsPipelineCacheCompatible(const VkPhysicalDeviceProperties &physicalDeviceProperties,
+                            const std::vector<uint8_t> &pipelineCacheData) {
+    if (pipelineCacheData.size() < sizeof(VkPipelineCacheHeaderVersionOne)) {
+        return VK_FALSE;
+    }
+
+    VkPipelineCacheHeaderVersionOne header;
+    memcpy(&header, pipelineCacheData.data(), sizeof(header));
+
+    if (header.headerSize < sizeof(VkPipelineCacheHeaderVersionOne) ||
+        header.headerSize > pipelineCacheData.size() ||
+        header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        header.vendorID != physicalDeviceProperties.vendorID ||
+        header.deviceID != physicalDeviceProperties.deviceID ||
+        memcmp(header.pipelineCacheUUID,
+               physicalDeviceProperties.pipelineCacheUUID,
+               VK_UUID_SIZE) != 0) {
+        return VK_FALSE;
+    }
+
+    return VK_TRUE;
+}
 
 inline VkResult
 vkGetMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
@@ -200,4 +448,152 @@ vkGetMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties &physicalDeviceMemor
     return VK_ERROR_UNKNOWN;
 }
 
+// requiredFlags를 모두 가진 메모리 타입 중 preferredFlags까지 모두 가진 타입을 우선 선택한다.
+// UMA GPU는 DEVICE_LOCAL이면서 HOST_VISIBLE인 타입을 제공하므로 스테이징 복사 없이 바로 쓸 수 있다.
+inline VkResult
+vkGetMemoryTypeIndex(const VkPhysicalDeviceMemoryProperties &physicalDeviceMemoryProperties,
+                     const VkMemoryRequirements &memoryRequirements,
+                     VkMemoryPropertyFlags requiredFlags,
+                     VkMemoryPropertyFlags preferredFlags,
+                     uint32_t *memoryTypeIndex) {
+    if (preferredFlags &&
+        vkGetMemoryTypeIndex(physicalDeviceMemoryProperties,
+                             memoryRequirements,
+                             requiredFlags | preferredFlags,
+                             memoryTypeIndex) == VK_SUCCESS) {
+        return VK_SUCCESS;
+    }
+
+    return vkGetMemoryTypeIndex(physicalDeviceMemoryProperties, memoryRequirements, requiredFlags, memoryTypeIndex);
+}
+
+inline VkDeviceSize vkAlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    // Vulkan의 정렬 값은 항상 2의 거듭제곱이다.
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// pNext 체인에서 sType이 같은 구조체를 찾으며 없으면 nullptr을 반환한다.
+inline const void *vkFindStructure(const void *pNext, VkStructureType sType) {
+    for (auto pStructure = static_cast<const VkBaseInStructure *>(pNext);
+         pStructure;
+         pStructure = pStructure->pNext) {
+        if (pStructure->sType == sType) {
+            return pStructure;
+        }
+    }
+    return nullptr;
+}
+
+// 레이어 목록에 layerName이 있으면 VK_TRUE를 반환한다.
+inline VkBool32
+vkHasLayer(const std::vector<VkLayerProperties> &layerProperties, const char *layerName) {
+    return std::any_of(layerProperties.begin(), layerProperties.end(), [=](const auto &properties) {
+        return strcmp(properties.layerName, layerName) == 0;
+    });
+}
+
+// 확장 목록에 extensionName이 있으면 VK_TRUE를 반환한다.
+inline VkBool32
+vkHasExtension(const std::vector<VkExtensionProperties> &extensionProperties,
+               const char *extensionName) {
+    return std::any_of(extensionProperties.begin(),
+                       extensionProperties.end(),
+                       [=](const auto &properties) {
+                           return strcmp(properties.extensionName, extensionName) == 0;
+                       });
+}
+
+// [-1, 1] 범위의 실수를 가장 가까운 SNORM16 값으로 변환한다.
+constexpr int16_t vkQuantizeSnorm16(float value) {
+    const auto scaled = std::clamp(value, -1.0f, 1.0f) * 32767.0f;
+    return static_cast<int16_t>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+}
+
+// [0, 1] 범위의 실수를 가장 가까운 UNORM16 값으로 변환한다.
+constexpr uint16_t vkQuantizeUnorm16(float value) {
+    return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+// [0, 1] 범위의 실수를 가장 가까운 UNORM8 값으로 변환한다.
+constexpr uint8_t vkQuantizeUnorm8(float value) {
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// 크기에 배율을 곱하고 8픽셀 단위로 올림해서 배율이 조금씩 바뀔 때마다 크기가 바뀌지 않게 한다.
+// 결과는 원래 크기를 넘지 않는다.
+inline VkExtent2D vkScaleExtent(const VkExtent2D &extent, double scale) {
+    const auto scaleSize = [=](uint32_t size) {
+        const auto scaledSize = static_cast<uint32_t>(std::ceil(size * scale / 8.0)) * 8;
+        return std::clamp(scaledSize, 1u, size);
+    };
+    return {scaleSize(extent.width), scaleSize(extent.height)};
+}
+
+inline uint32_t vkGetMipLevelCount(const VkExtent3D &extent) {
+    uint32_t mipLevelCount = 1;
+    for (auto size = std::max({extent.width, extent.height, extent.depth}); size > 1; size >>= 1) {
+        ++mipLevelCount;
+    }
+    return mipLevelCount;
+}
+
+// 특수화 상수가 모두 4바이트이고 constant_id가 0부터 배열 순서와 같다고 보고 VkSpecializationInfo를 채운다.
+// 반환된 구조체는 constants와 pMapEntries를 가리키므로 VkPipeline을 만들 때까지 둘 다 유효해야 한다.
+template<size_t N>
+inline VkSpecializationInfo
+vkGetSpecializationInfo(const std::array<uint32_t, N> &constants,
+                        std::array<VkSpecializationMapEntry, N> *pMapEntries) {
+    for (uint32_t i = 0; i != N; ++i) {
+        (*pMapEntries)[i] = {
+            .constantID = i,
+            .offset = static_cast<uint32_t>(i * sizeof(uint32_t)),
+            .size = sizeof(uint32_t)
+        };
+    }
+
+    return {
+        .mapEntryCount = static_cast<uint32_t>(N),
+        .pMapEntries = pMapEntries->data(),
+        .dataSize = sizeof(constants),
+        .pData = constants.data()
+    };
+}
+
+// 하나의 스레드가 넣고 다른 하나의 스레드가 꺼내는 잠금 없는 큐로 N은 2의 거듭제곱이어야 한다.
+template<typename T, size_t N>
+class VkSpscQueue {
+public:
+    bool push(const T &value) {
+        const auto tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mHead.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        mValues[tail & (N - 1)] = value;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T *value) {
+        const auto head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *value = mValues[head & (N - 1)];
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+private:
+    static_assert((N & (N - 1)) == 0);
+
+    std::array<T, N> mValues{};
+    // 생산자와 소비자가 서로의 캐시 라인을 무효화하지 않도록 분리한다.
+    alignas(64) std::atomic<size_t> mHead{0};
+    alignas(64) std::atomic<size_t> mTail{0};
+};
+
 #endif //PRACTICE_VULKAN_VKUTIL_H
@@ -0,0 +1,6 @@
+# GLSL 소스를 C++ raw string literal로 감싸서 #include 할 수 있는 파일을 생성한다.
+#
+# cmake -DSHADER_INPUT=<glsl> -DSHADER_OUTPUT=<inc> -P EmbedShader.cmake
+
+file(READ ${SHADER_INPUT} SHADER_CODE)
+file(WRITE ${SHADER_OUTPUT} "R\"glsl(${SHADER_CODE})glsl\"\n")
@@ -16,9 +16,39 @@ extern "C" {
 void handle_cmd(android_app *pApp, int32_t cmd) {
     switch (cmd) {
         case APP_CMD_INIT_WINDOW:
-            pApp->userData = new VkRenderer(pApp->window, pApp->activity->assetManager);
+            // Only the surface and swapchain are rebuilt when the window comes back.
+            if (pApp->userData) {
+                static_cast<VkRenderer *>(pApp->userData)->attachWindow(pApp->window);
+            } else {
+                pApp->userData = new VkRenderer(pApp->window,
+                                                pApp->activity->assetManager,
+                                                pApp->activity->internalDataPath);
+            }
             break;
         case APP_CMD_TERM_WINDOW:
+            if (pApp->userData) {
+                static_cast<VkRenderer *>(pApp->userData)->detachWindow();
+            }
+            break;
+        case APP_CMD_WINDOW_RESIZED:
+        case APP_CMD_CONFIG_CHANGED:
+            if (pApp->userData) {
+                static_cast<VkRenderer *>(pApp->userData)->resize();
+            }
+            break;
+        case APP_CMD_LOW_MEMORY:
+            // Release the textures; they are streamed back in when the next frame draws them.
+            if (pApp->userData) {
+                static_cast<VkRenderer *>(pApp->userData)->trimMemory();
+            }
+            break;
+        case APP_CMD_PAUSE:
+            // Dump the frame times collected so far whenever the app goes to the background.
+            if (pApp->userData) {
+                static_cast<VkRenderer *>(pApp->userData)->printFrameTimeHistogram();
+            }
+            break;
+        case APP_CMD_DESTROY:
             if (pApp->userData) {
                 delete static_cast<VkRenderer *>(pApp->userData);
                 pApp->userData = nullptr;
@@ -56,21 +86,17 @@ void android_main(struct android_app *pApp) {
     // implemented in android_native_app_glue.c.
     android_app_set_motion_event_filter(pApp, motion_event_filter_func);
 
-    // This sets up a typical game/event loop. It will run until the app is destroyed.
+    // This sets up the event loop. It will run until the app is destroyed.
+    // Rendering happens on the renderer's own thread, so block until an event arrives
+    // instead of busy-polling.
     int events;
     android_poll_source *pSource;
     do {
-        // Process all pending events before running game logic.
-        if (ALooper_pollAll(0, nullptr, &events, (void **) &pSource) >= 0) {
+        if (ALooper_pollAll(-1, nullptr, &events, (void **) &pSource) >= 0) {
             if (pSource) {
                 pSource->process(pApp, pSource);
             }
         }
-
-        // Check if any user data is associated. This is assigned in handle_cmd
-        if (pApp->userData) {
-            static_cast<VkRenderer *>(pApp->userData)->render();
-        }
     } while (!pApp->destroyRequested);
 }
 }
\ No newline at end of file
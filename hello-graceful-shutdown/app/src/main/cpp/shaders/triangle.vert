@@ -0,0 +1,30 @@
+#version 310 es
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inUv;
+layout(location = 3) in vec2 inInstancePosition;
+layout(location = 4) in float inInstanceScale;
+layout(location = 5) in uint inInstanceLayer;
+
+layout(location = 0) out vec3 outColor;
+layout(location = 1) out vec2 outUv;
+layout(location = 2) flat out uint outLayer;
+
+// 그리기마다의 데이터는 Uniform VkBuffer 대신 VkCommandBuffer에 직접 기록된다.
+layout(push_constant) uniform PushConstant {
+    mat2 rotation;
+    float ratio;
+    uint textureIndex;
+};
+
+void main() {
+    // 인스턴스의 위치는 Compute 셰이더에서 갱신되고 화면에 보이는 인스턴스만 전달된다.
+    gl_Position = vec4(inPosition * inInstanceScale, 1.0);
+    gl_Position.x *= ratio;
+    gl_Position.xy += inInstancePosition;
+    gl_Position.xy = rotation * gl_Position.xy;
+    outColor = inColor;
+    outUv = inUv;
+    outLayer = inInstanceLayer;
+}
@@ -0,0 +1,36 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 inColor;
+layout(location = 1) in vec2 inUv;
+// 인스턴스마다 샘플링할 텍스처 배열의 레이어.
+layout(location = 2) flat in uint inLayer;
+
+layout(location = 0) out vec4 outColor;
+
+// 모든 텍스처를 하나의 배열에 두고 그리기마다 Push Constant로 전달된 인덱스로 선택한다.
+// 각 원소는 텍스처 배열이며 레이어는 인스턴스마다 선택한다.
+layout(set = 0, binding = 1) uniform sampler2DArray textures[];
+
+// Vertex 셰이더와 같은 Push Constant 블록에서 텍스처 인덱스만 사용한다.
+layout(push_constant) uniform PushConstant {
+    layout(offset = 20) uint textureIndex;
+};
+
+// 특수화 상수로 VkPipeline을 만들 때 정해지며 드라이버가 사용하지 않는 분기를 제거한다.
+// VkRenderer::ShaderVariantConstant의 순서와 같아야 한다.
+layout(constant_id = 0) const bool kTextured = true;
+layout(constant_id = 1) const bool kTonemap = false;
+
+void main() {
+    vec3 color = inColor;
+    if (kTextured) {
+        color *= texture(textures[textureIndex], vec3(inUv, float(inLayer))).rgb;
+    }
+
+    // Reinhard 톤 매핑으로 밝은 색이 포화되지 않고 1에 가까워지게 한다.
+    if (kTonemap) {
+        color /= color + vec3(1.0);
+    }
+    outColor = vec4(color, 1.0);
+}